@@ -0,0 +1,157 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ---------- Reporting ---------- */
+
+static FILE *bench_out = NULL;
+static size_t bench_count = 0;
+
+void bench_begin(FILE *out, const bench_config_t *cfg) {
+    bench_out = out;
+    bench_count = 0;
+    fprintf(out, "{\n  \"suite\": \"fossil-threads\",\n");
+    fprintf(out, "  \"cpus\": %zu,\n  \"numa_nodes\": %zu,\n",
+            fossil_threads_cpu_count(), fossil_threads_numa_node_count());
+    fprintf(out, "  \"max_threads\": %zu,\n  \"scale\": %g,\n", cfg->max_threads, cfg->scale);
+    fprintf(out, "  \"lock_profiling\": %s,\n", fossil_threads_mutex_profile_enabled() ? "true" : "false");
+    fprintf(out, "  \"results\": [");
+}
+
+void bench_end(void) {
+    if (!bench_out) return;
+    fprintf(bench_out, "%s]\n}\n", bench_count ? "\n  " : "");
+    fflush(bench_out);
+    bench_out = NULL;
+}
+
+void bench_report(const bench_result_t *r) {
+    if (!bench_out) return;
+    fprintf(bench_out, "%s\n    {\"name\": \"%s\"", bench_count++ ? "," : "", r->name);
+    if (r->variant) fprintf(bench_out, ", \"variant\": \"%s\"", r->variant);
+    fprintf(bench_out, ", \"threads\": %zu, \"ops\": %llu, \"ns_per_op\": %.2f",
+            r->threads, r->ops, r->ns_per_op);
+    if (r->has_latency)
+        fprintf(bench_out, ", \"p50_ns\": %.0f, \"p90_ns\": %.0f, \"p99_ns\": %.0f, \"max_ns\": %.0f",
+                r->p50_ns, r->p90_ns, r->p99_ns, r->max_ns);
+    fprintf(bench_out, "}");
+    fflush(bench_out);
+}
+
+/* ---------- Helpers ---------- */
+
+int bench_selected(const bench_config_t *cfg, const char *name) {
+    return !cfg->filter || strstr(name, cfg->filter) != NULL;
+}
+
+size_t bench_iters(const bench_config_t *cfg, size_t base) {
+    double n = (double)base * cfg->scale;
+    return n < 1.0 ? 1 : (size_t)n;
+}
+
+long long bench_now(void) {
+    return fossil_threads_clock_monotonic_ns();
+}
+
+static int bench_cmp_ll(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+static double bench_percentile(const long long *sorted, size_t n, double q) {
+    return (double)sorted[(size_t)(q * (double)(n - 1) + 0.5)];
+}
+
+void bench_latency(bench_result_t *r, long long *samples, size_t n) {
+    if (n == 0) return;
+    qsort(samples, n, sizeof(*samples), bench_cmp_ll);
+    r->has_latency = 1;
+    r->p50_ns = bench_percentile(samples, n, 0.50);
+    r->p90_ns = bench_percentile(samples, n, 0.90);
+    r->p99_ns = bench_percentile(samples, n, 0.99);
+    r->max_ns = (double)samples[n - 1];
+}
+
+size_t bench_next_threads(size_t current, size_t max) {
+    if (current >= max) return 0;
+    return current * 2 < max ? current * 2 : max;
+}
+
+/* ---------- Thread group with a common start ---------- */
+
+typedef struct {
+    fossil_threads_mutex_t lock;
+    fossil_threads_cond_t cond;
+    int open;
+    fossil_threads_thread_func fn;
+    void *arg;
+} bench_gate_t;
+
+static void *bench_gate_main(void *p) {
+    bench_gate_t *g = (bench_gate_t *)p;
+    fossil_threads_mutex_lock(&g->lock);
+    while (!g->open) fossil_threads_cond_wait(&g->cond, &g->lock);
+    fossil_threads_mutex_unlock(&g->lock);
+    return g->fn(g->arg);
+}
+
+long long bench_run_threads(size_t n, fossil_threads_thread_func fn, void *arg) {
+    bench_gate_t g;
+    fossil_threads_thread_t *threads =
+        (fossil_threads_thread_t *)calloc(n, sizeof(*threads));
+    if (!threads) return -1;
+    fossil_threads_mutex_init(&g.lock);
+    fossil_threads_cond_init(&g.cond);
+    g.open = 0;
+    g.fn = fn;
+    g.arg = arg;
+
+    size_t started = 0;
+    for (; started < n; ++started) {
+        fossil_threads_thread_init(&threads[started]);
+        if (fossil_threads_thread_create(&threads[started], bench_gate_main, &g) != FOSSIL_THREADS_OK)
+            break;
+    }
+
+    /* Give the threads a moment to reach the gate so creation is not timed */
+    fossil_threads_thread_sleep_ms(10);
+    fossil_threads_mutex_lock(&g.lock);
+    g.open = 1;
+    long long t0 = bench_now();
+    fossil_threads_cond_broadcast(&g.cond);
+    fossil_threads_mutex_unlock(&g.lock);
+    for (size_t i = 0; i < started; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+    long long elapsed = bench_now() - t0;
+
+    fossil_threads_cond_dispose(&g.cond);
+    fossil_threads_mutex_dispose(&g.lock);
+    free(threads);
+    return started == n ? elapsed : -1;
+}
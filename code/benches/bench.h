@@ -0,0 +1,96 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_BENCH_H
+#define FOSSIL_THREADS_BENCH_H
+
+#include "fossil/threads/framework.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/* ---------- Configuration ---------- */
+
+typedef struct bench_config {
+    size_t      max_threads;   /* largest thread / worker count measured */
+    double      scale;         /* iteration multiplier (--quick lowers it) */
+    const char *filter;        /* run only benchmarks whose name contains this */
+} bench_config_t;
+
+/* ---------- Results ---------- */
+
+/*
+ * One measurement. ns_per_op is wall time divided by the total number of
+ * operations across all threads, so for contended runs it is the inverse
+ * of aggregate throughput. Latency fields are filled by bench_latency()
+ * for benchmarks that time individual operations.
+ */
+typedef struct bench_result {
+    const char *name;          /* e.g. "mutex.lock_unlock" */
+    const char *variant;       /* e.g. "adaptive", or NULL */
+    size_t threads;            /* threads or pool workers involved */
+    unsigned long long ops;    /* operations measured */
+    double ns_per_op;
+    int    has_latency;
+    double p50_ns, p90_ns, p99_ns, max_ns;
+} bench_result_t;
+
+/* Nonzero if the benchmark called name should run under cfg. */
+int bench_selected(const bench_config_t *cfg, const char *name);
+
+/* Iteration count for a benchmark whose full-scale count is base (at least 1). */
+size_t bench_iters(const bench_config_t *cfg, size_t base);
+
+/* Monotonic nanoseconds. */
+long long bench_now(void);
+
+/* Sorts samples in place and fills the percentile fields of r. */
+void bench_latency(bench_result_t *r, long long *samples, size_t n);
+
+/* Opens the JSON document on out; bench_end() closes it. */
+void bench_begin(FILE *out, const bench_config_t *cfg);
+void bench_end(void);
+
+/* Emits r as one element of the JSON results array. */
+void bench_report(const bench_result_t *r);
+
+/*
+ * Runs fn(arg) on n new threads released together; returns the wall time
+ * from release until the last thread finished, or -1 if a thread could
+ * not be created.
+ */
+long long bench_run_threads(size_t n, fossil_threads_thread_func fn, void *arg);
+
+/* Thread counts to sweep: 1, 2, 4, ... up to and including max. */
+size_t bench_next_threads(size_t current, size_t max);
+
+/* ---------- Suites ---------- */
+
+void bench_mutex(const bench_config_t *cfg);
+void bench_cond(const bench_config_t *cfg);
+void bench_thread(const bench_config_t *cfg);
+void bench_pool(const bench_config_t *cfg);
+void bench_barrier(const bench_config_t *cfg);
+void bench_channel(const bench_config_t *cfg);
+
+#endif /* FOSSIL_THREADS_BENCH_H */
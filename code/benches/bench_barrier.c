@@ -0,0 +1,104 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+
+/* ---------- Phase barrier ---------- */
+
+/*
+ * Every thread crosses the same barrier phase after phase with no work in
+ * between, so the figure is the cost of one phase divided across the
+ * threads. The "cond" variant is the mutex + condition variable barrier
+ * callers used to hand-roll; the others are fossil_threads_barrier_t with
+ * and without the spin phase.
+ */
+typedef struct {
+    fossil_threads_mutex_t m;
+    fossil_threads_cond_t c;
+    size_t count, arrived, generation;
+} bench_cond_barrier_t;
+
+static void bench_cond_barrier_wait(bench_cond_barrier_t *b) {
+    fossil_threads_mutex_lock(&b->m);
+    size_t gen = b->generation;
+    if (++b->arrived == b->count) {
+        b->arrived = 0;
+        b->generation++;
+        fossil_threads_cond_broadcast(&b->c);
+    } else {
+        while (gen == b->generation) fossil_threads_cond_wait(&b->c, &b->m);
+    }
+    fossil_threads_mutex_unlock(&b->m);
+}
+
+typedef struct {
+    int use_cond;
+    size_t phases;
+    bench_cond_barrier_t cb;
+    fossil_threads_barrier_t fb;
+} bench_barrier_ctx_t;
+
+static void *bench_barrier_body(void *arg) {
+    bench_barrier_ctx_t *ctx = (bench_barrier_ctx_t *)arg;
+    for (size_t p = 0; p < ctx->phases; ++p) {
+        if (ctx->use_cond) bench_cond_barrier_wait(&ctx->cb);
+        else fossil_threads_barrier_wait(&ctx->fb);
+    }
+    return NULL;
+}
+
+void bench_barrier(const bench_config_t *cfg) {
+    static const struct { int use_cond; unsigned int spin; const char *name; } variants[] = {
+        { 1, 0u,                                  "cond" },
+        { 0, 0u,                                  "futex" },
+        { 0, FOSSIL_THREADS_BARRIER_SPIN_DEFAULT, "futex_spin" }
+    };
+    if (!bench_selected(cfg, "barrier.phase")) return;
+
+    for (size_t t = 2; t && t <= cfg->max_threads; t = bench_next_threads(t, cfg->max_threads)) {
+        for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v) {
+            bench_barrier_ctx_t ctx;
+            ctx.use_cond = variants[v].use_cond;
+            ctx.phases = bench_iters(cfg, 20000);
+            fossil_threads_mutex_init(&ctx.cb.m);
+            fossil_threads_cond_init(&ctx.cb.c);
+            ctx.cb.count = t;
+            ctx.cb.arrived = 0;
+            ctx.cb.generation = 0;
+            fossil_threads_barrier_init(&ctx.fb, (unsigned int)t, variants[v].spin);
+
+            long long dt = bench_run_threads(t, bench_barrier_body, &ctx);
+
+            fossil_threads_barrier_dispose(&ctx.fb);
+            fossil_threads_cond_dispose(&ctx.cb.c);
+            fossil_threads_mutex_dispose(&ctx.cb.m);
+            if (dt < 0) continue;
+
+            bench_result_t r = { "barrier.phase", variants[v].name, t, 0, 0.0, 0, 0, 0, 0, 0 };
+            r.ops = (unsigned long long)(ctx.phases * t);
+            r.ns_per_op = (double)dt / (double)r.ops;
+            bench_report(&r);
+        }
+    }
+}
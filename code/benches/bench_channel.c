@@ -0,0 +1,155 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <string.h>
+
+/* ---------- Producer / consumer hand-off ---------- */
+
+/*
+ * Half the threads send, half receive, through a 256-slot queue. The
+ * "cond" variant is the mutex + two condition variables ring pipeline
+ * stages used before channels; "spsc" (two threads only) and "mpmc" are
+ * fossil_threads_channel_t. The last producer to finish closes the queue
+ * and consumers run until it is drained, so the figure is wall time per
+ * message delivered.
+ */
+#define BENCH_CHANNEL_SLOTS 256
+
+typedef struct {
+    fossil_threads_mutex_t m;
+    fossil_threads_cond_t not_empty, not_full;
+    size_t head, count;
+    int closed;
+    size_t slots[BENCH_CHANNEL_SLOTS];
+} bench_cond_queue_t;
+
+typedef struct {
+    int use_cond;
+    size_t per_producer;
+    size_t half;               /* producer count; the rest consume */
+    size_t producers;          /* guarded by role_lock */
+    size_t producers_left;     /* guarded by role_lock */
+    fossil_threads_mutex_t role_lock;
+    bench_cond_queue_t cq;
+    fossil_threads_channel_t *ch;
+} bench_channel_ctx_t;
+
+static void bench_cond_send(bench_cond_queue_t *q, size_t v) {
+    fossil_threads_mutex_lock(&q->m);
+    while (q->count == BENCH_CHANNEL_SLOTS) fossil_threads_cond_wait(&q->not_full, &q->m);
+    q->slots[(q->head + q->count++) % BENCH_CHANNEL_SLOTS] = v;
+    fossil_threads_cond_signal(&q->not_empty);
+    fossil_threads_mutex_unlock(&q->m);
+}
+
+static int bench_cond_recv(bench_cond_queue_t *q, size_t *v) {
+    fossil_threads_mutex_lock(&q->m);
+    while (q->count == 0 && !q->closed) fossil_threads_cond_wait(&q->not_empty, &q->m);
+    int ok = q->count != 0;
+    if (ok) {
+        *v = q->slots[q->head];
+        q->head = (q->head + 1) % BENCH_CHANNEL_SLOTS;
+        q->count--;
+        fossil_threads_cond_signal(&q->not_full);
+    }
+    fossil_threads_mutex_unlock(&q->m);
+    return ok;
+}
+
+static void *bench_channel_body(void *arg) {
+    bench_channel_ctx_t *ctx = (bench_channel_ctx_t *)arg;
+    fossil_threads_mutex_lock(&ctx->role_lock);
+    int producer = ctx->producers < ctx->half;
+    if (producer) ctx->producers++;
+    fossil_threads_mutex_unlock(&ctx->role_lock);
+
+    if (producer) {
+        for (size_t i = 1; i <= ctx->per_producer; ++i) {
+            if (ctx->use_cond) bench_cond_send(&ctx->cq, i);
+            else fossil_threads_channel_send(ctx->ch, &i);
+        }
+        fossil_threads_mutex_lock(&ctx->role_lock);
+        int last = --ctx->producers_left == 0;
+        fossil_threads_mutex_unlock(&ctx->role_lock);
+        if (last && ctx->use_cond) {
+            fossil_threads_mutex_lock(&ctx->cq.m);
+            ctx->cq.closed = 1;
+            fossil_threads_cond_broadcast(&ctx->cq.not_empty);
+            fossil_threads_mutex_unlock(&ctx->cq.m);
+        } else if (last) {
+            fossil_threads_channel_close(ctx->ch);
+        }
+    } else {
+        size_t v;
+        if (ctx->use_cond) while (bench_cond_recv(&ctx->cq, &v)) {}
+        else while (fossil_threads_channel_recv(ctx->ch, &v) == FOSSIL_THREADS_CHANNEL_OK) {}
+    }
+    return NULL;
+}
+
+void bench_channel(const bench_config_t *cfg) {
+    static const struct { int use_cond; int kind; const char *name; } variants[] = {
+        { 1, 0,                            "cond" },
+        { 0, FOSSIL_THREADS_CHANNEL_SPSC,  "spsc" },
+        { 0, FOSSIL_THREADS_CHANNEL_MPMC,  "mpmc" }
+    };
+    if (!bench_selected(cfg, "channel.handoff")) return;
+
+    for (size_t t = 2; t && t <= cfg->max_threads; t = bench_next_threads(t, cfg->max_threads)) {
+        for (size_t v = 0; v < sizeof(variants) / sizeof(variants[0]); ++v) {
+            if (!variants[v].use_cond && variants[v].kind == FOSSIL_THREADS_CHANNEL_SPSC && t != 2) continue;
+
+            bench_channel_ctx_t ctx;
+            memset(&ctx, 0, sizeof(ctx));
+            ctx.use_cond = variants[v].use_cond;
+            ctx.per_producer = bench_iters(cfg, 400000) / (t / 2);
+            ctx.half = t / 2;
+            ctx.producers_left = t / 2;
+            fossil_threads_mutex_init(&ctx.role_lock);
+            fossil_threads_mutex_init(&ctx.cq.m);
+            fossil_threads_cond_init(&ctx.cq.not_empty);
+            fossil_threads_cond_init(&ctx.cq.not_full);
+            if (!ctx.use_cond &&
+                fossil_threads_channel_create(&ctx.ch, variants[v].kind, BENCH_CHANNEL_SLOTS,
+                                              sizeof(size_t)) != FOSSIL_THREADS_CHANNEL_OK) {
+                ctx.ch = NULL;
+            }
+
+            long long dt = (ctx.use_cond || ctx.ch) ? bench_run_threads(t, bench_channel_body, &ctx) : -1;
+
+            fossil_threads_channel_destroy(ctx.ch);
+            fossil_threads_cond_dispose(&ctx.cq.not_full);
+            fossil_threads_cond_dispose(&ctx.cq.not_empty);
+            fossil_threads_mutex_dispose(&ctx.cq.m);
+            fossil_threads_mutex_dispose(&ctx.role_lock);
+            if (dt < 0) continue;
+
+            bench_result_t r = { "channel.handoff", variants[v].name, t, 0, 0.0, 0, 0, 0, 0, 0 };
+            r.ops = (unsigned long long)(ctx.per_producer * (t / 2));
+            r.ns_per_op = (double)dt / (double)r.ops;
+            bench_report(&r);
+        }
+    }
+}
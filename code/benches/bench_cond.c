@@ -0,0 +1,103 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdlib.h>
+
+/* ---------- Signal-to-wake latency ---------- */
+
+/*
+ * Two threads hand a token back and forth through one mutex and condition
+ * variable. Each round trip is two signal-to-wake hand-offs, so half of it
+ * is reported as the latency sample.
+ */
+typedef struct {
+    fossil_threads_mutex_t m;
+    fossil_threads_cond_t c;
+    int turn;              /* 1: echo thread's turn, 0: measuring thread's */
+    size_t rounds;
+} bench_cond_ctx_t;
+
+static void *bench_cond_echo(void *arg) {
+    bench_cond_ctx_t *ctx = (bench_cond_ctx_t *)arg;
+    fossil_threads_mutex_lock(&ctx->m);
+    for (size_t r = 0; r < ctx->rounds; ++r) {
+        while (ctx->turn != 1) fossil_threads_cond_wait(&ctx->c, &ctx->m);
+        ctx->turn = 0;
+        fossil_threads_cond_signal(&ctx->c);
+    }
+    fossil_threads_mutex_unlock(&ctx->m);
+    return NULL;
+}
+
+void bench_cond(const bench_config_t *cfg) {
+    static const struct { int kind; const char *name; } kinds[] = {
+        { FOSSIL_THREADS_MUTEX_KIND_NORMAL,   "normal" },
+        { FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE, "adaptive" }
+    };
+    if (!bench_selected(cfg, "cond.signal_wake")) return;
+
+    size_t rounds = bench_iters(cfg, 50000);
+    long long *samples = (long long *)malloc(rounds * sizeof(*samples));
+    if (!samples) return;
+
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); ++k) {
+        bench_cond_ctx_t ctx;
+        fossil_threads_thread_t echo;
+        fossil_threads_mutex_init_ex(&ctx.m, kinds[k].kind);
+        fossil_threads_cond_init(&ctx.c);
+        ctx.turn = 0;
+        ctx.rounds = rounds;
+        fossil_threads_thread_init(&echo);
+        if (fossil_threads_thread_create(&echo, bench_cond_echo, &ctx) != FOSSIL_THREADS_OK) {
+            fossil_threads_cond_dispose(&ctx.c);
+            fossil_threads_mutex_dispose(&ctx.m);
+            continue;
+        }
+
+        long long total = 0;
+        fossil_threads_mutex_lock(&ctx.m);
+        for (size_t r = 0; r < rounds; ++r) {
+            long long t0 = bench_now();
+            ctx.turn = 1;
+            fossil_threads_cond_signal(&ctx.c);
+            while (ctx.turn != 0) fossil_threads_cond_wait(&ctx.c, &ctx.m);
+            long long dt = bench_now() - t0;
+            samples[r] = dt / 2;
+            total += dt;
+        }
+        fossil_threads_mutex_unlock(&ctx.m);
+        fossil_threads_thread_join(&echo, NULL);
+        fossil_threads_thread_dispose(&echo);
+        fossil_threads_cond_dispose(&ctx.c);
+        fossil_threads_mutex_dispose(&ctx.m);
+
+        bench_result_t res = { "cond.signal_wake", kinds[k].name, 2, 0, 0.0, 0, 0, 0, 0, 0 };
+        res.ops = (unsigned long long)rounds * 2u;
+        res.ns_per_op = (double)total / (double)res.ops;
+        bench_latency(&res, samples, rounds);
+        bench_report(&res);
+    }
+    free(samples);
+}
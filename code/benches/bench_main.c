@@ -0,0 +1,88 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdlib.h>
+#include <string.h>
+
+static void bench_usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [--quick] [--threads=N] [--filter=NAME] [--out=FILE]\n"
+            "  --quick       run about 5%% of the default iterations\n"
+            "  --threads=N   largest thread / worker count to sweep (default: CPUs, at least 2)\n"
+            "  --filter=NAME only run benchmarks whose name contains NAME\n"
+            "  --out=FILE    write the JSON report to FILE instead of stdout\n",
+            prog);
+}
+
+int main(int argc, char **argv) {
+    bench_config_t cfg;
+    const char *out_path = NULL;
+    size_t cpus = fossil_threads_cpu_count();
+    cfg.max_threads = cpus < 2 ? 2 : cpus;
+    cfg.scale = 1.0;
+    cfg.filter = NULL;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (strcmp(a, "--quick") == 0) {
+            cfg.scale = 0.05;
+        } else if (strncmp(a, "--threads=", 10) == 0) {
+            long n = strtol(a + 10, NULL, 10);
+            if (n < 1 || n > 1024) {
+                bench_usage(argv[0]);
+                return 2;
+            }
+            cfg.max_threads = (size_t)n;
+        } else if (strncmp(a, "--filter=", 9) == 0) {
+            cfg.filter = a + 9;
+        } else if (strncmp(a, "--out=", 6) == 0) {
+            out_path = a + 6;
+        } else {
+            bench_usage(argv[0]);
+            return strcmp(a, "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    FILE *out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "cannot open %s\n", out_path);
+            return 1;
+        }
+    }
+
+    bench_begin(out, &cfg);
+    bench_mutex(&cfg);
+    bench_cond(&cfg);
+    bench_thread(&cfg);
+    bench_pool(&cfg);
+    bench_barrier(&cfg);
+    bench_channel(&cfg);
+    bench_end();
+
+    if (out != stdout) fclose(out);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+
+/* ---------- Lock / unlock ---------- */
+
+typedef struct {
+    fossil_threads_mutex_t m;
+    size_t iters;
+    volatile unsigned long counter;
+} bench_mutex_ctx_t;
+
+static void *bench_mutex_loop(void *arg) {
+    bench_mutex_ctx_t *ctx = (bench_mutex_ctx_t *)arg;
+    for (size_t i = 0; i < ctx->iters; ++i) {
+        fossil_threads_mutex_lock(&ctx->m);
+        ctx->counter++;
+        fossil_threads_mutex_unlock(&ctx->m);
+    }
+    return NULL;
+}
+
+void bench_mutex(const bench_config_t *cfg) {
+    static const struct { int kind; const char *name; } kinds[] = {
+        { FOSSIL_THREADS_MUTEX_KIND_NORMAL,   "normal" },
+        { FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE, "adaptive" }
+    };
+    if (!bench_selected(cfg, "mutex.lock_unlock")) return;
+
+    /* The total stays fixed as threads are added, so runs stay comparable */
+    size_t total = bench_iters(cfg, 2000000);
+    for (size_t k = 0; k < sizeof(kinds) / sizeof(kinds[0]); ++k) {
+        for (size_t t = 1; t; t = bench_next_threads(t, cfg->max_threads)) {
+            bench_mutex_ctx_t ctx;
+            fossil_threads_mutex_init_ex(&ctx.m, kinds[k].kind);
+            ctx.iters = total / t ? total / t : 1;
+            ctx.counter = 0;
+
+            long long elapsed;
+            if (t == 1) {
+                /* Uncontended: no second thread anywhere near the lock */
+                long long t0 = bench_now();
+                bench_mutex_loop(&ctx);
+                elapsed = bench_now() - t0;
+            } else {
+                elapsed = bench_run_threads(t, bench_mutex_loop, &ctx);
+            }
+            fossil_threads_mutex_dispose(&ctx.m);
+            if (elapsed < 0) continue;
+
+            bench_result_t r = { "mutex.lock_unlock", kinds[k].name, t, 0, 0.0, 0, 0, 0, 0, 0 };
+            r.ops = (unsigned long long)(ctx.iters * t);
+            r.ns_per_op = (double)elapsed / (double)r.ops;
+            bench_report(&r);
+        }
+    }
+}
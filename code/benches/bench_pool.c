@@ -0,0 +1,255 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdlib.h>
+
+/* ---------- Pool ---------- */
+
+static const struct { int sched; const char *name; } bench_scheds[] = {
+    { FOSSIL_THREADS_POOL_SCHED_SHARED,        "shared" },
+    { FOSSIL_THREADS_POOL_SCHED_WORK_STEALING, "work_stealing" },
+    { FOSSIL_THREADS_POOL_SCHED_BOUNDED,       "bounded" }
+};
+
+#define BENCH_SCHED_COUNT (sizeof(bench_scheds) / sizeof(bench_scheds[0]))
+
+static fossil_threads_pool_t *bench_pool_create(int sched, size_t workers) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = workers;
+    opts.scheduler = sched;
+    return fossil_threads_pool_create_ex(&opts);
+}
+
+static void *bench_pool_nop(void *arg) {
+    return arg;
+}
+
+/* Submit-to-start stamp pair for one task */
+typedef struct {
+    long long submitted;
+    volatile long long started;
+} bench_pool_stamp_t;
+
+static void *bench_pool_stamp(void *arg) {
+    ((bench_pool_stamp_t *)arg)->started = bench_now();
+    return NULL;
+}
+
+/* Many independent tasks from one producer, then a single wait. */
+static void bench_pool_throughput(const bench_config_t *cfg, size_t s, size_t workers) {
+    size_t n = bench_iters(cfg, 500000);
+    fossil_threads_pool_t *pool = bench_pool_create(bench_scheds[s].sched, workers);
+    if (!pool) return;
+
+    long long t0 = bench_now();
+    size_t submitted = 0;
+    for (; submitted < n; ++submitted) {
+        if (fossil_threads_pool_submit(pool, bench_pool_nop, NULL) != FOSSIL_THREADS_OK) break;
+    }
+    fossil_threads_pool_wait(pool);
+    long long elapsed = bench_now() - t0;
+    fossil_threads_pool_destroy(pool);
+    if (submitted == 0) return;
+
+    bench_result_t r = { "pool.submit_throughput", bench_scheds[s].name, workers, 0, 0.0, 0, 0, 0, 0, 0 };
+    r.ops = (unsigned long long)submitted;
+    r.ns_per_op = (double)elapsed / (double)submitted;
+    bench_report(&r);
+}
+
+/* One task at a time into an idle pool: time from submit until it starts. */
+static void bench_pool_latency(const bench_config_t *cfg, size_t s, size_t workers) {
+    size_t n = bench_iters(cfg, 20000);
+    long long *samples = (long long *)malloc(n * sizeof(*samples));
+    fossil_threads_pool_t *pool = bench_pool_create(bench_scheds[s].sched, workers);
+    if (!samples || !pool) {
+        free(samples);
+        if (pool) fossil_threads_pool_destroy(pool);
+        return;
+    }
+
+    long long total = 0;
+    size_t done = 0;
+    for (; done < n; ++done) {
+        bench_pool_stamp_t stamp;
+        stamp.started = 0;
+        stamp.submitted = bench_now();
+        if (fossil_threads_pool_submit(pool, bench_pool_stamp, &stamp) != FOSSIL_THREADS_OK) break;
+        fossil_threads_pool_wait(pool);
+        samples[done] = stamp.started - stamp.submitted;
+        total += samples[done];
+    }
+    fossil_threads_pool_destroy(pool);
+
+    if (done > 0) {
+        bench_result_t r = { "pool.task_latency", bench_scheds[s].name, workers, 0, 0.0, 0, 0, 0, 0, 0 };
+        r.ops = (unsigned long long)done;
+        r.ns_per_op = (double)total / (double)done;
+        bench_latency(&r, samples, done);
+        bench_report(&r);
+    }
+    free(samples);
+}
+
+/* One batch of a task per worker, then fossil_threads_pool_wait: the cost
+ * of a fork/join step with no work in it. */
+static void bench_pool_fork_join(const bench_config_t *cfg, size_t s, size_t workers) {
+    size_t rounds = bench_iters(cfg, 20000);
+    long long *samples = (long long *)malloc(rounds * sizeof(*samples));
+    fossil_threads_thread_func *funcs =
+        (fossil_threads_thread_func *)malloc(workers * sizeof(*funcs));
+    fossil_threads_pool_t *pool = bench_pool_create(bench_scheds[s].sched, workers);
+    if (!samples || !funcs || !pool) {
+        free(samples);
+        free(funcs);
+        if (pool) fossil_threads_pool_destroy(pool);
+        return;
+    }
+    for (size_t i = 0; i < workers; ++i) funcs[i] = bench_pool_nop;
+
+    long long total = 0;
+    size_t done = 0;
+    for (; done < rounds; ++done) {
+        long long t0 = bench_now();
+        if (fossil_threads_pool_submit_batch(pool, funcs, NULL, workers) != FOSSIL_THREADS_OK) break;
+        fossil_threads_pool_wait(pool);
+        samples[done] = bench_now() - t0;
+        total += samples[done];
+    }
+    fossil_threads_pool_destroy(pool);
+
+    if (done > 0) {
+        bench_result_t r = { "pool.fork_join", bench_scheds[s].name, workers, 0, 0.0, 0, 0, 0, 0, 0 };
+        r.ops = (unsigned long long)done;
+        r.ns_per_op = (double)total / (double)done;
+        bench_latency(&r, samples, done);
+        bench_report(&r);
+    }
+    free(samples);
+    free(funcs);
+}
+
+/* Tasks that each take a few short-lived scratch buffers, from malloc or
+ * from the worker's task arena. */
+#define BENCH_SCRATCH_BUFFERS 4
+
+static void *bench_pool_scratch(void *arg) {
+    int arena = arg != NULL;
+    void *bufs[BENCH_SCRATCH_BUFFERS];
+    for (size_t i = 0; i < BENCH_SCRATCH_BUFFERS; ++i) {
+        size_t size = (size_t)64 << i;
+        bufs[i] = arena ? fossil_threads_pool_task_alloc(size) : malloc(size);
+        if (bufs[i]) ((volatile unsigned char *)bufs[i])[size - 1] = (unsigned char)i;
+    }
+    if (!arena)
+        for (size_t i = 0; i < BENCH_SCRATCH_BUFFERS; ++i) free(bufs[i]);
+    return NULL;
+}
+
+static void bench_pool_scratch_run(const bench_config_t *cfg, size_t workers) {
+    static const char *const variants[] = { "malloc", "arena" };
+    static int arena_tag;
+    for (size_t v = 0; v < 2; ++v) {
+        size_t n = bench_iters(cfg, 500000);
+        fossil_threads_pool_t *pool = bench_pool_create(FOSSIL_THREADS_POOL_SCHED_WORK_STEALING, workers);
+        if (!pool) return;
+
+        long long t0 = bench_now();
+        size_t submitted = 0;
+        for (; submitted < n; ++submitted) {
+            if (fossil_threads_pool_submit(pool, bench_pool_scratch, v ? &arena_tag : NULL) != FOSSIL_THREADS_OK)
+                break;
+        }
+        fossil_threads_pool_wait(pool);
+        long long elapsed = bench_now() - t0;
+        fossil_threads_pool_destroy(pool);
+        if (submitted == 0) return;
+
+        bench_result_t r = { "pool.task_scratch", variants[v], workers, 0, 0.0, 0, 0, 0, 0, 0 };
+        r.ops = (unsigned long long)submitted;
+        r.ns_per_op = (double)elapsed / (double)submitted;
+        bench_report(&r);
+    }
+}
+
+/* Submit-to-start latency into an idle pool, parking at once versus
+ * polling for a while first (opts.idle_spin_us). */
+static void bench_pool_idle_wakeup(const bench_config_t *cfg, size_t workers) {
+    static const char *const variants[] = { "park", "spin" };
+    for (size_t v = 0; v < 2; ++v) {
+        size_t n = bench_iters(cfg, 20000);
+        long long *samples = (long long *)malloc(n * sizeof(*samples));
+        fossil_threads_pool_options_t opts;
+        fossil_threads_pool_options_init(&opts);
+        opts.num_threads = workers;
+        opts.idle_spin_us = v ? 200u : 0u;
+        fossil_threads_pool_t *pool = samples ? fossil_threads_pool_create_ex(&opts) : NULL;
+        if (!pool) {
+            free(samples);
+            return;
+        }
+
+        long long total = 0;
+        size_t done = 0;
+        for (; done < n; ++done) {
+            bench_pool_stamp_t stamp;
+            stamp.started = 0;
+            stamp.submitted = bench_now();
+            if (fossil_threads_pool_submit(pool, bench_pool_stamp, &stamp) != FOSSIL_THREADS_OK) break;
+            fossil_threads_pool_wait(pool);
+            samples[done] = stamp.started - stamp.submitted;
+            total += samples[done];
+        }
+        fossil_threads_pool_destroy(pool);
+
+        if (done > 0) {
+            bench_result_t r = { "pool.idle_wakeup", variants[v], workers, 0, 0.0, 0, 0, 0, 0, 0 };
+            r.ops = (unsigned long long)done;
+            r.ns_per_op = (double)total / (double)done;
+            bench_latency(&r, samples, done);
+            bench_report(&r);
+        }
+        free(samples);
+    }
+}
+
+void bench_pool(const bench_config_t *cfg) {
+    for (size_t s = 0; s < BENCH_SCHED_COUNT; ++s) {
+        for (size_t w = 1; w; w = bench_next_threads(w, cfg->max_threads)) {
+            if (bench_selected(cfg, "pool.submit_throughput")) bench_pool_throughput(cfg, s, w);
+            if (bench_selected(cfg, "pool.task_latency")) bench_pool_latency(cfg, s, w);
+            if (bench_selected(cfg, "pool.fork_join")) bench_pool_fork_join(cfg, s, w);
+        }
+    }
+    if (bench_selected(cfg, "pool.task_scratch")) {
+        for (size_t w = 1; w; w = bench_next_threads(w, cfg->max_threads))
+            bench_pool_scratch_run(cfg, w);
+    }
+    if (bench_selected(cfg, "pool.idle_wakeup")) {
+        for (size_t w = 1; w; w = bench_next_threads(w, cfg->max_threads))
+            bench_pool_idle_wakeup(cfg, w);
+    }
+}
@@ -0,0 +1,115 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "bench.h"
+#include <stdlib.h>
+
+/* ---------- Spawn + join ---------- */
+
+static void *bench_thread_nop(void *arg) {
+    return arg;
+}
+
+/* ---------- Batch spawn + join: a create/join loop against one group ---------- */
+
+static void *bench_group_nop(size_t index, void *ctx) {
+    (void)index;
+    return ctx;
+}
+
+static void bench_thread_batch(const bench_config_t *cfg, size_t threads) {
+    fossil_threads_thread_t *ts = (fossil_threads_thread_t *)malloc(threads * sizeof(*ts));
+    if (!ts) return;
+    size_t rounds = bench_iters(cfg, 200);
+
+    for (int group = 0; group <= 1; ++group) {
+        size_t done = 0;
+        long long t0 = bench_now();
+        for (; done < rounds; ++done) {
+            if (group) {
+                fossil_threads_group_t *g = NULL;
+                if (fossil_threads_group_create(&g, threads, NULL, bench_group_nop, NULL) != FOSSIL_THREADS_OK)
+                    break;
+                fossil_threads_group_join(g, NULL);
+                fossil_threads_group_destroy(g);
+                continue;
+            }
+            size_t started = 0;
+            for (; started < threads; ++started) {
+                fossil_threads_thread_init(&ts[started]);
+                if (fossil_threads_thread_create(&ts[started], bench_thread_nop, NULL) != FOSSIL_THREADS_OK)
+                    break;
+            }
+            for (size_t i = 0; i < started; ++i) {
+                fossil_threads_thread_join(&ts[i], NULL);
+                fossil_threads_thread_dispose(&ts[i]);
+            }
+            if (started < threads) break;
+        }
+        long long dt = bench_now() - t0;
+        if (done > 0) {
+            bench_result_t r = { "thread.batch_spawn_join", group ? "group" : "loop",
+                                 threads, 0, 0.0, 0, 0, 0, 0, 0 };
+            r.ops = (unsigned long long)(done * threads);
+            r.ns_per_op = (double)dt / (double)r.ops;
+            bench_report(&r);
+        }
+    }
+    free(ts);
+}
+
+void bench_thread(const bench_config_t *cfg) {
+    if (bench_selected(cfg, "thread.batch_spawn_join")) {
+        for (size_t t = 1; t; t = bench_next_threads(t, cfg->max_threads))
+            bench_thread_batch(cfg, t);
+    }
+    if (!bench_selected(cfg, "thread.create_join")) return;
+
+    size_t n = bench_iters(cfg, 5000);
+    long long *samples = (long long *)malloc(n * sizeof(*samples));
+    if (!samples) return;
+
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    long long total = 0;
+    size_t done = 0;
+    for (; done < n; ++done) {
+        long long t0 = bench_now();
+        if (fossil_threads_thread_create(&t, bench_thread_nop, NULL) != FOSSIL_THREADS_OK) break;
+        fossil_threads_thread_join(&t, NULL);
+        long long dt = bench_now() - t0;
+        fossil_threads_thread_dispose(&t);
+        samples[done] = dt;
+        total += dt;
+    }
+
+    if (done > 0) {
+        bench_result_t r = { "thread.create_join", NULL, 1, 0, 0.0, 0, 0, 0, 0, 0 };
+        r.ops = (unsigned long long)done;
+        r.ns_per_op = (double)total / (double)done;
+        bench_latency(&r, samples, done);
+        bench_report(&r);
+    }
+    free(samples);
+}
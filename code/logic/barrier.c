@@ -0,0 +1,158 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/barrier.h"
+#include "fossil/threads/thread.h"
+#include <stddef.h>
+
+#include "internal.h"
+
+// *****************************************************************************
+// Internal helpers
+// *****************************************************************************
+
+/*
+** Both primitives park on the word that changes when they open: the barrier
+** on its phase counter, the latch on its count. A waiter bumps waiters with
+** a full fence before re-checking the word, and the releaser changes the word
+** before checking waiters, so either the waiter sees the change or the
+** releaser sees the waiter and wakes it.
+*/
+
+/* Spinning only pays off if the thread that will release us can run meanwhile. */
+static unsigned int fossil__sync_spin(unsigned int spin) {
+    return fossil_threads_cpu_count() > 1 ? spin : 0u;
+}
+
+/* deadline_ns is absolute, or NULL to wait for as long as it takes. */
+static int fossil__sync_park(volatile unsigned int *word, unsigned int value,
+                             volatile unsigned int *waiters, const long long *deadline_ns) {
+    int rc = 0;
+    fossil__atomic_add_u32(waiters, 1u);
+    fossil__atomic_fence();
+    while (fossil__atomic_load_u32(word) == value) {
+        long long wait_ns = FOSSIL__FUTEX_INFINITE;
+        if (deadline_ns) {
+            wait_ns = *deadline_ns - fossil__monotonic_ns();
+            if (wait_ns <= 0) { rc = FOSSIL__FUTEX_TIMEDOUT; break; }
+        }
+        fossil__futex_wait(word, value, wait_ns);
+    }
+    fossil__atomic_add_u32(waiters, (unsigned int)-1);
+    return rc;
+}
+
+// *****************************************************************************
+// Barrier
+// *****************************************************************************
+
+int fossil_threads_barrier_init(fossil_threads_barrier_t *b, unsigned int count, unsigned int spin) {
+    if (!b || count == 0) return FOSSIL_THREADS_BARRIER_EINVAL;
+    b->count = count;
+    b->spin = fossil__sync_spin(spin);
+    b->arrived = 0u;
+    b->phase = 0u;
+    b->waiters = 0u;
+    return FOSSIL_THREADS_BARRIER_OK;
+}
+
+void fossil_threads_barrier_dispose(fossil_threads_barrier_t *b) {
+    if (!b) return;
+    b->count = 0u;
+}
+
+int fossil_threads_barrier_wait(fossil_threads_barrier_t *b) {
+    if (!b || b->count == 0) return FOSSIL_THREADS_BARRIER_EINVAL;
+
+    /* Sampled before arriving: the phase cannot move until we have. */
+    unsigned int phase = fossil__atomic_load_u32(&b->phase);
+    if (fossil__atomic_add_u32(&b->arrived, 1u) + 1u == b->count) {
+        /* Reset before the bump, so next-phase arrivals count from zero. */
+        fossil__atomic_store_u32(&b->arrived, 0u);
+        fossil__atomic_store_u32(&b->phase, phase + 1u);
+        if (fossil__atomic_load_sc_u32(&b->waiters) != 0u)
+            fossil__futex_wake_all(&b->phase);
+        return FOSSIL_THREADS_BARRIER_SERIAL;
+    }
+
+    if (!fossil__spin_while_eq(&b->phase, phase, b->spin))
+        fossil__sync_park(&b->phase, phase, &b->waiters, NULL);
+    /* The spin reads relaxed; pair with the releasing store of the phase. */
+    (void)fossil__atomic_load_u32(&b->phase);
+    return FOSSIL_THREADS_BARRIER_OK;
+}
+
+// *****************************************************************************
+// Latch
+// *****************************************************************************
+
+int fossil_threads_latch_init(fossil_threads_latch_t *l, unsigned int count, unsigned int spin) {
+    if (!l) return FOSSIL_THREADS_BARRIER_EINVAL;
+    l->count = count;
+    l->waiters = 0u;
+    l->spin = fossil__sync_spin(spin);
+    return FOSSIL_THREADS_BARRIER_OK;
+}
+
+int fossil_threads_latch_count_down(fossil_threads_latch_t *l, unsigned int n) {
+    if (!l) return FOSSIL_THREADS_BARRIER_EINVAL;
+    unsigned int c = fossil__atomic_load_u32(&l->count);
+    do {
+        if (n > c) return FOSSIL_THREADS_BARRIER_EINVAL;
+    } while (!fossil__atomic_cas_u32(&l->count, &c, c - n));
+
+    if (c == n && n != 0 && fossil__atomic_load_sc_u32(&l->waiters) != 0u)
+        fossil__futex_wake_all(&l->count);
+    return FOSSIL_THREADS_BARRIER_OK;
+}
+
+bool fossil_threads_latch_try_wait(const fossil_threads_latch_t *l) {
+    return l && fossil__atomic_load_u32(&l->count) == 0u;
+}
+
+static int fossil__latch_wait(fossil_threads_latch_t *l, const long long *deadline_ns) {
+    unsigned int c;
+    while ((c = fossil__atomic_load_u32(&l->count)) != 0u) {
+        if (fossil__spin_while_eq(&l->count, c, l->spin)) continue;
+        if (fossil__sync_park(&l->count, c, &l->waiters, deadline_ns) == FOSSIL__FUTEX_TIMEDOUT)
+            return FOSSIL_THREADS_BARRIER_ETIMEDOUT;
+    }
+    return FOSSIL_THREADS_BARRIER_OK;
+}
+
+void fossil_threads_latch_wait(fossil_threads_latch_t *l) {
+    if (l) fossil__latch_wait(l, NULL);
+}
+
+int fossil_threads_latch_wait_until(fossil_threads_latch_t *l, long long deadline_ns) {
+    if (!l) return FOSSIL_THREADS_BARRIER_EINVAL;
+    return fossil__latch_wait(l, &deadline_ns);
+}
+
+int fossil_threads_latch_arrive_and_wait(fossil_threads_latch_t *l, unsigned int n) {
+    int rc = fossil_threads_latch_count_down(l, n);
+    if (rc != FOSSIL_THREADS_BARRIER_OK) return rc;
+    fossil_threads_latch_wait(l);
+    return FOSSIL_THREADS_BARRIER_OK;
+}
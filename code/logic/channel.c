@@ -0,0 +1,590 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/channel.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal.h"
+
+// *****************************************************************************
+// Layout
+// *****************************************************************************
+
+/*
+** The consumer index and the producer index sit on their own cache lines,
+** each next to the copy of the other side's index that side last saw, so
+** an SPSC stream only touches the opposite line when its cached view says
+** the ring is full or empty. The two event counts get a line each as well:
+** a side that parks bumps its waiter count and must not knock the other
+** side's index out of its cache.
+**
+** SPSC cells are bare elements. MPMC cells follow Vyukov's bounded queue:
+** every cell carries a sequence number that says whether it is ready for
+** the producer or the consumer of a given lap, so producers and consumers
+** claim positions with one CAS each and never wait on one another's copy.
+*/
+
+#define FOSSIL__CHANNEL_STAGE_BATCH 64u
+
+/* Retries before a blocking send or receive parks (multi-CPU only). */
+#define FOSSIL__CHANNEL_SPIN 128u
+
+/* Stage state bits */
+#define FOSSIL__STAGE_SCHEDULED 1u  /* a drain task is queued or running */
+#define FOSSIL__STAGE_PENDING   2u  /* elements arrived while it was running */
+#define FOSSIL__STAGE_WAITER    4u  /* detach is parked on the state word */
+#define FOSSIL__STAGE_DETACHED  8u  /* senders must not schedule it any more */
+
+struct fossil_threads_channel {
+    /* Consumer line */
+    volatile size_t head;
+    size_t tail_seen;              /* SPSC consumer's last view of tail */
+    char pad0[FOSSIL__CACHE_LINE - 2 * sizeof(size_t)];
+
+    /* Producer line */
+    volatile size_t tail;
+    size_t head_seen;              /* SPSC producer's last view of head */
+    char pad1[FOSSIL__CACHE_LINE - 2 * sizeof(size_t)];
+
+    /* Consumers wait here for elements */
+    volatile unsigned int recv_seq;
+    volatile unsigned int recv_waiters;
+    char pad2[FOSSIL__CACHE_LINE - 2 * sizeof(unsigned int)];
+
+    /* Producers wait here for space */
+    volatile unsigned int send_seq;
+    volatile unsigned int send_waiters;
+    char pad3[FOSSIL__CACHE_LINE - 2 * sizeof(unsigned int)];
+
+    /* Read-mostly */
+    int kind;
+    unsigned int spin;
+    volatile unsigned int closed;
+    size_t mask;
+    size_t elem_size;
+    size_t stride;
+    unsigned char *cells;
+
+    /* Stage */
+    volatile unsigned int stage_on;    /* 1 while a stage is attached */
+    volatile unsigned int stage_state;
+    fossil_threads_channel_func stage_func;
+    void *stage_ctx;
+    fossil_threads_pool_t *stage_pool;
+    size_t stage_batch;
+    unsigned char *stage_buf;      /* drain task's element copy */
+};
+
+static volatile size_t *fossil__channel_cell_seq(fossil_threads_channel_t *ch, size_t pos) {
+    return (volatile size_t *)(void *)(ch->cells + (pos & ch->mask) * ch->stride);
+}
+
+static unsigned char *fossil__channel_cell_data(fossil_threads_channel_t *ch, size_t pos) {
+    unsigned char *cell = ch->cells + (pos & ch->mask) * ch->stride;
+    return ch->kind == FOSSIL_THREADS_CHANNEL_MPMC ? cell + sizeof(size_t) : cell;
+}
+
+// *****************************************************************************
+// Ring operations (no waking)
+// *****************************************************************************
+
+static size_t fossil__spsc_push(fossil_threads_channel_t *ch, const unsigned char *elems, size_t n) {
+    size_t cap = ch->mask + 1;
+    size_t t = fossil__atomic_load_relaxed_size(&ch->tail);
+    size_t room = cap - (t - ch->head_seen);
+    if (room < n) {
+        ch->head_seen = fossil__atomic_load_size(&ch->head);
+        room = cap - (t - ch->head_seen);
+    }
+    if (n > room) n = room;
+    for (size_t i = 0; i < n; ++i)
+        memcpy(fossil__channel_cell_data(ch, t + i), elems + i * ch->elem_size, ch->elem_size);
+    if (n) fossil__atomic_store_size(&ch->tail, t + n);
+    return n;
+}
+
+static size_t fossil__spsc_pop(fossil_threads_channel_t *ch, unsigned char *out, size_t max) {
+    size_t h = fossil__atomic_load_relaxed_size(&ch->head);
+    size_t avail = ch->tail_seen - h;
+    if (avail < max) {
+        ch->tail_seen = fossil__atomic_load_size(&ch->tail);
+        avail = ch->tail_seen - h;
+    }
+    if (max > avail) max = avail;
+    for (size_t i = 0; i < max; ++i)
+        memcpy(out + i * ch->elem_size, fossil__channel_cell_data(ch, h + i), ch->elem_size);
+    if (max) fossil__atomic_store_size(&ch->head, h + max);
+    return max;
+}
+
+static int fossil__mpmc_push(fossil_threads_channel_t *ch, const unsigned char *elem) {
+    size_t pos = fossil__atomic_load_relaxed_size(&ch->tail);
+    for (;;) {
+        size_t seq = fossil__atomic_load_size(fossil__channel_cell_seq(ch, pos));
+        intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+        if (dif == 0) {
+            if (fossil__atomic_cas_size(&ch->tail, &pos, pos + 1)) break;
+        } else if (dif < 0) {
+            return 0; /* the cell still holds last lap's element: full */
+        } else {
+            pos = fossil__atomic_load_relaxed_size(&ch->tail);
+        }
+    }
+    memcpy(fossil__channel_cell_data(ch, pos), elem, ch->elem_size);
+    fossil__atomic_store_size(fossil__channel_cell_seq(ch, pos), pos + 1);
+    return 1;
+}
+
+static int fossil__mpmc_pop(fossil_threads_channel_t *ch, unsigned char *out) {
+    size_t pos = fossil__atomic_load_relaxed_size(&ch->head);
+    for (;;) {
+        size_t seq = fossil__atomic_load_size(fossil__channel_cell_seq(ch, pos));
+        intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+        if (dif == 0) {
+            if (fossil__atomic_cas_size(&ch->head, &pos, pos + 1)) break;
+        } else if (dif < 0) {
+            return 0; /* not written yet: empty */
+        } else {
+            pos = fossil__atomic_load_relaxed_size(&ch->head);
+        }
+    }
+    memcpy(out, fossil__channel_cell_data(ch, pos), ch->elem_size);
+    fossil__atomic_store_size(fossil__channel_cell_seq(ch, pos), pos + ch->mask + 1);
+    return 1;
+}
+
+static size_t fossil__channel_push(fossil_threads_channel_t *ch, const void *elems, size_t n) {
+    const unsigned char *src = (const unsigned char *)elems;
+    if (ch->kind == FOSSIL_THREADS_CHANNEL_SPSC) return fossil__spsc_push(ch, src, n);
+    size_t done = 0;
+    while (done < n && fossil__mpmc_push(ch, src + done * ch->elem_size)) ++done;
+    return done;
+}
+
+static size_t fossil__channel_pop(fossil_threads_channel_t *ch, void *out, size_t max) {
+    unsigned char *dst = (unsigned char *)out;
+    if (ch->kind == FOSSIL_THREADS_CHANNEL_SPSC) return fossil__spsc_pop(ch, dst, max);
+    size_t done = 0;
+    while (done < max && fossil__mpmc_pop(ch, dst + done * ch->elem_size)) ++done;
+    return done;
+}
+
+// *****************************************************************************
+// Stage scheduling
+// *****************************************************************************
+
+/*
+** stage_state is the stage's only synchronization. A sender that finds the
+** stage idle sets SCHEDULED and submits a drain task; one that finds it
+** scheduled sets PENDING instead. The drain task clears PENDING before each
+** pass and gives the stage up with a CAS that fails if PENDING came back,
+** so an element is never left behind, and that CAS is its last access to
+** the channel: detach may free it as soon as SCHEDULED is seen clear.
+*/
+
+static void *fossil__channel_drain(void *arg);
+
+/*
+ * Clears SCHEDULED and PENDING, keeping DETACHED. Fails if the state is no
+ * longer expected, or if it shows PENDING and force is 0: the caller then
+ * has more to drain.
+ */
+static int fossil__stage_release(fossil_threads_channel_t *ch, unsigned int expected, int force) {
+    if (!force && !(expected & FOSSIL__STAGE_DETACHED) && (expected & FOSSIL__STAGE_PENDING)) return 0;
+    if (!fossil__atomic_cas_u32(&ch->stage_state, &expected, expected & FOSSIL__STAGE_DETACHED)) return 0;
+    if (expected & FOSSIL__STAGE_WAITER) fossil__futex_wake_all(&ch->stage_state);
+    return 1;
+}
+
+static void fossil__stage_kick(fossil_threads_channel_t *ch) {
+    unsigned int s = fossil__atomic_load_u32(&ch->stage_state);
+    for (;;) {
+        if (s & (FOSSIL__STAGE_DETACHED | FOSSIL__STAGE_PENDING)) return;
+        if (s & FOSSIL__STAGE_SCHEDULED) {
+            if (fossil__atomic_cas_u32(&ch->stage_state, &s, s | FOSSIL__STAGE_PENDING)) return;
+            continue;
+        }
+        if (fossil__atomic_cas_u32(&ch->stage_state, &s, FOSSIL__STAGE_SCHEDULED)) break;
+    }
+    if (fossil_threads_pool_submit(ch->stage_pool, fossil__channel_drain, ch) != FOSSIL_THREADS_OK) {
+        /* Pool is shutting down: leave the elements queued. */
+        do {
+            s = fossil__atomic_load_u32(&ch->stage_state);
+        } while (!fossil__stage_release(ch, s, 1));
+    }
+}
+
+static void *fossil__channel_drain(void *arg) {
+    fossil_threads_channel_t *ch = (fossil_threads_channel_t *)arg;
+    for (;;) {
+        unsigned int s = fossil__atomic_load_u32(&ch->stage_state);
+        while ((s & FOSSIL__STAGE_PENDING) &&
+               !fossil__atomic_cas_u32(&ch->stage_state, &s, s & ~FOSSIL__STAGE_PENDING)) {
+        }
+
+        size_t n = 0;
+        if (!(s & FOSSIL__STAGE_DETACHED)) {
+            while (n < ch->stage_batch && fossil__channel_pop(ch, ch->stage_buf, 1)) {
+                fossil__event_notify(&ch->send_seq, &ch->send_waiters, 0);
+                ch->stage_func(ch->stage_buf, ch->stage_ctx);
+                ++n;
+            }
+        }
+        /* A full batch may mean more is queued: yield the worker, stay scheduled. */
+        if (n == ch->stage_batch &&
+            fossil_threads_pool_submit(ch->stage_pool, fossil__channel_drain, ch) == FOSSIL_THREADS_OK)
+            return NULL;
+
+        s = fossil__atomic_load_u32(&ch->stage_state);
+        if (fossil__stage_release(ch, s, 0)) return NULL;
+    }
+}
+
+// *****************************************************************************
+// Function implementations
+// *****************************************************************************
+
+int fossil_threads_channel_create(fossil_threads_channel_t **out, int kind,
+                                  size_t capacity, size_t elem_size) {
+    if (!out) return FOSSIL_THREADS_CHANNEL_EINVAL;
+    *out = NULL;
+    if (kind != FOSSIL_THREADS_CHANNEL_SPSC && kind != FOSSIL_THREADS_CHANNEL_MPMC)
+        return FOSSIL_THREADS_CHANNEL_EINVAL;
+    if (capacity == 0 || elem_size == 0 || capacity > ((size_t)-1 >> 2))
+        return FOSSIL_THREADS_CHANNEL_EINVAL;
+
+    /* A Vyukov ring needs two cells to tell "full" from "ready" apart. */
+    size_t cap = kind == FOSSIL_THREADS_CHANNEL_MPMC ? 2 : 1;
+    while (cap < capacity) cap <<= 1;
+    size_t stride = elem_size;
+    if (kind == FOSSIL_THREADS_CHANNEL_MPMC) {
+        /* Keep each cell's sequence number aligned. */
+        stride = sizeof(size_t) + (elem_size + sizeof(size_t) - 1) / sizeof(size_t) * sizeof(size_t);
+    }
+    if (stride > ((size_t)-1) / cap) return FOSSIL_THREADS_CHANNEL_EINVAL;
+
+    fossil_threads_channel_t *ch =
+        (fossil_threads_channel_t *)fossil__aligned_alloc(FOSSIL__CACHE_LINE, sizeof(*ch));
+    if (!ch) return FOSSIL_THREADS_CHANNEL_ENOMEM;
+    memset(ch, 0, sizeof(*ch));
+    ch->cells = (unsigned char *)fossil__aligned_alloc(FOSSIL__CACHE_LINE, cap * stride);
+    if (!ch->cells) {
+        fossil__aligned_free(ch);
+        return FOSSIL_THREADS_CHANNEL_ENOMEM;
+    }
+    ch->kind = kind;
+    /* Spinning only pays off if the other side can run meanwhile. */
+    ch->spin = fossil_threads_cpu_count() > 1 ? FOSSIL__CHANNEL_SPIN : 0u;
+    ch->mask = cap - 1;
+    ch->elem_size = elem_size;
+    ch->stride = stride;
+    if (kind == FOSSIL_THREADS_CHANNEL_MPMC) {
+        for (size_t i = 0; i < cap; ++i)
+            *fossil__channel_cell_seq(ch, i) = i;
+    }
+    *out = ch;
+    return FOSSIL_THREADS_CHANNEL_OK;
+}
+
+void fossil_threads_channel_destroy(fossil_threads_channel_t *ch) {
+    if (!ch) return;
+    free(ch->stage_buf);
+    fossil__aligned_free(ch->cells);
+    fossil__aligned_free(ch);
+}
+
+/* Wakes consumers (and schedules the stage) after n elements went in. */
+static void fossil__channel_sent(fossil_threads_channel_t *ch, size_t n) {
+    fossil__event_notify(&ch->recv_seq, &ch->recv_waiters, n > 1);
+    if (fossil__atomic_load_u32(&ch->stage_on)) fossil__stage_kick(ch);
+}
+
+int fossil_threads_channel_try_send(fossil_threads_channel_t *ch, const void *elem) {
+    if (!ch || !elem) return FOSSIL_THREADS_CHANNEL_EINVAL;
+    if (fossil__atomic_load_u32(&ch->closed)) return FOSSIL_THREADS_CHANNEL_ECLOSED;
+    if (!fossil__channel_push(ch, elem, 1)) return FOSSIL_THREADS_CHANNEL_EAGAIN;
+    fossil__channel_sent(ch, 1);
+    return FOSSIL_THREADS_CHANNEL_OK;
+}
+
+int fossil_threads_channel_send(fossil_threads_channel_t *ch, const void *elem) {
+    for (;;) {
+        int rc = fossil_threads_channel_try_send(ch, elem);
+        for (unsigned int i = 0; rc == FOSSIL_THREADS_CHANNEL_EAGAIN && i < ch->spin; ++i) {
+            fossil__cpu_relax();
+            rc = fossil_threads_channel_try_send(ch, elem);
+        }
+        if (rc != FOSSIL_THREADS_CHANNEL_EAGAIN) return rc;
+
+        unsigned int key = fossil__event_prepare(&ch->send_seq, &ch->send_waiters);
+        rc = fossil_threads_channel_try_send(ch, elem);
+        if (rc == FOSSIL_THREADS_CHANNEL_EAGAIN)
+            fossil__futex_wait(&ch->send_seq, key, FOSSIL__FUTEX_INFINITE);
+        fossil__event_cancel(&ch->send_waiters);
+        if (rc != FOSSIL_THREADS_CHANNEL_EAGAIN) return rc;
+    }
+}
+
+size_t fossil_threads_channel_send_batch(fossil_threads_channel_t *ch, const void *elems, size_t n) {
+    if (!ch || !elems || n == 0) return 0;
+    if (fossil__atomic_load_u32(&ch->closed)) return 0;
+    size_t done = fossil__channel_push(ch, elems, n);
+    if (done) fossil__channel_sent(ch, done);
+    return done;
+}
+
+int fossil_threads_channel_try_recv(fossil_threads_channel_t *ch, void *out) {
+    if (!ch || !out) return FOSSIL_THREADS_CHANNEL_EINVAL;
+    if (!fossil__channel_pop(ch, out, 1)) {
+        if (!fossil__atomic_load_u32(&ch->closed)) return FOSSIL_THREADS_CHANNEL_EAGAIN;
+        /* Closed: one more look for elements sent before close. */
+        if (!fossil__channel_pop(ch, out, 1)) return FOSSIL_THREADS_CHANNEL_ECLOSED;
+    }
+    fossil__event_notify(&ch->send_seq, &ch->send_waiters, 0);
+    return FOSSIL_THREADS_CHANNEL_OK;
+}
+
+static int fossil__channel_recv(fossil_threads_channel_t *ch, void *out, const long long *deadline_ns) {
+    for (;;) {
+        int rc = fossil_threads_channel_try_recv(ch, out);
+        for (unsigned int i = 0; rc == FOSSIL_THREADS_CHANNEL_EAGAIN && i < ch->spin; ++i) {
+            fossil__cpu_relax();
+            rc = fossil_threads_channel_try_recv(ch, out);
+        }
+        if (rc != FOSSIL_THREADS_CHANNEL_EAGAIN) return rc;
+
+        unsigned int key = fossil__event_prepare(&ch->recv_seq, &ch->recv_waiters);
+        rc = fossil_threads_channel_try_recv(ch, out);
+        if (rc == FOSSIL_THREADS_CHANNEL_EAGAIN) {
+            long long wait_ns = FOSSIL__FUTEX_INFINITE;
+            if (deadline_ns) {
+                wait_ns = *deadline_ns - fossil__monotonic_ns();
+                if (wait_ns <= 0) rc = FOSSIL_THREADS_CHANNEL_ETIMEDOUT;
+            }
+            if (rc == FOSSIL_THREADS_CHANNEL_EAGAIN)
+                fossil__futex_wait(&ch->recv_seq, key, wait_ns);
+        }
+        fossil__event_cancel(&ch->recv_waiters);
+        if (rc != FOSSIL_THREADS_CHANNEL_EAGAIN) return rc;
+    }
+}
+
+int fossil_threads_channel_recv(fossil_threads_channel_t *ch, void *out) {
+    return fossil__channel_recv(ch, out, NULL);
+}
+
+int fossil_threads_channel_recv_until(fossil_threads_channel_t *ch, void *out, long long deadline_ns) {
+    return fossil__channel_recv(ch, out, &deadline_ns);
+}
+
+size_t fossil_threads_channel_recv_batch(fossil_threads_channel_t *ch, void *out, size_t max) {
+    if (!ch || !out || max == 0) return 0;
+    size_t done = fossil__channel_pop(ch, out, max);
+    if (done) fossil__event_notify(&ch->send_seq, &ch->send_waiters, done > 1);
+    return done;
+}
+
+void fossil_threads_channel_close(fossil_threads_channel_t *ch) {
+    if (!ch) return;
+    fossil__atomic_store_u32(&ch->closed, 1u);
+    /* Unconditional: a parked thread must see the close. */
+    fossil__atomic_add_u32(&ch->recv_seq, 1u);
+    fossil__futex_wake_all(&ch->recv_seq);
+    fossil__atomic_add_u32(&ch->send_seq, 1u);
+    fossil__futex_wake_all(&ch->send_seq);
+}
+
+bool fossil_threads_channel_is_closed(const fossil_threads_channel_t *ch) {
+    return ch && fossil__atomic_load_u32(&ch->closed) != 0u;
+}
+
+size_t fossil_threads_channel_size(const fossil_threads_channel_t *ch) {
+    if (!ch) return 0;
+    size_t h = fossil__atomic_load_size(&ch->head);
+    size_t t = fossil__atomic_load_size(&ch->tail);
+    size_t n = t - h;
+    /* head may be read before a burst of pops and tail after: clamp */
+    return n > ch->mask + 1 ? 0 : n;
+}
+
+size_t fossil_threads_channel_capacity(const fossil_threads_channel_t *ch) {
+    return ch ? ch->mask + 1 : 0;
+}
+
+int fossil_threads_channel_attach(fossil_threads_channel_t *ch, fossil_threads_pool_t *pool,
+                                  fossil_threads_channel_func func, void *ctx, size_t batch) {
+    if (!ch || !pool || !func) return FOSSIL_THREADS_CHANNEL_EINVAL;
+    if (fossil__atomic_load_u32(&ch->stage_on)) return FOSSIL_THREADS_CHANNEL_EBUSY;
+    unsigned char *buf = (unsigned char *)malloc(ch->elem_size);
+    if (!buf) return FOSSIL_THREADS_CHANNEL_ENOMEM;
+
+    free(ch->stage_buf);
+    ch->stage_buf = buf;
+    ch->stage_pool = pool;
+    ch->stage_func = func;
+    ch->stage_ctx = ctx;
+    ch->stage_batch = batch ? batch : FOSSIL__CHANNEL_STAGE_BATCH;
+    fossil__atomic_store_u32(&ch->stage_state, 0u);
+    fossil__atomic_store_u32(&ch->stage_on, 1u);
+    /* Anything sent before the stage existed is drained now. */
+    fossil__atomic_fence();
+    if (fossil_threads_channel_size(ch)) fossil__stage_kick(ch);
+    return FOSSIL_THREADS_CHANNEL_OK;
+}
+
+void fossil_threads_channel_detach(fossil_threads_channel_t *ch) {
+    if (!ch || !fossil__atomic_load_u32(&ch->stage_on)) return;
+    unsigned int s = fossil__atomic_load_u32(&ch->stage_state);
+    for (;;) {
+        unsigned int want = s | FOSSIL__STAGE_DETACHED;
+        if (s & FOSSIL__STAGE_SCHEDULED) want |= FOSSIL__STAGE_WAITER;
+        if (fossil__atomic_cas_u32(&ch->stage_state, &s, want)) { s = want; break; }
+    }
+    while (s & FOSSIL__STAGE_SCHEDULED) {
+        fossil__futex_wait(&ch->stage_state, s, FOSSIL__FUTEX_INFINITE);
+        s = fossil__atomic_load_u32(&ch->stage_state);
+    }
+    fossil__atomic_store_u32(&ch->stage_on, 0u);
+    ch->stage_func = NULL;
+    ch->stage_pool = NULL;
+    ch->stage_ctx = NULL;
+}
+
+// *****************************************************************************
+// Intrusive MPSC queue
+// *****************************************************************************
+
+/*
+** Vyukov's intrusive queue: producers exchange back and then link the old
+** back to their node, so a push is wait-free; the consumer walks front. The
+** stub node keeps the list non-empty; it is pushed back in whenever the
+** consumer is about to take the last real node.
+*/
+
+void fossil_threads_mpsc_init(fossil_threads_mpsc_t *q) {
+    if (!q) return;
+    memset(q, 0, sizeof(*q));
+    q->stub.next = NULL;
+    q->back = &q->stub;
+    q->front = &q->stub;
+}
+
+static void fossil__mpsc_link(fossil_threads_mpsc_t *q, fossil_threads_mpsc_node_t *first,
+                              fossil_threads_mpsc_node_t *last) {
+    fossil__atomic_store_ptr((void *volatile *)&last->next, NULL);
+    fossil_threads_mpsc_node_t *prev =
+        (fossil_threads_mpsc_node_t *)fossil__atomic_exchange_ptr((void *volatile *)&q->back, last);
+    fossil__atomic_store_ptr((void *volatile *)&prev->next, first);
+}
+
+void fossil_threads_mpsc_push(fossil_threads_mpsc_t *q, fossil_threads_mpsc_node_t *node) {
+    if (!q || !node) return;
+    fossil__mpsc_link(q, node, node);
+    fossil__event_notify(&q->seq, &q->waiters, 0);
+}
+
+void fossil_threads_mpsc_push_batch(fossil_threads_mpsc_t *q, fossil_threads_mpsc_node_t **nodes, size_t n) {
+    if (!q || !nodes || n == 0) return;
+    /* Chain privately first; only the last link is published. */
+    for (size_t i = 0; i + 1 < n; ++i)
+        fossil__atomic_store_ptr((void *volatile *)&nodes[i]->next, nodes[i + 1]);
+    fossil__mpsc_link(q, nodes[0], nodes[n - 1]);
+    fossil__event_notify(&q->seq, &q->waiters, 0);
+}
+
+static fossil_threads_mpsc_node_t *fossil__mpsc_next(fossil_threads_mpsc_node_t *n) {
+    return (fossil_threads_mpsc_node_t *)fossil__atomic_load_ptr((void *const volatile *)&n->next);
+}
+
+fossil_threads_mpsc_node_t *fossil_threads_mpsc_pop(fossil_threads_mpsc_t *q) {
+    if (!q) return NULL;
+    fossil_threads_mpsc_node_t *front = q->front;
+    fossil_threads_mpsc_node_t *next = fossil__mpsc_next(front);
+    if (front == &q->stub) {
+        if (!next) return NULL;
+        q->front = next;
+        front = next;
+        next = fossil__mpsc_next(next);
+    }
+    if (next) {
+        q->front = next;
+        return front;
+    }
+    if (front != (fossil_threads_mpsc_node_t *)fossil__atomic_load_ptr((void *const volatile *)&q->back)) {
+        /* A producer has exchanged back but not linked yet: wait it out. */
+        for (unsigned int spins = 0; !(next = fossil__mpsc_next(front)); ++spins) {
+            if (spins < 64u) fossil__cpu_relax();
+            else fossil_threads_thread_yield();
+        }
+        q->front = next;
+        return front;
+    }
+    /* front is the last node: put the stub behind it before taking it. */
+    fossil__mpsc_link(q, &q->stub, &q->stub);
+    for (unsigned int spins = 0; !(next = fossil__mpsc_next(front)); ++spins) {
+        if (spins < 64u) fossil__cpu_relax();
+        else fossil_threads_thread_yield();
+    }
+    q->front = next;
+    return front;
+}
+
+fossil_threads_mpsc_node_t *fossil_threads_mpsc_pop_wait(fossil_threads_mpsc_t *q, long long deadline_ns) {
+    if (!q) return NULL;
+    for (;;) {
+        fossil_threads_mpsc_node_t *n = fossil_threads_mpsc_pop(q);
+        if (n) return n;
+
+        unsigned int key = fossil__event_prepare(&q->seq, &q->waiters);
+        n = fossil_threads_mpsc_pop(q);
+        int timed_out = 0;
+        if (!n) {
+            long long wait_ns = FOSSIL__FUTEX_INFINITE;
+            if (deadline_ns >= 0) {
+                wait_ns = deadline_ns - fossil__monotonic_ns();
+                if (wait_ns <= 0) timed_out = 1;
+            }
+            if (!timed_out) fossil__futex_wait(&q->seq, key, wait_ns);
+        }
+        fossil__event_cancel(&q->waiters);
+        if (n || timed_out) return n;
+    }
+}
+
+size_t fossil_threads_mpsc_pop_batch(fossil_threads_mpsc_t *q, fossil_threads_mpsc_node_t **nodes, size_t max) {
+    if (!q || !nodes) return 0;
+    size_t n = 0;
+    while (n < max && (nodes[n] = fossil_threads_mpsc_pop(q)) != NULL) ++n;
+    return n;
+}
+
+bool fossil_threads_mpsc_empty(const fossil_threads_mpsc_t *q) {
+    if (!q) return true;
+    const fossil_threads_mpsc_node_t *front = q->front;
+    if (front != &q->stub) return false;
+    return fossil__atomic_load_ptr((void *const volatile *)&front->next) == NULL &&
+           fossil__atomic_load_ptr((void *const volatile *)&q->back) == (const void *)front;
+}
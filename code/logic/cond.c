@@ -22,64 +22,72 @@
  * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
-#define _POSIX_C_SOURCE 200809L
 #include "fossil/threads/cond.h"
 #include <string.h>
-#include <stdlib.h>
-#include <time.h>
-
-#if defined(_WIN32)
-#  define WIN32_LEAN_AND_MEAN
-#  include <windows.h>
-#else
-#  include <pthread.h>
-#  include <errno.h>
-#  include <time.h>
-#endif
+
+#include "internal.h"
 
 static void fossil__cond_zero(fossil_threads_cond_t *c) {
     if (c) memset(c, 0, sizeof(*c));
 }
 
+/*
+** Waiters register in c->waiters and fence before sampling c->seq, then
+** release the mutex and park on seq. Signalers bump seq first and read the
+** waiter count with an SC load afterwards, so either the waiter sees the new
+** generation and does not sleep, or the signaler sees the waiter and wakes
+** it. With no registered waiters a signal is two atomics and no syscall.
+*/
+/* deadline_ns < 0 waits forever; otherwise it is absolute on fossil__monotonic_ns */
+static int fossil__cond_wait(fossil_threads_cond_t *c,
+                             fossil_threads_mutex_t *m,
+                             long long deadline_ns) {
+    const int traced = fossil__trace_on();
+    long long t0 = traced ? fossil__monotonic_ns() : 0;
+    fossil__atomic_add_u32(&c->waiters, 1u);
+    fossil__atomic_store_ptr(&c->mutex, m);
+    fossil__atomic_fence();
+    unsigned int seq = fossil__atomic_load_u32(&c->seq);
+
+    if (fossil_threads_mutex_unlock(m) != FOSSIL_THREADS_MUTEX_OK) {
+        fossil__atomic_add_u32(&c->waiters, (unsigned int)-1);
+        return FOSSIL_THREADS_COND_EPERM;
+    }
+
+    /* The futex timeout is relative, but it is derived once from the monotonic deadline */
+    long long timeout_ns = FOSSIL__FUTEX_INFINITE;
+    if (deadline_ns >= 0) {
+        timeout_ns = deadline_ns - fossil__monotonic_ns();
+        if (timeout_ns < 0) timeout_ns = 0;
+    }
+    int wr = fossil__futex_wait(&c->seq, seq, timeout_ns);
+    fossil__atomic_add_u32(&c->waiters, (unsigned int)-1);
+
+    /* Requeued waiters resume here once the mutex hands them the wake */
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) fossil__mutex_lock_contended(m);
+    else fossil_threads_mutex_lock(m);
+    /* The span includes the relock, which is part of what the caller waited for */
+    if (traced)
+        fossil__trace_complete("cond", "cond.wait", m->name, t0, fossil__monotonic_ns(),
+                               (unsigned long long)(uintptr_t)c);
+
+    /* A wake that raced with the timeout still counts as a wake */
+    if (wr == FOSSIL__FUTEX_TIMEDOUT && fossil__atomic_load_u32(&c->seq) == seq)
+        return FOSSIL_THREADS_COND_ETIMEDOUT;
+    return FOSSIL_THREADS_COND_OK;
+}
+
 /* ---------- Lifecycle ---------- */
 
 int fossil_threads_cond_init(fossil_threads_cond_t *c) {
     if (!c) return FOSSIL_THREADS_COND_EINVAL;
     fossil__cond_zero(c);
-
-#if defined(_WIN32)
-    CONDITION_VARIABLE *cv = (CONDITION_VARIABLE*)malloc(sizeof(CONDITION_VARIABLE));
-    if (!cv) return FOSSIL_THREADS_COND_ENOMEM;
-    InitializeConditionVariable(cv);
-    c->handle = cv;
-#else
-    pthread_cond_t *pc = (pthread_cond_t*)malloc(sizeof(pthread_cond_t));
-    if (!pc) return FOSSIL_THREADS_COND_ENOMEM;
-    if (pthread_cond_init(pc, NULL) != 0) {
-        free(pc);
-        return FOSSIL_THREADS_COND_EINTERNAL;
-    }
-    c->handle = pc;
-#endif
     c->valid = 1;
-    c->is_broadcast = 0;
-    c->waiters = 0;
     return FOSSIL_THREADS_COND_OK;
 }
 
 void fossil_threads_cond_dispose(fossil_threads_cond_t *c) {
     if (!c || !c->valid) return;
-
-#if defined(_WIN32)
-    CONDITION_VARIABLE *cv = (CONDITION_VARIABLE*)c->handle;
-    free(cv); /* Windows condition vars don’t need explicit destruction */
-#else
-    pthread_cond_t *pc = (pthread_cond_t*)c->handle;
-    if (pc) {
-        pthread_cond_destroy(pc);
-        free(pc);
-    }
-#endif
     fossil__cond_zero(c);
 }
 
@@ -87,123 +95,58 @@ void fossil_threads_cond_dispose(fossil_threads_cond_t *c) {
 
 int fossil_threads_cond_wait(fossil_threads_cond_t *c, fossil_threads_mutex_t *m) {
     if (!c || !m || !c->valid || !m->valid) return FOSSIL_THREADS_COND_EINVAL;
-
-    c->waiters++;
-#if defined(_WIN32)
-    if (!SleepConditionVariableCS(
-        (CONDITION_VARIABLE*)c->handle,
-        (CRITICAL_SECTION*)m->handle,
-        INFINITE))
-    {
-        c->waiters--;
-        return FOSSIL_THREADS_COND_EINTERNAL;
-    }
-    c->waiters--;
-    return FOSSIL_THREADS_COND_OK;
-#else
-    int rc = pthread_cond_wait((pthread_cond_t*)c->handle,
-                               (pthread_mutex_t*)m->handle);
-    c->waiters--;
-    if (rc == 0) return FOSSIL_THREADS_COND_OK;
-    if (rc == EINVAL) return FOSSIL_THREADS_COND_EINVAL;
-    if (rc == EAGAIN) return FOSSIL_THREADS_COND_EAGAIN;
-    if (rc == ENOMEM) return FOSSIL_THREADS_COND_ENOMEM;
-    if (rc == EPERM)  return FOSSIL_THREADS_COND_EPERM;
-    if (rc == EBUSY)  return FOSSIL_THREADS_COND_EBUSY;
-    if (rc == EDEADLK) return FOSSIL_THREADS_COND_EDEADLK;
-    if (rc == ENOENT) return FOSSIL_THREADS_COND_ENOENT;
-    if (rc == ENOSYS) return FOSSIL_THREADS_COND_ENOSYS;
-    return FOSSIL_THREADS_COND_EINTERNAL;
-#endif
+    return fossil__cond_wait(c, m, FOSSIL__FUTEX_INFINITE);
 }
 
 int fossil_threads_cond_timedwait(fossil_threads_cond_t *c,
                                   fossil_threads_mutex_t *m,
                                   unsigned int ms) {
     if (!c || !m || !c->valid || !m->valid) return FOSSIL_THREADS_COND_EINVAL;
+    return fossil__cond_wait(c, m, fossil__monotonic_ns() + (long long)ms * 1000000LL);
+}
 
-    c->waiters++;
-#if defined(_WIN32)
-    BOOL ok = SleepConditionVariableCS(
-        (CONDITION_VARIABLE*)c->handle,
-        (CRITICAL_SECTION*)m->handle,
-        ms
-    );
-    c->waiters--;
-    if (ok) return FOSSIL_THREADS_COND_OK;
-    if (GetLastError() == ERROR_TIMEOUT) return FOSSIL_THREADS_COND_ETIMEDOUT;
-    return FOSSIL_THREADS_COND_EINTERNAL;
-#else
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-
-    ts.tv_sec += ms / 1000u;
-    ts.tv_nsec += (long)(ms % 1000u) * 1000000L;
-    if (ts.tv_nsec >= 1000000000L) {
-        ts.tv_sec += 1;
-        ts.tv_nsec -= 1000000000L;
-    }
-
-    int rc = pthread_cond_timedwait((pthread_cond_t*)c->handle,
-                                    (pthread_mutex_t*)m->handle,
-                                    &ts);
-    c->waiters--;
-    if (rc == 0) return FOSSIL_THREADS_COND_OK;
-    if (rc == ETIMEDOUT) return FOSSIL_THREADS_COND_ETIMEDOUT;
-    if (rc == EINVAL) return FOSSIL_THREADS_COND_EINVAL;
-    if (rc == EAGAIN) return FOSSIL_THREADS_COND_EAGAIN;
-    if (rc == ENOMEM) return FOSSIL_THREADS_COND_ENOMEM;
-    if (rc == EPERM)  return FOSSIL_THREADS_COND_EPERM;
-    if (rc == EBUSY)  return FOSSIL_THREADS_COND_EBUSY;
-    if (rc == EDEADLK) return FOSSIL_THREADS_COND_EDEADLK;
-    if (rc == ENOENT) return FOSSIL_THREADS_COND_ENOENT;
-    if (rc == ENOSYS) return FOSSIL_THREADS_COND_ENOSYS;
-    return FOSSIL_THREADS_COND_EINTERNAL;
-#endif
+int fossil_threads_cond_wait_until(fossil_threads_cond_t *c,
+                                   fossil_threads_mutex_t *m,
+                                   long long deadline_ns) {
+    if (!c || !m || !c->valid || !m->valid || deadline_ns < 0) return FOSSIL_THREADS_COND_EINVAL;
+    return fossil__cond_wait(c, m, deadline_ns);
 }
 
 int fossil_threads_cond_signal(fossil_threads_cond_t *c) {
     if (!c || !c->valid) return FOSSIL_THREADS_COND_EINVAL;
 
     c->is_broadcast = 0;
-#if defined(_WIN32)
-    WakeConditionVariable((CONDITION_VARIABLE*)c->handle);
+    fossil__atomic_add_u32(&c->seq, 1u);
+    if (fossil__atomic_load_sc_u32(&c->waiters) != 0)
+        fossil__futex_wake_one(&c->seq);
     return FOSSIL_THREADS_COND_OK;
-#else
-    int rc = pthread_cond_signal((pthread_cond_t*)c->handle);
-    if (rc == 0) return FOSSIL_THREADS_COND_OK;
-    if (rc == EINVAL) return FOSSIL_THREADS_COND_EINVAL;
-    if (rc == ENOMEM) return FOSSIL_THREADS_COND_ENOMEM;
-    if (rc == EBUSY) return FOSSIL_THREADS_COND_EBUSY;
-    if (rc == EPERM) return FOSSIL_THREADS_COND_EPERM;
-    if (rc == EDEADLK) return FOSSIL_THREADS_COND_EDEADLK;
-    if (rc == ENOENT) return FOSSIL_THREADS_COND_ENOENT;
-    if (rc == EAGAIN) return FOSSIL_THREADS_COND_EAGAIN;
-    if (rc == ENOSYS) return FOSSIL_THREADS_COND_ENOSYS;
-    return FOSSIL_THREADS_COND_EINTERNAL;
-#endif
 }
 
 int fossil_threads_cond_broadcast(fossil_threads_cond_t *c) {
     if (!c || !c->valid) return FOSSIL_THREADS_COND_EINVAL;
 
     c->is_broadcast = 1;
-#if defined(_WIN32)
-    WakeAllConditionVariable((CONDITION_VARIABLE*)c->handle);
+    unsigned int seq = fossil__atomic_add_u32(&c->seq, 1u) + 1u;
+    if (fossil__atomic_load_sc_u32(&c->waiters) == 0) return FOSSIL_THREADS_COND_OK;
+
+    /*
+    ** Waking everyone only to have them queue up on the mutex again is a
+    ** thundering herd. For adaptive mutexes wake one waiter and requeue the
+    ** rest onto the lock word; the woken waiter and each requeued one relock
+    ** in contended mode, so every unlock passes the wake along.
+    */
+    fossil_threads_mutex_t *m = (fossil_threads_mutex_t *)fossil__atomic_load_ptr(&c->mutex);
+    if (m && m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) {
+        int moved = fossil__futex_requeue(&c->seq, seq, &m->state);
+        if (moved >= 0) {
+            /* A holder that locked uncontended must still wake the requeued */
+            unsigned int held = 1u;
+            if (moved > 1) fossil__atomic_cas_u32(&m->state, &held, 2u);
+            return FOSSIL_THREADS_COND_OK;
+        }
+    }
+    fossil__futex_wake_all(&c->seq);
     return FOSSIL_THREADS_COND_OK;
-#else
-    int rc = pthread_cond_broadcast((pthread_cond_t*)c->handle);
-    if (rc == 0) return FOSSIL_THREADS_COND_OK;
-    if (rc == EINVAL) return FOSSIL_THREADS_COND_EINVAL;
-    if (rc == ENOMEM) return FOSSIL_THREADS_COND_ENOMEM;
-    if (rc == EBUSY) return FOSSIL_THREADS_COND_EBUSY;
-    if (rc == EPERM) return FOSSIL_THREADS_COND_EPERM;
-    if (rc == EDEADLK) return FOSSIL_THREADS_COND_EDEADLK;
-    if (rc == ENOENT) return FOSSIL_THREADS_COND_ENOENT;
-    if (rc == EAGAIN) return FOSSIL_THREADS_COND_EAGAIN;
-    if (rc == ENOSYS) return FOSSIL_THREADS_COND_ENOSYS;
-    return FOSSIL_THREADS_COND_EINTERNAL;
-#endif
 }
 
 int fossil_threads_cond_is_valid(const fossil_threads_cond_t *c) {
@@ -213,7 +156,7 @@ int fossil_threads_cond_is_valid(const fossil_threads_cond_t *c) {
 
 int fossil_threads_cond_waiter_count(const fossil_threads_cond_t *c) {
     if (!c || !c->valid) return -1;
-    return c->waiters;
+    return (int)fossil__atomic_load_u32(&c->waiters);
 }
 
 int fossil_threads_cond_reset(fossil_threads_cond_t *c) {
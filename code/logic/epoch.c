@@ -0,0 +1,270 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/epoch.h"
+#include "fossil/threads/thread.h"
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal.h"
+
+/* Retires between attempts to advance the epoch and reclaim */
+#define FOSSIL__EPOCH_SCAN_INTERVAL 32u
+
+// *****************************************************************************
+// Internal structures
+// *****************************************************************************
+
+typedef struct fossil__epoch_node {
+    struct fossil__epoch_node *next;
+    void *ptr;
+    fossil_threads_epoch_free_func fn;
+    size_t epoch;                          /* Global epoch when retired */
+} fossil__epoch_node;
+
+/*
+** One slot per thread, padded to a cache line so that entering and leaving
+** a section only dirties the owner's line. Slots are linked into a registry
+** that only grows; a thread that exits releases its slot for reuse.
+*/
+typedef struct fossil__epoch_slot {
+    volatile size_t local;                 /* 0 when quiescent, (epoch << 1) | 1 when active */
+    volatile unsigned int in_use;          /* Claimed by a live thread */
+    struct fossil__epoch_slot *next;       /* Registry link, immutable once published */
+    unsigned int nesting;                  /* Owner only from here on */
+    unsigned int since_scan;
+    size_t pending;
+    fossil__epoch_node *limbo;
+} fossil__epoch_slot;
+
+#define FOSSIL__EPOCH_SLOT_SIZE \
+    ((sizeof(fossil__epoch_slot) + FOSSIL__CACHE_LINE - 1) / FOSSIL__CACHE_LINE * FOSSIL__CACHE_LINE)
+
+static volatile size_t fossil__epoch_global = 0;
+static void *volatile fossil__epoch_registry = NULL;
+static void *volatile fossil__epoch_orphans = NULL;
+static FOSSIL__TLS fossil__epoch_slot *fossil__epoch_self = NULL;
+
+// *****************************************************************************
+// Internal helpers
+// *****************************************************************************
+
+static fossil__epoch_slot *fossil__epoch_acquire_slot(void) {
+    if (fossil__epoch_self) return fossil__epoch_self;
+
+    /* Reuse a slot released by an exited thread before growing the registry */
+    for (fossil__epoch_slot *s = (fossil__epoch_slot *)fossil__atomic_load_ptr(&fossil__epoch_registry);
+         s; s = s->next) {
+        unsigned int expected = 0u;
+        if (fossil__atomic_load_relaxed_u32(&s->in_use) == 0u &&
+            fossil__atomic_cas_u32(&s->in_use, &expected, 1u)) {
+            fossil__epoch_self = s;
+            return s;
+        }
+    }
+
+    fossil__epoch_slot *s = (fossil__epoch_slot *)fossil__aligned_alloc(FOSSIL__CACHE_LINE, FOSSIL__EPOCH_SLOT_SIZE);
+    if (!s) return NULL;
+    memset(s, 0, sizeof(*s));
+    s->in_use = 1u;
+
+    void *head = fossil__atomic_load_ptr(&fossil__epoch_registry);
+    do {
+        s->next = (fossil__epoch_slot *)head;
+    } while (!fossil__atomic_cas_ptr(&fossil__epoch_registry, &head, s));
+
+    fossil__epoch_self = s;
+    return s;
+}
+
+/* Advances the global epoch if every active thread has observed it. */
+static void fossil__epoch_try_advance(void) {
+    size_t g = fossil__atomic_load_size(&fossil__epoch_global);
+    size_t want = (g << 1) | 1u;
+
+    for (fossil__epoch_slot *s = (fossil__epoch_slot *)fossil__atomic_load_ptr(&fossil__epoch_registry);
+         s; s = s->next) {
+        size_t local = fossil__atomic_load_size(&s->local);
+        if ((local & 1u) && local != want) return;
+    }
+    fossil__atomic_cas_size(&fossil__epoch_global, &g, g + 1u);
+}
+
+static void fossil__epoch_adopt_orphans(fossil__epoch_slot *self) {
+    if (!fossil__atomic_load_ptr(&fossil__epoch_orphans)) return;
+    fossil__epoch_node *n = (fossil__epoch_node *)fossil__atomic_exchange_ptr(&fossil__epoch_orphans, NULL);
+    while (n) {
+        fossil__epoch_node *next = n->next;
+        n->next = self->limbo;
+        self->limbo = n;
+        self->pending++;
+        n = next;
+    }
+}
+
+/*
+** An object retired at epoch e may still be held by readers that entered at
+** e or e - 1. Once the global epoch reaches e + 2 every such reader has left,
+** since each advance requires all active readers to be at the current epoch.
+*/
+static void fossil__epoch_reclaim(fossil__epoch_slot *self) {
+    size_t g = fossil__atomic_load_size(&fossil__epoch_global);
+    fossil__epoch_node **link = &self->limbo;
+
+    while (*link) {
+        fossil__epoch_node *n = *link;
+        if (n->epoch + 2u <= g) {
+            *link = n->next;
+            self->pending--;
+            if (n->fn) n->fn(n->ptr);
+            else free(n->ptr);
+            free(n);
+        } else {
+            link = &n->next;
+        }
+    }
+}
+
+static void fossil__epoch_scan(fossil__epoch_slot *self) {
+    self->since_scan = 0u;
+    fossil__epoch_adopt_orphans(self);
+    fossil__epoch_try_advance();
+    fossil__epoch_reclaim(self);
+}
+
+/* Waits until two epoch advances have happened since the call. */
+static void fossil__epoch_grace_period(void) {
+    fossil__atomic_fence();
+    size_t target = fossil__atomic_load_size(&fossil__epoch_global) + 2u;
+    while (fossil__atomic_load_size(&fossil__epoch_global) < target) {
+        fossil__epoch_try_advance();
+        if (fossil__atomic_load_size(&fossil__epoch_global) < target)
+            fossil_threads_thread_yield();
+    }
+}
+
+// *****************************************************************************
+// Function implementations
+// *****************************************************************************
+
+int fossil_threads_epoch_enter(void) {
+    fossil__epoch_slot *self = fossil__epoch_acquire_slot();
+    if (!self) return FOSSIL_THREADS_EPOCH_ENOMEM;
+    if (self->nesting++ > 0u) return FOSSIL_THREADS_EPOCH_OK;
+
+    /*
+    ** Publish the observed epoch, then confirm it is still current so an
+    ** advancer cannot have run past us before the slot became visible.
+    */
+    size_t g = fossil__atomic_load_size(&fossil__epoch_global);
+    for (;;) {
+        fossil__atomic_store_size(&self->local, (g << 1) | 1u);
+        fossil__atomic_fence();
+        size_t now = fossil__atomic_load_size(&fossil__epoch_global);
+        if (now == g) break;
+        g = now;
+    }
+    return FOSSIL_THREADS_EPOCH_OK;
+}
+
+int fossil_threads_epoch_exit(void) {
+    fossil__epoch_slot *self = fossil__epoch_self;
+    if (!self || self->nesting == 0u) return FOSSIL_THREADS_EPOCH_EPERM;
+    if (--self->nesting == 0u) fossil__atomic_store_size(&self->local, 0u);
+    return FOSSIL_THREADS_EPOCH_OK;
+}
+
+bool fossil_threads_epoch_in_section(void) {
+    return fossil__epoch_self && fossil__epoch_self->nesting > 0u;
+}
+
+int fossil_threads_epoch_retire(void *ptr, fossil_threads_epoch_free_func fn) {
+    if (!ptr) return FOSSIL_THREADS_EPOCH_OK;
+
+    fossil__epoch_slot *self = fossil__epoch_acquire_slot();
+    fossil__epoch_node *n = self ? (fossil__epoch_node *)malloc(sizeof(*n)) : NULL;
+    if (!n) {
+        if (fossil_threads_epoch_in_section()) return FOSSIL_THREADS_EPOCH_ENOMEM;
+        fossil__epoch_grace_period();
+        if (fn) fn(ptr);
+        else free(ptr);
+        return FOSSIL_THREADS_EPOCH_OK;
+    }
+
+    /* The unlink that made ptr unreachable must be ordered before the tag */
+    fossil__atomic_fence();
+    n->ptr = ptr;
+    n->fn = fn;
+    n->epoch = fossil__atomic_load_size(&fossil__epoch_global);
+    n->next = self->limbo;
+    self->limbo = n;
+    self->pending++;
+
+    if (++self->since_scan >= FOSSIL__EPOCH_SCAN_INTERVAL) fossil__epoch_scan(self);
+    return FOSSIL_THREADS_EPOCH_OK;
+}
+
+int fossil_threads_epoch_synchronize(void) {
+    if (fossil_threads_epoch_in_section()) return FOSSIL_THREADS_EPOCH_EDEADLK;
+
+    /* Taking a slot lets this thread clean up after exited ones */
+    fossil__epoch_slot *self = fossil__epoch_acquire_slot();
+    if (self) fossil__epoch_adopt_orphans(self);
+    fossil__epoch_grace_period();
+    if (self) {
+        self->since_scan = 0u;
+        fossil__epoch_reclaim(self);
+    }
+    return FOSSIL_THREADS_EPOCH_OK;
+}
+
+size_t fossil_threads_epoch_pending(void) {
+    return fossil__epoch_self ? fossil__epoch_self->pending : 0u;
+}
+
+void fossil_threads_epoch_thread_exit(void) {
+    fossil__epoch_slot *self = fossil__epoch_self;
+    if (!self) return;
+
+    if (self->limbo) {
+        fossil__epoch_node *tail = self->limbo;
+        while (tail->next) tail = tail->next;
+        void *head = fossil__atomic_load_ptr(&fossil__epoch_orphans);
+        do {
+            tail->next = (fossil__epoch_node *)head;
+        } while (!fossil__atomic_cas_ptr(&fossil__epoch_orphans, &head, self->limbo));
+    }
+
+    self->limbo = NULL;
+    self->pending = 0u;
+    self->since_scan = 0u;
+    self->nesting = 0u;
+    fossil__atomic_store_size(&self->local, 0u);
+    fossil__atomic_store_u32(&self->in_use, 0u);
+    fossil__epoch_self = NULL;
+}
+
+void fossil__epoch_thread_exit(void) {
+    fossil_threads_epoch_thread_exit();
+}
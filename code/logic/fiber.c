@@ -0,0 +1,486 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#  define _GNU_SOURCE /* ucontext, MAP_ANONYMOUS */
+#elif defined(__APPLE__)
+#  define _XOPEN_SOURCE 600 /* ucontext is an XSI interface */
+#  define _DARWIN_C_SOURCE  /* MAP_ANON */
+#endif
+#include "fossil/threads/thread.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#  define FOSSIL__FIBER_WIN32 1
+#elif defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__NetBSD__)
+#  if defined(__APPLE__)
+#    pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#  endif
+#  include <ucontext.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#  define FOSSIL__FIBER_UCONTEXT 1
+#  if !defined(MAP_ANONYMOUS)
+#    define MAP_ANONYMOUS MAP_ANON
+#  endif
+#endif
+
+#if defined(__SANITIZE_THREAD__)
+#  define FOSSIL__FIBER_TSAN 1
+#endif
+#if defined(__SANITIZE_ADDRESS__)
+#  define FOSSIL__FIBER_ASAN 1
+#endif
+#if defined(__has_feature)
+#  if __has_feature(thread_sanitizer)
+#    define FOSSIL__FIBER_TSAN 1
+#  endif
+#  if __has_feature(address_sanitizer)
+#    define FOSSIL__FIBER_ASAN 1
+#  endif
+#endif
+#if defined(FOSSIL__FIBER_TSAN)
+#  include <sanitizer/tsan_interface.h>
+#endif
+#if defined(FOSSIL__FIBER_ASAN) && defined(FOSSIL__FIBER_UCONTEXT)
+#  include <sanitizer/common_interface_defs.h>
+#endif
+
+#include "internal.h"
+
+// *****************************************************************************
+// Internal structures
+// *****************************************************************************
+
+/*
+** A fiber is driven by a pool task: running fossil__fiber_resume() on a
+** worker switches onto the fiber's stack, and the fiber switches back when
+** it finishes, yields or awaits. Whatever has to happen next (queue the
+** fiber again, attach it to a future, publish completion) is done by the
+** worker after the switch back, so no other thread can pick the fiber up
+** while its context is still being saved.
+*/
+enum {
+    FOSSIL__FIBER_RUNNING = 0,
+    FOSSIL__FIBER_YIELD   = 1, /* queue again behind the current tasks */
+    FOSSIL__FIBER_AWAIT   = 2, /* queue again once awaited completes */
+    FOSSIL__FIBER_EXIT    = 3  /* func returned */
+};
+
+struct fossil_threads_fiber {
+    fossil_threads_pool_task_t task;        /* resume node, resubmitted on every wake */
+    fossil_threads_pool_t *pool;
+    fossil_threads_thread_func func;
+    void *arg;
+    void *result;
+    int rc;                                 /* fossil_threads_fiber_join() outcome */
+    fossil_threads_pool_future_t *awaited;  /* valid while action is AWAIT */
+    unsigned int action;                    /* why the fiber switched out */
+    volatile unsigned int done;             /* futex word: 1 once func returned */
+    volatile unsigned int refs;             /* join handle + execution */
+#if defined(FOSSIL__FIBER_UCONTEXT)
+    ucontext_t ctx;
+    ucontext_t *back;                       /* worker context to switch back to */
+    void *map;                              /* stack mapping, guard page first */
+    size_t map_size;
+#elif defined(FOSSIL__FIBER_WIN32)
+    LPVOID fiber;
+    LPVOID back;
+#endif
+#if defined(FOSSIL__FIBER_TSAN)
+    void *tsan_fiber;
+    void *tsan_back;
+#endif
+#if defined(FOSSIL__FIBER_ASAN) && defined(FOSSIL__FIBER_UCONTEXT)
+    void *asan_fake;
+    const void *asan_back_bottom;
+    size_t asan_back_size;
+#endif
+};
+
+/*
+** Fiber running on this thread, NULL on plain threads and plain tasks.
+** Code on a fiber stack must not read it again after a switch: the fiber
+** may come back on another thread, and the compiler may have cached the
+** address of this thread's copy.
+*/
+static FOSSIL__TLS fossil_threads_fiber_t *fossil__fiber_self = NULL;
+
+// *****************************************************************************
+// Context switching
+// *****************************************************************************
+
+#if defined(FOSSIL__FIBER_UCONTEXT)
+
+static void fossil__fiber_entry(void);
+
+static int fossil__fiber_stack_init(fossil_threads_fiber_t *f, size_t stack_size) {
+    long page_l = sysconf(_SC_PAGESIZE);
+    size_t page = page_l > 0 ? (size_t)page_l : 4096u;
+    stack_size = (stack_size + page - 1) & ~(page - 1);
+
+    /* Stacks grow down on every supported target: the guard page goes first. */
+    f->map_size = stack_size + page;
+    f->map = mmap(NULL, f->map_size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (f->map == MAP_FAILED) {
+        f->map = NULL;
+        return FOSSIL_THREADS_ENOMEM;
+    }
+    (void)mprotect(f->map, page, PROT_NONE);
+
+    if (getcontext(&f->ctx) != 0) {
+        munmap(f->map, f->map_size);
+        f->map = NULL;
+        return FOSSIL_THREADS_EOSFAIL;
+    }
+    f->ctx.uc_stack.ss_sp = (char*)f->map + page;
+    f->ctx.uc_stack.ss_size = stack_size;
+    f->ctx.uc_link = NULL;
+    makecontext(&f->ctx, fossil__fiber_entry, 0);
+    return FOSSIL_THREADS_OK;
+}
+
+static void fossil__fiber_stack_free(fossil_threads_fiber_t *f) {
+    if (f->map) munmap(f->map, f->map_size);
+}
+
+#elif defined(FOSSIL__FIBER_WIN32)
+
+static VOID CALLBACK fossil__fiber_entry_win32(LPVOID param);
+
+static int fossil__fiber_stack_init(fossil_threads_fiber_t *f, size_t stack_size) {
+    f->fiber = CreateFiberEx(stack_size, stack_size, FIBER_FLAG_FLOAT_SWITCH,
+                             fossil__fiber_entry_win32, f);
+    return f->fiber ? FOSSIL_THREADS_OK : FOSSIL_THREADS_ENOMEM;
+}
+
+static void fossil__fiber_stack_free(fossil_threads_fiber_t *f) {
+    if (f->fiber) DeleteFiber(f->fiber);
+}
+
+#endif
+
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+
+/* Sanitizer bookkeeping around each switch; no-ops in normal builds. */
+static inline void fossil__fiber_tsan_enter(fossil_threads_fiber_t *f) {
+#if defined(FOSSIL__FIBER_TSAN)
+    f->tsan_back = __tsan_get_current_fiber();
+    __tsan_switch_to_fiber(f->tsan_fiber, 0);
+#else
+    (void)f;
+#endif
+}
+
+static inline void fossil__fiber_tsan_leave(fossil_threads_fiber_t *f) {
+#if defined(FOSSIL__FIBER_TSAN)
+    __tsan_switch_to_fiber(f->tsan_back, 0);
+#else
+    (void)f;
+#endif
+}
+
+/* Worker side: run f until it switches back. */
+static int fossil__fiber_switch_in(fossil_threads_fiber_t *f) {
+#if defined(FOSSIL__FIBER_UCONTEXT)
+    ucontext_t back;
+    f->back = &back;
+    fossil__fiber_tsan_enter(f);
+#if defined(FOSSIL__FIBER_ASAN)
+    void *fake = NULL;
+    __sanitizer_start_switch_fiber(&fake, f->ctx.uc_stack.ss_sp, f->ctx.uc_stack.ss_size);
+    swapcontext(&back, &f->ctx);
+    __sanitizer_finish_switch_fiber(fake, NULL, NULL);
+#else
+    swapcontext(&back, &f->ctx);
+#endif
+    return 1;
+#else
+    /* The thread must itself be a fiber to switch; a nested resume (from a
+     * fiber helping with a wait) comes back to that fiber instead. */
+    f->back = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(NULL);
+    if (!f->back) return 0;
+    fossil__fiber_tsan_enter(f);
+    SwitchToFiber(f->fiber);
+    return 1;
+#endif
+}
+
+/* Fiber side: give the worker back; returns when the fiber is resumed. */
+static void fossil__fiber_switch_out(fossil_threads_fiber_t *f) {
+    fossil__fiber_tsan_leave(f);
+#if defined(FOSSIL__FIBER_UCONTEXT)
+#if defined(FOSSIL__FIBER_ASAN)
+    __sanitizer_start_switch_fiber(&f->asan_fake, f->asan_back_bottom, f->asan_back_size);
+    swapcontext(&f->ctx, f->back);
+    __sanitizer_finish_switch_fiber(f->asan_fake, &f->asan_back_bottom, &f->asan_back_size);
+#else
+    swapcontext(&f->ctx, f->back);
+#endif
+#else
+    SwitchToFiber(f->back);
+#endif
+}
+
+static void fossil__fiber_body(fossil_threads_fiber_t *f) {
+    f->result = f->func(f->arg);
+    f->action = FOSSIL__FIBER_EXIT;
+    fossil__fiber_tsan_leave(f);
+}
+
+#if defined(FOSSIL__FIBER_UCONTEXT)
+static void fossil__fiber_entry(void) {
+    fossil_threads_fiber_t *f = fossil__fiber_self;
+#if defined(FOSSIL__FIBER_ASAN)
+    __sanitizer_finish_switch_fiber(NULL, &f->asan_back_bottom, &f->asan_back_size);
+#endif
+    fossil__fiber_body(f);
+#if defined(FOSSIL__FIBER_ASAN)
+    __sanitizer_start_switch_fiber(NULL, f->asan_back_bottom, f->asan_back_size);
+#endif
+    setcontext(f->back);
+}
+#else
+static VOID CALLBACK fossil__fiber_entry_win32(LPVOID param) {
+    fossil_threads_fiber_t *f = (fossil_threads_fiber_t*)param;
+    fossil__fiber_body(f);
+    SwitchToFiber(f->back);
+}
+#endif
+
+#endif /* FOSSIL__FIBER_UCONTEXT || FOSSIL__FIBER_WIN32 */
+
+// *****************************************************************************
+// Scheduling
+// *****************************************************************************
+
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+
+static void fossil__fiber_put(fossil_threads_fiber_t *f) {
+    if (fossil__atomic_add_u32(&f->refs, (unsigned int)-1) != 1) return;
+    fossil__fiber_stack_free(f);
+#if defined(FOSSIL__FIBER_TSAN)
+    __tsan_destroy_fiber(f->tsan_fiber);
+#endif
+    free(f);
+}
+
+static void *fossil__fiber_resume(void *arg);
+
+/* Queue f to run again; 0 if the pool refuses the node (shutting down). */
+static int fossil__fiber_schedule(fossil_threads_fiber_t *f) {
+    return fossil_threads_pool_submit_task(f->pool, &f->task, fossil__fiber_resume, f) == FOSSIL_THREADS_OK;
+}
+
+/* Continuation attached to an awaited future. */
+static void *fossil__fiber_wake(void *ctx, void *result) {
+    (void)result;
+    fossil_threads_fiber_t *f = (fossil_threads_fiber_t*)ctx;
+    if (!fossil__fiber_schedule(f)) (void)fossil__fiber_resume(f);
+    return NULL;
+}
+
+static void *fossil__fiber_resume(void *arg) {
+    fossil_threads_fiber_t *f = (fossil_threads_fiber_t*)arg;
+    fossil_threads_fiber_t *outer = fossil__fiber_self;
+
+    /* Back on the worker stack after each switch; the fiber's context is
+     * saved. Once f is handed to whoever runs it next it must not be
+     * touched; a pool refusing it (shutting down) keeps it running here. */
+    for (;;) {
+        fossil__fiber_self = f;
+        f->action = FOSSIL__FIBER_RUNNING;
+        int switched = fossil__fiber_switch_in(f);
+        fossil__fiber_self = outer;
+        if (!switched) {
+            /* Cannot be switched to on this worker: end it with an error. */
+            f->result = NULL;
+            f->rc = FOSSIL_THREADS_EOSFAIL;
+            break;
+        }
+        if (f->action == FOSSIL__FIBER_YIELD) {
+            if (fossil__fiber_schedule(f)) return NULL;
+            continue;
+        }
+        if (f->action == FOSSIL__FIBER_AWAIT) {
+            fossil_threads_pool_future_t *cont = NULL;
+            if (fossil_threads_pool_future_then(f->awaited, fossil__fiber_wake, f, &cont) == FOSSIL_THREADS_OK) {
+                fossil_threads_pool_future_release(cont);
+                return NULL;
+            }
+            if (fossil__fiber_schedule(f)) return NULL; /* no continuation: poll by yielding */
+            continue;
+        }
+        break;
+    }
+    fossil__atomic_store_u32(&f->done, 1u);
+    fossil__futex_wake_all(&f->done);
+    fossil__fiber_put(f);
+    return NULL;
+}
+
+static void fossil__fiber_suspend(fossil_threads_fiber_t *f, unsigned int action) {
+    f->action = action;
+    fossil__fiber_switch_out(f);
+}
+
+#endif
+
+// *****************************************************************************
+// Internal hooks
+// *****************************************************************************
+
+int fossil__fiber_active(void) {
+    return fossil__fiber_self != NULL;
+}
+
+void *fossil__fiber_hide(void) {
+    fossil_threads_fiber_t *f = fossil__fiber_self;
+    fossil__fiber_self = NULL;
+    return f;
+}
+
+void fossil__fiber_unhide(void *fiber) {
+    fossil__fiber_self = (fossil_threads_fiber_t*)fiber;
+}
+
+// *****************************************************************************
+// Function implementations
+// *****************************************************************************
+
+int fossil_threads_fiber_spawn(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    size_t stack_size,
+    fossil_threads_fiber_t **out
+) {
+    if (out) *out = NULL;
+    if (!pool || !func)
+        return FOSSIL_THREADS_EINVAL;
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+    if (stack_size == 0)
+        stack_size = FOSSIL_THREADS_FIBER_STACK_DEFAULT;
+    else if (stack_size < FOSSIL_THREADS_FIBER_STACK_MIN)
+        stack_size = FOSSIL_THREADS_FIBER_STACK_MIN;
+
+    fossil_threads_fiber_t *f = (fossil_threads_fiber_t*)calloc(1, sizeof(*f));
+    if (!f)
+        return FOSSIL_THREADS_ENOMEM;
+    f->pool = pool;
+    f->func = func;
+    f->arg = arg;
+    f->refs = out ? 2u : 1u;
+    int rc = fossil__fiber_stack_init(f, stack_size);
+    if (rc != FOSSIL_THREADS_OK) {
+        free(f);
+        return rc;
+    }
+#if defined(FOSSIL__FIBER_TSAN)
+    f->tsan_fiber = __tsan_create_fiber(0);
+#endif
+    if (out) *out = f;
+
+    rc = fossil_threads_pool_submit_task(pool, &f->task, fossil__fiber_resume, f);
+    if (rc != FOSSIL_THREADS_OK) {
+        if (out) *out = NULL;
+        f->refs = 1u;
+        fossil__fiber_put(f);
+    }
+    return rc;
+#else
+    (void)arg;
+    (void)stack_size;
+    return FOSSIL_THREADS_EUNSUPPORTED;
+#endif
+}
+
+int fossil_threads_fiber_join(fossil_threads_fiber_t *fiber, void **result) {
+    if (!fiber)
+        return FOSSIL_THREADS_EINVAL;
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+    fossil_threads_fiber_t *self = fossil__fiber_self;
+    if (fiber == self)
+        return FOSSIL_THREADS_EDEADLK;
+
+    while (fossil__atomic_load_u32(&fiber->done) == 0u) {
+        if (self) {
+            fossil__fiber_suspend(self, FOSSIL__FIBER_YIELD);
+            continue;
+        }
+        /* A worker of the fiber's pool keeps running tasks, the fiber
+         * among them, instead of sleeping on it. */
+        int helped = fossil__pool_help_caller(fiber->pool);
+        if (helped > 0) continue;
+        fossil__futex_wait(&fiber->done, 0u, helped == 0 ? 1000000LL : FOSSIL__FUTEX_INFINITE);
+    }
+    if (result) *result = fiber->result;
+    int rc = fiber->rc;
+    fossil__fiber_put(fiber);
+    return rc;
+#else
+    (void)result;
+    return FOSSIL_THREADS_EUNSUPPORTED;
+#endif
+}
+
+int fossil_threads_fiber_yield(void) {
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+    fossil_threads_fiber_t *self = fossil__fiber_self;
+    if (!self)
+        return FOSSIL_THREADS_EPERM;
+    fossil__fiber_suspend(self, FOSSIL__FIBER_YIELD);
+    return FOSSIL_THREADS_OK;
+#else
+    return FOSSIL_THREADS_EPERM;
+#endif
+}
+
+int fossil_threads_fiber_await(fossil_threads_pool_future_t *future, void **result) {
+    if (!future)
+        return FOSSIL_THREADS_EINVAL;
+#if defined(FOSSIL__FIBER_UCONTEXT) || defined(FOSSIL__FIBER_WIN32)
+    fossil_threads_fiber_t *self = fossil__fiber_self;
+    if (self) {
+        for (;;) {
+            int rc = fossil_threads_pool_future_try_get(future, result);
+            if (rc != FOSSIL_THREADS_EBUSY)
+                return rc;
+            self->awaited = future;
+            fossil__fiber_suspend(self, FOSSIL__FIBER_AWAIT);
+        }
+    }
+#endif
+    return fossil_threads_pool_future_wait(future, result);
+}
+
+int fossil_threads_fiber_inside(void) {
+    return fossil__fiber_self != NULL;
+}
@@ -0,0 +1,298 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_BARRIER_H
+#define FOSSIL_THREADS_BARRIER_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Reusable barrier for a fixed number of threads. Waiters park on the phase
+ * word with the futex layer; the last thread to arrive bumps it and releases
+ * the whole phase with one wake, entering the kernel only if someone parked.
+ */
+typedef struct fossil_threads_barrier {
+    unsigned int count;            /* Threads that make up one phase */
+    unsigned int spin;             /* Pause iterations before parking, 0 parks at once */
+    volatile unsigned int arrived; /* Threads arrived in the current phase */
+    volatile unsigned int phase;   /* Generation word waiters park on */
+    volatile unsigned int waiters; /* Threads currently parked */
+} fossil_threads_barrier_t;
+
+/*
+ * Single-use countdown latch. count_down lowers the counter; once it reaches
+ * zero every current and future waiter is released.
+ */
+typedef struct fossil_threads_latch {
+    volatile unsigned int count;   /* Arrivals still expected; waiters park on it */
+    volatile unsigned int waiters; /* Threads currently parked */
+    unsigned int spin;             /* Pause iterations before parking, 0 parks at once */
+} fossil_threads_latch_t;
+
+/* Static initializer; equivalent to fossil_threads_latch_init(l, n, 0) */
+#define FOSSIL_THREADS_LATCH_INITIALIZER(n) { (n), 0u, 0u }
+
+/* Spin that suits phases a few microseconds long; pass 0 for long phases */
+#define FOSSIL_THREADS_BARRIER_SPIN_DEFAULT 1024u
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/* ---------- Barrier ---------- */
+
+/*
+ * Initializes a barrier for count threads.
+ *
+ * Parameters:
+ *   b     - Barrier to initialize.
+ *   count - Number of threads that must call wait to complete a phase.
+ *   spin  - Pause iterations a waiter spends watching the phase word before
+ *           it parks; 0 parks at once. Ignored on single-CPU machines.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_BARRIER_EINVAL if b is NULL or count is 0.
+ *
+ * Notes:
+ *   - A barrier owns no resources; dispose is optional.
+ */
+FOSSIL_THREADS_API int fossil_threads_barrier_init(fossil_threads_barrier_t *b,
+                                                   unsigned int count, unsigned int spin);
+
+/*
+ * Disposes a barrier. No thread may be waiting on it.
+ */
+FOSSIL_THREADS_API void fossil_threads_barrier_dispose(fossil_threads_barrier_t *b);
+
+/*
+ * Blocks until count threads have called wait in the current phase, then
+ * starts the next phase.
+ *
+ * Returns:
+ *   FOSSIL_THREADS_BARRIER_SERIAL in exactly one thread per phase (the last
+ *   to arrive), 0 in the others, FOSSIL_THREADS_BARRIER_EINVAL if b is NULL.
+ *
+ * Notes:
+ *   - Everything a thread wrote before wait is visible to every thread after
+ *     it returns from the same phase.
+ */
+FOSSIL_THREADS_API int fossil_threads_barrier_wait(fossil_threads_barrier_t *b);
+
+/* ---------- Latch ---------- */
+
+/*
+ * Initializes a latch expecting count arrivals; spin is as for
+ * fossil_threads_barrier_init.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_BARRIER_EINVAL if l is NULL.
+ *
+ * Notes:
+ *   - A latch initialized with 0 is already open.
+ */
+FOSSIL_THREADS_API int fossil_threads_latch_init(fossil_threads_latch_t *l,
+                                                 unsigned int count, unsigned int spin);
+
+/*
+ * Lowers the counter by n, releasing all waiters when it reaches zero.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_BARRIER_EINVAL if l is NULL or n exceeds the
+ *   remaining count (the counter is left unchanged).
+ */
+FOSSIL_THREADS_API int fossil_threads_latch_count_down(fossil_threads_latch_t *l, unsigned int n);
+
+/*
+ * Returns true once the counter has reached zero. Never blocks.
+ */
+FOSSIL_THREADS_API bool fossil_threads_latch_try_wait(const fossil_threads_latch_t *l);
+
+/*
+ * Blocks until the counter reaches zero.
+ */
+FOSSIL_THREADS_API void fossil_threads_latch_wait(fossil_threads_latch_t *l);
+
+/*
+ * Blocks until the counter reaches zero or the absolute deadline on the
+ * fossil_threads_clock_monotonic_ns clock passes.
+ *
+ * Returns:
+ *   0 once open, FOSSIL_THREADS_BARRIER_ETIMEDOUT on timeout.
+ */
+FOSSIL_THREADS_API int fossil_threads_latch_wait_until(fossil_threads_latch_t *l, long long deadline_ns);
+
+/*
+ * Counts down by n and then waits for the latch to open.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_BARRIER_EINVAL as for count_down (without
+ *   waiting).
+ */
+FOSSIL_THREADS_API int fossil_threads_latch_arrive_and_wait(fossil_threads_latch_t *l, unsigned int n);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_BARRIER_OK        = 0,   /* Success */
+    FOSSIL_THREADS_BARRIER_SERIAL    = 1,   /* Returned by wait to the last arrival of a phase */
+    FOSSIL_THREADS_BARRIER_EINVAL    = 22,  /* Invalid argument */
+    FOSSIL_THREADS_BARRIER_ETIMEDOUT = 110  /* Deadline passed (latch_wait_until only) */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief C++ wrapper for fossil_threads_barrier_t.
+         */
+        class Barrier {
+        public:
+            /**
+             * @brief Construct a barrier for count threads.
+             *
+             * Throws std::runtime_error if count is 0.
+             */
+            explicit Barrier(unsigned int count, unsigned int spin = FOSSIL_THREADS_BARRIER_SPIN_DEFAULT) {
+                if (fossil_threads_barrier_init(&b_, count, spin) != FOSSIL_THREADS_BARRIER_OK)
+                    throw std::runtime_error("Failed to initialize barrier");
+            }
+
+            /**
+             * @brief Destructor. No thread may still be waiting.
+             */
+            ~Barrier() { fossil_threads_barrier_dispose(&b_); }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            Barrier(const Barrier&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            Barrier& operator=(const Barrier&) = delete;
+
+            /**
+             * @brief Wait for the rest of the phase.
+             * @return true in the one thread that completed the phase.
+             */
+            bool arrive_and_wait() {
+                return fossil_threads_barrier_wait(&b_) == FOSSIL_THREADS_BARRIER_SERIAL;
+            }
+
+            /**
+             * @brief Access the underlying C barrier.
+             */
+            fossil_threads_barrier_t* native_handle() { return &b_; }
+
+        private:
+            fossil_threads_barrier_t b_;
+        };
+
+        /**
+         * @brief C++ wrapper for fossil_threads_latch_t.
+         */
+        class Latch {
+        public:
+            /**
+             * @brief Construct a latch expecting count arrivals.
+             */
+            explicit Latch(unsigned int count, unsigned int spin = 0) {
+                fossil_threads_latch_init(&l_, count, spin);
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            Latch(const Latch&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            Latch& operator=(const Latch&) = delete;
+
+            /**
+             * @brief Lower the counter by n.
+             *
+             * Throws std::runtime_error if n exceeds the remaining count.
+             */
+            void count_down(unsigned int n = 1) {
+                if (fossil_threads_latch_count_down(&l_, n) != FOSSIL_THREADS_BARRIER_OK)
+                    throw std::runtime_error("Latch count_down exceeds remaining count");
+            }
+
+            /**
+             * @brief True once the counter has reached zero.
+             */
+            bool try_wait() const { return fossil_threads_latch_try_wait(&l_); }
+
+            /**
+             * @brief Block until the counter reaches zero.
+             */
+            void wait() { fossil_threads_latch_wait(&l_); }
+
+            /**
+             * @brief Count down by n, then wait for the latch to open.
+             */
+            void arrive_and_wait(unsigned int n = 1) {
+                count_down(n);
+                wait();
+            }
+
+            /**
+             * @brief Access the underlying C latch.
+             */
+            fossil_threads_latch_t* native_handle() { return &l_; }
+
+        private:
+            fossil_threads_latch_t l_;
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_BARRIER_H */
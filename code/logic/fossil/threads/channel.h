@@ -0,0 +1,426 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_CHANNEL_H
+#define FOSSIL_THREADS_CHANNEL_H
+
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Bounded channel of fixed-size elements, copied in and out by value. The
+ * consumer index, the producer index and each side's wait state live on
+ * separate cache lines. Sends and receives are lock-free; the blocking
+ * calls retry briefly on multi-CPU machines and then park on the futex
+ * layer only while the channel stays full or empty; the other side enters
+ * the kernel only if someone is parked.
+ */
+typedef struct fossil_threads_channel fossil_threads_channel_t;
+
+/* Channel kinds accepted by fossil_threads_channel_create */
+enum {
+    FOSSIL_THREADS_CHANNEL_SPSC = 0, /* One producer and one consumer thread at a time */
+    FOSSIL_THREADS_CHANNEL_MPMC = 1  /* Any number of producers and consumers */
+};
+
+/* Consumer callback of a channel stage; elem points at a private copy. */
+typedef void (*fossil_threads_channel_func)(void *elem, void *ctx);
+
+/*
+ * Intrusive multi-producer, single-consumer queue. Callers embed a node in
+ * their own structures, so pushing never allocates and never fails. Push is
+ * one atomic exchange; only the consumer touches the front.
+ */
+typedef struct fossil_threads_mpsc_node {
+    struct fossil_threads_mpsc_node *volatile next;
+} fossil_threads_mpsc_node_t;
+
+typedef struct fossil_threads_mpsc {
+    fossil_threads_mpsc_node_t *volatile back;  /* Last pushed node, producers exchange it */
+    char pad0[64 - sizeof(void *)];
+    fossil_threads_mpsc_node_t *front;          /* Next node to pop, consumer only */
+    fossil_threads_mpsc_node_t stub;            /* Placeholder keeping the list non-empty */
+    char pad1[64 - 2 * sizeof(void *)];
+    volatile unsigned int seq;                  /* Wake generation the consumer parks on */
+    volatile unsigned int waiters;              /* 1 while the consumer is parked */
+} fossil_threads_mpsc_t;
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/* ---------- Bounded channels ---------- */
+
+/*
+ * Creates a bounded channel.
+ *
+ * Parameters:
+ *   out       - Receives the channel.
+ *   kind      - FOSSIL_THREADS_CHANNEL_SPSC or FOSSIL_THREADS_CHANNEL_MPMC.
+ *   capacity  - Elements it can hold; rounded up to a power of two (at
+ *               least 2 for MPMC).
+ *   elem_size - Size in bytes of one element.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_EINVAL for a bad argument,
+ *   FOSSIL_THREADS_CHANNEL_ENOMEM if allocation fails.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_create(fossil_threads_channel_t **out, int kind,
+                                                     size_t capacity, size_t elem_size);
+
+/*
+ * Destroys a channel. No thread may still use it and no stage may be attached.
+ */
+FOSSIL_THREADS_API void fossil_threads_channel_destroy(fossil_threads_channel_t *ch);
+
+/*
+ * Copies elem into the channel without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_EAGAIN if it is full,
+ *   FOSSIL_THREADS_CHANNEL_ECLOSED after close.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_try_send(fossil_threads_channel_t *ch, const void *elem);
+
+/*
+ * Copies elem into the channel, parking while it is full.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_ECLOSED after close.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_send(fossil_threads_channel_t *ch, const void *elem);
+
+/*
+ * Copies up to n consecutive elements from elems without blocking and wakes
+ * waiting consumers once for the whole batch.
+ *
+ * Returns:
+ *   The number of elements sent, 0 if the channel is full or closed.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_channel_send_batch(fossil_threads_channel_t *ch,
+                                                            const void *elems, size_t n);
+
+/*
+ * Copies the oldest element into out without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_EAGAIN if it is empty,
+ *   FOSSIL_THREADS_CHANNEL_ECLOSED once it is closed and drained.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_try_recv(fossil_threads_channel_t *ch, void *out);
+
+/*
+ * Copies the oldest element into out, parking while the channel is empty.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_ECLOSED once it is closed and drained.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_recv(fossil_threads_channel_t *ch, void *out);
+
+/*
+ * Like fossil_threads_channel_recv, but gives up once the absolute deadline
+ * on the fossil_threads_clock_monotonic_ns clock passes.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_ETIMEDOUT on timeout,
+ *   FOSSIL_THREADS_CHANNEL_ECLOSED once it is closed and drained.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_recv_until(fossil_threads_channel_t *ch, void *out,
+                                                         long long deadline_ns);
+
+/*
+ * Copies up to max of the oldest elements into out without blocking and
+ * wakes waiting producers once for the whole batch.
+ *
+ * Returns:
+ *   The number of elements received.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_channel_recv_batch(fossil_threads_channel_t *ch,
+                                                            void *out, size_t max);
+
+/*
+ * Closes the channel: further sends fail, receivers drain what is left and
+ * then get FOSSIL_THREADS_CHANNEL_ECLOSED, and every parked thread wakes.
+ *
+ * Notes:
+ *   - Call it after the last send has returned; a send racing close may
+ *     either fail or land in the channel.
+ */
+FOSSIL_THREADS_API void fossil_threads_channel_close(fossil_threads_channel_t *ch);
+
+/*
+ * Returns true once close has been called.
+ */
+FOSSIL_THREADS_API bool fossil_threads_channel_is_closed(const fossil_threads_channel_t *ch);
+
+/*
+ * Returns a snapshot of the number of queued elements.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_channel_size(const fossil_threads_channel_t *ch);
+
+/*
+ * Returns the capacity after rounding.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_channel_capacity(const fossil_threads_channel_t *ch);
+
+/* ---------- Pool stages ---------- */
+
+/*
+ * Makes func the channel's consumer, run as a pool task on demand.
+ *
+ * A send that finds the stage idle submits one drain task to pool. The task
+ * calls func on up to batch elements and then resubmits itself if more are
+ * queued, so a busy stage shares the workers with other tasks, and an idle
+ * one holds no worker at all. At most one drain task runs at a time, so an
+ * SPSC channel keeps its single consumer.
+ *
+ * Parameters:
+ *   ch    - Channel to consume from; nothing else may receive from it.
+ *   pool  - Pool that runs the drain tasks.
+ *   func  - Called with each element and ctx.
+ *   batch - Elements per task run; 0 selects 64.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_CHANNEL_EINVAL for a bad argument,
+ *   FOSSIL_THREADS_CHANNEL_EBUSY if a stage is already attached,
+ *   FOSSIL_THREADS_CHANNEL_ENOMEM if allocation fails.
+ */
+FOSSIL_THREADS_API int fossil_threads_channel_attach(fossil_threads_channel_t *ch,
+                                                     fossil_threads_pool_t *pool,
+                                                     fossil_threads_channel_func func,
+                                                     void *ctx, size_t batch);
+
+/*
+ * Stops scheduling the stage and waits for a running drain task to return.
+ * Elements still queued stay in the channel. Call it before destroying the
+ * channel or the pool.
+ */
+FOSSIL_THREADS_API void fossil_threads_channel_detach(fossil_threads_channel_t *ch);
+
+/* ---------- Intrusive MPSC queue ---------- */
+
+/*
+ * Initializes an empty queue. The queue owns no resources but points into
+ * itself, so it must not be moved or copied once initialized.
+ */
+FOSSIL_THREADS_API void fossil_threads_mpsc_init(fossil_threads_mpsc_t *q);
+
+/*
+ * Appends node. Safe from any number of threads; never blocks.
+ */
+FOSSIL_THREADS_API void fossil_threads_mpsc_push(fossil_threads_mpsc_t *q, fossil_threads_mpsc_node_t *node);
+
+/*
+ * Appends n nodes in order with a single atomic exchange.
+ */
+FOSSIL_THREADS_API void fossil_threads_mpsc_push_batch(fossil_threads_mpsc_t *q,
+                                                       fossil_threads_mpsc_node_t **nodes, size_t n);
+
+/*
+ * Removes the oldest node, or returns NULL if the queue is empty.
+ * Consumer thread only.
+ */
+FOSSIL_THREADS_API fossil_threads_mpsc_node_t *fossil_threads_mpsc_pop(fossil_threads_mpsc_t *q);
+
+/*
+ * Removes the oldest node, parking while the queue is empty. Consumer
+ * thread only.
+ *
+ * Parameters:
+ *   deadline_ns - Absolute deadline on the fossil_threads_clock_monotonic_ns
+ *                 clock, or a negative value to wait without limit.
+ *
+ * Returns:
+ *   The node, or NULL once the deadline has passed.
+ */
+FOSSIL_THREADS_API fossil_threads_mpsc_node_t *fossil_threads_mpsc_pop_wait(fossil_threads_mpsc_t *q,
+                                                                            long long deadline_ns);
+
+/*
+ * Removes up to max nodes into nodes without blocking. Consumer thread only.
+ *
+ * Returns:
+ *   The number of nodes removed.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_mpsc_pop_batch(fossil_threads_mpsc_t *q,
+                                                        fossil_threads_mpsc_node_t **nodes, size_t max);
+
+/*
+ * Returns true if no node is queued. Consumer thread only.
+ */
+FOSSIL_THREADS_API bool fossil_threads_mpsc_empty(const fossil_threads_mpsc_t *q);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_CHANNEL_OK        = 0,   /* Success */
+    FOSSIL_THREADS_CHANNEL_EINVAL    = 22,  /* Invalid argument */
+    FOSSIL_THREADS_CHANNEL_ENOMEM    = 12,  /* Allocation failed */
+    FOSSIL_THREADS_CHANNEL_EAGAIN    = 11,  /* Full (send) or empty (receive) */
+    FOSSIL_THREADS_CHANNEL_EBUSY     = 16,  /* A stage is already attached */
+    FOSSIL_THREADS_CHANNEL_ECLOSED   = 32,  /* Channel closed (and drained, for receives) */
+    FOSSIL_THREADS_CHANNEL_ETIMEDOUT = 110  /* Deadline passed */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+#include <optional>
+#include <type_traits>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief Typed bounded channel of trivially copyable values.
+         *
+         * Wraps fossil_threads_channel_t; kind is FOSSIL_THREADS_CHANNEL_SPSC
+         * or FOSSIL_THREADS_CHANNEL_MPMC.
+         */
+        template <class T>
+        class Channel {
+            static_assert(std::is_trivially_copyable_v<T>, "Channel requires a trivially copyable T");
+        public:
+            /**
+             * @brief Create a channel holding at least capacity values.
+             *
+             * Throws std::runtime_error if creation fails.
+             */
+            explicit Channel(size_t capacity, int kind = FOSSIL_THREADS_CHANNEL_MPMC) {
+                if (fossil_threads_channel_create(&ch_, kind, capacity, sizeof(T)) != FOSSIL_THREADS_CHANNEL_OK)
+                    throw std::runtime_error("Failed to create channel");
+            }
+
+            /**
+             * @brief Destructor. Detach any stage first.
+             */
+            ~Channel() { fossil_threads_channel_destroy(ch_); }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            Channel(const Channel&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            Channel& operator=(const Channel&) = delete;
+
+            /**
+             * @brief Send without blocking.
+             * @return 0, FOSSIL_THREADS_CHANNEL_EAGAIN or FOSSIL_THREADS_CHANNEL_ECLOSED.
+             */
+            int try_send(const T& v) { return fossil_threads_channel_try_send(ch_, &v); }
+
+            /**
+             * @brief Send, parking while the channel is full.
+             * @return false once the channel is closed.
+             */
+            bool send(const T& v) { return fossil_threads_channel_send(ch_, &v) == FOSSIL_THREADS_CHANNEL_OK; }
+
+            /**
+             * @brief Send up to n values without blocking.
+             * @return Number of values sent.
+             */
+            size_t send_batch(const T* vs, size_t n) { return fossil_threads_channel_send_batch(ch_, vs, n); }
+
+            /**
+             * @brief Receive without blocking.
+             * @return The value, or std::nullopt if empty or closed and drained.
+             */
+            std::optional<T> try_recv() {
+                T v;
+                if (fossil_threads_channel_try_recv(ch_, &v) != FOSSIL_THREADS_CHANNEL_OK) return std::nullopt;
+                return v;
+            }
+
+            /**
+             * @brief Receive, parking while the channel is empty.
+             * @return The value, or std::nullopt once closed and drained.
+             */
+            std::optional<T> recv() {
+                T v;
+                if (fossil_threads_channel_recv(ch_, &v) != FOSSIL_THREADS_CHANNEL_OK) return std::nullopt;
+                return v;
+            }
+
+            /**
+             * @brief Receive up to max values without blocking.
+             * @return Number of values received.
+             */
+            size_t recv_batch(T* out, size_t max) { return fossil_threads_channel_recv_batch(ch_, out, max); }
+
+            /**
+             * @brief Close the channel after the last send.
+             */
+            void close() { fossil_threads_channel_close(ch_); }
+
+            /**
+             * @brief True once closed.
+             */
+            bool is_closed() const { return fossil_threads_channel_is_closed(ch_); }
+
+            /**
+             * @brief Snapshot of the number of queued values.
+             */
+            size_t size() const { return fossil_threads_channel_size(ch_); }
+
+            /**
+             * @brief Capacity after rounding.
+             */
+            size_t capacity() const { return fossil_threads_channel_capacity(ch_); }
+
+            /**
+             * @brief Access the underlying C channel, e.g. to attach a stage.
+             */
+            fossil_threads_channel_t* native_handle() { return ch_; }
+
+        private:
+            fossil_threads_channel_t* ch_ = nullptr;
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_CHANNEL_H */
@@ -42,13 +42,24 @@ extern "C"
 
 /* ---------- Types ---------- */
 
+/*
+ * The condition variable is a wake generation counter plus a waiter count,
+ * parked on with the futex layer. Signalling with no waiters never enters
+ * the kernel, and a broadcast on Linux with an adaptive mutex requeues the
+ * sleepers onto the mutex word instead of waking them all at once.
+ */
 typedef struct fossil_threads_cond {
-    void *handle;      /* CONDITION_VARIABLE* on Win, pthread_cond_t* on POSIX */
+    void *handle;      /* Unused, always NULL */
     int   valid;
     int   is_broadcast; /* 1 if last signal was broadcast, 0 otherwise */
-    int   waiters;      /* Number of threads currently waiting */
+    volatile unsigned int waiters; /* Threads currently inside wait/timedwait */
+    volatile unsigned int seq;     /* Wake generation waiters park on */
+    void *volatile mutex;          /* Mutex of the latest waiter, used to requeue on broadcast */
 } fossil_threads_cond_t;
 
+/* Static initializer; equivalent to fossil_threads_cond_init */
+#define FOSSIL_THREADS_COND_INITIALIZER { NULL, 1, 0, 0u, 0u, NULL }
+
 /* ---------- Lifecycle ---------- */
 
 // *****************************************************************************
@@ -87,6 +98,9 @@ FOSSIL_THREADS_API void fossil_threads_cond_dispose(fossil_threads_cond_t *c);
  * @param c Pointer to the condition variable.
  * @param m Pointer to the mutex (must be locked by the calling thread).
  * @return FOSSIL_THREADS_COND_OK on success, or error code on failure.
+ *
+ * Spurious wakeups are possible; re-check the predicate. All threads waiting
+ * concurrently on one condition variable must use the same mutex.
  */
 FOSSIL_THREADS_API int fossil_threads_cond_wait(
     fossil_threads_cond_t *c,
@@ -112,6 +126,26 @@ FOSSIL_THREADS_API int fossil_threads_cond_timedwait(
     unsigned int ms
 );
 
+/**
+ * @brief Wait on a condition variable until an absolute deadline.
+ *
+ * Like fossil_threads_cond_timedwait, but the deadline is absolute on the
+ * fossil_threads_clock_monotonic_ns clock, so a predicate loop can re-wait
+ * against the same deadline without it drifting, and wall-clock steps do not
+ * affect it.
+ *
+ * @param c Pointer to the condition variable.
+ * @param m Pointer to the mutex (must be locked by the calling thread).
+ * @param deadline_ns Absolute monotonic deadline in nanoseconds.
+ * @return FOSSIL_THREADS_COND_OK if woken, FOSSIL_THREADS_COND_ETIMEDOUT once the
+ *         deadline has passed, or error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_cond_wait_until(
+    fossil_threads_cond_t *c,
+    fossil_threads_mutex_t *m,
+    long long deadline_ns
+);
+
 /**
  * @brief Wake one thread waiting on the condition variable.
  *
@@ -126,6 +160,8 @@ FOSSIL_THREADS_API int fossil_threads_cond_signal(fossil_threads_cond_t *c);
  * @brief Wake all threads waiting on the condition variable.
  *
  * Broadcasts to the condition variable, waking up all waiting threads.
+ * Where the platform and mutex kind allow it, one waiter is woken and the
+ * rest are moved onto the mutex so they resume one at a time.
  *
  * @param c Pointer to the condition variable.
  * @return FOSSIL_THREADS_COND_OK on success, or error code on failure.
@@ -180,6 +216,7 @@ enum {
 #include <stdexcept>
 #include <vector>
 #include <string>
+#include <chrono>
 
 namespace fossil {
 
@@ -259,6 +296,31 @@ namespace threads {
             return fossil_threads_cond_timedwait(&cond_, mutex, ms);
         }
 
+        /**
+         * @brief Waits on the condition variable until an absolute monotonic deadline.
+         *
+         * @param mutex Pointer to the mutex (must be locked by the calling thread).
+         * @param deadline_ns Deadline on the fossil_threads_clock_monotonic_ns clock.
+         * @return FOSSIL_THREADS_COND_OK if woken, FOSSIL_THREADS_COND_ETIMEDOUT on timeout,
+         *         or error code on failure.
+         */
+        int wait_until(fossil_threads_mutex_t *mutex, long long deadline_ns) {
+            return fossil_threads_cond_wait_until(&cond_, mutex, deadline_ns);
+        }
+
+        /**
+         * @brief Waits on the condition variable until a steady_clock time point.
+         *
+         * @param mutex Pointer to the mutex (must be locked by the calling thread).
+         * @param tp Deadline; converted once to the library's monotonic clock.
+         * @return FOSSIL_THREADS_COND_OK if woken, FOSSIL_THREADS_COND_ETIMEDOUT on timeout,
+         *         or error code on failure.
+         */
+        int wait_until(fossil_threads_mutex_t *mutex, std::chrono::steady_clock::time_point tp) {
+            auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(tp - std::chrono::steady_clock::now()).count();
+            return wait_until(mutex, fossil_threads_clock_monotonic_ns() + (left > 0 ? left : 0));
+        }
+
         /**
          * @brief Wakes one thread waiting on the condition variable.
          *
@@ -0,0 +1,231 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_EPOCH_H
+#define FOSSIL_THREADS_EPOCH_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Destructor invoked on a retired pointer once no reader can still hold it.
+ */
+typedef void (*fossil_threads_epoch_free_func)(void *ptr);
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/*
+ * Epoch-based reclamation for pointer-swapped, read-mostly structures.
+ *
+ * Readers bracket every access with enter/exit; a writer publishes a new
+ * version, unlinks the old one and hands it to retire. The old version is
+ * destroyed only after every thread that was inside a section at the time
+ * has left it. Entering and leaving a section only touch the calling
+ * thread's own cache-line sized slot, never shared memory.
+ *
+ * Each thread gets its slot on first use. Threads started with
+ * fossil_threads_thread_create (including pool workers) release it
+ * automatically when their function returns; any other thread should call
+ * fossil_threads_epoch_thread_exit before it terminates.
+ */
+
+/*
+ * Enters a read-side critical section. Sections nest.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_EPOCH_ENOMEM if the calling thread's slot
+ *   could not be allocated on first use.
+ */
+FOSSIL_THREADS_API int fossil_threads_epoch_enter(void);
+
+/*
+ * Leaves the innermost read-side critical section.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_EPOCH_EPERM if the thread is not inside one.
+ */
+FOSSIL_THREADS_API int fossil_threads_epoch_exit(void);
+
+/*
+ * Returns true if the calling thread is inside a read-side critical section.
+ */
+FOSSIL_THREADS_API bool fossil_threads_epoch_in_section(void);
+
+/*
+ * Defers destruction of an unlinked object until no reader can reference it.
+ *
+ * Parameters:
+ *   ptr - Object already made unreachable for new readers. NULL is a no-op.
+ *   fn  - Destructor to run on ptr, or NULL for free().
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_EPOCH_ENOMEM if the deferral record could
+ *   not be allocated while inside a critical section (ptr is not retired).
+ *
+ * Notes:
+ *   - Reclamation is amortized: every few retires the caller tries to
+ *     advance the global epoch and destroys what has become safe.
+ *   - Outside a section an allocation failure falls back to a synchronous
+ *     grace period and destroys ptr before returning.
+ */
+FOSSIL_THREADS_API int fossil_threads_epoch_retire(void *ptr, fossil_threads_epoch_free_func fn);
+
+/*
+ * Waits for a full grace period and destroys everything the calling thread
+ * has retired.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_EPOCH_EDEADLK if called from inside a
+ *   critical section.
+ */
+FOSSIL_THREADS_API int fossil_threads_epoch_synchronize(void);
+
+/*
+ * Returns the number of objects the calling thread has retired that are not
+ * yet destroyed.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_epoch_pending(void);
+
+/*
+ * Releases the calling thread's slot. Objects it still has pending are
+ * handed to the remaining threads for destruction.
+ *
+ * Notes:
+ *   - Called automatically for threads from fossil_threads_thread_create.
+ *   - Safe to call when the thread never used epochs.
+ */
+FOSSIL_THREADS_API void fossil_threads_epoch_thread_exit(void);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_EPOCH_OK      = 0,  /* Success */
+    FOSSIL_THREADS_EPOCH_EPERM   = 1,  /* Not inside a critical section */
+    FOSSIL_THREADS_EPOCH_ENOMEM  = 12, /* Out of memory */
+    FOSSIL_THREADS_EPOCH_EDEADLK = 35  /* Grace period requested inside a section */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief RAII epoch read-side critical section.
+         */
+        class EpochGuard {
+        public:
+            /**
+             * @brief Enter a critical section.
+             * @throws std::runtime_error if the thread slot cannot be allocated.
+             */
+            EpochGuard() {
+                if (fossil_threads_epoch_enter() != FOSSIL_THREADS_EPOCH_OK)
+                    throw std::runtime_error("epoch enter failed");
+            }
+
+            /**
+             * @brief Leave the critical section.
+             */
+            ~EpochGuard() {
+                fossil_threads_epoch_exit();
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            EpochGuard(const EpochGuard&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            EpochGuard& operator=(const EpochGuard&) = delete;
+        };
+
+        /**
+         * @brief Epoch reclamation entry points for C++ objects.
+         */
+        class Epoch {
+        public:
+            /**
+             * @brief Defer `delete p` until no reader can reference it.
+             * @throws std::runtime_error if the deferral cannot be recorded.
+             */
+            template <class T>
+            static void retire(T* p) {
+                int rc = fossil_threads_epoch_retire(p, [](void* q) { delete static_cast<T*>(q); });
+                if (rc != FOSSIL_THREADS_EPOCH_OK)
+                    throw std::runtime_error("epoch retire failed");
+            }
+
+            /**
+             * @brief Wait for a grace period and destroy this thread's retired objects.
+             * @throws std::runtime_error if called inside a critical section.
+             */
+            static void synchronize() {
+                if (fossil_threads_epoch_synchronize() != FOSSIL_THREADS_EPOCH_OK)
+                    throw std::runtime_error("epoch synchronize inside a critical section");
+            }
+
+            /**
+             * @brief Number of objects retired by this thread and not yet destroyed.
+             */
+            static size_t pending() {
+                return fossil_threads_epoch_pending();
+            }
+
+            /**
+             * @brief Release this thread's slot (for threads not started by the library).
+             */
+            static void thread_exit() {
+                fossil_threads_epoch_thread_exit();
+            }
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_EPOCH_H */
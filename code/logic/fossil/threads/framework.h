@@ -28,5 +28,13 @@
 #include "thread.h"
 #include "mutex.h"
 #include "cond.h"
+#include "rwlock.h"
+#include "seqlock.h"
+#include "epoch.h"
+#include "barrier.h"
+#include "semaphore.h"
+#include "channel.h"
+#include "tls.h"
+#include "trace.h"
 
 #endif /* FOSSIL_THREADS_FRAMEWORK_H */
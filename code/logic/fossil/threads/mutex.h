@@ -43,13 +43,45 @@ extern "C"
 
 /* ---------- Types ---------- */
 
+/* Bytes reserved inside fossil_threads_mutex_t for the platform lock */
+#define FOSSIL_THREADS_MUTEX_STORAGE_SIZE 64
+
 typedef struct fossil_threads_mutex {
-    void *handle;      /* CRITICAL_SECTION* or pthread_mutex_t* */
+    void *handle;      /* Unused, always NULL: the platform lock lives in storage */
     int   valid;       /* 1 if initialized */
     int   locked;      /* 1 if currently locked, 0 otherwise */
     int   recursive;   /* 1 if recursive mutex, 0 otherwise */
+    int   kind;        /* FOSSIL_THREADS_MUTEX_KIND_* selected at init */
+    volatile unsigned int state; /* adaptive: 0 free, 1 locked, 2 locked with sleepers */
+    volatile unsigned int spin;  /* adaptive: running estimate of spins needed to acquire */
+    const char *name;  /* optional tag for profiling output, caller-owned */
+    void *profile;     /* contention record (profiling builds only), else NULL */
+    union {
+        unsigned char bytes[FOSSIL_THREADS_MUTEX_STORAGE_SIZE];
+        long long     align_ll;
+        double        align_d;
+        void         *align_p;
+    } storage;         /* SRWLOCK on Windows, pthread_mutex_t on POSIX */
 } fossil_threads_mutex_t;
 
+/*
+ * Static initializer for a mutex that needs no call to fossil_threads_mutex_init:
+ *
+ *     static fossil_threads_mutex_t table_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+ *
+ * The result is an adaptive mutex (see fossil_threads_mutex_init_ex), which is
+ * the only kind whose ready state is plain data on every platform. Disposing it
+ * is allowed but not required.
+ */
+#define FOSSIL_THREADS_MUTEX_INITIALIZER \
+    { NULL, 1, 0, 0, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE, 0u, 0u, NULL, NULL, { { 0 } } }
+
+/* Mutex kinds accepted by fossil_threads_mutex_init_ex */
+enum {
+    FOSSIL_THREADS_MUTEX_KIND_NORMAL   = 0, /* Platform mutex (pthread / CRITICAL_SECTION) */
+    FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE = 1  /* Spin with backoff, then park on the lock word */
+};
+
 /* ---------- Lifecycle ---------- */
 
 // *****************************************************************************
@@ -68,9 +100,32 @@ typedef struct fossil_threads_mutex {
  * Notes:
  *   - The mutex must be disposed with fossil_threads_mutex_dispose when no longer needed.
  *   - The mutex is initially unlocked.
+ *   - The platform lock is stored inside the structure, so this never allocates.
  */
 FOSSIL_THREADS_API int fossil_threads_mutex_init(fossil_threads_mutex_t *m);
 
+/* 
+ * Initializes a mutex object of the given kind.
+ * 
+ * Parameters:
+ *   m    - Pointer to a fossil_threads_mutex_t structure to initialize.
+ *   kind - FOSSIL_THREADS_MUTEX_KIND_NORMAL or FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE.
+ * 
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_MUTEX_EINVAL for an unknown kind, or another
+ *   nonzero error code on failure.
+ * 
+ * Notes:
+ *   - KIND_NORMAL is equivalent to fossil_threads_mutex_init.
+ *   - KIND_ADAPTIVE allocates nothing: contended lockers spin with exponential
+ *     backoff and then park on the lock word (futex on Linux, WaitOnAddress on
+ *     Windows, __ulock_wait on macOS). The spin limit tracks how long recent
+ *     acquisitions had to wait, so locks held briefly spin and locks held for
+ *     long stretches park early.
+ *   - Adaptive mutexes work with fossil_threads_cond_wait/timedwait.
+ */
+FOSSIL_THREADS_API int fossil_threads_mutex_init_ex(fossil_threads_mutex_t *m, int kind);
+
 /* 
  * Disposes (destroys) a mutex object.
  * 
@@ -132,6 +187,32 @@ FOSSIL_THREADS_API int fossil_threads_mutex_unlock(fossil_threads_mutex_t *m);
  */
 FOSSIL_THREADS_API int fossil_threads_mutex_trylock(fossil_threads_mutex_t *m);
 
+/* 
+ * Locks the mutex, blocking until it becomes available or the deadline passes.
+ * 
+ * Parameters:
+ *   m           - Pointer to a fossil_threads_mutex_t structure to lock.
+ *   deadline_ns - Absolute deadline on the fossil_threads_clock_monotonic_ns clock.
+ * 
+ * Returns:
+ *   0 if the mutex was locked.
+ *   FOSSIL_THREADS_MUTEX_ETIMEDOUT if the deadline passed first.
+ *   Other nonzero error code on failure.
+ * 
+ * Notes:
+ *   - Adaptive mutexes park on the lock word; normal mutexes use
+ *     pthread_mutex_clocklock(CLOCK_MONOTONIC) where available. Platforms
+ *     without a timed platform lock fall back to short sleeps between tries.
+ *   - Wall-clock adjustments never shorten or stretch the wait.
+ */
+FOSSIL_THREADS_API int fossil_threads_mutex_lock_until(fossil_threads_mutex_t *m, long long deadline_ns);
+
+/* 
+ * Returns the current time in nanoseconds on the monotonic clock used for all
+ * absolute deadlines in this library. The epoch is arbitrary.
+ */
+FOSSIL_THREADS_API long long fossil_threads_clock_monotonic_ns(void);
+
 /* 
  * Checks if the mutex is currently locked.
  * 
@@ -170,6 +251,107 @@ FOSSIL_THREADS_API bool fossil_threads_mutex_is_initialized(const fossil_threads
  */
 FOSSIL_THREADS_API void fossil_threads_mutex_reset(fossil_threads_mutex_t *m);
 
+/* ---------- Contention Profiling ---------- */
+
+/*
+ * Contention profiling is compiled in with FOSSIL_THREADS_MUTEX_PROFILE
+ * (meson -Dwith_lock_profiling=enabled). Without it the functions below
+ * still exist but report nothing, and lock/unlock carry no extra code.
+ *
+ * In a profiling build every mutex gets a record on its first acquisition.
+ * The record counts acquisitions and contended acquisitions (the first
+ * attempt found the lock held), keeps a log2 histogram of contended wait
+ * times and tracks the longest wait and hold. Counters are updated by the
+ * lock holder, so profiling adds two clock reads per acquisition but no
+ * shared atomics. Records of disposed mutexes stay listed until
+ * fossil_threads_mutex_profile_reset(), so short-lived locks still show.
+ */
+
+/* Histogram buckets: bucket i counts waits shorter than 2^(10 + i) ns,
+ * the last bucket everything longer (about 16 ms and up). */
+#define FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS 16
+
+typedef struct fossil_threads_mutex_profile {
+    const char *name;                    /* tag from set_name, or NULL */
+    const void *mutex;                   /* address at first acquisition, NULL once disposed */
+    unsigned long long acquisitions;     /* successful lock, trylock and lock_until calls */
+    unsigned long long contended;        /* acquisitions that had to wait */
+    unsigned long long wait_ns_total;    /* summed wait of contended acquisitions */
+    unsigned long long wait_ns_max;      /* longest single wait */
+    unsigned long long hold_ns_max;      /* longest time between acquire and unlock */
+    unsigned long long wait_histogram[FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS];
+} fossil_threads_mutex_profile_t;
+
+/*
+ * Tags a mutex for profiling output.
+ *
+ * Parameters:
+ *   m    - Pointer to an initialized mutex.
+ *   name - String that must outlive the mutex (typically a literal), or NULL.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_MUTEX_EINVAL for an uninitialized mutex.
+ *
+ * Notes:
+ *   - Works in every build; the name is just stored in the mutex.
+ */
+FOSSIL_THREADS_API int fossil_threads_mutex_set_name(fossil_threads_mutex_t *m, const char *name);
+
+/* 
+ * Returns the tag set with fossil_threads_mutex_set_name, or NULL.
+ */
+FOSSIL_THREADS_API const char *fossil_threads_mutex_name(const fossil_threads_mutex_t *m);
+
+/* 
+ * Returns true if the library was built with contention profiling.
+ */
+FOSSIL_THREADS_API bool fossil_threads_mutex_profile_enabled(void);
+
+/* 
+ * Copies the records of the most contended mutexes.
+ * 
+ * Parameters:
+ *   out - Array receiving up to max records, most contended first (ties are
+ *         broken by total wait time, then by acquisitions).
+ *   max - Capacity of out.
+ * 
+ * Returns:
+ *   Number of records written; 0 when profiling is compiled out.
+ * 
+ * Notes:
+ *   - Each record is copied while the lock holder may be updating it, so
+ *     counters of a busy mutex are current to within a few acquisitions.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_mutex_profile_top(fossil_threads_mutex_profile_t *out, size_t max);
+
+/*
+ * Sink for dumped profile text. Called once per line, terminator
+ * included; returns 0 to continue or nonzero to stop the dump.
+ */
+typedef int (*fossil_threads_mutex_profile_write_func)(void *ctx, const char *data, size_t len);
+
+/* 
+ * Writes the n most contended mutexes to write, a header and one line each.
+ * 
+ * Returns:
+ *   Number of mutexes written before write stopped the dump; 0 when
+ *   profiling is compiled out.
+ * 
+ * Notes:
+ *   - To print to a stream, pass a write that fwrite()s data to ctx.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_mutex_profile_dump(fossil_threads_mutex_profile_write_func write,
+                                                            void *ctx, size_t n);
+
+/* 
+ * Zeroes every record and drops the records of disposed mutexes.
+ * 
+ * Notes:
+ *   - A mutex held across the call may fold its current acquisition back
+ *     into the fresh counters.
+ */
+FOSSIL_THREADS_API void fossil_threads_mutex_profile_reset(void);
+
 /* Error codes */
 enum {
     FOSSIL_THREADS_MUTEX_OK        = 0,   /* Success */
@@ -180,7 +362,8 @@ enum {
     FOSSIL_THREADS_MUTEX_EPERM     = 1,   /* Operation not permitted */
     FOSSIL_THREADS_MUTEX_EDEADLK   = 35,  /* Deadlock detected */
     FOSSIL_THREADS_MUTEX_ENOTINIT  = 100, /* Mutex not initialized */
-    FOSSIL_THREADS_MUTEX_EUNLOCK   = 101  /* Unlock of unlocked mutex */
+    FOSSIL_THREADS_MUTEX_EUNLOCK   = 101, /* Unlock of unlocked mutex */
+    FOSSIL_THREADS_MUTEX_ETIMEDOUT = 110  /* Deadline passed (lock_until only) */
 };
 
 #ifdef __cplusplus
@@ -191,6 +374,7 @@ enum {
 #include <chrono>
 #include <atomic>
 #include <type_traits>
+#include <vector>
 
 namespace fossil {
 
@@ -203,7 +387,7 @@ namespace fossil {
          *  - RAII initialization and disposal in ctor/dtor
          *  - non-copyable, movable
          *  - lock/unlock/try_lock operations that translate error codes into exceptions
-         *  - timed try-lock helpers implemented via repeated non-blocking attempts
+         *  - timed try-lock helpers that block on fossil_threads_mutex_lock_until
          *  - a small LockGuard nested class for scoped locking
          *
          * The underlying C mutex implementation may be platform-specific (e.g. CRITICAL_SECTION
@@ -217,9 +401,19 @@ namespace fossil {
              * @brief Construct and initialize the underlying C mutex.
              */
             Mutex()
-            : m_{nullptr, 0, 0, 0}, initialized_{false}
+            : Mutex(FOSSIL_THREADS_MUTEX_KIND_NORMAL)
             {
-            int rc = fossil_threads_mutex_init(&m_);
+            }
+
+            /**
+             * @brief Construct and initialize the underlying C mutex with the given kind.
+             *
+             * @param kind FOSSIL_THREADS_MUTEX_KIND_NORMAL or FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE.
+             */
+            explicit Mutex(int kind)
+            : m_{}, initialized_{false}
+            {
+            int rc = fossil_threads_mutex_init_ex(&m_, kind);
             if (rc != FOSSIL_THREADS_MUTEX_OK) {
                 throw std::runtime_error("Failed to initialize mutex");
             }
@@ -240,7 +434,7 @@ namespace fossil {
              * @brief Move constructor.
              */
             Mutex(Mutex&& other) noexcept
-            : m_(std::exchange(other.m_, fossil_threads_mutex_t{nullptr, 0, 0, 0})),
+            : m_(std::exchange(other.m_, fossil_threads_mutex_t{})),
               initialized_(other.initialized_.load(std::memory_order_acquire))
             {
             other.initialized_.store(false, std::memory_order_release);
@@ -254,7 +448,7 @@ namespace fossil {
                 if (initialized_.load(std::memory_order_acquire)) {
                 fossil_threads_mutex_dispose(&m_);
                 }
-                m_ = std::exchange(other.m_, fossil_threads_mutex_t{nullptr, 0, 0, 0});
+                m_ = std::exchange(other.m_, fossil_threads_mutex_t{});
                 initialized_.store(other.initialized_.load(std::memory_order_acquire),
                           std::memory_order_release);
                 other.initialized_.store(false, std::memory_order_release);
@@ -316,16 +510,8 @@ namespace fossil {
                 return try_lock();
             }
 
-            auto deadline = std::chrono::steady_clock::now() + rel_time;
-            while (std::chrono::steady_clock::now() < deadline) {
-                int rc = fossil_threads_mutex_trylock(&m_);
-                if (rc == FOSSIL_THREADS_MUTEX_OK) return true;
-                if (rc != FOSSIL_THREADS_MUTEX_EBUSY) {
-                throw std::runtime_error("Failed to try_lock mutex");
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-            }
-            return false;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(rel_time).count();
+            return lock_until_ns(fossil_threads_clock_monotonic_ns() + ns);
             }
 
             /**
@@ -350,19 +536,54 @@ namespace fossil {
                 throw std::runtime_error("Timed try_lock on uninitialized mutex");
             }
 
-            if (std::chrono::steady_clock::now() >= tp) {
+            auto now = std::chrono::steady_clock::now();
+            if (now >= tp) {
                 return try_lock();
             }
 
-            while (std::chrono::steady_clock::now() < tp) {
-                int rc = fossil_threads_mutex_trylock(&m_);
-                if (rc == FOSSIL_THREADS_MUTEX_OK) return true;
-                if (rc != FOSSIL_THREADS_MUTEX_EBUSY) {
-                throw std::runtime_error("Failed to try_lock mutex");
-                }
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            // steady_clock and the library clock have different epochs; carry the distance over
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(tp - now).count();
+            return lock_until_ns(fossil_threads_clock_monotonic_ns() + ns);
+            }
+
+            /**
+             * @brief Attempt to lock the mutex until an absolute fossil_threads_clock_monotonic_ns deadline.
+             */
+            bool lock_until_ns(long long deadline_ns) {
+            if (!initialized_.load(std::memory_order_acquire)) {
+                throw std::runtime_error("Timed try_lock on uninitialized mutex");
+            }
+            int rc = fossil_threads_mutex_lock_until(&m_, deadline_ns);
+            if (rc == FOSSIL_THREADS_MUTEX_OK) return true;
+            if (rc == FOSSIL_THREADS_MUTEX_ETIMEDOUT) return false;
+            throw std::runtime_error("Failed to timed-lock mutex");
             }
-            return false;
+
+            /**
+             * @brief Tag the mutex for profiling output.
+             * @param name String that outlives the mutex (typically a literal).
+             */
+            void set_name(const char* name) {
+            if (fossil_threads_mutex_set_name(&m_, name) != FOSSIL_THREADS_MUTEX_OK) {
+                throw std::runtime_error("Failed to name mutex");
+            }
+            }
+
+            /**
+             * @brief Tag set with set_name, or nullptr.
+             */
+            const char* name() const noexcept {
+            return fossil_threads_mutex_name(&m_);
+            }
+
+            /**
+             * @brief Records of the n most contended mutexes, most contended first.
+             * @return Empty when the library was built without lock profiling.
+             */
+            static std::vector<fossil_threads_mutex_profile_t> profile_top(size_t n) {
+            std::vector<fossil_threads_mutex_profile_t> out(n);
+            out.resize(fossil_threads_mutex_profile_top(out.data(), n));
+            return out;
             }
 
             /**
@@ -0,0 +1,432 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_RWLOCK_H
+#define FOSSIL_THREADS_RWLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/* Bytes reserved inside fossil_threads_rwlock_t for the platform lock */
+#if defined(__APPLE__)
+#  define FOSSIL_THREADS_RWLOCK_STORAGE_SIZE 200
+#else
+#  define FOSSIL_THREADS_RWLOCK_STORAGE_SIZE 64
+#endif
+
+typedef struct fossil_threads_rwlock {
+    int   valid;       /* 1 if initialized */
+    int   policy;      /* FOSSIL_THREADS_RWLOCK_POLICY_* selected at init */
+    int   write_held;  /* native: 1 while held exclusively (selects the release call) */
+    volatile unsigned int state;    /* policy locks: write bit | reader count */
+    volatile unsigned int writers;  /* policy locks: writers waiting to acquire */
+    volatile unsigned int seq;      /* policy locks: release generation, parked on */
+    volatile unsigned int sleepers; /* policy locks: threads parked on seq */
+    union {
+        unsigned char bytes[FOSSIL_THREADS_RWLOCK_STORAGE_SIZE];
+        long long     align_ll;
+        double        align_d;
+        void         *align_p;
+    } storage;         /* SRWLOCK on Windows, pthread_rwlock_t on POSIX */
+} fossil_threads_rwlock_t;
+
+/* Scheduling policies accepted by fossil_threads_rwlock_init_ex */
+enum {
+    FOSSIL_THREADS_RWLOCK_POLICY_NATIVE        = 0, /* pthread_rwlock / SRWLOCK, platform fairness */
+    FOSSIL_THREADS_RWLOCK_POLICY_PREFER_READER = 1, /* Readers enter whenever no writer holds it */
+    FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER = 2  /* New readers wait while a writer is queued */
+};
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/* ---------- Lifecycle ---------- */
+
+/*
+ * Initializes a reader-writer lock backed by the platform rwlock.
+ *
+ * Parameters:
+ *   rw - Pointer to a fossil_threads_rwlock_t structure to initialize.
+ *
+ * Returns:
+ *   0 on success, or a nonzero error code on failure.
+ *
+ * Notes:
+ *   - Equivalent to fossil_threads_rwlock_init_ex(rw, FOSSIL_THREADS_RWLOCK_POLICY_NATIVE).
+ *   - The lock is stored inside the structure; this never allocates.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_init(fossil_threads_rwlock_t *rw);
+
+/*
+ * Initializes a reader-writer lock with the given scheduling policy.
+ *
+ * Parameters:
+ *   rw     - Pointer to a fossil_threads_rwlock_t structure to initialize.
+ *   policy - One of FOSSIL_THREADS_RWLOCK_POLICY_*.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_EINVAL for an unknown policy, or
+ *   another nonzero error code on failure.
+ *
+ * Notes:
+ *   - POLICY_NATIVE uses pthread_rwlock_t / SRWLOCK directly.
+ *   - Neither SRWLOCK nor the macOS rwlock expose a preference knob, so the
+ *     PREFER_READER and PREFER_WRITER policies use the library's own lock word
+ *     and park on it (futex / WaitOnAddress / __ulock_wait). Only these two
+ *     policies support fossil_threads_rwlock_try_upgrade.
+ *   - Under PREFER_WRITER a thread must not take a read lock it already holds:
+ *     a writer queued in between would deadlock both.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_init_ex(fossil_threads_rwlock_t *rw, int policy);
+
+/*
+ * Disposes a reader-writer lock.
+ *
+ * Parameters:
+ *   rw - Pointer to a fossil_threads_rwlock_t structure to dispose.
+ *
+ * Notes:
+ *   - Safe to call on a zeroed or already-disposed lock.
+ *   - The lock must not be held.
+ */
+FOSSIL_THREADS_API void fossil_threads_rwlock_dispose(fossil_threads_rwlock_t *rw);
+
+/* ---------- Shared (read) locking ---------- */
+
+/*
+ * Acquires the lock for reading, blocking while a writer holds it (and, under
+ * PREFER_WRITER, while a writer is waiting).
+ *
+ * Returns:
+ *   0 on success, or a nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_rdlock(fossil_threads_rwlock_t *rw);
+
+/*
+ * Attempts to acquire the lock for reading without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_EBUSY if a reader cannot enter now,
+ *   or another nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_tryrdlock(fossil_threads_rwlock_t *rw);
+
+/*
+ * Acquires the lock for reading, waiting at most ms milliseconds.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_ETIMEDOUT if the time ran out, or
+ *   another nonzero error code on failure.
+ *
+ * Notes:
+ *   - Where the platform lacks a timed rwlock (Windows, macOS) the native
+ *     policy polls with backoff; the preference policies park with a timeout.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_timedrdlock(fossil_threads_rwlock_t *rw, unsigned int ms);
+
+/* ---------- Exclusive (write) locking ---------- */
+
+/*
+ * Acquires the lock for writing, blocking until no reader or writer holds it.
+ *
+ * Returns:
+ *   0 on success, or a nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_wrlock(fossil_threads_rwlock_t *rw);
+
+/*
+ * Attempts to acquire the lock for writing without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_EBUSY if the lock is held, or another
+ *   nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_trywrlock(fossil_threads_rwlock_t *rw);
+
+/*
+ * Acquires the lock for writing, waiting at most ms milliseconds.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_ETIMEDOUT if the time ran out, or
+ *   another nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_timedwrlock(fossil_threads_rwlock_t *rw, unsigned int ms);
+
+/* ---------- Release and conversion ---------- */
+
+/*
+ * Releases a read or write hold on the lock.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_EUNLOCK if the lock was not held, or
+ *   another nonzero error code on failure.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_unlock(fossil_threads_rwlock_t *rw);
+
+/*
+ * Converts the caller's read hold into a write hold if it is the only reader.
+ *
+ * Returns:
+ *   0 if the caller now holds the lock for writing.
+ *   FOSSIL_THREADS_RWLOCK_EBUSY if other readers are present; the caller still
+ *   holds its read lock.
+ *   FOSSIL_THREADS_RWLOCK_EPERM if the lock is not held for reading.
+ *   FOSSIL_THREADS_RWLOCK_EUNSUPPORTED for POLICY_NATIVE locks.
+ *
+ * Notes:
+ *   - Never blocks: two readers waiting to upgrade would deadlock each other.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_try_upgrade(fossil_threads_rwlock_t *rw);
+
+/*
+ * Converts the caller's write hold into a read hold without letting another
+ * writer in between.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_RWLOCK_EUNLOCK if the lock was not held for
+ *   writing, or FOSSIL_THREADS_RWLOCK_EUNSUPPORTED for POLICY_NATIVE locks.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_downgrade(fossil_threads_rwlock_t *rw);
+
+/* ---------- Queries ---------- */
+
+/*
+ * Checks if the lock has been initialized.
+ *
+ * Returns:
+ *   true if the lock is initialized, false otherwise.
+ */
+FOSSIL_THREADS_API bool fossil_threads_rwlock_is_initialized(const fossil_threads_rwlock_t *rw);
+
+/*
+ * Returns the policy the lock was initialized with, or -1 if rw is not
+ * initialized.
+ */
+FOSSIL_THREADS_API int fossil_threads_rwlock_policy(const fossil_threads_rwlock_t *rw);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_RWLOCK_OK           = 0,   /* Success */
+    FOSSIL_THREADS_RWLOCK_EINVAL       = 22,  /* Invalid argument */
+    FOSSIL_THREADS_RWLOCK_EBUSY        = 16,  /* Lock not available (try variants) */
+    FOSSIL_THREADS_RWLOCK_ETIMEDOUT    = 110, /* Timed variant ran out of time */
+    FOSSIL_THREADS_RWLOCK_EINTERNAL    = 199, /* Internal error */
+    FOSSIL_THREADS_RWLOCK_ENOMEM       = 12,  /* Out of memory */
+    FOSSIL_THREADS_RWLOCK_EPERM        = 1,   /* Operation not permitted */
+    FOSSIL_THREADS_RWLOCK_EDEADLK      = 35,  /* Deadlock detected */
+    FOSSIL_THREADS_RWLOCK_EAGAIN       = 11,  /* Too many readers */
+    FOSSIL_THREADS_RWLOCK_EUNLOCK      = 101, /* Unlock of unlocked rwlock */
+    FOSSIL_THREADS_RWLOCK_EUNSUPPORTED = 252  /* Not supported by this policy */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+#include <utility>
+#include <chrono>
+#include <type_traits>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief RAII wrapper around fossil_threads_rwlock_t.
+         *
+         * Satisfies the standard Lockable and SharedLockable requirements, so it
+         * works with std::unique_lock and std::shared_lock as well as with the
+         * nested WriteGuard / ReadGuard helpers. Errors other than "busy" and
+         * "timed out" are reported as std::runtime_error.
+         */
+        class RwLock {
+        public:
+            /**
+             * @brief Construct a lock with the given policy (native by default).
+             *
+             * @param policy One of FOSSIL_THREADS_RWLOCK_POLICY_*.
+             */
+            explicit RwLock(int policy = FOSSIL_THREADS_RWLOCK_POLICY_NATIVE)
+            : rw_{}
+            {
+                if (fossil_threads_rwlock_init_ex(&rw_, policy) != FOSSIL_THREADS_RWLOCK_OK) {
+                    throw std::runtime_error("Failed to initialize rwlock");
+                }
+            }
+
+            /**
+             * @brief Destructor disposes the underlying lock.
+             */
+            ~RwLock() { fossil_threads_rwlock_dispose(&rw_); }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            RwLock(const RwLock&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            RwLock& operator=(const RwLock&) = delete;
+
+            /**
+             * @brief Acquire the lock exclusively.
+             */
+            void lock() { check(fossil_threads_rwlock_wrlock(&rw_), "Failed to write-lock rwlock"); }
+
+            /**
+             * @brief Try to acquire the lock exclusively without blocking.
+             */
+            bool try_lock() { return attempt(fossil_threads_rwlock_trywrlock(&rw_)); }
+
+            /**
+             * @brief Try to acquire the lock exclusively, waiting up to rel_time.
+             */
+            template <class Rep, class Period>
+            bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time) {
+                return attempt(fossil_threads_rwlock_timedwrlock(&rw_, to_ms(rel_time)));
+            }
+
+            /**
+             * @brief Release an exclusive hold.
+             */
+            void unlock() { check(fossil_threads_rwlock_unlock(&rw_), "Failed to unlock rwlock"); }
+
+            /**
+             * @brief Acquire the lock shared.
+             */
+            void lock_shared() { check(fossil_threads_rwlock_rdlock(&rw_), "Failed to read-lock rwlock"); }
+
+            /**
+             * @brief Try to acquire the lock shared without blocking.
+             */
+            bool try_lock_shared() { return attempt(fossil_threads_rwlock_tryrdlock(&rw_)); }
+
+            /**
+             * @brief Try to acquire the lock shared, waiting up to rel_time.
+             */
+            template <class Rep, class Period>
+            bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& rel_time) {
+                return attempt(fossil_threads_rwlock_timedrdlock(&rw_, to_ms(rel_time)));
+            }
+
+            /**
+             * @brief Release a shared hold.
+             */
+            void unlock_shared() { check(fossil_threads_rwlock_unlock(&rw_), "Failed to unlock rwlock"); }
+
+            /**
+             * @brief Turn the caller's shared hold into an exclusive one if it is the only reader.
+             *
+             * @return true if upgraded; false if other readers are present (still held shared).
+             */
+            bool try_upgrade() { return attempt(fossil_threads_rwlock_try_upgrade(&rw_)); }
+
+            /**
+             * @brief Turn the caller's exclusive hold into a shared one.
+             */
+            void downgrade() { check(fossil_threads_rwlock_downgrade(&rw_), "Failed to downgrade rwlock"); }
+
+            /**
+             * @brief Returns the policy the lock was created with.
+             */
+            int policy() const { return fossil_threads_rwlock_policy(&rw_); }
+
+            /**
+             * @brief Returns a pointer to the underlying C lock.
+             */
+            fossil_threads_rwlock_t* native_handle() { return &rw_; }
+
+            /**
+             * @brief Scoped shared hold: lock_shared() on construction, unlock_shared() on destruction.
+             */
+            class ReadGuard {
+            public:
+            explicit ReadGuard(RwLock& rw) : rw_(rw) { rw_.lock_shared(); }
+            ~ReadGuard() noexcept { try { rw_.unlock_shared(); } catch (...) {} }
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+            private:
+            RwLock& rw_;
+            };
+
+            /**
+             * @brief Scoped exclusive hold: lock() on construction, unlock() on destruction.
+             */
+            class WriteGuard {
+            public:
+            explicit WriteGuard(RwLock& rw) : rw_(rw) { rw_.lock(); }
+            ~WriteGuard() noexcept { try { rw_.unlock(); } catch (...) {} }
+            WriteGuard(const WriteGuard&) = delete;
+            WriteGuard& operator=(const WriteGuard&) = delete;
+            private:
+            RwLock& rw_;
+            };
+
+        private:
+            static void check(int rc, const char *what) {
+                if (rc != FOSSIL_THREADS_RWLOCK_OK) throw std::runtime_error(what);
+            }
+
+            static bool attempt(int rc) {
+                if (rc == FOSSIL_THREADS_RWLOCK_OK) return true;
+                if (rc == FOSSIL_THREADS_RWLOCK_EBUSY || rc == FOSSIL_THREADS_RWLOCK_ETIMEDOUT) return false;
+                throw std::runtime_error("rwlock operation failed");
+            }
+
+            template <class Rep, class Period>
+            static unsigned int to_ms(const std::chrono::duration<Rep, Period>& d) {
+                auto ms = std::chrono::ceil<std::chrono::milliseconds>(d).count();
+                if (ms <= 0) return 0;
+                if (ms > 0xffffffffLL) return 0xffffffffu;
+                return static_cast<unsigned int>(ms);
+            }
+
+            fossil_threads_rwlock_t rw_;
+        };
+
+        static_assert(!std::is_copy_constructible_v<RwLock>, "RwLock must not be copyable");
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_RWLOCK_H */
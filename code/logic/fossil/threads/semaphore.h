@@ -0,0 +1,255 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_SEMAPHORE_H
+#define FOSSIL_THREADS_SEMAPHORE_H
+
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Counting semaphore. The count is the futex word: acquirers take a unit
+ * with a CAS and park on the word only while it is zero, and a post enters
+ * the kernel only when someone is parked.
+ */
+typedef struct fossil_threads_sem {
+    volatile unsigned int value;   /* Units available; waiters park while it is 0 */
+    volatile unsigned int waiters; /* Threads currently parked */
+    unsigned int spin;             /* Pause iterations before parking, 0 parks at once */
+} fossil_threads_sem_t;
+
+/* Static initializer; equivalent to fossil_threads_sem_init(s, n, 0) */
+#define FOSSIL_THREADS_SEM_INITIALIZER(n) { (n), 0u, 0u }
+
+/* Largest count a semaphore can hold */
+#define FOSSIL_THREADS_SEM_VALUE_MAX 0x7fffffffu
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/*
+ * Initializes a semaphore holding initial units.
+ *
+ * Parameters:
+ *   s       - Semaphore to initialize.
+ *   initial - Starting count, at most FOSSIL_THREADS_SEM_VALUE_MAX.
+ *   spin    - Pause iterations an acquirer spends waiting for a unit before
+ *             it parks; 0 parks at once. Ignored on single-CPU machines.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_EINVAL if s is NULL or initial is too large.
+ *
+ * Notes:
+ *   - A semaphore owns no resources; dispose is optional.
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_init(fossil_threads_sem_t *s,
+                                               unsigned int initial, unsigned int spin);
+
+/*
+ * Disposes a semaphore. No thread may be waiting on it.
+ */
+FOSSIL_THREADS_API void fossil_threads_sem_dispose(fossil_threads_sem_t *s);
+
+/* ---------- Acquire ---------- */
+
+/*
+ * Takes one unit, blocking while none is available.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_EINVAL if s is NULL.
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_wait(fossil_threads_sem_t *s);
+
+/*
+ * Takes one unit if one is available, without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_EAGAIN if the count is zero.
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_trywait(fossil_threads_sem_t *s);
+
+/*
+ * Takes one unit, giving up after ms milliseconds.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_ETIMEDOUT on timeout.
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_timedwait(fossil_threads_sem_t *s, unsigned int ms);
+
+/*
+ * Takes one unit, giving up once the absolute deadline on the
+ * fossil_threads_clock_monotonic_ns clock passes.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_ETIMEDOUT on timeout.
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_wait_until(fossil_threads_sem_t *s, long long deadline_ns);
+
+/* ---------- Release ---------- */
+
+/*
+ * Releases n units, waking parked waiters to claim them.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEM_EOVERFLOW if the count would exceed
+ *   FOSSIL_THREADS_SEM_VALUE_MAX (nothing is released).
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_post_n(fossil_threads_sem_t *s, unsigned int n);
+
+/*
+ * Releases one unit; same as fossil_threads_sem_post_n(s, 1).
+ */
+FOSSIL_THREADS_API int fossil_threads_sem_post(fossil_threads_sem_t *s);
+
+/*
+ * Returns a snapshot of the count, or 0 if s is NULL.
+ */
+FOSSIL_THREADS_API unsigned int fossil_threads_sem_value(const fossil_threads_sem_t *s);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_SEM_OK        = 0,   /* Success */
+    FOSSIL_THREADS_SEM_EINVAL    = 22,  /* Invalid argument */
+    FOSSIL_THREADS_SEM_EAGAIN    = 11,  /* No unit available (trywait only) */
+    FOSSIL_THREADS_SEM_ETIMEDOUT = 110, /* Timeout or deadline passed */
+    FOSSIL_THREADS_SEM_EOVERFLOW = 75   /* Count would exceed FOSSIL_THREADS_SEM_VALUE_MAX */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+#include <chrono>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief C++ wrapper for fossil_threads_sem_t, modelled on std::counting_semaphore.
+         */
+        class Semaphore {
+        public:
+            /**
+             * @brief Construct holding initial units.
+             *
+             * Throws std::runtime_error if initial exceeds FOSSIL_THREADS_SEM_VALUE_MAX.
+             */
+            explicit Semaphore(unsigned int initial = 0, unsigned int spin = 0) {
+                if (fossil_threads_sem_init(&s_, initial, spin) != FOSSIL_THREADS_SEM_OK)
+                    throw std::runtime_error("Failed to initialize semaphore");
+            }
+
+            /**
+             * @brief Destructor. No thread may still be waiting.
+             */
+            ~Semaphore() { fossil_threads_sem_dispose(&s_); }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            Semaphore(const Semaphore&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            Semaphore& operator=(const Semaphore&) = delete;
+
+            /**
+             * @brief Take one unit, blocking while none is available.
+             */
+            void acquire() { fossil_threads_sem_wait(&s_); }
+
+            /**
+             * @brief Take one unit if available.
+             * @return true on success.
+             */
+            bool try_acquire() { return fossil_threads_sem_trywait(&s_) == FOSSIL_THREADS_SEM_OK; }
+
+            /**
+             * @brief Take one unit, giving up after the given duration.
+             * @return true on success, false on timeout.
+             */
+            template <class Rep, class Period>
+            bool try_acquire_for(const std::chrono::duration<Rep, Period>& d) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+                return try_acquire_until_ns(fossil_threads_clock_monotonic_ns() + (ns > 0 ? ns : 0));
+            }
+
+            /**
+             * @brief Take one unit, giving up at an absolute monotonic deadline.
+             * @return true on success, false on timeout.
+             */
+            bool try_acquire_until_ns(long long deadline_ns) {
+                return fossil_threads_sem_wait_until(&s_, deadline_ns) == FOSSIL_THREADS_SEM_OK;
+            }
+
+            /**
+             * @brief Release n units.
+             *
+             * Throws std::runtime_error if the count would overflow.
+             */
+            void release(unsigned int n = 1) {
+                if (fossil_threads_sem_post_n(&s_, n) != FOSSIL_THREADS_SEM_OK)
+                    throw std::runtime_error("Semaphore release overflows the count");
+            }
+
+            /**
+             * @brief Snapshot of the available units.
+             */
+            unsigned int value() const { return fossil_threads_sem_value(&s_); }
+
+            /**
+             * @brief Access the underlying C semaphore.
+             */
+            fossil_threads_sem_t* native_handle() { return &s_; }
+
+        private:
+            fossil_threads_sem_t s_;
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_SEMAPHORE_H */
@@ -0,0 +1,224 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_SEQLOCK_H
+#define FOSSIL_THREADS_SEQLOCK_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Sequence lock for small plain-data snapshots. Readers never write to the
+ * lock: they sample the sequence, copy, and retry if a writer ran meanwhile.
+ * Writers serialize among themselves on the same word and make it odd while
+ * they update.
+ */
+typedef struct fossil_threads_seqlock {
+    volatile unsigned int seq;     /* Even when stable, odd while a write is in progress */
+    volatile unsigned int waiters; /* Writers parked waiting for the current writer */
+} fossil_threads_seqlock_t;
+
+/* Static initializer; equivalent to fossil_threads_seqlock_init */
+#define FOSSIL_THREADS_SEQLOCK_INITIALIZER { 0u, 0u }
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/*
+ * Initializes a seqlock.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEQLOCK_EINVAL if sl is NULL.
+ *
+ * Notes:
+ *   - A seqlock owns no resources and needs no dispose call.
+ */
+FOSSIL_THREADS_API int fossil_threads_seqlock_init(fossil_threads_seqlock_t *sl);
+
+/* ---------- Readers ---------- */
+
+/*
+ * Starts a read section and returns the sequence to pass to read_retry.
+ *
+ * Notes:
+ *   - Spins (yielding after a while) while a writer is active.
+ *   - Data read inside the section may be torn; only use it once
+ *     fossil_threads_seqlock_read_retry has returned false.
+ */
+FOSSIL_THREADS_API unsigned int fossil_threads_seqlock_read_begin(const fossil_threads_seqlock_t *sl);
+
+/*
+ * Ends a read section.
+ *
+ * Returns:
+ *   true if a writer ran since read_begin and the section must be repeated,
+ *   false if everything read in between is a consistent snapshot.
+ */
+FOSSIL_THREADS_API bool fossil_threads_seqlock_read_retry(const fossil_threads_seqlock_t *sl, unsigned int start);
+
+/*
+ * Copies size bytes from the protected object src into dst, retrying until
+ * the copy is a consistent snapshot.
+ */
+FOSSIL_THREADS_API void fossil_threads_seqlock_read(const fossil_threads_seqlock_t *sl,
+                                                    void *dst, const void *src, size_t size);
+
+/* ---------- Writers ---------- */
+
+/*
+ * Acquires the write side, blocking while another writer holds it.
+ */
+FOSSIL_THREADS_API void fossil_threads_seqlock_write_lock(fossil_threads_seqlock_t *sl);
+
+/*
+ * Attempts to acquire the write side without blocking.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_SEQLOCK_EBUSY if another writer holds it.
+ */
+FOSSIL_THREADS_API int fossil_threads_seqlock_write_trylock(fossil_threads_seqlock_t *sl);
+
+/*
+ * Releases the write side, publishing the update to readers.
+ */
+FOSSIL_THREADS_API void fossil_threads_seqlock_write_unlock(fossil_threads_seqlock_t *sl);
+
+/*
+ * Copies size bytes from src into the protected object dst under the write
+ * side.
+ */
+FOSSIL_THREADS_API void fossil_threads_seqlock_write(fossil_threads_seqlock_t *sl,
+                                                     void *dst, const void *src, size_t size);
+
+/*
+ * Copies between a protected object and private memory with per-word relaxed
+ * atomic accesses, so concurrent readers and writers do not race formally.
+ * Use it for copies inside a manually written read or write section; the
+ * fossil_threads_seqlock_read/write helpers already do.
+ */
+FOSSIL_THREADS_API void fossil_threads_seqlock_copy(void *dst, const void *src, size_t size);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_SEQLOCK_OK     = 0,  /* Success */
+    FOSSIL_THREADS_SEQLOCK_EINVAL = 22, /* Invalid argument */
+    FOSSIL_THREADS_SEQLOCK_EBUSY  = 16  /* Another writer holds the lock */
+};
+
+#ifdef __cplusplus
+}
+#include <type_traits>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief A trivially copyable value guarded by a seqlock.
+         *
+         * load() never writes shared memory, so any number of readers can
+         * sample the value without bouncing its cache line; store() and
+         * update() serialize writers.
+         */
+        template <class T>
+        class Seqlocked {
+            static_assert(std::is_trivially_copyable_v<T>, "Seqlocked requires a trivially copyable T");
+        public:
+            /**
+             * @brief Construct holding a value-initialized T.
+             */
+            Seqlocked() : value_{}, sl_{} {}
+
+            /**
+             * @brief Construct holding the given value.
+             */
+            explicit Seqlocked(const T& v) : value_(v), sl_{} {}
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            Seqlocked(const Seqlocked&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            Seqlocked& operator=(const Seqlocked&) = delete;
+
+            /**
+             * @brief Return a consistent snapshot of the value.
+             */
+            T load() const {
+                T out;
+                fossil_threads_seqlock_read(&sl_, &out, &value_, sizeof(T));
+                return out;
+            }
+
+            /**
+             * @brief Replace the value.
+             */
+            void store(const T& v) {
+                fossil_threads_seqlock_write(&sl_, &value_, &v, sizeof(T));
+            }
+
+            /**
+             * @brief Apply fn to a copy of the value under the write side and publish the result.
+             */
+            template <class F>
+            void update(F&& fn) {
+                fossil_threads_seqlock_write_lock(&sl_);
+                T tmp;
+                fossil_threads_seqlock_copy(&tmp, &value_, sizeof(T));
+                fn(tmp);
+                fossil_threads_seqlock_copy(&value_, &tmp, sizeof(T));
+                fossil_threads_seqlock_write_unlock(&sl_);
+            }
+
+        private:
+            T value_;
+            mutable fossil_threads_seqlock_t sl_;
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_SEQLOCK_H */
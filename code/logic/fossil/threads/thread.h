@@ -87,12 +87,22 @@ typedef struct fossil_threads_thread {
     /* --------------------------------------------------------------
     ** Timing and diagnostics
     ** -------------------------------------------------------------- */
-    unsigned long long start_time_ns; /* timestamp when thread started */
-    unsigned long long end_time_ns;   /* timestamp when thread finished */
+    unsigned long long start_time_ns; /* monotonic ns when the thread was launched */
+    unsigned long long end_time_ns;   /* monotonic ns when the thread function returned */
     unsigned long exec_time_ns;       /* derived or measured execution time */
     int   exit_code;                  /* numeric return or mapped OS exit code */
     int   error_code;                 /* last Fossil thread error code */
 
+    /* --------------------------------------------------------------
+    ** Inline start state (internal)
+    ** Lets create() and join() run without heap allocation.
+    ** -------------------------------------------------------------- */
+    fossil_threads_thread_func start_func; /* entry point, read once by the new thread */
+    void *start_arg;                       /* argument passed to start_func */
+    volatile unsigned int launched;        /* 1 once the new thread has read both */
+    volatile unsigned int exit_state;      /* completion word joiners park on */
+    void *native_storage[2];               /* POSIX pthread_t; unused on Windows */
+
     /* --------------------------------------------------------------
     ** Reserved / extension
     ** -------------------------------------------------------------- */
@@ -124,6 +134,70 @@ FOSSIL_THREADS_API int fossil_threads_thread_create(
     void *arg
 );
 
+/* ---------- Creation attributes ---------- */
+
+/* Scheduling policy requested at creation */
+enum {
+    FOSSIL_THREADS_POLICY_DEFAULT = 0, /* normal time-sharing scheduler */
+    FOSSIL_THREADS_POLICY_FIFO    = 1, /* POSIX SCHED_FIFO (usually needs privileges) */
+    FOSSIL_THREADS_POLICY_RR      = 2  /* POSIX SCHED_RR (usually needs privileges) */
+};
+
+/* -------------------------------------------------------------------------
+** Fossil Threads: Thread Creation Attributes
+**
+** Always initialize with fossil_threads_thread_attr_init() before setting
+** individual fields so that newly added attributes keep their defaults.
+** ------------------------------------------------------------------------- */
+typedef struct fossil_threads_thread_attr {
+    size_t stack_size;   /* stack bytes; 0 = platform default. Without a caller
+                            stack it is rounded up to the page size and the
+                            platform minimum (reserved, not committed, on Windows) */
+    size_t guard_size;   /* guard bytes below the stack; 0 = platform default
+                            (POSIX only, ignored with a caller stack) */
+    void  *stack;        /* caller-provided stack of stack_size bytes, or NULL;
+                            must stay valid until the thread is joined or has
+                            finished (POSIX only). The C library may place the
+                            thread descriptor and static TLS inside it, and
+                            sanitizer runtimes need more still, so size it
+                            well above PTHREAD_STACK_MIN (1 MiB is safe) */
+    int    detached;     /* 1 to start detached: join() is rejected */
+    int    priority;     /* initial priority, same scale as set_priority() */
+    int    policy;       /* FOSSIL_THREADS_POLICY_* */
+} fossil_threads_thread_attr_t;
+
+/*
+ * Initialize creation attributes to defaults (platform stack, joinable,
+ * normal priority and policy).
+ * @param attr Pointer to the attribute structure.
+ */
+FOSSIL_THREADS_API void fossil_threads_thread_attr_init(
+    fossil_threads_thread_attr_t *attr
+);
+
+/*
+ * Create a new thread with explicit attributes.
+ * Behaves like fossil_threads_thread_create() when attr is NULL. The
+ * chosen priority and policy are recorded in thread->priority and
+ * thread->policy.
+ *
+ * @param thread Pointer to the thread structure to initialize.
+ * @param attr   Creation attributes, or NULL for defaults.
+ * @param func   Function pointer to the thread entry point.
+ * @param arg    Argument to pass to the thread function.
+ * @return 0 on success; FOSSIL_THREADS_EINVAL for a malformed attribute or
+ *         a caller stack the platform rejects, FOSSIL_THREADS_EPERM when
+ *         the policy needs privileges the process lacks,
+ *         FOSSIL_THREADS_EUNSUPPORTED for a caller stack or real-time
+ *         policy on Windows, or another error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_thread_create_ex(
+    fossil_threads_thread_t *thread,
+    const fossil_threads_thread_attr_t *attr,
+    fossil_threads_thread_func func,
+    void *arg
+);
+
 /**
  * Join a thread.
  * Waits for the specified thread to finish execution. Optionally retrieves the
@@ -138,6 +212,24 @@ FOSSIL_THREADS_API int fossil_threads_thread_join(
     void **retval
 );
 
+/**
+ * Join a thread, giving up after a timeout.
+ * Parks on the thread's completion word, so the caller wakes as soon as the
+ * thread function returns rather than at the next polling tick. On timeout
+ * the thread is left untouched and may be joined again later.
+ *
+ * @param thread     Pointer to the thread structure.
+ * @param retval     Pointer to receive the thread's return value (may be NULL).
+ * @param timeout_ms Timeout in milliseconds; 0 only checks.
+ * @return           0 on success, FOSSIL_THREADS_ETIMEDOUT if the thread is
+ *                   still running, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_thread_timedjoin(
+    fossil_threads_thread_t *thread,
+    void **retval,
+    unsigned int timeout_ms
+);
+
 /**
  * Detach a thread.
  * Marks the thread as detached, releasing resources when it finishes.
@@ -163,8 +255,9 @@ FOSSIL_THREADS_API void fossil_threads_thread_init(
 
 /**
  * Dispose of a thread structure.
- * Cleans up any resources associated with the thread structure.
- * Does not join or detach running threads.
+ * Cleans up any resources associated with the thread structure. A joinable
+ * thread is joined; for a detached one this parks until its function has
+ * returned, so the structure can be reused as soon as this returns.
  *
  * @param thread Pointer to the thread structure to dispose.
  */
@@ -263,6 +356,72 @@ FOSSIL_THREADS_API void* fossil_threads_thread_get_retval(
     const fossil_threads_thread_t *thread
 );
 
+/* ---------- CPU affinity and topology ---------- */
+
+/*
+ * Pin a thread to a set of CPUs.
+ * CPU ids are the ones listed by fossil_threads_numa_node_cpus(). On Linux
+ * the set is a hard mask; on Windows every CPU must belong to the same
+ * processor group; on macOS the first CPU becomes a mach affinity tag, a
+ * hint that keeps equally tagged threads on one cache domain.
+ * @param thread Pointer to a started thread, or NULL for the calling thread.
+ *               A detached thread keeps no handle, so it can only pin itself.
+ * @param cpus   CPU ids to allow.
+ * @param count  Number of entries in cpus (must be > 0).
+ * @return 0 on success, FOSSIL_THREADS_ENOTSTARTED, FOSSIL_THREADS_EFINISHED
+ *         once the thread has returned, FOSSIL_THREADS_EDETACHED for a
+ *         detached thread, FOSSIL_THREADS_EINVAL, FOSSIL_THREADS_EOSFAIL if
+ *         the OS rejects the set, or FOSSIL_THREADS_EUNSUPPORTED on
+ *         platforms without affinity control.
+ */
+FOSSIL_THREADS_API int fossil_threads_thread_set_affinity(
+    fossil_threads_thread_t *thread,
+    const unsigned int *cpus,
+    size_t count
+);
+
+/*
+ * Number of CPUs this process may run on.
+ * @return CPU count (at least 1).
+ */
+FOSSIL_THREADS_API size_t fossil_threads_cpu_count(void);
+
+/*
+ * CPU the calling thread is running on right now.
+ * @return CPU id, or -1 if the platform cannot tell.
+ */
+FOSSIL_THREADS_API int fossil_threads_cpu_current(void);
+
+/*
+ * Number of NUMA nodes holding CPUs this process may run on.
+ * Nodes are numbered densely from 0; without NUMA information the whole
+ * machine is reported as node 0.
+ * @return Node count (at least 1).
+ */
+FOSSIL_THREADS_API size_t fossil_threads_numa_node_count(void);
+
+/*
+ * NUMA node of a CPU.
+ * @param cpu CPU id.
+ * @return Node index, or -1 if the CPU is not usable by this process.
+ */
+FOSSIL_THREADS_API int fossil_threads_numa_node_of_cpu(
+    unsigned int cpu
+);
+
+/*
+ * List the usable CPUs of a NUMA node.
+ * @param node Node index (< fossil_threads_numa_node_count()).
+ * @param cpus Receives up to max CPU ids in ascending order (may be NULL).
+ * @param max  Capacity of cpus.
+ * @return Number of CPUs on the node (may exceed max), 0 for a bad node.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_numa_node_cpus(
+    size_t node,
+    unsigned int *cpus,
+    size_t max
+);
+
 /* ============================================================================
 ** Fossil Threads Error Codes
 ** Mirrors common errno / GetLastError() semantics,
@@ -318,11 +477,275 @@ enum {
     FOSSIL_THREADS_EPARTIAL      = 254  /* partial or best-effort implementation */
 };
 
+/* ---------- Thread Group API ---------- */
+
+/* Opaque group of threads started and joined together */
+typedef struct fossil_threads_group fossil_threads_group_t;
+
+/* Group member entry point: receives its index in [0, count) and the
+ * context shared by the whole group */
+typedef void *(*fossil_threads_group_func)(size_t index, void *ctx);
+
+/*
+ * Start count threads running func as one group.
+ *
+ * The group and every member's thread object come from one allocation.
+ * Members are all created first and held at a start gate, then released
+ * together by a single wake, so no member runs before the last one exists.
+ * If a create fails, the members already launched are released without
+ * calling func and joined before the error is returned. attr applies to
+ * every member; it may not request a detached start, and a caller stack
+ * only works for a group of one.
+ *
+ * @param group Receives the group handle (NULL on failure).
+ * @param count Number of threads (> 0).
+ * @param attr  Creation attributes shared by all members, or NULL.
+ * @param func  Member entry point.
+ * @param ctx   Context passed to every member.
+ * @return 0 on success, FOSSIL_THREADS_EINVAL on invalid arguments,
+ *         FOSSIL_THREADS_ENOMEM, or the error from creating a member.
+ */
+FOSSIL_THREADS_API int fossil_threads_group_create(
+    fossil_threads_group_t **group,
+    size_t count,
+    const fossil_threads_thread_attr_t *attr,
+    fossil_threads_group_func func,
+    void *ctx
+);
+
+/*
+ * Wait for every member of the group to finish.
+ *
+ * The caller sleeps on one shared counter that the last member to return
+ * wakes, rather than joining each thread in turn, then reaps the finished
+ * threads. Joining again returns the same results immediately. Call from
+ * one thread at a time.
+ *
+ * @param group Group handle.
+ * @param results Optional array of fossil_threads_group_size() entries
+ *                receiving each member's return value, or NULL.
+ * @return 0 on success, FOSSIL_THREADS_EINVAL if group is NULL.
+ */
+FOSSIL_THREADS_API int fossil_threads_group_join(
+    fossil_threads_group_t *group,
+    void **results
+);
+
+/*
+ * Get the number of threads in the group.
+ * @param group Group handle.
+ * @return Member count, or 0 for NULL.
+ */
+FOSSIL_THREADS_API size_t fossil_threads_group_size(
+    const fossil_threads_group_t *group
+);
+
+/*
+ * Get a member's thread object, e.g. to set its affinity or priority.
+ * The object belongs to the group: do not join, detach or dispose it.
+ *
+ * @param group Group handle.
+ * @param index Member index.
+ * @return Thread object, or NULL if index is out of range.
+ */
+FOSSIL_THREADS_API fossil_threads_thread_t *fossil_threads_group_thread(
+    fossil_threads_group_t *group,
+    size_t index
+);
+
+/*
+ * Join the group if that has not happened yet, then free it.
+ * @param group Group handle (NULL is ignored).
+ */
+FOSSIL_THREADS_API void fossil_threads_group_destroy(
+    fossil_threads_group_t *group
+);
+
 /* ---------- Thread Pool API ---------- */
 
 /* Forward declaration for thread pool handle */
 typedef struct fossil_threads_pool fossil_threads_pool_t;
 
+/* -------------------------------------------------------------------------
+** Fossil Threads: Pool Task Node
+**
+** The pool links tasks through these nodes. fossil_threads_pool_submit()
+** takes them from a slab owned by the pool; fossil_threads_pool_submit_task()
+** lets the caller embed one in its own object so submission never touches
+** the heap. Fields are managed by the pool and must not be modified while
+** the task is queued.
+** ------------------------------------------------------------------------- */
+typedef struct fossil_threads_pool_task {
+    fossil_threads_thread_func func;        /* task entry point */
+    void *arg;                              /* argument passed to func */
+    struct fossil_threads_pool_task *next;  /* queue / free-list link */
+    unsigned int flags;                     /* ownership flags (internal) */
+    unsigned int stamp;                     /* enqueue time, elastic pools (internal) */
+    long long deadline_ns;                  /* deadline queue key (internal) */
+} fossil_threads_pool_task_t;
+
+/* Opaque future handle returned by fossil_threads_pool_submit_future() */
+typedef struct fossil_threads_pool_future fossil_threads_pool_future_t;
+
+/* Continuation: receives its context and the result of the future it follows */
+typedef void *(*fossil_threads_pool_then_func)(void *ctx, void *result);
+
+/* Pool scheduler kinds */
+enum {
+    FOSSIL_THREADS_POOL_SCHED_SHARED        = 0, /* single shared FIFO queue (default) */
+    FOSSIL_THREADS_POOL_SCHED_WORK_STEALING = 1, /* per-worker deques with stealing */
+    FOSSIL_THREADS_POOL_SCHED_BOUNDED       = 2  /* bounded lock-free MPMC ring */
+};
+
+/* What submit does when a bounded pool queue is full */
+enum {
+    FOSSIL_THREADS_POOL_FULL_BLOCK      = 0, /* wait for a free slot (default) */
+    FOSSIL_THREADS_POOL_FULL_FAIL       = 1, /* return FOSSIL_THREADS_EBUSY */
+    FOSSIL_THREADS_POOL_FULL_RUN_CALLER = 2  /* run the task on the submitting thread */
+};
+
+/* Priority classes for fossil_threads_pool_submit_priority() */
+enum {
+    FOSSIL_THREADS_POOL_PRIORITY_HIGH   = 0, /* latency critical */
+    FOSSIL_THREADS_POOL_PRIORITY_NORMAL = 1, /* plain submits */
+    FOSSIL_THREADS_POOL_PRIORITY_LOW    = 2, /* bulk and background work */
+    FOSSIL_THREADS_POOL_PRIORITY_COUNT  = 3
+};
+
+/* Where pool workers run */
+enum {
+    FOSSIL_THREADS_POOL_PLACE_NONE = 0, /* leave workers to the OS scheduler (default) */
+    FOSSIL_THREADS_POOL_PLACE_CORE = 1, /* pin worker i to the i-th usable CPU */
+    FOSSIL_THREADS_POOL_PLACE_NODE = 2  /* pin workers round-robin to whole NUMA nodes */
+};
+
+/* -------------------------------------------------------------------------
+** Fossil Threads: Pool Creation Options
+**
+** Always initialize with fossil_threads_pool_options_init() before setting
+** individual fields so that newly added options keep their defaults.
+** ------------------------------------------------------------------------- */
+typedef struct fossil_threads_pool_options {
+    size_t num_threads;        /* number of worker threads (must be > 0) */
+    int    scheduler;          /* FOSSIL_THREADS_POOL_SCHED_* */
+    size_t deque_capacity;     /* per-worker deque slots, rounded up to a power
+                                  of two (work stealing only; 0 = default) */
+    size_t task_slab_size;     /* task nodes preallocated at creation; once
+                                  exhausted, submit falls back to malloc
+                                  (0 = always malloc) */
+    size_t queue_capacity;     /* ring slots, rounded up to a power of two
+                                  (bounded scheduler only; 0 = default) */
+    int    full_policy;        /* FOSSIL_THREADS_POOL_FULL_* (bounded only) */
+    size_t future_slab_size;   /* future states preallocated at creation and
+                                  recycled; beyond that futures use malloc
+                                  (0 = always malloc) */
+    int    placement;          /* FOSSIL_THREADS_POOL_PLACE_* */
+    int    stats;              /* nonzero to collect per-worker runtime
+                                  counters (see fossil_threads_pool_stats) */
+    size_t min_threads;        /* workers kept when idle (0 = num_threads) */
+    size_t max_threads;        /* upper bound for growth (0 = num_threads) */
+    unsigned int keep_alive_ms;   /* idle time before a worker above
+                                     min_threads retires (0 = never) */
+    unsigned int grow_latency_us; /* queue wait that adds a worker, up to
+                                     max_threads (0 = only on resize) */
+    unsigned int aging_limit;  /* times a queued class may be passed over
+                                  before it is served anyway (0 = strict) */
+    void (*local_destructor)(void *local); /* run on a worker's non-NULL
+                                  local slot when it exits (NULL = none) */
+    size_t arena_size;         /* first chunk of each worker's task arena,
+                                  allocated on first use (0 = default) */
+    int    arena_huge_pages;   /* nonzero to back task arenas with huge
+                                  pages where the OS provides them */
+    unsigned int idle_spin_us;  /* an idle worker polls for work this long
+                                   before parking (0 = park at once) */
+    unsigned int idle_yield_us; /* then polls yielding the CPU this long */
+    unsigned int idle_spinners; /* most workers polling at once
+                                   (0 = half the workers, at least one) */
+} fossil_threads_pool_options_t;
+
+/* Per-worker counters reported by fossil_threads_pool_stats() */
+typedef struct fossil_threads_pool_worker_stats {
+    unsigned long long tasks_executed; /* task bodies run by this worker */
+    unsigned long long steals;         /* tasks taken from another worker's deque */
+    unsigned long long wakeups;        /* times the worker was woken from a park */
+    unsigned long long busy_ns;        /* monotonic ns spent inside task bodies */
+    unsigned long long idle_ns;        /* monotonic ns spent parked waiting for work */
+    unsigned long long spin_hits;      /* tasks found while polling, without parking */
+    size_t deque_high_water;           /* deepest own deque seen (work stealing) */
+} fossil_threads_pool_worker_stats_t;
+
+/* Pool-wide snapshot filled by fossil_threads_pool_stats() */
+typedef struct fossil_threads_pool_stats {
+    int    enabled;                    /* counters are collected (opts.stats) */
+    size_t num_workers;                /* worker slots (max_threads); retired
+                                          slots keep their counters */
+    size_t active_workers;             /* worker threads running right now */
+    size_t pending;                    /* tasks queued or running right now */
+    size_t queue_high_water;           /* deepest shared list or ring seen */
+    unsigned long long uptime_ns;      /* monotonic ns since the pool was created */
+    fossil_threads_pool_worker_stats_t total; /* sums over all workers;
+                                                 deque_high_water is the maximum */
+} fossil_threads_pool_stats_t;
+
+/*
+ * Initialize pool options to defaults (one worker, shared scheduler).
+ * @param opts Pointer to options structure.
+ */
+FOSSIL_THREADS_API void fossil_threads_pool_options_init(
+    fossil_threads_pool_options_t *opts
+);
+
+/*
+ * Create a thread pool from an options structure.
+ *
+ * With FOSSIL_THREADS_POOL_SCHED_WORK_STEALING every worker owns a deque:
+ * tasks submitted from inside a running task go to the submitting worker's
+ * deque and are executed newest-first by that worker, while idle workers
+ * steal the oldest entries from other deques. Tasks submitted from outside
+ * the pool (or when a deque is full) go to the shared injection queue.
+ *
+ * With FOSSIL_THREADS_POOL_SCHED_BOUNDED all tasks go through a fixed-size
+ * lock-free ring; submit never takes a lock unless a worker is asleep, and
+ * a full ring applies opts->full_policy. A worker submitting into its own
+ * full pool always runs the task itself rather than block, since blocking
+ * every worker that way would deadlock the pool.
+ *
+ * With a placement other than FOSSIL_THREADS_POOL_PLACE_NONE each worker
+ * pins itself before it touches any pool memory. CPUs are taken node by
+ * node, so PLACE_CORE fills one node before moving to the next. The task
+ * slab is split into one segment per node, first touched by a worker of
+ * that node so the OS backs it with local memory, and submitters take nodes
+ * from their own node's segment first. Work-stealing deques are likewise
+ * allocated by their pinned owner, and idle workers steal from workers of
+ * their own node before crossing to another one. Pinning is best effort: a
+ * platform without affinity control still runs the pool unpinned.
+ *
+ * A pool created with min_threads below max_threads is elastic. It starts
+ * num_threads workers and keeps room for max_threads. When a task waited
+ * longer than grow_latency_us in the queue, or no worker took a task for
+ * that long while every worker is busy, one more worker is started (at
+ * most one per grow_latency_us). A worker idle for keep_alive_ms while
+ * more than min_threads run exits; fossil_threads_pool_destroy() joins
+ * retired and running workers alike. A fixed pool (the default) never
+ * reads the clock for this.
+ *
+ * An idle worker normally parks at once, and a task submitted to an idle
+ * pool pays for a kernel wakeup. With idle_spin_us set, up to
+ * idle_spinners idle workers first poll the queues for that long, then
+ * for idle_yield_us more while yielding the CPU, and park only after
+ * that. A task that arrives meanwhile starts without any wakeup. Submits
+ * wake no parked worker for work a spinner will take. A spinner that
+ * finds work with more still queued wakes a single parked worker, so a
+ * burst brings workers in one at a time. This trades idle CPU time for
+ * dispatch latency; the default (0) never spins.
+ *
+ * @param opts Pool options (see fossil_threads_pool_options_init).
+ * @return Pointer to thread pool, or NULL on failure or invalid options.
+ */
+FOSSIL_THREADS_API fossil_threads_pool_t* fossil_threads_pool_create_ex(
+    const fossil_threads_pool_options_t *opts
+);
+
 /*
  * Create a thread pool.
  * @param num_threads Number of worker threads.
@@ -334,6 +757,9 @@ FOSSIL_THREADS_API fossil_threads_pool_t* fossil_threads_pool_create(
 
 /*
  * Destroy a thread pool.
+ * Workers finish their current task and exit; tasks still queued are
+ * discarded. A discarded future's task is cancelled: its waiters return
+ * FOSSIL_THREADS_ECANCELLED and its continuations are cancelled too.
  * @param pool Pointer to thread pool.
  */
 FOSSIL_THREADS_API void fossil_threads_pool_destroy(
@@ -345,7 +771,8 @@ FOSSIL_THREADS_API void fossil_threads_pool_destroy(
  * @param pool Pointer to thread pool.
  * @param func Task function (same signature as thread entry).
  * @param arg Argument to pass to the task function.
- * @return 0 on success, error code otherwise.
+ * @return 0 on success, FOSSIL_THREADS_EBUSY when a bounded queue is full
+ *         under FOSSIL_THREADS_POOL_FULL_FAIL, error code otherwise.
  */
 FOSSIL_THREADS_API int fossil_threads_pool_submit(
     fossil_threads_pool_t *pool,
@@ -354,64 +781,557 @@ FOSSIL_THREADS_API int fossil_threads_pool_submit(
 );
 
 /*
- * Wait for all tasks in the pool to finish.
+ * Submit a task with a priority class.
+ *
+ * The shared queue keeps one FIFO list per class plus a deadline queue
+ * (see fossil_threads_pool_submit_deadline) and serves the deadline queue,
+ * then HIGH, NORMAL and LOW. A non-empty class that has been passed over
+ * opts.aging_limit times is served next regardless, so urgent traffic
+ * delays background work without starving it. Workers of the work-stealing
+ * and bounded schedulers look at the shared queue before their own deque
+ * or the ring while deadline or HIGH tasks are waiting there.
+ *
+ * NORMAL takes the same path as fossil_threads_pool_submit(). Other
+ * classes always go to the shared queue: they bypass work-stealing deques
+ * and the bounded ring, and with it the ring's full policy.
+ *
+ * @param pool Pointer to thread pool.
+ * @param func Task function.
+ * @param arg Argument to pass to the task function.
+ * @param priority FOSSIL_THREADS_POOL_PRIORITY_* class.
+ * @return 0 on success, FOSSIL_THREADS_EINVAL for an unknown class, error
+ *         code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_submit_priority(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    int priority
+);
+
+/*
+ * Submit a task with a deadline.
+ *
+ * Deadline tasks sit in their own queue, ordered earliest deadline first,
+ * which ranks above FOSSIL_THREADS_POOL_PRIORITY_HIGH and is aged like the
+ * priority classes. The deadline only orders the queue: a task whose
+ * deadline has passed still runs. Like non-NORMAL priorities, deadline
+ * tasks always go to the shared queue.
+ *
+ * @param pool Pointer to thread pool.
+ * @param func Task function.
+ * @param arg Argument to pass to the task function.
+ * @param deadline_ns Absolute deadline on the fossil_threads_clock_monotonic_ns clock.
+ * @return 0 on success, FOSSIL_THREADS_ENOMEM if the deadline queue could
+ *         not grow, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_submit_deadline(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    long long deadline_ns
+);
+
+/*
+ * Submit a task using a caller-provided node (no allocation).
+ *
+ * The node is typically embedded in the object passed as arg. It must stay
+ * valid until func starts running; the pool does not touch the node once
+ * func has been called, so func may free the enclosing object or submit
+ * the same node again. A node must not be submitted twice while queued.
+ *
+ * @param pool Pointer to thread pool.
+ * @param task Caller-owned task node.
+ * @param func Task function.
+ * @param arg  Argument to pass to the task function.
+ * @return 0 on success, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_submit_task(
+    fossil_threads_pool_t *pool,
+    fossil_threads_pool_task_t *task,
+    fossil_threads_thread_func func,
+    void *arg
+);
+
+/*
+ * Submit several tasks at once.
+ *
+ * Task nodes for the whole batch are allocated first, then linked into the
+ * queue under a single lock acquisition (or claimed with a single CAS on a
+ * bounded ring), waking only as many idle workers as there are new tasks.
+ * Tasks from a work-stealing worker go to its own deque, overflowing to the
+ * shared queue. On FOSSIL_THREADS_ENOMEM or FOSSIL_THREADS_EINVAL nothing
+ * was submitted; with FOSSIL_THREADS_POOL_FULL_FAIL a batch that does not
+ * fit in the bounded ring is rejected whole with FOSSIL_THREADS_EBUSY.
+ *
+ * @param pool  Pointer to thread pool.
+ * @param funcs Array of count task functions (none may be NULL).
+ * @param args  Array of count arguments, or NULL to pass NULL to every task.
+ * @param count Number of tasks in the batch.
+ * @return 0 on success, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_submit_batch(
+    fossil_threads_pool_t *pool,
+    const fossil_threads_thread_func *funcs,
+    void *const *args,
+    size_t count
+);
+
+/*
+ * Submit a task and get a future for its return value.
+ *
+ * The future's state comes from storage recycled by the pool, and the
+ * task itself is queued through a node embedded in it, so the common path
+ * allocates nothing. Every future must be released with
+ * fossil_threads_pool_future_release(). A handle outlives its pool: after
+ * fossil_threads_pool_destroy() it may still be waited on, queried and
+ * released, but not chained onto.
+ *
  * @param pool Pointer to thread pool.
+ * @param func Task function; its return value becomes the future's result.
+ * @param arg  Argument to pass to the task function.
+ * @param out  Receives the future handle (NULL on failure).
+ * @return 0 on success, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_submit_future(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    fossil_threads_pool_future_t **out
+);
+
+/*
+ * Chain a continuation onto a future.
+ *
+ * Once future completes, func(ctx, result) is queued on the same pool and
+ * its return value becomes the result of the new future. If future has
+ * already completed, the continuation is queued immediately. If future
+ * was cancelled, the continuation is cancelled too without running. The
+ * original handle may be released right after this call.
+ *
+ * @param future Future to continue from.
+ * @param func   Continuation function.
+ * @param ctx    Context passed to func.
+ * @param out    Receives the continuation's future (NULL on failure).
  * @return 0 on success, error code otherwise.
  */
+FOSSIL_THREADS_API int fossil_threads_pool_future_then(
+    fossil_threads_pool_future_t *future,
+    fossil_threads_pool_then_func func,
+    void *ctx,
+    fossil_threads_pool_future_t **out
+);
+
+/*
+ * Block until the future's task has finished.
+ *
+ * Called from a worker of the same pool, the caller runs other queued
+ * tasks while it waits instead of sleeping.
+ *
+ * @param future Future to wait on.
+ * @param result Receives the task's return value (may be NULL).
+ * @return 0 on success, FOSSIL_THREADS_ECANCELLED if the task was dropped
+ *         (pool shutdown, cancelled parent), error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_future_wait(
+    fossil_threads_pool_future_t *future,
+    void **result
+);
+
+/*
+ * Fetch the result without blocking.
+ * @param future Future to query.
+ * @param result Receives the task's return value when ready (may be NULL).
+ * @return 0 if finished, FOSSIL_THREADS_EBUSY if still pending,
+ *         FOSSIL_THREADS_ECANCELLED if cancelled, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_future_try_get(
+    const fossil_threads_pool_future_t *future,
+    void **result
+);
+
+/*
+ * Release a future handle. The task keeps running if it has not finished;
+ * its state is recycled once both the handle and the task are done.
+ * @param future Future to release (NULL is ignored).
+ */
+FOSSIL_THREADS_API void fossil_threads_pool_future_release(
+    fossil_threads_pool_future_t *future
+);
+
+/*
+ * Wait for all tasks in the pool to finish.
+ *
+ * Blocks until every task submitted so far, including tasks they submit
+ * in turn, has returned (not merely been dequeued). The caller sleeps and
+ * is woken directly by the worker completing the last task.
+ *
+ * @param pool Pointer to thread pool.
+ * @return 0 on success, FOSSIL_THREADS_EDEADLK when called from one of the
+ *         pool's own workers, error code otherwise.
+ */
 FOSSIL_THREADS_API int fossil_threads_pool_wait(
     fossil_threads_pool_t *pool
 );
 
+/*
+ * Get the number of in-flight tasks (queued plus currently running).
+ * @param pool Pointer to thread pool.
+ * @return Number of tasks not yet finished (snapshot).
+ */
+FOSSIL_THREADS_API size_t fossil_threads_pool_pending(
+    const fossil_threads_pool_t *pool
+);
+
 /*
  * Get number of threads in the pool.
  * @param pool Pointer to thread pool.
- * @return Number of threads.
+ * @return Number of worker threads currently running (snapshot).
  */
 FOSSIL_THREADS_API size_t fossil_threads_pool_size(
     const fossil_threads_pool_t *pool
 );
 
-#ifdef __cplusplus
-}
-#include <stdexcept>
-#include <utility>
+/*
+ * Set the number of worker threads.
+ *
+ * Growing starts the missing workers before returning. Shrinking lets the
+ * surplus workers retire as they next run out of work, so the pool may
+ * briefly stay larger. A count below min_threads lowers min_threads to
+ * it; workers above min_threads still retire after keep_alive_ms idle.
+ *
+ * @param pool Pointer to thread pool.
+ * @param num_threads New worker count, 1 to the pool's max_threads.
+ * @return 0 on success, FOSSIL_THREADS_EINVAL for a count out of range,
+ *         FOSSIL_THREADS_ECANCELLED once the pool is being destroyed, or the
+ *         error from starting a worker (workers already started stay).
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_resize(
+    fossil_threads_pool_t *pool,
+    size_t num_threads
+);
 
-namespace fossil {
+/*
+ * Get the scheduler kind the pool was created with.
+ * @param pool Pointer to thread pool.
+ * @return FOSSIL_THREADS_POOL_SCHED_* value, or FOSSIL_THREADS_EINVAL.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_scheduler(
+    const fossil_threads_pool_t *pool
+);
 
-    namespace threads {
+/*
+ * Take a snapshot of the pool's runtime counters.
+ *
+ * Counters are only collected when the pool was created with opts.stats
+ * set; otherwise every counter reads zero and stats->enabled is 0. Each
+ * worker keeps its own counters on a separate cache line and updates them
+ * without atomic read-modify-write, so collection costs two clock reads
+ * per task and per park. The snapshot is not atomic across workers: values
+ * are each current at some point during the call. Busy time counts whole
+ * task bodies, including time a task spends blocked inside them; tasks run
+ * by a non-worker thread (FOSSIL_THREADS_POOL_FULL_RUN_CALLER from outside
+ * the pool) are not counted. Timestamps come from the monotonic clock.
+ *
+ * @param pool Pointer to thread pool.
+ * @param stats Receives the pool-wide snapshot and per-worker totals.
+ * @param workers Optional array receiving per-worker counters, may be NULL
+ *                when max_workers is 0.
+ * @param max_workers Capacity of workers; entries beyond the pool size are
+ *                    left untouched.
+ * @return 0 on success, FOSSIL_THREADS_EINVAL on invalid arguments.
+ */
+FOSSIL_THREADS_API int fossil_threads_pool_stats(
+    const fossil_threads_pool_t *pool,
+    fossil_threads_pool_stats_t *stats,
+    fossil_threads_pool_worker_stats_t *workers,
+    size_t max_workers
+);
 
-        /**
-         * @brief C++ wrapper for fossil_threads_thread_t.
-         *
-         * Provides a RAII-style interface for thread management using the Fossil Logic thread API.
-         * Disallows copy semantics; supports move semantics.
-         */
-        class Thread {
-        public:
-            /**
-             * @brief Thread entry point function type.
-             * Signature matches fossil_threads_thread_func.
-             */
-            using Func = void*(*)(void*);
+/* ---------- Worker-Local Storage ---------- */
 
-            /**
-             * @brief Default constructor.
-             * Initializes the thread structure to a safe state; does not start a thread.
-             */
-            Thread() {
-                fossil_threads_thread_init(&native_);
-            }
+/*
+ * Address of the calling pool worker's local slot.
+ *
+ * Each worker thread owns one pointer-sized slot that starts NULL and keeps
+ * its value across every task the worker runs, so tasks can cache scratch
+ * buffers or other per-worker state there with no lock and no lookup. When
+ * the worker thread exits (pool destruction, or retirement of an elastic
+ * pool's surplus worker) opts.local_destructor runs on a non-NULL value; a
+ * worker started later in the same place begins with NULL again. The
+ * destructor runs after the thread stops being a worker, so it may submit
+ * to or resize the pool like any other thread.
+ *
+ * @return Pointer to the slot, or NULL when the caller is not a pool worker
+ *         (for example a submitter running a task under
+ *         FOSSIL_THREADS_POOL_FULL_RUN_CALLER).
+ */
+FOSSIL_THREADS_API void **fossil_threads_pool_worker_local(void);
 
-            /**
-             * @brief Construct and start a thread.
-             * Initializes and creates a new thread executing the given function.
-             * @param func Function pointer to thread entry.
-             * @param arg Argument to pass to thread function (default nullptr).
-             * @throws std::runtime_error on failure.
-             */
-            explicit Thread(Func func, void* arg = nullptr) {
-                fossil_threads_thread_init(&native_);
-                if (fossil_threads_thread_create(&native_, func, arg) != 0) {
+/*
+ * Allocate size bytes from the calling worker's task arena.
+ *
+ * The arena is a bump allocator owned by the worker thread, so allocation
+ * takes no lock and touches no shared memory. Nothing is freed one by one:
+ * everything a task allocated is released when the task returns. A task
+ * run nested inside another (while helping from a wait) releases only its
+ * own allocations. Memory is aligned for any fundamental type.
+ *
+ * @param size Bytes wanted (0 is treated as 1).
+ * @return Memory valid until the running task returns or calls
+ *         fossil_threads_pool_task_reset(), or NULL when out of memory or
+ *         when the caller is not a pool worker.
+ */
+FOSSIL_THREADS_API void *fossil_threads_pool_task_alloc(size_t size);
+
+/*
+ * Like fossil_threads_pool_task_alloc() with an explicit alignment.
+ *
+ * @param size      Bytes wanted (0 is treated as 1).
+ * @param alignment Power of two.
+ * @return Aligned memory, or NULL on invalid alignment, out of memory, or
+ *         outside a pool worker.
+ */
+FOSSIL_THREADS_API void *fossil_threads_pool_task_alloc_aligned(size_t size, size_t alignment);
+
+/*
+ * Release everything the running task has allocated from its worker's
+ * arena so far, for long tasks that work in rounds. No-op outside a pool
+ * worker.
+ */
+FOSSIL_THREADS_API void fossil_threads_pool_task_reset(void);
+
+/* ---------- Fibers ---------- */
+
+/* Opaque fiber handle returned by fossil_threads_fiber_spawn() */
+typedef struct fossil_threads_fiber fossil_threads_fiber_t;
+
+/* Fiber stack sizes in bytes */
+#define FOSSIL_THREADS_FIBER_STACK_DEFAULT (128u * 1024u)
+#define FOSSIL_THREADS_FIBER_STACK_MIN     (16u * 1024u)
+
+/*
+ * Run func(arg) as a fiber on the pool's workers.
+ *
+ * A fiber is a pool task with a stack of its own. When it yields, joins
+ * another fiber or waits on a future it switches back to its worker,
+ * which goes on with other tasks; the fiber is queued again once it can
+ * continue and may resume on a different worker. Far more fibers than
+ * workers can therefore wait at the same time without holding a thread
+ * each. fossil_threads_pool_future_wait() called on a fiber suspends it
+ * the same way as fossil_threads_fiber_await().
+ *
+ * @param pool       Pool whose workers run the fiber.
+ * @param func       Fiber body; its return value is the fiber's result.
+ * @param arg        Argument passed to func.
+ * @param stack_size Stack bytes; 0 selects FOSSIL_THREADS_FIBER_STACK_DEFAULT
+ *                   and smaller values are raised to FOSSIL_THREADS_FIBER_STACK_MIN.
+ * @param out        Receives the handle for fossil_threads_fiber_join(), or
+ *                   NULL to let the fiber release itself when it finishes.
+ * @return 0 on success, FOSSIL_THREADS_EUNSUPPORTED where the platform has
+ *         no user-mode context switch, error code otherwise.
+ *
+ * Notes: anything tied to the running thread (thread ids, thread-local
+ * values, fossil_threads_pool_worker_local(), task arena memory) is only
+ * stable between two suspension points. Mutexes, condition variables and
+ * channels still block the worker. All fibers must have finished before
+ * the pool is destroyed; one still running when destroy stops the pool
+ * keeps running on its worker until it returns, and a fiber awaiting a
+ * future that gets cancelled is never resumed.
+ */
+FOSSIL_THREADS_API int fossil_threads_fiber_spawn(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    size_t stack_size,
+    fossil_threads_fiber_t **out
+);
+
+/*
+ * Wait for a fiber to finish and release its handle.
+ *
+ * A fiber calling this yields until the other one is done; a worker of
+ * the same pool runs queued tasks meanwhile; any other thread blocks.
+ *
+ * @param fiber  Handle from fossil_threads_fiber_spawn().
+ * @param result Receives the fiber's return value (may be NULL).
+ * @return 0 on success, FOSSIL_THREADS_EDEADLK when a fiber joins itself,
+ *         FOSSIL_THREADS_EOSFAIL if a worker could not switch to the fiber
+ *         (it was ended there, result NULL), error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_fiber_join(fossil_threads_fiber_t *fiber, void **result);
+
+/*
+ * Let other queued tasks run, then continue the calling fiber.
+ * @return 0 on success, FOSSIL_THREADS_EPERM when not called on a fiber.
+ */
+FOSSIL_THREADS_API int fossil_threads_fiber_yield(void);
+
+/*
+ * Suspend the calling fiber until future has completed.
+ *
+ * The fiber is queued again by a continuation on the future, so no worker
+ * is held while it waits. Off a fiber this is fossil_threads_pool_future_wait().
+ *
+ * @param future Future to wait on.
+ * @param result Receives the task's return value (may be NULL).
+ * @return 0 on success, FOSSIL_THREADS_ECANCELLED if the task was dropped,
+ *         error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_fiber_await(
+    fossil_threads_pool_future_t *future,
+    void **result
+);
+
+/*
+ * Whether the caller runs on a fiber.
+ * @return Nonzero on a fiber, 0 otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_fiber_inside(void);
+
+/* ---------- Parallel Loops ---------- */
+
+/* Loop body: processes indices [begin, end) */
+typedef void (*fossil_threads_range_func)(size_t begin, size_t end, void *ctx);
+
+/* Reduction body: folds indices [begin, end) into the partial result acc */
+typedef void (*fossil_threads_reduce_func)(size_t begin, size_t end, void *acc, void *ctx);
+
+/* Reduction combiner: folds the partial result other into acc */
+typedef void (*fossil_threads_combine_func)(void *acc, const void *other, void *ctx);
+
+/*
+ * Run body over [begin, end) on the pool and the calling thread.
+ *
+ * The range is handed out in guided chunks of at least grain indices:
+ * large chunks first, shrinking toward grain as the range drains. The
+ * calling thread runs chunks too, and up to one helper task per worker is
+ * submitted as a single batch. Returns when every index has been
+ * processed. From inside a worker of the same pool the caller also runs
+ * other queued tasks while waiting for the last chunks.
+ *
+ * @param pool  Pointer to thread pool.
+ * @param begin First index.
+ * @param end   One past the last index.
+ * @param grain Minimum chunk size (0 = 1).
+ * @param body  Chunk function.
+ * @param ctx   Context passed to body.
+ * @return 0 on success, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_parallel_for(
+    fossil_threads_pool_t *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    fossil_threads_range_func body,
+    void *ctx
+);
+
+/*
+ * Reduce [begin, end) in parallel.
+ *
+ * Every participating thread starts from a copy of identity and folds its
+ * chunks into it with reduce; the partial results are then folded into
+ * result, itself starting from identity, with combine. Chunks reach a
+ * partial in no particular order, so reduce and combine must be
+ * associative and commutative. Partial results are copied with memcpy.
+ *
+ * @param pool     Pointer to thread pool.
+ * @param begin    First index.
+ * @param end      One past the last index.
+ * @param grain    Minimum chunk size (0 = 1).
+ * @param result   Receives the reduced value (size bytes).
+ * @param identity Identity value (size bytes).
+ * @param size     Size of the result type in bytes.
+ * @param reduce   Chunk reduction function.
+ * @param combine  Partial result combiner.
+ * @param ctx      Context passed to reduce and combine.
+ * @return 0 on success, error code otherwise.
+ */
+FOSSIL_THREADS_API int fossil_threads_parallel_reduce(
+    fossil_threads_pool_t *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    void *result,
+    const void *identity,
+    size_t size,
+    fossil_threads_reduce_func reduce,
+    fossil_threads_combine_func combine,
+    void *ctx
+);
+
+#ifdef __cplusplus
+}
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__has_include)
+#  if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#    define FOSSIL_THREADS_HAS_COROUTINES 1
+#  endif
+#endif
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+#include <condition_variable>
+#include <coroutine>
+#include <mutex>
+#include <optional>
+#endif
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief C++ wrapper for fossil_threads_thread_t.
+         *
+         * Provides a RAII-style interface for thread management using the Fossil Logic thread API.
+         * Disallows copy and move semantics: the native structure is kept
+         * inline, at the address the running thread was started with.
+         */
+        class Thread {
+        public:
+            /**
+             * @brief Thread entry point function type.
+             * Signature matches fossil_threads_thread_func.
+             */
+            using Func = void*(*)(void*);
+
+            /**
+             * @brief Default constructor.
+             * Initializes the thread structure to a safe state; does not start a thread.
+             */
+            Thread() {
+                fossil_threads_thread_init(&native_);
+            }
+
+            /**
+             * @brief Construct and start a thread.
+             * Initializes and creates a new thread executing the given function.
+             * @param func Function pointer to thread entry.
+             * @param arg Argument to pass to thread function (default nullptr).
+             * @throws std::runtime_error on failure.
+             */
+            explicit Thread(Func func, void* arg = nullptr) : Thread() {
+                if (fossil_threads_thread_create(&native_, func, arg) != 0) {
+                    throw std::runtime_error("Failed to create thread");
+                }
+            }
+
+            /**
+             * @brief Construct and start a thread with creation attributes.
+             * @param attr Creation attributes (see fossil_threads_thread_attr_init).
+             * @param func Function pointer to thread entry.
+             * @param arg Argument to pass to thread function (default nullptr).
+             * @throws std::runtime_error on failure.
+             */
+            Thread(const fossil_threads_thread_attr_t& attr, Func func, void* arg = nullptr) : Thread() {
+                if (fossil_threads_thread_create_ex(&native_, &attr, func, arg) != 0) {
                     throw std::runtime_error("Failed to create thread");
                 }
             }
@@ -437,29 +1357,17 @@ namespace fossil {
             Thread& operator=(const Thread&) = delete;
 
             /**
-             * @brief Move constructor.
-             * Transfers thread ownership; source is reset to default state.
-             * @param other Thread to move from.
+             * @brief Deleted move constructor.
+             * A started thread writes into the native structure until it
+             * exits, so the structure cannot be relocated.
              */
-            Thread(Thread&& other) noexcept {
-                native_ = other.native_;
-                other.native_ = {};
-            }
+            Thread(Thread&&) = delete;
 
             /**
-             * @brief Move assignment operator.
-             * Disposes current thread and transfers ownership from other.
-             * @param other Thread to move from.
-             * @return Reference to this thread.
+             * @brief Deleted move assignment operator.
+             * See the deleted move constructor.
              */
-            Thread& operator=(Thread&& other) noexcept {
-                if (this != &other) {
-                    fossil_threads_thread_dispose(&native_);
-                    native_ = other.native_;
-                    other.native_ = {};
-                }
-                return *this;
-            }
+            Thread& operator=(Thread&&) = delete;
 
             /**
              * @brief Join the thread.
@@ -471,6 +1379,17 @@ namespace fossil {
                 return fossil_threads_thread_join(&native_, retval);
             }
 
+            /**
+             * @brief Join the thread, giving up after a timeout.
+             * @param timeout_ms Timeout in milliseconds.
+             * @param retval Pointer to receive thread return value (may be nullptr).
+             * @return 0 on success, FOSSIL_THREADS_ETIMEDOUT if still running,
+             *         error code otherwise.
+             */
+            int timedjoin(unsigned int timeout_ms, void** retval = nullptr) {
+                return fossil_threads_thread_timedjoin(&native_, retval, timeout_ms);
+            }
+
             /**
              * @brief Detach the thread.
              * Marks thread as detached; resources released when finished.
@@ -565,6 +1484,55 @@ namespace fossil {
                 return fossil_threads_thread_get_priority(&native_);
             }
 
+            /**
+             * @brief Pin the thread to a set of CPUs.
+             * @param cpus CPU ids (see fossil_threads_numa_node_cpus).
+             * @return 0 on success, error code otherwise.
+             */
+            int set_affinity(const std::vector<unsigned int>& cpus) {
+                return fossil_threads_thread_set_affinity(&native_, cpus.data(), cpus.size());
+            }
+
+            /**
+             * @brief Pin the calling thread to a set of CPUs.
+             * Static utility function.
+             * @param cpus CPU ids (see fossil_threads_numa_node_cpus).
+             * @return 0 on success, error code otherwise.
+             */
+            static int set_current_affinity(const std::vector<unsigned int>& cpus) {
+                return fossil_threads_thread_set_affinity(nullptr, cpus.data(), cpus.size());
+            }
+
+            /**
+             * @brief Number of CPUs this process may run on.
+             * Static utility function.
+             * @return CPU count.
+             */
+            static size_t cpu_count() {
+                return fossil_threads_cpu_count();
+            }
+
+            /**
+             * @brief CPU the calling thread is running on.
+             * Static utility function.
+             * @return CPU id, or -1 if unknown.
+             */
+            static int current_cpu() {
+                return fossil_threads_cpu_current();
+            }
+
+            /**
+             * @brief Usable CPUs of a NUMA node.
+             * Static utility function.
+             * @param node Node index.
+             * @return CPU ids in ascending order; empty for a bad node.
+             */
+            static std::vector<unsigned int> node_cpus(size_t node) {
+                std::vector<unsigned int> cpus(fossil_threads_numa_node_cpus(node, nullptr, 0));
+                fossil_threads_numa_node_cpus(node, cpus.data(), cpus.size());
+                return cpus;
+            }
+
             /**
              * @brief Request thread cancellation (cooperative).
              * @return 0 on success, error code otherwise.
@@ -592,11 +1560,1100 @@ namespace fossil {
         private:
             /**
              * @brief Native thread structure.
-             * Holds OS-specific thread handle and state.
+             * Holds OS-specific thread handle and state; the started thread
+             * publishes its exit into it, so it stays where it is.
              */
             fossil_threads_thread_t native_{};
         };
 
+        /**
+         * @brief C++ wrapper for fossil_threads_group_t.
+         *
+         * Starts all members in the constructor; the destructor joins any
+         * member still running and frees the group.
+         * Disallows copy semantics; supports move semantics.
+         */
+        class ThreadGroup {
+        public:
+            /**
+             * @brief Member entry point type.
+             * Signature matches fossil_threads_group_func.
+             */
+            using Func = void*(*)(size_t, void*);
+
+            /**
+             * @brief Start count threads running func.
+             * @param count Number of threads.
+             * @param func Member entry point, receives its index and ctx.
+             * @param ctx Context shared by all members (default nullptr).
+             * @param attr Creation attributes for every member, or nullptr.
+             * @throws std::runtime_error on failure.
+             */
+            ThreadGroup(size_t count, Func func, void* ctx = nullptr,
+                        const fossil_threads_thread_attr_t* attr = nullptr) {
+                if (fossil_threads_group_create(&group_, count, attr, func, ctx) != FOSSIL_THREADS_OK)
+                    throw std::runtime_error("Failed to create thread group");
+            }
+
+            /**
+             * @brief Destructor.
+             * Joins the members if join() was not called, then frees the group.
+             */
+            ~ThreadGroup() {
+                fossil_threads_group_destroy(group_);
+            }
+
+            ThreadGroup(const ThreadGroup&) = delete;
+            ThreadGroup& operator=(const ThreadGroup&) = delete;
+
+            /**
+             * @brief Move constructor.
+             * @param other Group to move from; left empty.
+             */
+            ThreadGroup(ThreadGroup&& other) noexcept : group_(other.group_) {
+                other.group_ = nullptr;
+            }
+
+            /**
+             * @brief Move assignment operator.
+             * Joins and frees the current group, then takes over other's.
+             * @param other Group to move from; left empty.
+             * @return Reference to this group.
+             */
+            ThreadGroup& operator=(ThreadGroup&& other) noexcept {
+                if (this != &other) {
+                    fossil_threads_group_destroy(group_);
+                    group_ = other.group_;
+                    other.group_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Wait for every member to finish.
+             * @return Each member's return value, by index.
+             * @throws std::runtime_error on failure or after a move.
+             */
+            std::vector<void*> join() {
+                std::vector<void*> results(size());
+                if (fossil_threads_group_join(group_, results.data()) != FOSSIL_THREADS_OK)
+                    throw std::runtime_error("fossil_threads_group_join failed");
+                return results;
+            }
+
+            /**
+             * @brief Number of threads in the group.
+             * @return Member count (0 after a move).
+             */
+            size_t size() const {
+                return fossil_threads_group_size(group_);
+            }
+
+            /**
+             * @brief Get native group handle.
+             * @return Pointer to the native group, or nullptr after a move.
+             */
+            fossil_threads_group_t* native_handle() const { return group_; }
+
+        private:
+            fossil_threads_group_t* group_ = nullptr;
+        };
+
+        /**
+         * @brief C++ wrapper for fossil_threads_pool_future_t.
+         *
+         * Owns one reference to a pool future and releases it on destruction.
+         * Disallows copy semantics; supports move semantics.
+         */
+        class Future {
+        public:
+            /**
+             * @brief Continuation function type.
+             * Signature matches fossil_threads_pool_then_func.
+             */
+            using ThenFunc = void*(*)(void*, void*);
+
+            /**
+             * @brief Construct an empty future.
+             */
+            Future() = default;
+
+            /**
+             * @brief Adopt a native future handle.
+             * @param future Handle to take ownership of.
+             */
+            explicit Future(fossil_threads_pool_future_t* future) : future_(future) {}
+
+            /**
+             * @brief Destructor.
+             * Releases the handle; the task itself keeps running.
+             */
+            ~Future() {
+                fossil_threads_pool_future_release(future_);
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             * Futures cannot be copied.
+             */
+            Future(const Future&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             * Futures cannot be copied.
+             */
+            Future& operator=(const Future&) = delete;
+
+            /**
+             * @brief Move constructor.
+             * @param other Future to move from; left empty.
+             */
+            Future(Future&& other) noexcept : future_(other.future_) {
+                other.future_ = nullptr;
+            }
+
+            /**
+             * @brief Move assignment operator.
+             * Releases the current handle and takes ownership from other.
+             * @param other Future to move from; left empty.
+             * @return Reference to this future.
+             */
+            Future& operator=(Future&& other) noexcept {
+                if (this != &other) {
+                    fossil_threads_pool_future_release(future_);
+                    future_ = other.future_;
+                    other.future_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Block until the task finishes and return its result.
+             * @return Task return value.
+             * @throws std::runtime_error if the future is empty or was cancelled.
+             */
+            void* get() {
+                void* result = nullptr;
+                if (fossil_threads_pool_future_wait(future_, &result) != 0) {
+                    throw std::runtime_error("Future has no result");
+                }
+                return result;
+            }
+
+            /**
+             * @brief Block until the task finishes.
+             * @param result Receives the task return value (may be nullptr).
+             * @return 0 on success, error code otherwise.
+             */
+            int wait(void** result = nullptr) {
+                return fossil_threads_pool_future_wait(future_, result);
+            }
+
+            /**
+             * @brief Fetch the result without blocking.
+             * @param result Receives the task return value when ready (may be nullptr).
+             * @return 0 if finished, FOSSIL_THREADS_EBUSY if still pending, error code otherwise.
+             */
+            int try_get(void** result = nullptr) const {
+                return fossil_threads_pool_future_try_get(future_, result);
+            }
+
+            /**
+             * @brief Chain a continuation run with this future's result.
+             * @param func Continuation function.
+             * @param ctx Context passed to func (default nullptr).
+             * @return Future for the continuation's result.
+             * @throws std::runtime_error on failure.
+             */
+            Future then(ThenFunc func, void* ctx = nullptr) {
+                fossil_threads_pool_future_t* next = nullptr;
+                if (fossil_threads_pool_future_then(future_, func, ctx, &next) != 0) {
+                    throw std::runtime_error("Failed to chain continuation");
+                }
+                return Future(next);
+            }
+
+            /**
+             * @brief Check whether the future holds a handle.
+             * @return true if valid, false if empty.
+             */
+            bool valid() const { return future_ != nullptr; }
+
+            /**
+             * @brief Get native future handle.
+             * @return Pointer to the native future, or nullptr if empty.
+             */
+            fossil_threads_pool_future_t* native_handle() const { return future_; }
+
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+            /**
+             * @brief Awaiter returned by co_await on a Future.
+             *
+             * The awaiting coroutine is resumed by a continuation on the
+             * future, on whichever worker completes it. A cancelled future
+             * never resumes the coroutine.
+             */
+            struct Awaiter {
+                fossil_threads_pool_future_t* future;
+                void* result = nullptr;
+                int rc = FOSSIL_THREADS_EBUSY;
+
+                bool await_ready() {
+                    rc = fossil_threads_pool_future_try_get(future, &result);
+                    return rc != FOSSIL_THREADS_EBUSY;
+                }
+
+                bool await_suspend(std::coroutine_handle<> awaiting) {
+                    fossil_threads_pool_future_t* cont = nullptr;
+                    if (fossil_threads_pool_future_then(future, &Awaiter::resume, awaiting.address(), &cont) != 0)
+                        return false; /* keep running; await_resume blocks instead */
+                    fossil_threads_pool_future_release(cont);
+                    return true;
+                }
+
+                void* await_resume() {
+                    if (rc == FOSSIL_THREADS_EBUSY)
+                        rc = fossil_threads_pool_future_wait(future, &result);
+                    if (rc != 0) {
+                        throw std::runtime_error("Future has no result");
+                    }
+                    return result;
+                }
+
+                static void* resume(void* ctx, void*) {
+                    std::coroutine_handle<>::from_address(ctx).resume();
+                    return nullptr;
+                }
+            };
+
+            /**
+             * @brief Suspend the calling coroutine until the task finishes.
+             * @return Awaiter yielding the task's return value.
+             * @throws std::runtime_error (on resume) if the future is empty or was cancelled.
+             */
+            Awaiter operator co_await() const {
+                if (!future_) {
+                    throw std::runtime_error("Future has no result");
+                }
+                return Awaiter{future_};
+            }
+#endif
+
+        private:
+            fossil_threads_pool_future_t* future_ = nullptr;
+        };
+
+        /**
+         * @brief C++ wrapper for fossil_threads_pool_t.
+         *
+         * Owns the pool: the destructor stops the workers and joins them.
+         * Disallows copy semantics; supports move semantics.
+         */
+        class Pool {
+        public:
+            /**
+             * @brief Task function type.
+             * Signature matches fossil_threads_thread_func.
+             */
+            using Func = void*(*)(void*);
+
+            /**
+             * @brief Create a pool with the default shared scheduler.
+             * @param num_threads Number of worker threads.
+             * @throws std::runtime_error on failure.
+             */
+            explicit Pool(size_t num_threads)
+                : pool_(fossil_threads_pool_create(num_threads)) {
+                if (!pool_) {
+                    throw std::runtime_error("Failed to create thread pool");
+                }
+            }
+
+            /**
+             * @brief Create a pool from an options structure.
+             * @param opts Pool options (see fossil_threads_pool_options_init).
+             * @throws std::runtime_error on failure.
+             */
+            explicit Pool(const fossil_threads_pool_options_t& opts)
+                : pool_(fossil_threads_pool_create_ex(&opts)) {
+                if (!pool_) {
+                    throw std::runtime_error("Failed to create thread pool");
+                }
+            }
+
+            /**
+             * @brief Destructor.
+             * Stops the workers and destroys the pool; queued tasks are
+             * discarded and their futures cancelled.
+             */
+            ~Pool() {
+                fossil_threads_pool_destroy(pool_);
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             * Pools cannot be copied.
+             */
+            Pool(const Pool&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             * Pools cannot be copied.
+             */
+            Pool& operator=(const Pool&) = delete;
+
+            /**
+             * @brief Move constructor.
+             * Transfers pool ownership; source no longer owns a pool.
+             * @param other Pool to move from.
+             */
+            Pool(Pool&& other) noexcept : pool_(other.pool_) {
+                other.pool_ = nullptr;
+            }
+
+            /**
+             * @brief Move assignment operator.
+             * Destroys the current pool and takes ownership from other.
+             * @param other Pool to move from.
+             * @return Reference to this pool.
+             */
+            Pool& operator=(Pool&& other) noexcept {
+                if (this != &other) {
+                    fossil_threads_pool_destroy(pool_);
+                    pool_ = other.pool_;
+                    other.pool_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Submit a task.
+             * @param func Task function.
+             * @param arg Argument to pass to the task (default nullptr).
+             * @return 0 on success, error code otherwise.
+             */
+            int submit(Func func, void* arg = nullptr) {
+                return fossil_threads_pool_submit(pool_, func, arg);
+            }
+
+            /**
+             * @brief Submit a task with a priority class.
+             * @param func Task function.
+             * @param arg Argument to pass to the task.
+             * @param priority FOSSIL_THREADS_POOL_PRIORITY_* class.
+             * @return 0 on success, error code otherwise.
+             */
+            int submit_priority(Func func, void* arg, int priority) {
+                return fossil_threads_pool_submit_priority(pool_, func, arg, priority);
+            }
+
+            /**
+             * @brief Submit a task ordered by deadline.
+             * @param func Task function.
+             * @param arg Argument to pass to the task.
+             * @param deadline_ns Absolute fossil_threads_clock_monotonic_ns deadline.
+             * @return 0 on success, error code otherwise.
+             */
+            int submit_deadline(Func func, void* arg, long long deadline_ns) {
+                return fossil_threads_pool_submit_deadline(pool_, func, arg, deadline_ns);
+            }
+
+            /**
+             * @brief Submit a task using a caller-owned node (no allocation).
+             * @param task Task node, valid until func starts running.
+             * @param func Task function.
+             * @param arg Argument to pass to the task (default nullptr).
+             * @return 0 on success, error code otherwise.
+             */
+            int submit(fossil_threads_pool_task_t& task, Func func, void* arg = nullptr) {
+                return fossil_threads_pool_submit_task(pool_, &task, func, arg);
+            }
+
+            /**
+             * @brief Submit a task and get a future for its result.
+             * @param func Task function.
+             * @param arg Argument to pass to the task (default nullptr).
+             * @return Future for the task's return value.
+             * @throws std::runtime_error on failure.
+             */
+            Future submit_future(Func func, void* arg = nullptr) {
+                fossil_threads_pool_future_t* future = nullptr;
+                if (fossil_threads_pool_submit_future(pool_, func, arg, &future) != 0) {
+                    throw std::runtime_error("Failed to submit task");
+                }
+                return Future(future);
+            }
+
+            /**
+             * @brief Submit a batch from parallel arrays.
+             * @param funcs Array of count task functions.
+             * @param args Array of count arguments, or nullptr.
+             * @param count Number of tasks.
+             * @return 0 on success, error code otherwise.
+             */
+            int submit_batch(const Func* funcs, void* const* args, size_t count) {
+                return fossil_threads_pool_submit_batch(pool_, funcs, args, count);
+            }
+
+            /**
+             * @brief Submit one task per element of a range, all running func.
+             * Elements must be convertible to void*.
+             * @param func Task function shared by the batch.
+             * @param args Range of arguments.
+             * @return 0 on success, error code otherwise.
+             */
+            template <typename Range>
+            int submit_batch(Func func, const Range& args) {
+                std::vector<Func> funcs;
+                std::vector<void*> ptrs;
+                for (const auto& arg : args) {
+                    funcs.push_back(func);
+                    ptrs.push_back(static_cast<void*>(arg));
+                }
+                return fossil_threads_pool_submit_batch(pool_, funcs.data(), ptrs.data(), funcs.size());
+            }
+
+            /**
+             * @brief Submit a range of (function, argument) pairs.
+             * Elements expose .first (Func) and .second (void*-convertible).
+             * @param tasks Range of pairs.
+             * @return 0 on success, error code otherwise.
+             */
+            template <typename Range>
+            int submit_batch(const Range& tasks) {
+                std::vector<Func> funcs;
+                std::vector<void*> ptrs;
+                for (const auto& task : tasks) {
+                    funcs.push_back(task.first);
+                    ptrs.push_back(static_cast<void*>(task.second));
+                }
+                return fossil_threads_pool_submit_batch(pool_, funcs.data(), ptrs.data(), funcs.size());
+            }
+
+            /**
+             * @brief Wait until every submitted task has finished.
+             * @return 0 on success, error code otherwise.
+             */
+            int wait() {
+                return fossil_threads_pool_wait(pool_);
+            }
+
+            /**
+             * @brief Number of tasks queued or running (snapshot).
+             * @return Pending task count.
+             */
+            size_t pending() const {
+                return fossil_threads_pool_pending(pool_);
+            }
+
+            /**
+             * @brief Number of worker threads.
+             * @return Worker count.
+             */
+            size_t size() const {
+                return fossil_threads_pool_size(pool_);
+            }
+
+            /**
+             * @brief Set the number of worker threads.
+             * @param num_threads New worker count, 1 to the pool's max_threads.
+             * @throws std::runtime_error on failure.
+             */
+            void resize(size_t num_threads) {
+                if (fossil_threads_pool_resize(pool_, num_threads) != FOSSIL_THREADS_OK)
+                    throw std::runtime_error("fossil_threads_pool_resize failed");
+            }
+
+            /**
+             * @brief Scheduler kind the pool was created with.
+             * @return FOSSIL_THREADS_POOL_SCHED_* value.
+             */
+            int scheduler() const {
+                return fossil_threads_pool_scheduler(pool_);
+            }
+
+            /**
+             * @brief Snapshot of the pool's runtime counters.
+             * @param workers Optional vector resized to the worker slot count
+             *                and filled with per-worker counters.
+             * @return Pool-wide snapshot (all zero unless created with stats).
+             */
+            fossil_threads_pool_stats_t stats(
+                std::vector<fossil_threads_pool_worker_stats_t>* workers = nullptr) const {
+                fossil_threads_pool_stats_t s;
+                if (workers) {
+                    if (fossil_threads_pool_stats(pool_, &s, nullptr, 0) != FOSSIL_THREADS_OK)
+                        throw std::runtime_error("fossil_threads_pool_stats failed");
+                    workers->resize(s.num_workers);
+                }
+                int rc = fossil_threads_pool_stats(pool_, &s,
+                                                   workers ? workers->data() : nullptr,
+                                                   workers ? workers->size() : 0);
+                if (rc != FOSSIL_THREADS_OK)
+                    throw std::runtime_error("fossil_threads_pool_stats failed");
+                return s;
+            }
+
+            /**
+             * @brief Calling worker's local slot.
+             * @return Pointer to the slot, or nullptr outside a pool worker.
+             */
+            static void** worker_local() { return fossil_threads_pool_worker_local(); }
+
+            /**
+             * @brief Allocate from the calling worker's task arena.
+             * @return Memory released when the running task returns, or
+             *         nullptr outside a pool worker or when out of memory.
+             */
+            static void* task_alloc(size_t size, size_t alignment = alignof(std::max_align_t)) {
+                return fossil_threads_pool_task_alloc_aligned(size, alignment);
+            }
+
+            /**
+             * @brief Release the running task's arena allocations so far.
+             */
+            static void task_reset() { fossil_threads_pool_task_reset(); }
+
+            /**
+             * @brief Get native pool handle.
+             * @return Pointer to the native pool, or nullptr after a move.
+             */
+            fossil_threads_pool_t* native_handle() const { return pool_; }
+
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+            /**
+             * @brief Awaiter returned by schedule().
+             *
+             * Queues the awaiting coroutine as a task through a node kept
+             * in the coroutine frame, so the hop costs no allocation.
+             */
+            struct ScheduleAwaiter {
+                fossil_threads_pool_t* pool;
+                fossil_threads_pool_task_t task{};
+
+                bool await_ready() const noexcept { return false; }
+
+                bool await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    /* On failure the coroutine simply continues where it is. */
+                    return fossil_threads_pool_submit_task(pool, &task, &ScheduleAwaiter::resume,
+                                                           awaiting.address()) == 0;
+                }
+
+                void await_resume() const noexcept {}
+
+                static void* resume(void* arg) {
+                    std::coroutine_handle<>::from_address(arg).resume();
+                    return nullptr;
+                }
+            };
+
+            /**
+             * @brief Continue the calling coroutine on a pool worker.
+             *
+             * `co_await pool.schedule();` suspends the coroutine and resumes
+             * it from the pool's queue, like any other task.
+             * @return Awaiter for the hop.
+             */
+            ScheduleAwaiter schedule() { return ScheduleAwaiter{pool_}; }
+#endif
+
+        private:
+            fossil_threads_pool_t* pool_;
+        };
+
+        /**
+         * @brief C++ wrapper for fossil_threads_fiber_t.
+         *
+         * Runs a function on its own stack on a pool's workers; see
+         * fossil_threads_fiber_spawn(). The destructor joins a fiber that
+         * has not been joined yet.
+         * Disallows copy semantics; supports move semantics.
+         */
+        class Fiber {
+        public:
+            /**
+             * @brief Fiber function type.
+             * Signature matches fossil_threads_thread_func.
+             */
+            using Func = void*(*)(void*);
+
+            /**
+             * @brief Start a fiber on a pool.
+             * @param pool Pool whose workers run the fiber; must outlive it.
+             * @param func Fiber body.
+             * @param arg Argument passed to func (default nullptr).
+             * @param stack_size Stack bytes, 0 for the default.
+             * @throws std::runtime_error on failure or where fibers are unsupported.
+             */
+            Fiber(Pool& pool, Func func, void* arg = nullptr, size_t stack_size = 0) {
+                if (fossil_threads_fiber_spawn(pool.native_handle(), func, arg, stack_size, &fiber_) != 0) {
+                    throw std::runtime_error("Failed to spawn fiber");
+                }
+            }
+
+            /**
+             * @brief Destructor.
+             * Joins the fiber if it is still owned.
+             */
+            ~Fiber() {
+                if (fiber_) (void)fossil_threads_fiber_join(fiber_, nullptr);
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             * Fibers cannot be copied.
+             */
+            Fiber(const Fiber&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             * Fibers cannot be copied.
+             */
+            Fiber& operator=(const Fiber&) = delete;
+
+            /**
+             * @brief Move constructor.
+             * @param other Fiber to move from; left empty.
+             */
+            Fiber(Fiber&& other) noexcept : fiber_(other.fiber_) {
+                other.fiber_ = nullptr;
+            }
+
+            /**
+             * @brief Move assignment operator.
+             * Joins the current fiber and takes ownership from other.
+             * @param other Fiber to move from; left empty.
+             * @return Reference to this fiber.
+             */
+            Fiber& operator=(Fiber&& other) noexcept {
+                if (this != &other) {
+                    if (fiber_) (void)fossil_threads_fiber_join(fiber_, nullptr);
+                    fiber_ = other.fiber_;
+                    other.fiber_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Wait for the fiber to finish and return its result.
+             * @return Fiber return value.
+             * @throws std::runtime_error if empty or the join fails.
+             */
+            void* join() {
+                void* result = nullptr;
+                fossil_threads_fiber_t* fiber = fiber_;
+                fiber_ = nullptr;
+                if (fossil_threads_fiber_join(fiber, &result) != 0) {
+                    throw std::runtime_error("Failed to join fiber");
+                }
+                return result;
+            }
+
+            /**
+             * @brief Check whether the fiber is still owned (not joined).
+             * @return true if joinable, false otherwise.
+             */
+            bool joinable() const { return fiber_ != nullptr; }
+
+            /**
+             * @brief Let other queued tasks run from inside a fiber.
+             * @return 0 on success, FOSSIL_THREADS_EPERM off a fiber.
+             */
+            static int yield() { return fossil_threads_fiber_yield(); }
+
+            /**
+             * @brief Suspend the calling fiber until future completes.
+             * @param future Future to wait on.
+             * @return Task return value.
+             * @throws std::runtime_error if the future is empty or was cancelled.
+             */
+            static void* await(Future& future) {
+                void* result = nullptr;
+                if (fossil_threads_fiber_await(future.native_handle(), &result) != 0) {
+                    throw std::runtime_error("Future has no result");
+                }
+                return result;
+            }
+
+            /**
+             * @brief Check whether the caller runs on a fiber.
+             * @return true on a fiber, false otherwise.
+             */
+            static bool inside() { return fossil_threads_fiber_inside() != 0; }
+
+            /**
+             * @brief Get native fiber handle.
+             * @return Pointer to the native fiber, or nullptr once joined.
+             */
+            fossil_threads_fiber_t* native_handle() const { return fiber_; }
+
+        private:
+            fossil_threads_fiber_t* fiber_ = nullptr;
+        };
+
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+        template <typename T = void>
+        class Task;
+
+        namespace detail {
+
+            /* Blocking Task::get() parks here; signalled under the lock so
+             * the waiter cannot return while the signal is in flight. */
+            struct TaskWaiter {
+                std::mutex lock;
+                std::condition_variable cv;
+                bool done = false;
+            };
+
+            struct TaskPromiseBase {
+                std::coroutine_handle<> continuation;
+                TaskWaiter* waiter = nullptr;
+                std::exception_ptr error;
+
+                struct FinalAwaiter {
+                    bool await_ready() const noexcept { return false; }
+
+                    template <typename Promise>
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) const noexcept {
+                        TaskPromiseBase& p = self.promise();
+                        if (p.continuation) return p.continuation;
+                        if (TaskWaiter* w = p.waiter) {
+                            std::lock_guard<std::mutex> hold(w->lock);
+                            w->done = true;
+                            w->cv.notify_all();
+                        }
+                        return std::noop_coroutine();
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                std::suspend_always initial_suspend() const noexcept { return {}; }
+                FinalAwaiter final_suspend() const noexcept { return {}; }
+                void unhandled_exception() noexcept { error = std::current_exception(); }
+            };
+
+            template <typename T>
+            struct TaskPromise : TaskPromiseBase {
+                std::optional<T> value;
+
+                Task<T> get_return_object() noexcept;
+
+                template <typename U>
+                void return_value(U&& v) { value.emplace(std::forward<U>(v)); }
+
+                T take() {
+                    if (error) std::rethrow_exception(error);
+                    return std::move(*value);
+                }
+            };
+
+            template <>
+            struct TaskPromise<void> : TaskPromiseBase {
+                Task<void> get_return_object() noexcept;
+                void return_void() noexcept {}
+                void take() {
+                    if (error) std::rethrow_exception(error);
+                }
+            };
+
+        } // namespace detail
+
+        /**
+         * @brief Lazily started coroutine producing a T.
+         *
+         * The body runs when the task is awaited or get() is called, on the
+         * calling thread until its first suspension; `co_await
+         * pool.schedule()` and `co_await future` move it onto pool workers.
+         * Awaiting a task resumes the awaiting coroutine straight from the
+         * task's final suspension, with no trip through a queue. Exceptions
+         * thrown by the body are rethrown to whoever takes the result.
+         * Disallows copy semantics; supports move semantics.
+         */
+        template <typename T>
+        class Task {
+        public:
+            using promise_type = detail::TaskPromise<T>;
+            using handle_type = std::coroutine_handle<promise_type>;
+
+            /**
+             * @brief Construct an empty task.
+             */
+            Task() = default;
+
+            /**
+             * @brief Adopt a coroutine handle.
+             * @param handle Coroutine to take ownership of.
+             */
+            explicit Task(handle_type handle) noexcept : handle_(handle) {}
+
+            /**
+             * @brief Destructor.
+             * Destroys the coroutine; it must not be running.
+             */
+            ~Task() {
+                if (handle_) handle_.destroy();
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             * Tasks cannot be copied.
+             */
+            Task(const Task&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             * Tasks cannot be copied.
+             */
+            Task& operator=(const Task&) = delete;
+
+            /**
+             * @brief Move constructor.
+             * @param other Task to move from; left empty.
+             */
+            Task(Task&& other) noexcept : handle_(other.handle_) {
+                other.handle_ = nullptr;
+            }
+
+            /**
+             * @brief Move assignment operator.
+             * Destroys the current coroutine and takes ownership from other.
+             * @param other Task to move from; left empty.
+             * @return Reference to this task.
+             */
+            Task& operator=(Task&& other) noexcept {
+                if (this != &other) {
+                    if (handle_) handle_.destroy();
+                    handle_ = other.handle_;
+                    other.handle_ = nullptr;
+                }
+                return *this;
+            }
+
+            /**
+             * @brief Awaiter returned by co_await on a Task.
+             */
+            struct Awaiter {
+                handle_type handle;
+
+                bool await_ready() const noexcept { return handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() { return handle.promise().take(); }
+            };
+
+            /**
+             * @brief Start the task and suspend until it has finished.
+             * @return Awaiter yielding the task's result.
+             * @throws std::runtime_error if the task is empty.
+             */
+            Awaiter operator co_await() const {
+                if (!handle_) {
+                    throw std::runtime_error("Task is empty");
+                }
+                return Awaiter{handle_};
+            }
+
+            /**
+             * @brief Run the task from ordinary code and block for its result.
+             *
+             * Must not be called on a pool worker the task needs in order
+             * to finish.
+             * @return Task result.
+             * @throws std::runtime_error if the task is empty or already started;
+             *         otherwise rethrows what the body threw.
+             */
+            T get() {
+                if (!handle_ || handle_.done() || handle_.promise().waiter) {
+                    throw std::runtime_error("Task is empty or already started");
+                }
+                detail::TaskWaiter waiter;
+                handle_.promise().waiter = &waiter;
+                handle_.resume();
+                {
+                    std::unique_lock<std::mutex> hold(waiter.lock);
+                    waiter.cv.wait(hold, [&waiter] { return waiter.done; });
+                }
+                return handle_.promise().take();
+            }
+
+            /**
+             * @brief Check whether the task holds a coroutine.
+             * @return true if valid, false if empty.
+             */
+            bool valid() const { return static_cast<bool>(handle_); }
+
+            /**
+             * @brief Check whether the coroutine has run to completion.
+             * @return true if finished, false otherwise (or if empty).
+             */
+            bool done() const { return handle_ && handle_.done(); }
+
+        private:
+            handle_type handle_ = nullptr;
+        };
+
+        namespace detail {
+
+            template <typename T>
+            inline Task<T> TaskPromise<T>::get_return_object() noexcept {
+                return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+            }
+
+            inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+                return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+            }
+
+        } // namespace detail
+#endif
+
+        namespace detail {
+
+            /**
+             * @brief First exception raised by a parallel body.
+             *
+             * Chunk trampolines run inside C frames, so nothing may unwind
+             * through them: each catches, the first exception is kept, and
+             * later chunks are skipped. The caller rethrows after the join.
+             */
+            struct ParallelFailure {
+                std::atomic<bool> raised{false};
+                std::exception_ptr error;
+
+                bool failed() const noexcept { return raised.load(std::memory_order_acquire); }
+
+                void capture() noexcept {
+                    if (!raised.exchange(true, std::memory_order_acq_rel)) error = std::current_exception();
+                }
+
+                void rethrow() const {
+                    if (error) std::rethrow_exception(error);
+                }
+            };
+
+        } // namespace detail
+
+        /**
+         * @brief Parallel loop over [begin, end) with a callable body.
+         *
+         * body may take a single index, body(i), or a chunk, body(begin, end).
+         * The body is called directly from a per-type chunk function, so it
+         * inlines into the chunk loop instead of being invoked per element
+         * through a function pointer.
+         *
+         * @param pool Pool to run on.
+         * @param begin First index.
+         * @param end One past the last index.
+         * @param grain Minimum chunk size (0 = 1).
+         * @param body Callable taking (size_t) or (size_t, size_t).
+         * @return 0 on success, error code otherwise.
+         * @throws The first exception thrown by body, rethrown once every
+         *         chunk has finished; chunks not yet started are skipped.
+         */
+        template <typename Body>
+        int parallel_for(fossil_threads_pool_t* pool, size_t begin, size_t end, size_t grain, Body&& body) {
+            using B = std::remove_reference_t<Body>;
+            struct Ctx { B* body; detail::ParallelFailure failure; } ctx{ &body, {} };
+
+            auto chunk = [](size_t b, size_t e, void* c) {
+                Ctx* p = static_cast<Ctx*>(c);
+                if (p->failure.failed()) return;
+                try {
+                    B& fn = *p->body;
+                    if constexpr (std::is_invocable_v<B&, size_t, size_t>) {
+                        fn(b, e);
+                    } else {
+                        for (size_t i = b; i < e; ++i) fn(i);
+                    }
+                } catch (...) {
+                    p->failure.capture();
+                }
+            };
+            int rc = fossil_threads_parallel_for(pool, begin, end, grain, chunk, &ctx);
+            ctx.failure.rethrow();
+            return rc;
+        }
+
+        /**
+         * @brief Parallel reduction over [begin, end).
+         *
+         * body(begin, end, acc) folds a chunk into acc and returns the new
+         * value; combine(a, b) merges two partial results. Both must be
+         * associative and commutative. T must be trivially copyable.
+         *
+         * @param pool Pool to run on.
+         * @param begin First index.
+         * @param end One past the last index.
+         * @param grain Minimum chunk size (0 = 1).
+         * @param identity Identity value for combine.
+         * @param body Callable (size_t, size_t, T) -> T.
+         * @param combine Callable (T, T) -> T.
+         * @return Reduced value.
+         * @throws The first exception thrown by body or combine, rethrown
+         *         once every chunk has finished; std::runtime_error on
+         *         any other failure.
+         */
+        template <typename T, typename Body, typename Combine>
+        T parallel_reduce(fossil_threads_pool_t* pool, size_t begin, size_t end, size_t grain,
+                          const T& identity, Body&& body, Combine&& combine) {
+            static_assert(std::is_trivially_copyable_v<T>, "parallel_reduce requires a trivially copyable T");
+            using B = std::remove_reference_t<Body>;
+            using C = std::remove_reference_t<Combine>;
+            struct Ctx { B* body; C* combine; detail::ParallelFailure failure; } ctx{ &body, &combine, {} };
+
+            auto reduce = [](size_t b, size_t e, void* acc, void* c) {
+                Ctx* p = static_cast<Ctx*>(c);
+                if (p->failure.failed()) return;
+                T* value = static_cast<T*>(acc);
+                try {
+                    *value = (*p->body)(b, e, *value);
+                } catch (...) {
+                    p->failure.capture();
+                }
+            };
+            auto merge = [](void* acc, const void* other, void* c) {
+                Ctx* p = static_cast<Ctx*>(c);
+                if (p->failure.failed()) return;
+                T* value = static_cast<T*>(acc);
+                try {
+                    *value = (*p->combine)(*value, *static_cast<const T*>(other));
+                } catch (...) {
+                    p->failure.capture();
+                }
+            };
+
+            T result = identity;
+            int rc = fossil_threads_parallel_reduce(pool, begin, end, grain, &result, &identity, sizeof(T),
+                                                    reduce, merge, &ctx);
+            ctx.failure.rethrow();
+            if (rc != 0) throw std::runtime_error("parallel_reduce failed");
+            return result;
+        }
+
+        /**
+         * @brief parallel_for on a Pool wrapper.
+         * @see parallel_for(fossil_threads_pool_t*, size_t, size_t, size_t, Body&&)
+         */
+        template <typename Body>
+        int parallel_for(Pool& pool, size_t begin, size_t end, size_t grain, Body&& body) {
+            return parallel_for(pool.native_handle(), begin, end, grain, std::forward<Body>(body));
+        }
+
+        /**
+         * @brief parallel_reduce on a Pool wrapper.
+         * @see parallel_reduce(fossil_threads_pool_t*, size_t, size_t, size_t, const T&, Body&&, Combine&&)
+         */
+        template <typename T, typename Body, typename Combine>
+        T parallel_reduce(Pool& pool, size_t begin, size_t end, size_t grain,
+                          const T& identity, Body&& body, Combine&& combine) {
+            return parallel_reduce(pool.native_handle(), begin, end, grain, identity,
+                                   std::forward<Body>(body), std::forward<Combine>(combine));
+        }
+
     } // namespace threads
 
 } // namespace fossil
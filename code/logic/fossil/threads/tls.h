@@ -0,0 +1,226 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_TLS_H
+#define FOSSIL_THREADS_TLS_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Handle for one thread-local variable. Zero is never a valid key, so a
+ * zero-initialized handle reads as "not created".
+ */
+typedef unsigned int fossil_threads_tls_key_t;
+
+/*
+ * Destructor run on a thread's non-NULL value when that thread exits.
+ */
+typedef void (*fossil_threads_tls_destructor)(void *value);
+
+/* Keys that can exist at the same time */
+#define FOSSIL_THREADS_TLS_KEYS_MAX 64
+
+/* Destructor passes at thread exit, for destructors that set values again */
+#define FOSSIL_THREADS_TLS_DESTRUCTOR_ITERATIONS 4
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/*
+ * Thread-local storage keys.
+ *
+ * Every thread has one value slot per key, stored in the thread's own
+ * static TLS block: get and set are an index and a compare, with no lock,
+ * no allocation and no shared memory touched. A key handle carries a
+ * generation, so values left behind by a deleted key are never visible
+ * through a key created later in the same slot.
+ *
+ * Threads started with fossil_threads_thread_create (including pool
+ * workers) run the destructors automatically when their function returns;
+ * any other thread should call fossil_threads_tls_thread_exit before it
+ * terminates to have its values destroyed.
+ */
+
+/*
+ * Creates a key whose value is NULL in every thread.
+ *
+ * Parameters:
+ *   key        - Receives the new key.
+ *   destructor - Run at thread exit on each non-NULL value, or NULL.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TLS_EINVAL if key is NULL, or
+ *   FOSSIL_THREADS_TLS_EAGAIN if FOSSIL_THREADS_TLS_KEYS_MAX keys exist.
+ */
+FOSSIL_THREADS_API int fossil_threads_tls_key_create(
+    fossil_threads_tls_key_t *key,
+    fossil_threads_tls_destructor destructor
+);
+
+/*
+ * Deletes a key. Destructors are not run; values still held by threads
+ * become unreachable and are the caller's to reclaim.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TLS_EINVAL if key is not a live key.
+ */
+FOSSIL_THREADS_API int fossil_threads_tls_key_delete(fossil_threads_tls_key_t key);
+
+/*
+ * Returns the calling thread's value for key, or NULL if it has none or
+ * key is not a live key.
+ */
+FOSSIL_THREADS_API void *fossil_threads_tls_get(fossil_threads_tls_key_t key);
+
+/*
+ * Sets the calling thread's value for key. The previous value, if any, is
+ * replaced without running the destructor.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TLS_EINVAL if key is not a live key.
+ */
+FOSSIL_THREADS_API int fossil_threads_tls_set(fossil_threads_tls_key_t key, const void *value);
+
+/*
+ * Runs the destructors for the calling thread's non-NULL values and clears
+ * them. A destructor may set values again; those are destroyed in further
+ * passes, up to FOSSIL_THREADS_TLS_DESTRUCTOR_ITERATIONS.
+ *
+ * Notes:
+ *   - Called automatically for threads from fossil_threads_thread_create.
+ *   - Safe to call when the thread never set a value.
+ */
+FOSSIL_THREADS_API void fossil_threads_tls_thread_exit(void);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_TLS_OK     = 0,  /* Success */
+    FOSSIL_THREADS_TLS_EAGAIN = 11, /* All keys in use */
+    FOSSIL_THREADS_TLS_EINVAL = 22  /* Invalid or deleted key */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief Per-thread owned T, destroyed with delete when each thread exits.
+         *
+         * Values still held by other threads when the ThreadLocal itself is
+         * destroyed are not deleted.
+         */
+        template <class T>
+        class ThreadLocal {
+        public:
+            /**
+             * @brief Create the underlying key.
+             * @throws std::runtime_error if no key is free.
+             */
+            ThreadLocal() {
+                if (fossil_threads_tls_key_create(&key_, [](void* p) { delete static_cast<T*>(p); })
+                        != FOSSIL_THREADS_TLS_OK)
+                    throw std::runtime_error("Failed to create TLS key");
+            }
+
+            /**
+             * @brief Delete the calling thread's value and the key.
+             */
+            ~ThreadLocal() {
+                delete get();
+                fossil_threads_tls_key_delete(key_);
+            }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            ThreadLocal(const ThreadLocal&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            ThreadLocal& operator=(const ThreadLocal&) = delete;
+
+            /**
+             * @brief The calling thread's value, or nullptr.
+             */
+            T* get() const { return static_cast<T*>(fossil_threads_tls_get(key_)); }
+
+            /**
+             * @brief Replace the calling thread's value, deleting the old one.
+             */
+            void reset(T* p = nullptr) {
+                T* old = get();
+                if (old == p) return;
+                fossil_threads_tls_set(key_, p);
+                delete old;
+            }
+
+            /**
+             * @brief The calling thread's value, default-constructed on first use.
+             */
+            T& local() {
+                T* p = get();
+                if (!p) {
+                    p = new T();
+                    fossil_threads_tls_set(key_, p);
+                }
+                return *p;
+            }
+
+            /**
+             * @brief Get the underlying key.
+             */
+            fossil_threads_tls_key_t native_handle() const { return key_; }
+
+        private:
+            fossil_threads_tls_key_t key_ = 0;
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_TLS_H */
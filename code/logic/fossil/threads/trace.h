@@ -0,0 +1,295 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_TRACE_H
+#define FOSSIL_THREADS_TRACE_H
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(FOSSIL_THREADS_BUILD_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllexport)
+#elif defined(_WIN32) && defined(FOSSIL_THREADS_USE_DLL)
+#  define FOSSIL_THREADS_API __declspec(dllimport)
+#else
+#  define FOSSIL_THREADS_API
+#endif
+
+/* ---------- Types ---------- */
+
+/*
+ * Sink for exported trace text. Called with consecutive pieces of the
+ * document; returns 0 to continue or nonzero to abort the export.
+ */
+typedef int (*fossil_threads_trace_write_func)(void *ctx, const char *data, size_t len);
+
+/* Events kept per thread when fossil_threads_trace_start is given 0 */
+#define FOSSIL_THREADS_TRACE_EVENTS_DEFAULT 16384u
+
+/* Bytes of a thread name kept in the trace, including the terminator */
+#define FOSSIL_THREADS_TRACE_NAME_MAX 32u
+
+// *****************************************************************************
+// Function prototypes
+// *****************************************************************************
+
+/*
+ * Execution tracing.
+ *
+ * While tracing is on, the library records what its threads spend time on:
+ * each library thread's run, each pool task, every contended mutex
+ * acquisition and every condition wait, plus any spans and instants the
+ * application marks itself. Events go into a ring owned by the recording
+ * thread, so recording is a clock read and a few stores with no lock and
+ * no shared cache line; when a ring is full its oldest events are
+ * overwritten. Export renders every ring as Chrome trace JSON, which
+ * chrome://tracing and ui.perfetto.dev open directly.
+ *
+ * When tracing is off each hook costs one relaxed load and a branch. Builds
+ * with FOSSIL_THREADS_NO_TRACE (meson -Dwith_tracing=disabled) drop the
+ * hooks entirely; the functions below remain and do nothing.
+ *
+ * Event names and categories are stored as pointers and read at export, so
+ * they must outlive the trace (string literals are the intended use).
+ */
+
+/*
+ * Starts recording on every thread.
+ *
+ * Parameters:
+ *   events_per_thread - Ring capacity for threads that start recording
+ *                       from now on, rounded up to a power of two
+ *                       between 64 and 2^24, or 0 for
+ *                       FOSSIL_THREADS_TRACE_EVENTS_DEFAULT.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TRACE_EBUSY if tracing is already on, or
+ *   FOSSIL_THREADS_TRACE_ENOSYS in builds without tracing.
+ *
+ * Notes:
+ *   - Events from an earlier session are kept until exported or cleared.
+ *   - A recycled ring of a different size is reallocated at this capacity.
+ *   - A thread whose ring cannot be allocated records nothing.
+ */
+FOSSIL_THREADS_API int fossil_threads_trace_start(size_t events_per_thread);
+
+/*
+ * Stops recording. Threads already inside a hook may still finish the
+ * event they are writing; recorded events stay available for export.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_stop(void);
+
+/*
+ * Returns true while tracing is on.
+ */
+FOSSIL_THREADS_API bool fossil_threads_trace_enabled(void);
+
+/*
+ * Opens a span named name on the calling thread; fossil_threads_trace_end
+ * closes the innermost open one. Spans nest and must be closed on the
+ * thread that opened them.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_begin(const char *name);
+
+/*
+ * Closes the calling thread's innermost span.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_end(void);
+
+/*
+ * Records a zero-length marker named name on the calling thread.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_instant(const char *name);
+
+/*
+ * Names the calling thread in exported traces. The name is copied and
+ * truncated to FOSSIL_THREADS_TRACE_NAME_MAX - 1 bytes; it applies whether
+ * or not tracing is on. Pool workers name themselves.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_set_thread_name(const char *name);
+
+/*
+ * Writes every recorded event as one Chrome trace JSON document.
+ *
+ * Parameters:
+ *   write - Receives the document in pieces.
+ *   ctx   - Passed through to write.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TRACE_EINVAL if write is NULL,
+ *   FOSSIL_THREADS_TRACE_EIO if write returned nonzero, or
+ *   FOSSIL_THREADS_TRACE_ENOSYS in builds without tracing.
+ *
+ * Notes:
+ *   - Safe while tracing is on; events being overwritten as they are read
+ *     are left out rather than exported torn.
+ *   - Timestamps are microseconds since the first fossil_threads_trace_start.
+ *   - Rings of threads that have exited are recycled once exported.
+ *   - write is called without any library lock held, so it may lock,
+ *     trace, start threads or export again itself.
+ */
+FOSSIL_THREADS_API int fossil_threads_trace_export(fossil_threads_trace_write_func write, void *ctx);
+
+/*
+ * Exports to the file at path, replacing it.
+ *
+ * Returns:
+ *   0 on success, FOSSIL_THREADS_TRACE_EINVAL if path is NULL,
+ *   FOSSIL_THREADS_TRACE_EIO if the file cannot be written, or
+ *   FOSSIL_THREADS_TRACE_ENOSYS in builds without tracing.
+ */
+FOSSIL_THREADS_API int fossil_threads_trace_export_file(const char *path);
+
+/*
+ * Discards every recorded event. Recording continues if tracing is on.
+ */
+FOSSIL_THREADS_API void fossil_threads_trace_clear(void);
+
+/* Error codes */
+enum {
+    FOSSIL_THREADS_TRACE_OK     = 0,  /* Success */
+    FOSSIL_THREADS_TRACE_EIO    = 5,  /* Writer or file failed */
+    FOSSIL_THREADS_TRACE_EBUSY  = 16, /* Tracing already on */
+    FOSSIL_THREADS_TRACE_EINVAL = 22, /* Invalid argument */
+    FOSSIL_THREADS_TRACE_ENOSYS = 38  /* Built without tracing */
+};
+
+#ifdef __cplusplus
+}
+#include <stdexcept>
+#include <string>
+
+namespace fossil {
+
+    namespace threads {
+
+        /**
+         * @brief RAII trace span on the calling thread.
+         */
+        class TraceScope {
+        public:
+            /**
+             * @brief Open a span; name must outlive the trace.
+             */
+            explicit TraceScope(const char* name) { fossil_threads_trace_begin(name); }
+
+            /**
+             * @brief Close the span.
+             */
+            ~TraceScope() { fossil_threads_trace_end(); }
+
+            /**
+             * @brief Deleted copy constructor.
+             */
+            TraceScope(const TraceScope&) = delete;
+
+            /**
+             * @brief Deleted copy assignment operator.
+             */
+            TraceScope& operator=(const TraceScope&) = delete;
+        };
+
+        /**
+         * @brief Process-wide tracing controls.
+         */
+        class Trace {
+        public:
+            /**
+             * @brief Start recording.
+             * @throws std::runtime_error if tracing is on or unavailable.
+             */
+            static void start(size_t events_per_thread = 0) {
+                if (fossil_threads_trace_start(events_per_thread) != FOSSIL_THREADS_TRACE_OK)
+                    throw std::runtime_error("trace start failed");
+            }
+
+            /**
+             * @brief Stop recording.
+             */
+            static void stop() { fossil_threads_trace_stop(); }
+
+            /**
+             * @brief Whether tracing is on.
+             */
+            static bool enabled() { return fossil_threads_trace_enabled(); }
+
+            /**
+             * @brief Record a marker; name must outlive the trace.
+             */
+            static void instant(const char* name) { fossil_threads_trace_instant(name); }
+
+            /**
+             * @brief Name the calling thread.
+             */
+            static void thread_name(const std::string& name) {
+                fossil_threads_trace_set_thread_name(name.c_str());
+            }
+
+            /**
+             * @brief The recorded events as a Chrome trace JSON document.
+             * @throws std::runtime_error if the export fails.
+             */
+            static std::string to_json() {
+                std::string out;
+                int rc = fossil_threads_trace_export(
+                    [](void* ctx, const char* data, size_t len) -> int {
+                        try {
+                            static_cast<std::string*>(ctx)->append(data, len);
+                        } catch (...) {
+                            return 1;
+                        }
+                        return 0;
+                    }, &out);
+                if (rc != FOSSIL_THREADS_TRACE_OK)
+                    throw std::runtime_error("trace export failed");
+                return out;
+            }
+
+            /**
+             * @brief Write the recorded events to a file.
+             * @throws std::runtime_error if the file cannot be written.
+             */
+            static void write_file(const std::string& path) {
+                if (fossil_threads_trace_export_file(path.c_str()) != FOSSIL_THREADS_TRACE_OK)
+                    throw std::runtime_error("trace export failed");
+            }
+
+            /**
+             * @brief Discard recorded events.
+             */
+            static void clear() { fossil_threads_trace_clear(); }
+        };
+
+    } // namespace threads
+
+} // namespace fossil
+
+#endif
+
+#endif /* FOSSIL_THREADS_TRACE_H */
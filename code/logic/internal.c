@@ -0,0 +1,258 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#  define _GNU_SOURCE /* syscall() */
+#endif
+#define _POSIX_C_SOURCE 200809L
+#include "internal.h"
+
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#  include <malloc.h>
+#elif defined(__linux__)
+#  include <errno.h>
+#  include <time.h>
+#  include <unistd.h>
+#  include <sys/syscall.h>
+#  include <linux/futex.h>
+#elif defined(__APPLE__)
+#  include <errno.h>
+#  include <time.h>
+#else
+#  include <errno.h>
+#  include <pthread.h>
+#  include <time.h>
+#endif
+
+/* ============================================================================
+** Futex-style Waiting
+** --------------------------------------------------------------------------*/
+#if defined(_WIN32)
+
+int fossil__futex_wait(volatile unsigned int *addr, unsigned int expected, long long timeout_ns) {
+    DWORD ms = INFINITE;
+    if (timeout_ns >= 0) {
+        long long rounded = (timeout_ns + 999999LL) / 1000000LL;
+        ms = rounded >= (long long)INFINITE ? INFINITE - 1 : (DWORD)rounded;
+    }
+    if (WaitOnAddress(addr, &expected, sizeof(expected), ms)) return 0;
+    return GetLastError() == ERROR_TIMEOUT ? FOSSIL__FUTEX_TIMEDOUT : 0;
+}
+
+void fossil__futex_wake_one(volatile unsigned int *addr) {
+    WakeByAddressSingle((PVOID)addr);
+}
+
+void fossil__futex_wake_all(volatile unsigned int *addr) {
+    WakeByAddressAll((PVOID)addr);
+}
+
+int fossil__futex_requeue(volatile unsigned int *from, unsigned int expected, volatile unsigned int *to) {
+    (void)from; (void)expected; (void)to;
+    return -1;
+}
+
+#elif defined(__linux__)
+
+int fossil__futex_wait(volatile unsigned int *addr, unsigned int expected, long long timeout_ns) {
+    struct timespec ts, *pts = NULL;
+    if (timeout_ns >= 0) {
+        ts.tv_sec = (time_t)(timeout_ns / 1000000000LL);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000LL);
+        pts = &ts;
+    }
+    long rc = syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAIT_PRIVATE, expected, pts, NULL, 0);
+    if (rc == -1 && errno == ETIMEDOUT) return FOSSIL__FUTEX_TIMEDOUT;
+    return 0;
+}
+
+void fossil__futex_wake_one(volatile unsigned int *addr) {
+    syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+void fossil__futex_wake_all(volatile unsigned int *addr) {
+    syscall(SYS_futex, (unsigned int*)addr, FUTEX_WAKE_PRIVATE, 0x7fffffff, NULL, NULL, 0);
+}
+
+int fossil__futex_requeue(volatile unsigned int *from, unsigned int expected, volatile unsigned int *to) {
+    /* The fourth argument doubles as the requeue count for FUTEX_CMP_REQUEUE */
+    long rc = syscall(SYS_futex, (unsigned int*)from, FUTEX_CMP_REQUEUE_PRIVATE, 1,
+                      (void*)(uintptr_t)0x7fffffff, (unsigned int*)to, expected);
+    return rc < 0 ? -1 : (int)rc;
+}
+
+#elif defined(__APPLE__)
+
+/* Private but stable libSystem interface used by libc++ and Swift. */
+extern int __ulock_wait(uint32_t operation, void *addr, uint64_t value, uint32_t timeout_us);
+extern int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
+
+#define FOSSIL__UL_COMPARE_AND_WAIT 1u
+#define FOSSIL__ULF_WAKE_ALL        0x00000100u
+#define FOSSIL__ULF_NO_ERRNO        0x01000000u
+
+int fossil__futex_wait(volatile unsigned int *addr, unsigned int expected, long long timeout_ns) {
+    uint32_t us = 0; /* 0 = wait forever */
+    if (timeout_ns >= 0) {
+        long long rounded = (timeout_ns + 999LL) / 1000LL;
+        us = rounded < 1 ? 1u : (rounded > 0xffffffffLL ? 0xffffffffu : (uint32_t)rounded);
+    }
+    int rc = __ulock_wait(FOSSIL__UL_COMPARE_AND_WAIT | FOSSIL__ULF_NO_ERRNO,
+                          (void*)addr, expected, us);
+    return rc == -ETIMEDOUT ? FOSSIL__FUTEX_TIMEDOUT : 0;
+}
+
+void fossil__futex_wake_one(volatile unsigned int *addr) {
+    __ulock_wake(FOSSIL__UL_COMPARE_AND_WAIT | FOSSIL__ULF_NO_ERRNO, (void*)addr, 0);
+}
+
+void fossil__futex_wake_all(volatile unsigned int *addr) {
+    __ulock_wake(FOSSIL__UL_COMPARE_AND_WAIT | FOSSIL__ULF_WAKE_ALL | FOSSIL__ULF_NO_ERRNO,
+                 (void*)addr, 0);
+}
+
+int fossil__futex_requeue(volatile unsigned int *from, unsigned int expected, volatile unsigned int *to) {
+    (void)from; (void)expected; (void)to;
+    return -1;
+}
+
+#else /* generic POSIX: hashed parking buckets */
+
+#define FOSSIL__PARK_BUCKETS 64
+
+typedef struct fossil__park_bucket {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+} fossil__park_bucket_t;
+
+static fossil__park_bucket_t fossil__park_table[FOSSIL__PARK_BUCKETS];
+static pthread_once_t fossil__park_once = PTHREAD_ONCE_INIT;
+
+/* Bucket conditions time out against CLOCK_MONOTONIC, immune to clock steps */
+static void fossil__park_init(void) {
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    for (int i = 0; i < FOSSIL__PARK_BUCKETS; ++i) {
+        pthread_mutex_init(&fossil__park_table[i].lock, NULL);
+        pthread_cond_init(&fossil__park_table[i].cond, &attr);
+    }
+    pthread_condattr_destroy(&attr);
+}
+
+static fossil__park_bucket_t *fossil__park_bucket(volatile unsigned int *addr) {
+    uintptr_t h = (uintptr_t)addr;
+    h ^= h >> 7;
+    h ^= h >> 13;
+    pthread_once(&fossil__park_once, fossil__park_init);
+    return &fossil__park_table[h % FOSSIL__PARK_BUCKETS];
+}
+
+int fossil__futex_wait(volatile unsigned int *addr, unsigned int expected, long long timeout_ns) {
+    fossil__park_bucket_t *b = fossil__park_bucket(addr);
+    int timed_out = 0;
+    pthread_mutex_lock(&b->lock);
+    if (fossil__atomic_load_u32(addr) == expected) {
+        if (timeout_ns < 0) {
+            pthread_cond_wait(&b->cond, &b->lock);
+        } else {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            long long nsec = (long long)ts.tv_nsec + timeout_ns % 1000000000LL;
+            ts.tv_sec += (time_t)(timeout_ns / 1000000000LL + nsec / 1000000000LL);
+            ts.tv_nsec = (long)(nsec % 1000000000LL);
+            timed_out = pthread_cond_timedwait(&b->cond, &b->lock, &ts) == ETIMEDOUT;
+        }
+    }
+    pthread_mutex_unlock(&b->lock);
+    return timed_out ? FOSSIL__FUTEX_TIMEDOUT : 0;
+}
+
+/* Buckets are shared between addresses, so every wake is a broadcast. */
+void fossil__futex_wake_one(volatile unsigned int *addr) {
+    fossil__futex_wake_all(addr);
+}
+
+void fossil__futex_wake_all(volatile unsigned int *addr) {
+    fossil__park_bucket_t *b = fossil__park_bucket(addr);
+    pthread_mutex_lock(&b->lock);
+    pthread_cond_broadcast(&b->cond);
+    pthread_mutex_unlock(&b->lock);
+}
+
+/* A parked thread only re-checks the word it waited on, so it cannot be moved. */
+int fossil__futex_requeue(volatile unsigned int *from, unsigned int expected, volatile unsigned int *to) {
+    (void)from; (void)expected; (void)to;
+    return -1;
+}
+
+#endif /* futex backend */
+
+/* ============================================================================
+** Monotonic Clock
+** --------------------------------------------------------------------------*/
+long long fossil__monotonic_ns(void) {
+#if defined(_WIN32)
+    static LARGE_INTEGER freq; /* benign race: every thread stores the same value */
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (long long)((now.QuadPart / freq.QuadPart) * 1000000000LL +
+                       (now.QuadPart % freq.QuadPart) * 1000000000LL / freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + (long long)ts.tv_nsec;
+#endif
+}
+
+/* ============================================================================
+** Aligned Memory
+** --------------------------------------------------------------------------*/
+void *fossil__aligned_alloc(size_t alignment, size_t size) {
+    if (size == 0) size = 1;
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void *p = NULL;
+    if (alignment < sizeof(void*)) alignment = sizeof(void*);
+    if (posix_memalign(&p, alignment, size) != 0) return NULL;
+    return p;
+#endif
+}
+
+void fossil__aligned_free(void *p) {
+    if (!p) return;
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
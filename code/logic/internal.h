@@ -0,0 +1,454 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#ifndef FOSSIL_THREADS_INTERNAL_H
+#define FOSSIL_THREADS_INTERNAL_H
+
+/* -------------------------------------------------------------------------
+** Fossil Threads: Internal Helpers
+**
+** Private to the library sources; never included from public headers.
+** Public structures keep plain integer/pointer fields so they stay usable
+** from C++ and from MSVC C (which lacks <stdatomic.h>); the helpers below
+** are the only sanctioned way to touch those fields concurrently.
+** ------------------------------------------------------------------------- */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#  define FOSSIL__MSVC_ATOMICS 1
+#endif
+
+/* ---------- Configuration ---------- */
+
+#define FOSSIL__CACHE_LINE 64
+
+#if defined(_MSC_VER)
+#  define FOSSIL__TLS __declspec(thread)
+#else
+#  define FOSSIL__TLS _Thread_local
+#endif
+
+/* ---------- CPU relax ---------- */
+
+static inline void fossil__cpu_relax(void) {
+#if defined(FOSSIL__MSVC_ATOMICS)
+    YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/* ---------- Atomics ----------
+** Loads are acquire, stores are release, read-modify-write operations
+** and fossil__atomic_fence() are sequentially consistent. The *_relaxed
+** variants carry no ordering and exist for counters and racy hints.
+**
+** fossil__atomic_load_sc_u32() is for the "publish, then check for
+** sleepers" side of a wake protocol: an RMW followed by an SC load orders
+** against a waiter that does RMW + fossil__atomic_fence() + load, which a
+** plain acquire load does not. The acquire/release fences order relaxed
+** data accesses around a sequence counter (seqlock readers and writers).
+*/
+
+#if defined(FOSSIL__MSVC_ATOMICS)
+
+#if defined(_M_IX86) || defined(_M_X64)
+#  define FOSSIL__ACQ_BARRIER() _ReadWriteBarrier()
+#else
+#  define FOSSIL__ACQ_BARRIER() MemoryBarrier()
+#endif
+
+static inline void fossil__atomic_fence(void) { MemoryBarrier(); }
+static inline void fossil__atomic_fence_acquire(void) { FOSSIL__ACQ_BARRIER(); }
+static inline void fossil__atomic_fence_release(void) { FOSSIL__ACQ_BARRIER(); }
+
+static inline unsigned int fossil__atomic_load_u32(const volatile unsigned int *p) {
+    unsigned int v = *p; FOSSIL__ACQ_BARRIER(); return v;
+}
+static inline unsigned int fossil__atomic_load_sc_u32(const volatile unsigned int *p) {
+#if defined(_M_IX86) || defined(_M_X64)
+    /* Interlocked* are full barriers, so a plain load is SC against them */
+    _ReadWriteBarrier(); return *p;
+#else
+    unsigned int v; MemoryBarrier(); v = *p; MemoryBarrier(); return v;
+#endif
+}
+static inline unsigned int fossil__atomic_load_relaxed_u32(const volatile unsigned int *p) {
+    return *p;
+}
+static inline void fossil__atomic_store_u32(volatile unsigned int *p, unsigned int v) {
+    FOSSIL__ACQ_BARRIER(); *p = v;
+}
+static inline unsigned int fossil__atomic_add_u32(volatile unsigned int *p, unsigned int v) {
+    return (unsigned int)InterlockedExchangeAdd((volatile LONG*)p, (LONG)v);
+}
+static inline unsigned int fossil__atomic_exchange_u32(volatile unsigned int *p, unsigned int v) {
+    return (unsigned int)InterlockedExchange((volatile LONG*)p, (LONG)v);
+}
+static inline int fossil__atomic_cas_u32(volatile unsigned int *p, unsigned int *expected, unsigned int desired) {
+    LONG prev = InterlockedCompareExchange((volatile LONG*)p, (LONG)desired, (LONG)*expected);
+    if ((unsigned int)prev == *expected) return 1;
+    *expected = (unsigned int)prev;
+    return 0;
+}
+
+static inline long long fossil__atomic_load_i64(const volatile long long *p) {
+#if defined(_M_IX86)
+    return InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+#else
+    long long v = *p; FOSSIL__ACQ_BARRIER(); return v;
+#endif
+}
+static inline long long fossil__atomic_load_relaxed_i64(const volatile long long *p) {
+#if defined(_M_IX86)
+    return InterlockedCompareExchange64((volatile LONG64*)p, 0, 0);
+#else
+    return *p;
+#endif
+}
+static inline void fossil__atomic_store_i64(volatile long long *p, long long v) {
+#if defined(_M_IX86)
+    InterlockedExchange64((volatile LONG64*)p, v);
+#else
+    FOSSIL__ACQ_BARRIER(); *p = v;
+#endif
+}
+static inline long long fossil__atomic_add_i64(volatile long long *p, long long v) {
+    return InterlockedExchangeAdd64((volatile LONG64*)p, v);
+}
+static inline int fossil__atomic_cas_i64(volatile long long *p, long long *expected, long long desired) {
+    long long prev = InterlockedCompareExchange64((volatile LONG64*)p, desired, *expected);
+    if (prev == *expected) return 1;
+    *expected = prev;
+    return 0;
+}
+
+static inline size_t fossil__atomic_load_size(const volatile size_t *p) {
+    size_t v = *p; FOSSIL__ACQ_BARRIER(); return v;
+}
+static inline size_t fossil__atomic_load_relaxed_size(const volatile size_t *p) {
+    return *p;
+}
+static inline void fossil__atomic_store_size(volatile size_t *p, size_t v) {
+    FOSSIL__ACQ_BARRIER(); *p = v;
+}
+static inline void fossil__atomic_store_relaxed_size(volatile size_t *p, size_t v) {
+    *p = v;
+}
+static inline unsigned char fossil__atomic_load_relaxed_u8(const volatile unsigned char *p) {
+    return *p;
+}
+static inline void fossil__atomic_store_relaxed_u8(volatile unsigned char *p, unsigned char v) {
+    *p = v;
+}
+static inline size_t fossil__atomic_add_size(volatile size_t *p, size_t v) {
+#if defined(_WIN64)
+    return (size_t)InterlockedExchangeAdd64((volatile LONG64*)p, (LONG64)v);
+#else
+    return (size_t)InterlockedExchangeAdd((volatile LONG*)p, (LONG)v);
+#endif
+}
+static inline size_t fossil__atomic_sub_size(volatile size_t *p, size_t v) {
+    return fossil__atomic_add_size(p, (size_t)0 - v);
+}
+static inline int fossil__atomic_cas_size(volatile size_t *p, size_t *expected, size_t desired) {
+#if defined(_WIN64)
+    size_t prev = (size_t)InterlockedCompareExchange64((volatile LONG64*)p, (LONG64)desired, (LONG64)*expected);
+#else
+    size_t prev = (size_t)InterlockedCompareExchange((volatile LONG*)p, (LONG)desired, (LONG)*expected);
+#endif
+    if (prev == *expected) return 1;
+    *expected = prev;
+    return 0;
+}
+
+static inline void *fossil__atomic_load_ptr(void *const volatile *p) {
+    void *v = *p; FOSSIL__ACQ_BARRIER(); return v;
+}
+static inline void fossil__atomic_store_ptr(void *volatile *p, void *v) {
+    FOSSIL__ACQ_BARRIER(); *p = v;
+}
+static inline void *fossil__atomic_exchange_ptr(void *volatile *p, void *v) {
+    return InterlockedExchangePointer((PVOID volatile*)p, v);
+}
+static inline int fossil__atomic_cas_ptr(void *volatile *p, void **expected, void *desired) {
+    void *prev = InterlockedCompareExchangePointer((PVOID volatile*)p, desired, *expected);
+    if (prev == *expected) return 1;
+    *expected = prev;
+    return 0;
+}
+
+#else /* GCC / Clang builtins */
+
+static inline void fossil__atomic_fence(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void fossil__atomic_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void fossil__atomic_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+
+static inline unsigned int fossil__atomic_load_u32(const volatile unsigned int *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+static inline unsigned int fossil__atomic_load_sc_u32(const volatile unsigned int *p) {
+    return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+}
+static inline unsigned int fossil__atomic_load_relaxed_u32(const volatile unsigned int *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+static inline void fossil__atomic_store_u32(volatile unsigned int *p, unsigned int v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+static inline unsigned int fossil__atomic_add_u32(volatile unsigned int *p, unsigned int v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+static inline unsigned int fossil__atomic_exchange_u32(volatile unsigned int *p, unsigned int v) {
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+static inline int fossil__atomic_cas_u32(volatile unsigned int *p, unsigned int *expected, unsigned int desired) {
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline long long fossil__atomic_load_i64(const volatile long long *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+static inline long long fossil__atomic_load_relaxed_i64(const volatile long long *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+static inline void fossil__atomic_store_i64(volatile long long *p, long long v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+static inline long long fossil__atomic_add_i64(volatile long long *p, long long v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+static inline int fossil__atomic_cas_i64(volatile long long *p, long long *expected, long long desired) {
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline size_t fossil__atomic_load_size(const volatile size_t *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+static inline size_t fossil__atomic_load_relaxed_size(const volatile size_t *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+static inline void fossil__atomic_store_size(volatile size_t *p, size_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+static inline void fossil__atomic_store_relaxed_size(volatile size_t *p, size_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELAXED);
+}
+static inline unsigned char fossil__atomic_load_relaxed_u8(const volatile unsigned char *p) {
+    return __atomic_load_n(p, __ATOMIC_RELAXED);
+}
+static inline void fossil__atomic_store_relaxed_u8(volatile unsigned char *p, unsigned char v) {
+    __atomic_store_n(p, v, __ATOMIC_RELAXED);
+}
+static inline size_t fossil__atomic_add_size(volatile size_t *p, size_t v) {
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+static inline size_t fossil__atomic_sub_size(volatile size_t *p, size_t v) {
+    return __atomic_fetch_sub(p, v, __ATOMIC_SEQ_CST);
+}
+static inline int fossil__atomic_cas_size(volatile size_t *p, size_t *expected, size_t desired) {
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+static inline void *fossil__atomic_load_ptr(void *const volatile *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+static inline void fossil__atomic_store_ptr(void *volatile *p, void *v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+static inline void *fossil__atomic_exchange_ptr(void *volatile *p, void *v) {
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+static inline int fossil__atomic_cas_ptr(void *volatile *p, void **expected, void *desired) {
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+#endif /* atomics backend */
+
+/* ---------- Futex-style waiting ----------
+** Address-based park/unpark on a 32-bit word: futex on Linux, WaitOnAddress
+** on Windows, __ulock on macOS, and hashed mutex/condition buckets elsewhere.
+** fossil__futex_wait() returns immediately if *addr != expected; otherwise it
+** blocks until woken, a spurious wakeup, or the relative timeout expires.
+** Callers must always re-check their condition after it returns.
+*/
+
+#define FOSSIL__FUTEX_INFINITE (-1LL)
+#define FOSSIL__FUTEX_TIMEDOUT 1
+
+/* Returns 0 when woken (or on value mismatch), FOSSIL__FUTEX_TIMEDOUT on timeout. */
+int  fossil__futex_wait(volatile unsigned int *addr, unsigned int expected, long long timeout_ns);
+void fossil__futex_wake_one(volatile unsigned int *addr);
+void fossil__futex_wake_all(volatile unsigned int *addr);
+
+/*
+** Wakes one waiter on from and moves the remaining ones onto to, provided
+** *from still equals expected. Returns the number of threads woken or moved,
+** or -1 if the backend cannot requeue or the value changed; callers then
+** fall back to fossil__futex_wake_all(from).
+*/
+int  fossil__futex_requeue(volatile unsigned int *from, unsigned int expected, volatile unsigned int *to);
+
+/* Sleeps for ns nanoseconds by waiting on a word nothing ever wakes. */
+static inline void fossil__sleep_ns(long long ns) {
+    unsigned int never = 0;
+    fossil__futex_wait(&never, 0u, ns);
+}
+
+/*
+** Watches *addr for up to spins pause iterations, backing off exponentially
+** so the line is not hammered. Returns 1 as soon as it no longer equals
+** value, 0 if the budget ran out and the caller should park.
+*/
+static inline int fossil__spin_while_eq(const volatile unsigned int *addr, unsigned int value, unsigned int spins) {
+    unsigned int backoff = 1;
+    for (unsigned int done = 0; done < spins; done += backoff) {
+        if (fossil__atomic_load_relaxed_u32(addr) != value) return 1;
+        for (unsigned int i = 0; i < backoff; ++i) fossil__cpu_relax();
+        if (backoff < 64u) backoff <<= 1;
+    }
+    return fossil__atomic_load_relaxed_u32(addr) != value;
+}
+
+/* ---------- Event counts ----------
+** Lets a lock-free structure park waiters only when it has nothing for them.
+** A waiter takes a key with fossil__event_prepare(), re-checks the structure,
+** and only then parks with fossil__futex_wait(seq, key, ...); it always ends
+** with fossil__event_cancel(). The other side publishes its update and then
+** calls fossil__event_notify(), which touches only memory while nobody waits.
+** The full fences on both sides guarantee that either the waiter's re-check
+** sees the update or the notifier sees the waiter.
+*/
+
+static inline unsigned int fossil__event_prepare(volatile unsigned int *seq, volatile unsigned int *waiters) {
+    fossil__atomic_add_u32(waiters, 1u);
+    fossil__atomic_fence();
+    return fossil__atomic_load_u32(seq);
+}
+
+static inline void fossil__event_cancel(volatile unsigned int *waiters) {
+    fossil__atomic_add_u32(waiters, (unsigned int)-1);
+}
+
+static inline void fossil__event_notify(volatile unsigned int *seq, volatile unsigned int *waiters, int all) {
+    fossil__atomic_fence();
+    if (fossil__atomic_load_relaxed_u32(waiters) == 0u) return;
+    fossil__atomic_add_u32(seq, 1u);
+    if (all) fossil__futex_wake_all(seq);
+    else fossil__futex_wake_one(seq);
+}
+
+/* ---------- Time ---------- */
+
+/* Nanoseconds on a monotonic clock with an arbitrary epoch, for deadlines. */
+long long fossil__monotonic_ns(void);
+
+/* ---------- Mutex ---------- */
+
+struct fossil_threads_mutex;
+
+/*
+** Relocks an adaptive mutex after a condition wait. The lock word is always
+** marked contended, because waiters requeued by a broadcast may be parked on
+** it and the eventual unlock has to wake the next one.
+*/
+void fossil__mutex_lock_contended(struct fossil_threads_mutex *m);
+
+/* ---------- Thread lifecycle ---------- */
+
+/* Releases the calling thread's epoch slot; run when a library thread's function returns. */
+void fossil__epoch_thread_exit(void);
+
+/* Runs the calling thread's TLS destructors; run just before the epoch release. */
+void fossil__tls_thread_exit(void);
+
+/* ---------- Pool / fibers ---------- */
+
+struct fossil_threads_pool;
+
+/*
+** Runs one queued task of pool on the calling thread if it is one of the
+** pool's workers. Returns 1 if a task ran, 0 if nothing was runnable, and
+** -1 when the caller is not a worker of pool (it may block instead).
+*/
+int fossil__pool_help_caller(struct fossil_threads_pool *pool);
+
+/* Nonzero while the calling code runs on a fiber's stack. */
+int fossil__fiber_active(void);
+
+/*
+** A worker helping from inside a fiber runs other tasks on the fiber's
+** stack; those must not see themselves as that fiber (a yield there would
+** suspend the fiber under them), so helping hides it for the duration.
+*/
+void *fossil__fiber_hide(void);
+void  fossil__fiber_unhide(void *fiber);
+
+/* ---------- Tracing ---------- */
+
+#if defined(FOSSIL_THREADS_NO_TRACE)
+static inline int fossil__trace_on(void) { return 0; }
+static inline void fossil__trace_complete(const char *cat, const char *name, const char *label,
+                                          long long start_ns, long long end_ns,
+                                          unsigned long long arg) {
+    (void)cat; (void)name; (void)label; (void)start_ns; (void)end_ns; (void)arg;
+}
+static inline void fossil__trace_thread_exit(void) {}
+#else
+/* Nonzero while tracing records; hooks test it before reading the clock. */
+extern volatile unsigned int fossil__trace_active;
+
+static inline int fossil__trace_on(void) {
+    return fossil__atomic_load_relaxed_u32(&fossil__trace_active) != 0u;
+}
+
+/*
+** Records a span from start_ns to end_ns on the calling thread. cat, name
+** and label (the object's tag, or NULL) must be static strings; arg is
+** usually the address of the object or function involved.
+*/
+void fossil__trace_complete(const char *cat, const char *name, const char *label,
+                            long long start_ns, long long end_ns, unsigned long long arg);
+
+/* Retires the calling thread's trace ring; run after the epoch release. */
+void fossil__trace_thread_exit(void);
+#endif
+
+/* ---------- Memory ---------- */
+
+/* Cache-line aligned allocation; release with fossil__aligned_free(). */
+void *fossil__aligned_alloc(size_t alignment, size_t size);
+void  fossil__aligned_free(void *p);
+
+#endif /* FOSSIL_THREADS_INTERNAL_H */
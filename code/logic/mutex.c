@@ -22,7 +22,11 @@
  * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
+#if defined(__linux__)
+#  define _GNU_SOURCE /* pthread_mutex_clocklock() */
+#endif
 #include "fossil/threads/mutex.h"
+#include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <errno.h>
@@ -32,12 +36,235 @@
 #  include <windows.h>
 #else
 #  include <pthread.h>
+#  include <time.h>
+#endif
+
+#include "internal.h"
+
+/*
+** Timed acquisition of the platform lock: glibc 2.30+ can wait against
+** CLOCK_MONOTONIC directly; other POSIX systems only offer a CLOCK_REALTIME
+** pthread_mutex_timedlock; SRWLOCK and macOS have no timed lock at all.
+*/
+#if defined(_WIN32) || defined(__APPLE__)
+#  define FOSSIL__MUTEX_POLL_TIMED 1
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#  define FOSSIL__MUTEX_CLOCKLOCK 1
+#endif
+
+#if defined(_WIN32)
+typedef SRWLOCK fossil__mutex_native_t;
+#else
+typedef pthread_mutex_t fossil__mutex_native_t;
 #endif
 
+_Static_assert(sizeof(fossil__mutex_native_t) <= FOSSIL_THREADS_MUTEX_STORAGE_SIZE,
+               "FOSSIL_THREADS_MUTEX_STORAGE_SIZE too small for the platform mutex");
+
+static inline fossil__mutex_native_t *fossil__mutex_native(fossil_threads_mutex_t *m) {
+    return (fossil__mutex_native_t *)(void *)m->storage.bytes;
+}
+
 static void fossil__mutex_zero(fossil_threads_mutex_t *m) {
     if (m) memset(m, 0, sizeof(*m));
 }
 
+/* ---------- Adaptive kind ---------- */
+
+/*
+** Lock word states follow the classic three-state futex mutex: 0 free,
+** 1 locked, 2 locked with (possible) sleepers, so an uncontended unlock
+** never has to enter the kernel.
+**
+** m->spin holds a running average of how many pause iterations recent
+** acquisitions needed before the lock came free. A contended locker spins up
+** to twice that (clamped to [MIN, MAX]) with exponential backoff. Winning
+** during the spin pulls the average toward the observed wait; giving up and
+** parking decays it, so a lock that is held for long stretches stops wasting
+** cycles and a lock with short critical sections keeps spinning.
+*/
+#define FOSSIL__MUTEX_SPIN_MIN     16u
+#define FOSSIL__MUTEX_SPIN_MAX     2048u
+#define FOSSIL__MUTEX_BACKOFF_MAX  64u
+
+static void fossil__mutex_adapt(fossil_threads_mutex_t *m, unsigned int observed) {
+    int cur = (int)fossil__atomic_load_relaxed_u32(&m->spin);
+    int next = cur + ((int)observed - cur) / 8;
+    if (next < 0) next = 0;
+    fossil__atomic_store_u32(&m->spin, (unsigned int)next);
+}
+
+static void fossil__mutex_park(fossil_threads_mutex_t *m) {
+    while (fossil__atomic_exchange_u32(&m->state, 2u) != 0)
+        fossil__futex_wait(&m->state, 2u, FOSSIL__FUTEX_INFINITE);
+}
+
+static int fossil__mutex_adaptive_lock(fossil_threads_mutex_t *m) {
+    unsigned int c = 0;
+    if (fossil__atomic_cas_u32(&m->state, &c, 1u)) return FOSSIL_THREADS_MUTEX_OK;
+
+    unsigned int limit = fossil__atomic_load_relaxed_u32(&m->spin) * 2u;
+    if (limit < FOSSIL__MUTEX_SPIN_MIN) limit = FOSSIL__MUTEX_SPIN_MIN;
+    if (limit > FOSSIL__MUTEX_SPIN_MAX) limit = FOSSIL__MUTEX_SPIN_MAX;
+
+    unsigned int spins = 0;
+    unsigned int backoff = 1;
+    while (spins < limit) {
+        for (unsigned int i = 0; i < backoff; ++i) fossil__cpu_relax();
+        spins += backoff;
+        if (backoff < FOSSIL__MUTEX_BACKOFF_MAX) backoff <<= 1;
+
+        /* Test before test-and-set so spinners do not bounce the line */
+        if (fossil__atomic_load_relaxed_u32(&m->state) == 0) {
+            c = 0;
+            if (fossil__atomic_cas_u32(&m->state, &c, 1u)) {
+                fossil__mutex_adapt(m, spins);
+                return FOSSIL_THREADS_MUTEX_OK;
+            }
+        }
+    }
+
+    fossil__mutex_adapt(m, 0);
+
+    /* Park: mark the word contended; whoever unlocks it will wake one of us */
+    fossil__mutex_park(m);
+    return FOSSIL_THREADS_MUTEX_OK;
+}
+
+static int fossil__mutex_adaptive_unlock(fossil_threads_mutex_t *m) {
+    unsigned int prev = fossil__atomic_exchange_u32(&m->state, 0u);
+    if (prev == 0) return FOSSIL_THREADS_MUTEX_EUNLOCK;
+    if (prev == 2u) fossil__futex_wake_one(&m->state);
+    return FOSSIL_THREADS_MUTEX_OK;
+}
+
+static int fossil__mutex_adaptive_lock_until(fossil_threads_mutex_t *m, long long deadline_ns) {
+    unsigned int c = 0;
+    if (fossil__atomic_cas_u32(&m->state, &c, 1u)) return FOSSIL_THREADS_MUTEX_OK;
+
+    /* Same parking protocol as the untimed path, with a bounded wait */
+    while (fossil__atomic_exchange_u32(&m->state, 2u) != 0) {
+        long long left = deadline_ns - fossil__monotonic_ns();
+        if (left <= 0) return FOSSIL_THREADS_MUTEX_ETIMEDOUT;
+        fossil__futex_wait(&m->state, 2u, left);
+    }
+    return FOSSIL_THREADS_MUTEX_OK;
+}
+
+static int fossil__mutex_adaptive_trylock(fossil_threads_mutex_t *m) {
+    unsigned int c = 0;
+    if (fossil__atomic_cas_u32(&m->state, &c, 1u)) return FOSSIL_THREADS_MUTEX_OK;
+    return FOSSIL_THREADS_MUTEX_EBUSY;
+}
+
+/* ---------- Contention profiling ---------- */
+
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+
+/*
+** One record per profiled mutex, linked into a global registry on first
+** acquisition. Counters are only written by the thread holding the mutex,
+** so updates are plain load/store pairs; readers use the same relaxed loads.
+** The registry has its own lock word, taken through the adaptive path
+** directly so that it is never profiled itself.
+*/
+typedef struct fossil__mutex_record {
+    struct fossil__mutex_record *next;
+    const char *name;                 /* registry lock */
+    const void *mutex;                /* registry lock; NULL once disposed */
+    volatile long long acquisitions;
+    volatile long long contended;
+    volatile long long wait_total;
+    volatile long long wait_max;
+    volatile long long hold_max;
+    volatile long long histogram[FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS];
+    long long hold_start;             /* holder only */
+    int held;                         /* holder only */
+} fossil__mutex_record_t;
+
+static fossil_threads_mutex_t fossil__mutex_registry_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+static fossil__mutex_record_t *fossil__mutex_registry = NULL;
+
+static void fossil__profile_add(volatile long long *counter, long long v) {
+    fossil__atomic_store_i64(counter, fossil__atomic_load_relaxed_i64(counter) + v);
+}
+
+static void fossil__profile_max(volatile long long *mark, long long v) {
+    if (v > fossil__atomic_load_relaxed_i64(mark)) fossil__atomic_store_i64(mark, v);
+}
+
+/* Record of a mutex the caller holds, created on first use. */
+static fossil__mutex_record_t *fossil__mutex_record(fossil_threads_mutex_t *m) {
+    fossil__mutex_record_t *r = (fossil__mutex_record_t *)m->profile;
+    if (r) return r;
+    r = (fossil__mutex_record_t *)calloc(1, sizeof(*r));
+    if (!r) return NULL;
+    /* Published under the registry lock so set_name never misses it */
+    fossil__mutex_adaptive_lock(&fossil__mutex_registry_lock);
+    r->name = m->name;
+    r->mutex = m;
+    r->next = fossil__mutex_registry;
+    fossil__mutex_registry = r;
+    m->profile = r;
+    fossil__mutex_adaptive_unlock(&fossil__mutex_registry_lock);
+    return r;
+}
+
+/* Called with m just acquired; wait_ns is only meaningful when contended. */
+static void fossil__mutex_profile_acquired(fossil_threads_mutex_t *m, int contended, long long wait_ns) {
+    fossil__mutex_record_t *r = fossil__mutex_record(m);
+    if (!r) return;
+    fossil__profile_add(&r->acquisitions, 1);
+    if (contended) {
+        if (wait_ns < 0) wait_ns = 0;
+        unsigned int b = 0;
+        for (long long v = wait_ns >> 10; v && b < FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS - 1; v >>= 1) ++b;
+        fossil__profile_add(&r->contended, 1);
+        fossil__profile_add(&r->wait_total, wait_ns);
+        fossil__profile_max(&r->wait_max, wait_ns);
+        fossil__profile_add(&r->histogram[b], 1);
+    }
+    r->hold_start = fossil__monotonic_ns();
+    r->held = 1;
+}
+
+/* Called with m still held, right before the platform unlock. */
+static void fossil__mutex_profile_release(fossil_threads_mutex_t *m) {
+    fossil__mutex_record_t *r = (fossil__mutex_record_t *)m->profile;
+    if (!r || !r->held) return;
+    r->held = 0;
+    fossil__profile_max(&r->hold_max, fossil__monotonic_ns() - r->hold_start);
+}
+
+static void fossil__mutex_profile_retire(fossil_threads_mutex_t *m) {
+    if (!m->profile) return;
+    fossil__mutex_adaptive_lock(&fossil__mutex_registry_lock);
+    ((fossil__mutex_record_t *)m->profile)->mutex = NULL;
+    m->profile = NULL;
+    fossil__mutex_adaptive_unlock(&fossil__mutex_registry_lock);
+}
+
+static void fossil__mutex_profile_copy(const fossil__mutex_record_t *r, fossil_threads_mutex_profile_t *p) {
+    p->name = r->name;
+    p->mutex = r->mutex;
+    p->acquisitions = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->acquisitions);
+    p->contended = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->contended);
+    p->wait_ns_total = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->wait_total);
+    p->wait_ns_max = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->wait_max);
+    p->hold_ns_max = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->hold_max);
+    for (int i = 0; i < FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS; ++i)
+        p->wait_histogram[i] = (unsigned long long)fossil__atomic_load_relaxed_i64(&r->histogram[i]);
+}
+
+static int fossil__mutex_profile_hotter(const fossil_threads_mutex_profile_t *a,
+                                        const fossil_threads_mutex_profile_t *b) {
+    if (a->contended != b->contended) return a->contended > b->contended;
+    if (a->wait_ns_total != b->wait_ns_total) return a->wait_ns_total > b->wait_ns_total;
+    return a->acquisitions > b->acquisitions;
+}
+
+#endif /* FOSSIL_THREADS_MUTEX_PROFILE */
+
 /* ---------- Lifecycle ---------- */
 
 int fossil_threads_mutex_init(fossil_threads_mutex_t *m) {
@@ -45,16 +272,10 @@ int fossil_threads_mutex_init(fossil_threads_mutex_t *m) {
     fossil__mutex_zero(m);
 
 #if defined(_WIN32)
-    CRITICAL_SECTION *cs = (CRITICAL_SECTION*)malloc(sizeof(CRITICAL_SECTION));
-    if (!cs) return FOSSIL_THREADS_MUTEX_ENOMEM;
-    InitializeCriticalSection(cs);
-    m->handle = cs;
+    InitializeSRWLock(fossil__mutex_native(m));
 #else
-    pthread_mutex_t *pm = (pthread_mutex_t*)malloc(sizeof(pthread_mutex_t));
-    if (!pm) return FOSSIL_THREADS_MUTEX_ENOMEM;
-    int rc = pthread_mutex_init(pm, NULL);
+    int rc = pthread_mutex_init(fossil__mutex_native(m), NULL);
     if (rc != 0) {
-        free(pm);
         if (rc == ENOMEM)
             return FOSSIL_THREADS_MUTEX_ENOMEM;
         else if (rc == EPERM)
@@ -62,7 +283,6 @@ int fossil_threads_mutex_init(fossil_threads_mutex_t *m) {
         else
             return FOSSIL_THREADS_MUTEX_EINTERNAL;
     }
-    m->handle = pm;
 #endif
 
     m->valid = 1;
@@ -71,37 +291,48 @@ int fossil_threads_mutex_init(fossil_threads_mutex_t *m) {
     return FOSSIL_THREADS_MUTEX_OK;
 }
 
+int fossil_threads_mutex_init_ex(fossil_threads_mutex_t *m, int kind) {
+    if (!m) return FOSSIL_THREADS_MUTEX_EINVAL;
+    if (kind == FOSSIL_THREADS_MUTEX_KIND_NORMAL) return fossil_threads_mutex_init(m);
+    if (kind != FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) return FOSSIL_THREADS_MUTEX_EINVAL;
+
+    fossil__mutex_zero(m);
+    m->kind = FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE;
+    m->valid = 1;
+    return FOSSIL_THREADS_MUTEX_OK;
+}
+
 void fossil_threads_mutex_dispose(fossil_threads_mutex_t *m) {
     if (!m || !m->valid) return;
-
-#if defined(_WIN32)
-    CRITICAL_SECTION *cs = (CRITICAL_SECTION*)m->handle;
-    if (cs) {
-        DeleteCriticalSection(cs);
-        free(cs);
-    }
-#else
-    pthread_mutex_t *pm = (pthread_mutex_t*)m->handle;
-    if (pm) {
-        int rc = pthread_mutex_destroy(pm);
-        free(pm);
-        (void)rc; // ignore destroy errors for now
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_profile_retire(m);
+#endif
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) {
+        fossil__mutex_zero(m);
+        return;
     }
+
+#if !defined(_WIN32)
+    /* SRWLOCKs need no teardown */
+    int rc = pthread_mutex_destroy(fossil__mutex_native(m));
+    (void)rc; // ignore destroy errors for now
 #endif
     fossil__mutex_zero(m);
 }
 
-/* ---------- Locking ---------- */
+/* ---------- Platform locking ---------- */
 
-int fossil_threads_mutex_lock(fossil_threads_mutex_t *m) {
-    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+/* Platform operations on a valid mutex; the public entry points below add
+ * argument checks and, in profiling builds, contention accounting. */
+static int fossil__mutex_lock_impl(fossil_threads_mutex_t *m) {
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) return fossil__mutex_adaptive_lock(m);
 
 #if defined(_WIN32)
-    EnterCriticalSection((CRITICAL_SECTION*)m->handle);
+    AcquireSRWLockExclusive(fossil__mutex_native(m));
     m->locked = 1;
     return FOSSIL_THREADS_MUTEX_OK;
 #else
-    int rc = pthread_mutex_lock((pthread_mutex_t*)m->handle);
+    int rc = pthread_mutex_lock(fossil__mutex_native(m));
     if (rc == 0) {
         m->locked = 1;
         return FOSSIL_THREADS_MUTEX_OK;
@@ -116,15 +347,17 @@ int fossil_threads_mutex_lock(fossil_threads_mutex_t *m) {
 #endif
 }
 
-int fossil_threads_mutex_unlock(fossil_threads_mutex_t *m) {
-    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+static int fossil__mutex_unlock_impl(fossil_threads_mutex_t *m) {
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) return fossil__mutex_adaptive_unlock(m);
 
 #if defined(_WIN32)
-    LeaveCriticalSection((CRITICAL_SECTION*)m->handle);
+    /* Releasing an SRWLOCK that is not held raises an exception */
+    if (!m->locked) return FOSSIL_THREADS_MUTEX_EUNLOCK;
+    ReleaseSRWLockExclusive(fossil__mutex_native(m));
     m->locked = 0;
     return FOSSIL_THREADS_MUTEX_OK;
 #else
-    int rc = pthread_mutex_unlock((pthread_mutex_t*)m->handle);
+    int rc = pthread_mutex_unlock(fossil__mutex_native(m));
     if (rc == 0) {
         m->locked = 0;
         return FOSSIL_THREADS_MUTEX_OK;
@@ -137,18 +370,18 @@ int fossil_threads_mutex_unlock(fossil_threads_mutex_t *m) {
 #endif
 }
 
-int fossil_threads_mutex_trylock(fossil_threads_mutex_t *m) {
-    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+static int fossil__mutex_trylock_impl(fossil_threads_mutex_t *m) {
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE) return fossil__mutex_adaptive_trylock(m);
 
 #if defined(_WIN32)
-    if (TryEnterCriticalSection((CRITICAL_SECTION*)m->handle)) {
+    if (TryAcquireSRWLockExclusive(fossil__mutex_native(m))) {
         m->locked = 1;
         return FOSSIL_THREADS_MUTEX_OK;
     } else {
         return FOSSIL_THREADS_MUTEX_EBUSY;
     }
 #else
-    int rc = pthread_mutex_trylock((pthread_mutex_t*)m->handle);
+    int rc = pthread_mutex_trylock(fossil__mutex_native(m));
     if (rc == 0) {
         m->locked = 1;
         return FOSSIL_THREADS_MUTEX_OK;
@@ -163,8 +396,143 @@ int fossil_threads_mutex_trylock(fossil_threads_mutex_t *m) {
 #endif
 }
 
+static int fossil__mutex_lock_until_impl(fossil_threads_mutex_t *m, long long deadline_ns) {
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE)
+        return fossil__mutex_adaptive_lock_until(m, deadline_ns);
+
+#if defined(FOSSIL__MUTEX_POLL_TIMED)
+    long long nap = 50000LL; /* 50us, doubling up to 1ms */
+    for (;;) {
+        int rc = fossil__mutex_trylock_impl(m);
+        if (rc != FOSSIL_THREADS_MUTEX_EBUSY) return rc;
+        long long left = deadline_ns - fossil__monotonic_ns();
+        if (left <= 0) return FOSSIL_THREADS_MUTEX_ETIMEDOUT;
+        fossil__sleep_ns(nap < left ? nap : left);
+        if (nap < 1000000LL) nap *= 2;
+    }
+#else
+    struct timespec ts;
+#  if defined(FOSSIL__MUTEX_CLOCKLOCK)
+    /* fossil__monotonic_ns reads CLOCK_MONOTONIC, so the deadline maps 1:1 */
+    long long abs_ns = deadline_ns < 0 ? 0 : deadline_ns;
+    ts.tv_sec = (time_t)(abs_ns / 1000000000LL);
+    ts.tv_nsec = (long)(abs_ns % 1000000000LL);
+    int rc = pthread_mutex_clocklock(fossil__mutex_native(m), CLOCK_MONOTONIC, &ts);
+#  else
+    long long left = deadline_ns - fossil__monotonic_ns();
+    if (left < 0) left = 0;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    long long nsec = (long long)ts.tv_nsec + left % 1000000000LL;
+    ts.tv_sec += (time_t)(left / 1000000000LL + nsec / 1000000000LL);
+    ts.tv_nsec = (long)(nsec % 1000000000LL);
+    int rc = pthread_mutex_timedlock(fossil__mutex_native(m), &ts);
+#  endif
+    if (rc == 0) {
+        m->locked = 1;
+        return FOSSIL_THREADS_MUTEX_OK;
+    }
+    if (rc == ETIMEDOUT)
+        return FOSSIL_THREADS_MUTEX_ETIMEDOUT;
+    if (rc == EINVAL)
+        return FOSSIL_THREADS_MUTEX_EINVAL;
+    if (rc == EDEADLK)
+        return FOSSIL_THREADS_MUTEX_EDEADLK;
+    return FOSSIL_THREADS_MUTEX_EINTERNAL;
+#endif
+}
+
+/* Adaptive relock after a condition wait (see internal.h); normal mutexes
+ * relock through fossil_threads_mutex_lock and are profiled there. */
+void fossil__mutex_lock_contended(fossil_threads_mutex_t *m) {
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    if (fossil__atomic_exchange_u32(&m->state, 2u) == 0) {
+        fossil__mutex_profile_acquired(m, 0, 0);
+        return;
+    }
+    long long t0 = fossil__monotonic_ns();
+    fossil__mutex_park(m);
+    fossil__mutex_profile_acquired(m, 1, fossil__monotonic_ns() - t0);
+#else
+    fossil__mutex_park(m);
+#endif
+}
+
+/* ---------- Locking ---------- */
+
+/*
+** Bookkeeping after a timed acquisition: the contention profile (when built
+** in) and, for a lock that had to wait since t0, a trace event. Only called
+** when one of the two is active; the plain path skips the timing entirely.
+*/
+static void fossil__mutex_acquired(fossil_threads_mutex_t *m, int contended, long long t0) {
+    long long now = contended ? fossil__monotonic_ns() : 0;
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_profile_acquired(m, contended, contended ? now - t0 : 0);
+#endif
+    if (contended && fossil__trace_on())
+        fossil__trace_complete("mutex", "mutex.wait", m->name, t0, now,
+                               (unsigned long long)(uintptr_t)m);
+}
+
+int fossil_threads_mutex_lock(fossil_threads_mutex_t *m) {
+    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+#if !defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    if (!fossil__trace_on()) return fossil__mutex_lock_impl(m);
+#endif
+    int rc = fossil__mutex_trylock_impl(m);
+    if (rc == FOSSIL_THREADS_MUTEX_OK) {
+        fossil__mutex_acquired(m, 0, 0);
+        return rc;
+    }
+    if (rc != FOSSIL_THREADS_MUTEX_EBUSY) return rc;
+    long long t0 = fossil__monotonic_ns();
+    rc = fossil__mutex_lock_impl(m);
+    if (rc == FOSSIL_THREADS_MUTEX_OK) fossil__mutex_acquired(m, 1, t0);
+    return rc;
+}
+
+int fossil_threads_mutex_unlock(fossil_threads_mutex_t *m) {
+    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_profile_release(m);
+#endif
+    return fossil__mutex_unlock_impl(m);
+}
+
+int fossil_threads_mutex_trylock(fossil_threads_mutex_t *m) {
+    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+    int rc = fossil__mutex_trylock_impl(m);
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    if (rc == FOSSIL_THREADS_MUTEX_OK) fossil__mutex_profile_acquired(m, 0, 0);
+#endif
+    return rc;
+}
+
+int fossil_threads_mutex_lock_until(fossil_threads_mutex_t *m, long long deadline_ns) {
+    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+#if !defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    if (!fossil__trace_on()) return fossil__mutex_lock_until_impl(m, deadline_ns);
+#endif
+    int rc = fossil__mutex_trylock_impl(m);
+    if (rc == FOSSIL_THREADS_MUTEX_OK) {
+        fossil__mutex_acquired(m, 0, 0);
+        return rc;
+    }
+    if (rc != FOSSIL_THREADS_MUTEX_EBUSY) return rc;
+    long long t0 = fossil__monotonic_ns();
+    rc = fossil__mutex_lock_until_impl(m, deadline_ns);
+    if (rc == FOSSIL_THREADS_MUTEX_OK) fossil__mutex_acquired(m, 1, t0);
+    return rc;
+}
+
+long long fossil_threads_clock_monotonic_ns(void) {
+    return fossil__monotonic_ns();
+}
+
 bool fossil_threads_mutex_is_locked(const fossil_threads_mutex_t *m) {
     if (!m || !m->valid) return false;
+    if (m->kind == FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE)
+        return fossil__atomic_load_u32(&m->state) != 0;
     return m->locked ? true : false;
 }
 
@@ -178,3 +546,108 @@ void fossil_threads_mutex_reset(fossil_threads_mutex_t *m) {
     fossil_threads_mutex_dispose(m);
     fossil__mutex_zero(m);
 }
+
+/* ---------- Names and profile queries ---------- */
+
+int fossil_threads_mutex_set_name(fossil_threads_mutex_t *m, const char *name) {
+    if (!m || !m->valid) return FOSSIL_THREADS_MUTEX_EINVAL;
+    m->name = name;
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_adaptive_lock(&fossil__mutex_registry_lock);
+    if (m->profile) ((fossil__mutex_record_t *)m->profile)->name = name;
+    fossil__mutex_adaptive_unlock(&fossil__mutex_registry_lock);
+#endif
+    return FOSSIL_THREADS_MUTEX_OK;
+}
+
+const char *fossil_threads_mutex_name(const fossil_threads_mutex_t *m) {
+    if (!m || !m->valid) return NULL;
+    return m->name;
+}
+
+bool fossil_threads_mutex_profile_enabled(void) {
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t fossil_threads_mutex_profile_top(fossil_threads_mutex_profile_t *out, size_t max) {
+    if (!out || max == 0) return 0;
+    size_t n = 0;
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_adaptive_lock(&fossil__mutex_registry_lock);
+    for (const fossil__mutex_record_t *r = fossil__mutex_registry; r; r = r->next) {
+        fossil_threads_mutex_profile_t p;
+        fossil__mutex_profile_copy(r, &p);
+        /* Insertion into the sorted prefix; the coldest entry falls off */
+        size_t i = n < max ? n++ : max;
+        while (i > 0 && fossil__mutex_profile_hotter(&p, &out[i - 1])) {
+            if (i < max) out[i] = out[i - 1];
+            --i;
+        }
+        if (i < max) out[i] = p;
+    }
+    fossil__mutex_adaptive_unlock(&fossil__mutex_registry_lock);
+#endif
+    return n;
+}
+
+size_t fossil_threads_mutex_profile_dump(fossil_threads_mutex_profile_write_func write,
+                                         void *ctx, size_t n) {
+    if (!write || n == 0) return 0;
+    fossil_threads_mutex_profile_t *top =
+        (fossil_threads_mutex_profile_t *)malloc(n * sizeof(*top));
+    if (!top) return 0;
+    size_t count = fossil_threads_mutex_profile_top(top, n);
+    char line[160];
+    int len = 0;
+    if (count > 0) {
+        len = snprintf(line, sizeof(line), "%-32s %14s %14s %16s %14s %14s\n", "mutex", "acquisitions",
+                       "contended", "wait_total_ns", "wait_max_ns", "hold_max_ns");
+        if (write(ctx, line, (size_t)len) != 0) count = 0;
+    }
+    size_t written = 0;
+    for (; written < count; ++written) {
+        const fossil_threads_mutex_profile_t *p = &top[written];
+        char label[33];
+        if (p->name)
+            snprintf(label, sizeof(label), "%s", p->name);
+        else if (p->mutex)
+            snprintf(label, sizeof(label), "%p", p->mutex);
+        else
+            snprintf(label, sizeof(label), "(disposed)");
+        len = snprintf(line, sizeof(line), "%-32s %14llu %14llu %16llu %14llu %14llu\n", label,
+                       p->acquisitions, p->contended, p->wait_ns_total, p->wait_ns_max, p->hold_ns_max);
+        if (len < 0) break;
+        if ((size_t)len >= sizeof(line)) len = (int)sizeof(line) - 1;
+        if (write(ctx, line, (size_t)len) != 0) break;
+    }
+    free(top);
+    return written;
+}
+
+void fossil_threads_mutex_profile_reset(void) {
+#if defined(FOSSIL_THREADS_MUTEX_PROFILE)
+    fossil__mutex_adaptive_lock(&fossil__mutex_registry_lock);
+    fossil__mutex_record_t **link = &fossil__mutex_registry;
+    while (*link) {
+        fossil__mutex_record_t *r = *link;
+        if (!r->mutex) {
+            *link = r->next;
+            free(r);
+            continue;
+        }
+        fossil__atomic_store_i64(&r->acquisitions, 0);
+        fossil__atomic_store_i64(&r->contended, 0);
+        fossil__atomic_store_i64(&r->wait_total, 0);
+        fossil__atomic_store_i64(&r->wait_max, 0);
+        fossil__atomic_store_i64(&r->hold_max, 0);
+        for (int i = 0; i < FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS; ++i)
+            fossil__atomic_store_i64(&r->histogram[i], 0);
+        link = &r->next;
+    }
+    fossil__mutex_adaptive_unlock(&fossil__mutex_registry_lock);
+#endif
+}
@@ -0,0 +1,389 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#if defined(__linux__)
+#  define _GNU_SOURCE /* pthread_rwlock_clockrdlock() */
+#else
+#  define _POSIX_C_SOURCE 200809L
+#endif
+#include "fossil/threads/rwlock.h"
+#include <string.h>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#  include <errno.h>
+#  include <time.h>
+#endif
+
+#include "internal.h"
+
+#if defined(_WIN32)
+typedef SRWLOCK fossil__rwlock_native_t;
+#else
+typedef pthread_rwlock_t fossil__rwlock_native_t;
+#endif
+
+_Static_assert(sizeof(fossil__rwlock_native_t) <= FOSSIL_THREADS_RWLOCK_STORAGE_SIZE,
+               "FOSSIL_THREADS_RWLOCK_STORAGE_SIZE too small for the platform rwlock");
+
+/* Windows and macOS have no timed rwlock acquire; the native policy polls
+ * there. glibc 2.30+ waits against CLOCK_MONOTONIC, like mutex.c; other
+ * POSIX systems only take a CLOCK_REALTIME deadline. */
+#if defined(_WIN32) || defined(__APPLE__)
+#  define FOSSIL__RWLOCK_POLL_TIMED 1
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#  define FOSSIL__RWLOCK_CLOCKLOCK 1
+#endif
+
+static inline fossil__rwlock_native_t *fossil__rwlock_native(fossil_threads_rwlock_t *rw) {
+    return (fossil__rwlock_native_t *)(void *)rw->storage.bytes;
+}
+
+static void fossil__rwlock_zero(fossil_threads_rwlock_t *rw) {
+    if (rw) memset(rw, 0, sizeof(*rw));
+}
+
+static long long fossil__rwlock_deadline(unsigned int ms) {
+    return fossil__monotonic_ns() + (long long)ms * 1000000LL;
+}
+
+/* ============================================================================
+** Policy Locks
+** ----------------------------------------------------------------------------
+** state holds the write bit and the reader count. Blocked threads park on the
+** separate seq word: they publish themselves in sleepers, sample seq, then
+** retry; a release changes state (or writers), reads sleepers, and bumps seq
+** only if someone may be parked. The waiter fences after publishing and the
+** releaser reads sleepers with an SC load, so either the retry observes the
+** release or the release observes the sleeper.
+** Readers only wake others when the last one leaves, which keeps the read
+** path to one RMW on enter and one on exit.
+** --------------------------------------------------------------------------*/
+#define FOSSIL__RW_WRITER  0x80000000u
+#define FOSSIL__RW_READERS 0x7fffffffu
+#define FOSSIL__RW_SPIN    64
+
+static void fossil__rw_wake(fossil_threads_rwlock_t *rw) {
+    if (fossil__atomic_load_sc_u32(&rw->sleepers) == 0) return;
+    fossil__atomic_add_u32(&rw->seq, 1u);
+    fossil__futex_wake_all(&rw->seq);
+}
+
+static int fossil__rw_try_read(fossil_threads_rwlock_t *rw) {
+    for (;;) {
+        unsigned int s = fossil__atomic_load_u32(&rw->state);
+        if (s & FOSSIL__RW_WRITER) return FOSSIL_THREADS_RWLOCK_EBUSY;
+        if ((s & FOSSIL__RW_READERS) == FOSSIL__RW_READERS) return FOSSIL_THREADS_RWLOCK_EAGAIN;
+        if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER &&
+            fossil__atomic_load_u32(&rw->writers) != 0)
+            return FOSSIL_THREADS_RWLOCK_EBUSY;
+        if (fossil__atomic_cas_u32(&rw->state, &s, s + 1u)) return FOSSIL_THREADS_RWLOCK_OK;
+    }
+}
+
+static int fossil__rw_try_write(fossil_threads_rwlock_t *rw) {
+    unsigned int s = 0;
+    if (fossil__atomic_cas_u32(&rw->state, &s, FOSSIL__RW_WRITER)) return FOSSIL_THREADS_RWLOCK_OK;
+    return FOSSIL_THREADS_RWLOCK_EBUSY;
+}
+
+/* deadline < 0 waits forever */
+static int fossil__rw_acquire(fossil_threads_rwlock_t *rw, int write, long long deadline) {
+    int rc = write ? fossil__rw_try_write(rw) : fossil__rw_try_read(rw);
+    if (rc != FOSSIL_THREADS_RWLOCK_EBUSY) return rc;
+
+    /* A queued writer holds back new readers under PREFER_WRITER */
+    if (write) fossil__atomic_add_u32(&rw->writers, 1u);
+
+    for (int i = 0; i < FOSSIL__RW_SPIN && rc == FOSSIL_THREADS_RWLOCK_EBUSY; ++i) {
+        fossil__cpu_relax();
+        rc = write ? fossil__rw_try_write(rw) : fossil__rw_try_read(rw);
+    }
+
+    while (rc == FOSSIL_THREADS_RWLOCK_EBUSY) {
+        long long timeout = FOSSIL__FUTEX_INFINITE;
+        fossil__atomic_add_u32(&rw->sleepers, 1u);
+        fossil__atomic_fence();
+        unsigned int seq = fossil__atomic_load_u32(&rw->seq);
+
+        rc = write ? fossil__rw_try_write(rw) : fossil__rw_try_read(rw);
+        if (rc == FOSSIL_THREADS_RWLOCK_EBUSY && deadline >= 0) {
+            timeout = deadline - fossil__monotonic_ns();
+            if (timeout <= 0) rc = FOSSIL_THREADS_RWLOCK_ETIMEDOUT;
+        }
+        if (rc == FOSSIL_THREADS_RWLOCK_EBUSY) fossil__futex_wait(&rw->seq, seq, timeout);
+        fossil__atomic_add_u32(&rw->sleepers, (unsigned int)-1);
+    }
+
+    if (write) {
+        fossil__atomic_add_u32(&rw->writers, (unsigned int)-1);
+        /* Readers held back by this writer may enter now that it gave up */
+        if (rc != FOSSIL_THREADS_RWLOCK_OK) fossil__rw_wake(rw);
+    }
+    return rc;
+}
+
+static int fossil__rw_release(fossil_threads_rwlock_t *rw) {
+    unsigned int s = FOSSIL__RW_WRITER;
+    if (fossil__atomic_cas_u32(&rw->state, &s, 0u)) {
+        fossil__rw_wake(rw);
+        return FOSSIL_THREADS_RWLOCK_OK;
+    }
+    for (;;) {
+        if ((s & FOSSIL__RW_READERS) == 0) return FOSSIL_THREADS_RWLOCK_EUNLOCK;
+        if (fossil__atomic_cas_u32(&rw->state, &s, s - 1u)) break;
+    }
+    if (s == 1u) fossil__rw_wake(rw);
+    return FOSSIL_THREADS_RWLOCK_OK;
+}
+
+/* ============================================================================
+** Native Locks
+** --------------------------------------------------------------------------*/
+#if !defined(_WIN32)
+static int fossil__rwlock_map_errno(int rc) {
+    if (rc == 0) return FOSSIL_THREADS_RWLOCK_OK;
+    if (rc == EBUSY) return FOSSIL_THREADS_RWLOCK_EBUSY;
+    if (rc == ETIMEDOUT) return FOSSIL_THREADS_RWLOCK_ETIMEDOUT;
+    if (rc == EINVAL) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rc == EAGAIN) return FOSSIL_THREADS_RWLOCK_EAGAIN;
+    if (rc == EDEADLK) return FOSSIL_THREADS_RWLOCK_EDEADLK;
+    if (rc == ENOMEM) return FOSSIL_THREADS_RWLOCK_ENOMEM;
+    if (rc == EPERM) return FOSSIL_THREADS_RWLOCK_EPERM;
+    return FOSSIL_THREADS_RWLOCK_EINTERNAL;
+}
+#endif
+
+static int fossil__rwlock_native_try(fossil_threads_rwlock_t *rw, int write) {
+#if defined(_WIN32)
+    if (write) {
+        if (!TryAcquireSRWLockExclusive(fossil__rwlock_native(rw))) return FOSSIL_THREADS_RWLOCK_EBUSY;
+        rw->write_held = 1;
+        return FOSSIL_THREADS_RWLOCK_OK;
+    }
+    return TryAcquireSRWLockShared(fossil__rwlock_native(rw))
+        ? FOSSIL_THREADS_RWLOCK_OK : FOSSIL_THREADS_RWLOCK_EBUSY;
+#else
+    int rc = write ? pthread_rwlock_trywrlock(fossil__rwlock_native(rw))
+                   : pthread_rwlock_tryrdlock(fossil__rwlock_native(rw));
+    if (rc == 0 && write) rw->write_held = 1;
+    return fossil__rwlock_map_errno(rc);
+#endif
+}
+
+static int fossil__rwlock_native_lock(fossil_threads_rwlock_t *rw, int write) {
+#if defined(_WIN32)
+    if (write) {
+        AcquireSRWLockExclusive(fossil__rwlock_native(rw));
+        rw->write_held = 1;
+    } else {
+        AcquireSRWLockShared(fossil__rwlock_native(rw));
+    }
+    return FOSSIL_THREADS_RWLOCK_OK;
+#else
+    int rc = write ? pthread_rwlock_wrlock(fossil__rwlock_native(rw))
+                   : pthread_rwlock_rdlock(fossil__rwlock_native(rw));
+    if (rc == 0 && write) rw->write_held = 1;
+    return fossil__rwlock_map_errno(rc);
+#endif
+}
+
+static int fossil__rwlock_native_timed(fossil_threads_rwlock_t *rw, int write, unsigned int ms) {
+#if defined(FOSSIL__RWLOCK_POLL_TIMED)
+    long long deadline = fossil__rwlock_deadline(ms);
+    long long nap = 50000LL; /* 50us, doubling up to 1ms */
+    for (;;) {
+        int rc = fossil__rwlock_native_try(rw, write);
+        if (rc != FOSSIL_THREADS_RWLOCK_EBUSY) return rc;
+        long long left = deadline - fossil__monotonic_ns();
+        if (left <= 0) return FOSSIL_THREADS_RWLOCK_ETIMEDOUT;
+        fossil__sleep_ns(nap < left ? nap : left);
+        if (nap < 1000000LL) nap *= 2;
+    }
+#else
+    struct timespec ts;
+#  if defined(FOSSIL__RWLOCK_CLOCKLOCK)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#  else
+    clock_gettime(CLOCK_REALTIME, &ts);
+#  endif
+
+    ts.tv_sec += ms / 1000u;
+    ts.tv_nsec += (long)(ms % 1000u) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+
+#  if defined(FOSSIL__RWLOCK_CLOCKLOCK)
+    int rc = write ? pthread_rwlock_clockwrlock(fossil__rwlock_native(rw), CLOCK_MONOTONIC, &ts)
+                   : pthread_rwlock_clockrdlock(fossil__rwlock_native(rw), CLOCK_MONOTONIC, &ts);
+#  else
+    int rc = write ? pthread_rwlock_timedwrlock(fossil__rwlock_native(rw), &ts)
+                   : pthread_rwlock_timedrdlock(fossil__rwlock_native(rw), &ts);
+#  endif
+    if (rc == 0 && write) rw->write_held = 1;
+    return fossil__rwlock_map_errno(rc);
+#endif
+}
+
+static int fossil__rwlock_native_unlock(fossil_threads_rwlock_t *rw) {
+    /* write_held is only written by the exclusive owner, so readers see 0 */
+    int write = rw->write_held;
+    if (write) rw->write_held = 0;
+#if defined(_WIN32)
+    if (write) ReleaseSRWLockExclusive(fossil__rwlock_native(rw));
+    else ReleaseSRWLockShared(fossil__rwlock_native(rw));
+    return FOSSIL_THREADS_RWLOCK_OK;
+#else
+    (void)write;
+    int rc = pthread_rwlock_unlock(fossil__rwlock_native(rw));
+    if (rc == EPERM) return FOSSIL_THREADS_RWLOCK_EUNLOCK;
+    return fossil__rwlock_map_errno(rc);
+#endif
+}
+
+/* ============================================================================
+** Public API
+** --------------------------------------------------------------------------*/
+
+/* ---------- Lifecycle ---------- */
+
+int fossil_threads_rwlock_init(fossil_threads_rwlock_t *rw) {
+    return fossil_threads_rwlock_init_ex(rw, FOSSIL_THREADS_RWLOCK_POLICY_NATIVE);
+}
+
+int fossil_threads_rwlock_init_ex(fossil_threads_rwlock_t *rw, int policy) {
+    if (!rw) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (policy != FOSSIL_THREADS_RWLOCK_POLICY_NATIVE &&
+        policy != FOSSIL_THREADS_RWLOCK_POLICY_PREFER_READER &&
+        policy != FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER)
+        return FOSSIL_THREADS_RWLOCK_EINVAL;
+
+    fossil__rwlock_zero(rw);
+    if (policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) {
+#if defined(_WIN32)
+        InitializeSRWLock(fossil__rwlock_native(rw));
+#else
+        int rc = pthread_rwlock_init(fossil__rwlock_native(rw), NULL);
+        if (rc != 0) return fossil__rwlock_map_errno(rc);
+#endif
+    }
+    rw->policy = policy;
+    rw->valid = 1;
+    return FOSSIL_THREADS_RWLOCK_OK;
+}
+
+void fossil_threads_rwlock_dispose(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return;
+#if !defined(_WIN32)
+    /* SRWLOCKs need no teardown */
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE)
+        pthread_rwlock_destroy(fossil__rwlock_native(rw));
+#endif
+    fossil__rwlock_zero(rw);
+}
+
+/* ---------- Shared (read) locking ---------- */
+
+int fossil_threads_rwlock_rdlock(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_lock(rw, 0);
+    return fossil__rw_acquire(rw, 0, -1);
+}
+
+int fossil_threads_rwlock_tryrdlock(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_try(rw, 0);
+    return fossil__rw_try_read(rw);
+}
+
+int fossil_threads_rwlock_timedrdlock(fossil_threads_rwlock_t *rw, unsigned int ms) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_timed(rw, 0, ms);
+    return fossil__rw_acquire(rw, 0, fossil__rwlock_deadline(ms));
+}
+
+/* ---------- Exclusive (write) locking ---------- */
+
+int fossil_threads_rwlock_wrlock(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_lock(rw, 1);
+    return fossil__rw_acquire(rw, 1, -1);
+}
+
+int fossil_threads_rwlock_trywrlock(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_try(rw, 1);
+    return fossil__rw_try_write(rw);
+}
+
+int fossil_threads_rwlock_timedwrlock(fossil_threads_rwlock_t *rw, unsigned int ms) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_timed(rw, 1, ms);
+    return fossil__rw_acquire(rw, 1, fossil__rwlock_deadline(ms));
+}
+
+/* ---------- Release and conversion ---------- */
+
+int fossil_threads_rwlock_unlock(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return fossil__rwlock_native_unlock(rw);
+    return fossil__rw_release(rw);
+}
+
+int fossil_threads_rwlock_try_upgrade(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return FOSSIL_THREADS_RWLOCK_EUNSUPPORTED;
+
+    unsigned int s = 1u;
+    if (fossil__atomic_cas_u32(&rw->state, &s, FOSSIL__RW_WRITER)) return FOSSIL_THREADS_RWLOCK_OK;
+    if ((s & FOSSIL__RW_WRITER) || (s & FOSSIL__RW_READERS) == 0) return FOSSIL_THREADS_RWLOCK_EPERM;
+    return FOSSIL_THREADS_RWLOCK_EBUSY;
+}
+
+int fossil_threads_rwlock_downgrade(fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return FOSSIL_THREADS_RWLOCK_EINVAL;
+    if (rw->policy == FOSSIL_THREADS_RWLOCK_POLICY_NATIVE) return FOSSIL_THREADS_RWLOCK_EUNSUPPORTED;
+
+    unsigned int s = FOSSIL__RW_WRITER;
+    if (!fossil__atomic_cas_u32(&rw->state, &s, 1u)) return FOSSIL_THREADS_RWLOCK_EUNLOCK;
+    fossil__rw_wake(rw);
+    return FOSSIL_THREADS_RWLOCK_OK;
+}
+
+/* ---------- Queries ---------- */
+
+bool fossil_threads_rwlock_is_initialized(const fossil_threads_rwlock_t *rw) {
+    if (!rw) return false;
+    return rw->valid ? true : false;
+}
+
+int fossil_threads_rwlock_policy(const fossil_threads_rwlock_t *rw) {
+    if (!rw || !rw->valid) return -1;
+    return rw->policy;
+}
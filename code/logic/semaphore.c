@@ -0,0 +1,131 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/semaphore.h"
+#include "fossil/threads/thread.h"
+#include <stddef.h>
+
+#include "internal.h"
+
+// *****************************************************************************
+// Internal helpers
+// *****************************************************************************
+
+/*
+** value is both the count and the park word. A waiter registers in waiters
+** with a full fence before it re-reads value and parks on 0; post raises
+** value before it reads waiters, so a post racing a waiter that is about to
+** park either sees it counted or the waiter sees the new unit.
+*/
+
+static int fossil__sem_take(fossil_threads_sem_t *s) {
+    unsigned int v = fossil__atomic_load_u32(&s->value);
+    while (v != 0u) {
+        if (fossil__atomic_cas_u32(&s->value, &v, v - 1u)) return 1;
+    }
+    return 0;
+}
+
+/* deadline_ns is absolute, or NULL to wait for as long as it takes. */
+static int fossil__sem_wait(fossil_threads_sem_t *s, const long long *deadline_ns) {
+    if (fossil__sem_take(s)) return FOSSIL_THREADS_SEM_OK;
+    if (fossil__spin_while_eq(&s->value, 0u, s->spin) && fossil__sem_take(s))
+        return FOSSIL_THREADS_SEM_OK;
+
+    int rc = FOSSIL_THREADS_SEM_OK;
+    fossil__atomic_add_u32(&s->waiters, 1u);
+    fossil__atomic_fence();
+    while (!fossil__sem_take(s)) {
+        long long wait_ns = FOSSIL__FUTEX_INFINITE;
+        if (deadline_ns) {
+            wait_ns = *deadline_ns - fossil__monotonic_ns();
+            if (wait_ns <= 0) { rc = FOSSIL_THREADS_SEM_ETIMEDOUT; break; }
+        }
+        fossil__futex_wait(&s->value, 0u, wait_ns);
+    }
+    fossil__atomic_add_u32(&s->waiters, (unsigned int)-1);
+    return rc;
+}
+
+// *****************************************************************************
+// Function implementations
+// *****************************************************************************
+
+int fossil_threads_sem_init(fossil_threads_sem_t *s, unsigned int initial, unsigned int spin) {
+    if (!s || initial > FOSSIL_THREADS_SEM_VALUE_MAX) return FOSSIL_THREADS_SEM_EINVAL;
+    s->value = initial;
+    s->waiters = 0u;
+    /* Spinning only pays off if the poster can run meanwhile. */
+    s->spin = fossil_threads_cpu_count() > 1 ? spin : 0u;
+    return FOSSIL_THREADS_SEM_OK;
+}
+
+void fossil_threads_sem_dispose(fossil_threads_sem_t *s) {
+    if (!s) return;
+    s->value = 0u;
+}
+
+int fossil_threads_sem_wait(fossil_threads_sem_t *s) {
+    if (!s) return FOSSIL_THREADS_SEM_EINVAL;
+    return fossil__sem_wait(s, NULL);
+}
+
+int fossil_threads_sem_trywait(fossil_threads_sem_t *s) {
+    if (!s) return FOSSIL_THREADS_SEM_EINVAL;
+    return fossil__sem_take(s) ? FOSSIL_THREADS_SEM_OK : FOSSIL_THREADS_SEM_EAGAIN;
+}
+
+int fossil_threads_sem_wait_until(fossil_threads_sem_t *s, long long deadline_ns) {
+    if (!s) return FOSSIL_THREADS_SEM_EINVAL;
+    return fossil__sem_wait(s, &deadline_ns);
+}
+
+int fossil_threads_sem_timedwait(fossil_threads_sem_t *s, unsigned int ms) {
+    if (!s) return FOSSIL_THREADS_SEM_EINVAL;
+    long long deadline_ns = fossil__monotonic_ns() + (long long)ms * 1000000LL;
+    return fossil__sem_wait(s, &deadline_ns);
+}
+
+int fossil_threads_sem_post_n(fossil_threads_sem_t *s, unsigned int n) {
+    if (!s) return FOSSIL_THREADS_SEM_EINVAL;
+    if (n == 0u) return FOSSIL_THREADS_SEM_OK;
+    unsigned int v = fossil__atomic_load_u32(&s->value);
+    do {
+        if (n > FOSSIL_THREADS_SEM_VALUE_MAX - v) return FOSSIL_THREADS_SEM_EOVERFLOW;
+    } while (!fossil__atomic_cas_u32(&s->value, &v, v + n));
+
+    if (fossil__atomic_load_sc_u32(&s->waiters) != 0u) {
+        if (n == 1u) fossil__futex_wake_one(&s->value);
+        else fossil__futex_wake_all(&s->value);
+    }
+    return FOSSIL_THREADS_SEM_OK;
+}
+
+int fossil_threads_sem_post(fossil_threads_sem_t *s) {
+    return fossil_threads_sem_post_n(s, 1u);
+}
+
+unsigned int fossil_threads_sem_value(const fossil_threads_sem_t *s) {
+    return s ? fossil__atomic_load_u32(&s->value) : 0u;
+}
@@ -0,0 +1,138 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/seqlock.h"
+#include "fossil/threads/thread.h"
+#include <stdint.h>
+
+#include "internal.h"
+
+/* Reader spins before it starts yielding to a descheduled writer */
+#define FOSSIL__SEQLOCK_SPIN 128
+
+// *****************************************************************************
+// Internal helpers
+// *****************************************************************************
+
+/*
+** Ordering follows the classic seqlock recipe: the writer makes the sequence
+** odd and issues a release fence before touching the data, and publishes the
+** next even value with a release store. Readers load the sequence with
+** acquire, copy with relaxed accesses, and issue an acquire fence before
+** re-reading it, so any data written by an overlapping writer forces a retry.
+*/
+
+static void fossil__seqlock_park(fossil_threads_seqlock_t *sl, unsigned int s) {
+    /* Same waiter/releaser handshake as the rwlock: RMW, full fence, re-load */
+    fossil__atomic_add_u32(&sl->waiters, 1u);
+    fossil__atomic_fence();
+    if (fossil__atomic_load_u32(&sl->seq) == s)
+        fossil__futex_wait(&sl->seq, s, FOSSIL__FUTEX_INFINITE);
+    fossil__atomic_add_u32(&sl->waiters, (unsigned int)-1);
+}
+
+// *****************************************************************************
+// Function implementations
+// *****************************************************************************
+
+int fossil_threads_seqlock_init(fossil_threads_seqlock_t *sl) {
+    if (!sl) return FOSSIL_THREADS_SEQLOCK_EINVAL;
+    sl->seq = 0u;
+    sl->waiters = 0u;
+    return FOSSIL_THREADS_SEQLOCK_OK;
+}
+
+unsigned int fossil_threads_seqlock_read_begin(const fossil_threads_seqlock_t *sl) {
+    unsigned int s = fossil__atomic_load_u32(&sl->seq);
+    int spins = 0;
+    while (s & 1u) {
+        if (++spins < FOSSIL__SEQLOCK_SPIN) fossil__cpu_relax();
+        else fossil_threads_thread_yield();
+        s = fossil__atomic_load_u32(&sl->seq);
+    }
+    return s;
+}
+
+bool fossil_threads_seqlock_read_retry(const fossil_threads_seqlock_t *sl, unsigned int start) {
+    fossil__atomic_fence_acquire();
+    return fossil__atomic_load_relaxed_u32(&sl->seq) != start;
+}
+
+void fossil_threads_seqlock_read(const fossil_threads_seqlock_t *sl,
+                                 void *dst, const void *src, size_t size) {
+    unsigned int s;
+    do {
+        s = fossil_threads_seqlock_read_begin(sl);
+        fossil_threads_seqlock_copy(dst, src, size);
+    } while (fossil_threads_seqlock_read_retry(sl, s));
+}
+
+void fossil_threads_seqlock_write_lock(fossil_threads_seqlock_t *sl) {
+    for (int spins = 0;; ++spins) {
+        unsigned int s = fossil__atomic_load_u32(&sl->seq);
+        if (!(s & 1u)) {
+            if (fossil__atomic_cas_u32(&sl->seq, &s, s + 1u)) break;
+            continue;
+        }
+        if (spins < FOSSIL__SEQLOCK_SPIN) fossil__cpu_relax();
+        else fossil__seqlock_park(sl, s);
+    }
+    fossil__atomic_fence_release();
+}
+
+int fossil_threads_seqlock_write_trylock(fossil_threads_seqlock_t *sl) {
+    unsigned int s = fossil__atomic_load_u32(&sl->seq);
+    if ((s & 1u) || !fossil__atomic_cas_u32(&sl->seq, &s, s + 1u))
+        return FOSSIL_THREADS_SEQLOCK_EBUSY;
+    fossil__atomic_fence_release();
+    return FOSSIL_THREADS_SEQLOCK_OK;
+}
+
+void fossil_threads_seqlock_write_unlock(fossil_threads_seqlock_t *sl) {
+    unsigned int s = fossil__atomic_load_relaxed_u32(&sl->seq);
+    fossil__atomic_store_u32(&sl->seq, s + 1u);
+    if (fossil__atomic_load_sc_u32(&sl->waiters) != 0u)
+        fossil__futex_wake_one(&sl->seq);
+}
+
+void fossil_threads_seqlock_write(fossil_threads_seqlock_t *sl,
+                                  void *dst, const void *src, size_t size) {
+    fossil_threads_seqlock_write_lock(sl);
+    fossil_threads_seqlock_copy(dst, src, size);
+    fossil_threads_seqlock_write_unlock(sl);
+}
+
+void fossil_threads_seqlock_copy(void *dst, const void *src, size_t size) {
+    volatile unsigned char *d = (volatile unsigned char *)dst;
+    const volatile unsigned char *s = (const volatile unsigned char *)src;
+    size_t i = 0;
+
+    if ((((uintptr_t)d | (uintptr_t)s) % sizeof(size_t)) == 0) {
+        for (; i + sizeof(size_t) <= size; i += sizeof(size_t))
+            fossil__atomic_store_relaxed_size((volatile size_t *)(d + i),
+                                              fossil__atomic_load_relaxed_size((const volatile size_t *)(s + i)));
+    }
+    for (; i < size; ++i)
+        fossil__atomic_store_relaxed_u8(d + i, fossil__atomic_load_relaxed_u8(s + i));
+}
@@ -22,9 +22,14 @@
  * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
  * -----------------------------------------------------------------------------
  */
-#define _POSIX_C_SOURCE 199309L
+#if defined(__linux__)
+#  define _GNU_SOURCE /* CPU_SET, pthread_setaffinity_np, sched_getcpu */
+#endif
+#define _POSIX_C_SOURCE 200809L
 #include "fossil/threads/thread.h"
+#include "fossil/threads/trace.h"
 
+#include <stdio.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -43,7 +48,6 @@
 #  include <unistd.h>
 #  include <sys/types.h>
 #else
-#  define _GNU_SOURCE
 #  include <pthread.h>
 #  include <sched.h>
 #  include <time.h>
@@ -51,15 +55,74 @@
 #  include <sys/types.h>
 #endif
 
+#if !defined(_WIN32)
+#  include <limits.h>     /* PTHREAD_STACK_MIN */
+#endif
+#if defined(__linux__)
+#  include <sys/mman.h>
+#endif
+
+#include "internal.h"
 
 /* ============================================================================
-** Thread Start Context
+** Inline Start State
+** --------------------------------------------------------------------------
+** The new thread receives the thread object itself and reads its entry
+** point from start_func / start_arg; on POSIX the pthread_t lives in
+** native_storage. handle only marks whether that storage is valid, so
+** create, join and detach never touch the heap.
 ** --------------------------------------------------------------------------*/
-typedef struct fossil__thread_start_ctx {
-    fossil_threads_thread_func func;
-    void *arg;
-    fossil_threads_thread_t *owner;
-} fossil__thread_start_ctx;
+#if !defined(_WIN32)
+typedef char fossil__pthread_fits_inline[
+    sizeof(pthread_t) <= sizeof(((fossil_threads_thread_t*)0)->native_storage) ? 1 : -1];
+
+static pthread_t *fossil__pthread(const fossil_threads_thread_t *t) {
+    return (pthread_t*)(void*)t->native_storage;
+}
+#endif
+
+/* ============================================================================
+** Completion Word
+** --------------------------------------------------------------------------
+** exit_state is the one field a finishing thread publishes through. The
+** thread swaps in DONE as its very last touch of the object and, only if a
+** waiter flagged itself, wakes the word's address; the wake never reads the
+** object, so a dispose() that reuses it the moment DONE is seen is safe.
+** Waiters set WAITERS before parking so an exit with nobody waiting costs
+** no system call.
+** --------------------------------------------------------------------------*/
+#define FOSSIL__EXIT_DONE    1u
+#define FOSSIL__EXIT_WAITERS 2u
+
+static void fossil__thread_publish_exit(fossil_threads_thread_t *self) {
+    volatile unsigned int *word = &self->exit_state;
+    if (fossil__atomic_exchange_u32(word, FOSSIL__EXIT_DONE) & FOSSIL__EXIT_WAITERS)
+        fossil__futex_wake_all(word);
+}
+
+static int fossil__thread_exited(const fossil_threads_thread_t *t) {
+    return (fossil__atomic_load_u32(&t->exit_state) & FOSSIL__EXIT_DONE) != 0;
+}
+
+/* Parks until the thread function has returned; timeout_ns < 0 waits forever. */
+static int fossil__thread_wait_exit(fossil_threads_thread_t *t, long long timeout_ns) {
+    long long deadline = timeout_ns < 0 ? 0 : fossil__monotonic_ns() + timeout_ns;
+    for (;;) {
+        unsigned int s = fossil__atomic_load_u32(&t->exit_state);
+        if (s & FOSSIL__EXIT_DONE) return FOSSIL_THREADS_OK;
+        if (!(s & FOSSIL__EXIT_WAITERS)) {
+            if (!fossil__atomic_cas_u32(&t->exit_state, &s, s | FOSSIL__EXIT_WAITERS))
+                continue;
+            s |= FOSSIL__EXIT_WAITERS;
+        }
+        long long wait_ns = FOSSIL__FUTEX_INFINITE;
+        if (timeout_ns >= 0) {
+            wait_ns = deadline - fossil__monotonic_ns();
+            if (wait_ns <= 0) return FOSSIL_THREADS_ETIMEDOUT;
+        }
+        fossil__futex_wait(&t->exit_state, s, wait_ns);
+    }
+}
 
 /* ============================================================================
 ** Internal Utilities
@@ -99,36 +162,21 @@ void fossil_threads_thread_dispose(fossil_threads_thread_t *t) {
         WaitForSingleObject(h, INFINITE);
         CloseHandle(h);
         t->handle = NULL;
-    } else {
-        /* If no handle but thread is still running, spin-wait until finished. */
-        while (t->started && !t->finished) {
-            Sleep(1);
-        }
+    } else if (t->started) {
+        /* No handle left to wait on: park on the completion word. */
+        fossil__thread_wait_exit(t, FOSSIL__FUTEX_INFINITE);
     }
 #else
-    if (t->handle) {
-        pthread_t *pth = (pthread_t*)t->handle;
-        if (t->joinable) {
-            /* If still joinable, join and free the stored pthread_t. */
-            void *ret = NULL;
-            pthread_join(*pth, &ret);
-            free(pth);
-            t->handle = NULL;
-        } else {
-            /* Detached: cannot pthread_join; wait for the worker to mark finished. */
-            while (t->started && !t->finished) {
-                struct timespec ts = {0, 1000000L}; /* 1ms */
-                nanosleep(&ts, NULL);
-            }
-            free(pth);
-            t->handle = NULL;
-        }
-    } else {
-        /* No handle pointer available (e.g. detach already freed it). Wait for finish. */
-        while (t->started && !t->finished) {
-            struct timespec ts = {0, 1000000L}; /* 1ms */
-            nanosleep(&ts, NULL);
-        }
+    if (t->handle && t->joinable) {
+        /* If still joinable, join the stored pthread_t. */
+        void *ret = NULL;
+        pthread_join(*fossil__pthread(t), &ret);
+        t->handle = NULL;
+    } else if (t->started) {
+        /* Detached or handle-less: cannot pthread_join, so park on the
+         * completion word until the worker publishes its exit. */
+        fossil__thread_wait_exit(t, FOSSIL__FUTEX_INFINITE);
+        t->handle = NULL;
     }
 #endif
 
@@ -136,59 +184,168 @@ void fossil_threads_thread_dispose(fossil_threads_thread_t *t) {
 }
 
 /* ============================================================================
-** Windows Implementation
+** Creation Attributes
 ** --------------------------------------------------------------------------*/
+void fossil_threads_thread_attr_init(fossil_threads_thread_attr_t *attr) {
+    if (!attr) return;
+    memset(attr, 0, sizeof(*attr));
+    attr->policy = FOSSIL_THREADS_POLICY_DEFAULT;
+}
+
+static int fossil__thread_attr_check(const fossil_threads_thread_attr_t *attr) {
+    if (attr->stack && attr->stack_size == 0) return FOSSIL_THREADS_EINVAL;
+    if (attr->policy != FOSSIL_THREADS_POLICY_DEFAULT &&
+        attr->policy != FOSSIL_THREADS_POLICY_FIFO &&
+        attr->policy != FOSSIL_THREADS_POLICY_RR)
+        return FOSSIL_THREADS_EINVAL;
+    return FOSSIL_THREADS_OK;
+}
+
 #if defined(_WIN32)
-static unsigned __stdcall fossil__thread_start(void *param) {
-    fossil__thread_start_ctx *ctx = (fossil__thread_start_ctx*)param;
-    fossil_threads_thread_t *self = ctx ? ctx->owner : NULL;
-    if (self) {
-        self->started = 1;
-        self->start_time_ns = GetTickCount64() * 1000000ULL;
+/* Map the portable -2..2 priority scale onto Windows thread priorities. */
+static int fossil__win_priority(int priority) {
+    switch (priority) {
+        case 2: return THREAD_PRIORITY_HIGHEST;
+        case 1: return THREAD_PRIORITY_ABOVE_NORMAL;
+        case -1: return THREAD_PRIORITY_BELOW_NORMAL;
+        case -2: return THREAD_PRIORITY_LOWEST;
+        default: return THREAD_PRIORITY_NORMAL;
     }
+}
+#else
+#if defined(PTHREAD_STACK_MIN)
+#  define FOSSIL__THREAD_STACK_MIN ((size_t)PTHREAD_STACK_MIN)
+#else
+#  define FOSSIL__THREAD_STACK_MIN ((size_t)16384)
+#endif
+
+/* Map the portable priority scale onto the range of a POSIX policy. */
+static int fossil__sched_priority(int policy, int priority) {
+    int min = sched_get_priority_min(policy);
+    int max = sched_get_priority_max(policy);
+    if (priority > 0) return max;
+    if (priority < 0) return min;
+    return (min + max) / 2;
+}
 
-    void *ret = ctx && ctx->func ? ctx->func(ctx->arg) : NULL;
+/* Translate creation attributes; pa is left initialized only on success. */
+static int fossil__thread_attr_apply(pthread_attr_t *pa, const fossil_threads_thread_attr_t *attr) {
+    if (pthread_attr_init(pa) != 0) return FOSSIL_THREADS_EINTERNAL;
 
-    if (self) {
-        self->retval = ret;
-        self->finished = 1;
-        self->end_time_ns = GetTickCount64() * 1000000ULL;
-        self->exec_time_ns = (unsigned long)(self->end_time_ns - self->start_time_ns);
-        self->exit_code = (unsigned)(uintptr_t)ret;
+    int rc = 0;
+    if (attr->stack) {
+        rc = pthread_attr_setstack(pa, attr->stack, attr->stack_size);
+    } else {
+        if (attr->stack_size) {
+            size_t size = attr->stack_size < FOSSIL__THREAD_STACK_MIN ? FOSSIL__THREAD_STACK_MIN
+                                                                      : attr->stack_size;
+            long page = sysconf(_SC_PAGESIZE);
+            if (page > 0) size = (size + (size_t)page - 1) / (size_t)page * (size_t)page;
+            rc = pthread_attr_setstacksize(pa, size);
+        }
+        if (rc == 0 && attr->guard_size)
+            rc = pthread_attr_setguardsize(pa, attr->guard_size);
+    }
+    if (rc == 0 && attr->detached)
+        rc = pthread_attr_setdetachstate(pa, PTHREAD_CREATE_DETACHED);
+    if (rc == 0 && (attr->policy != FOSSIL_THREADS_POLICY_DEFAULT || attr->priority != 0)) {
+        int policy = attr->policy == FOSSIL_THREADS_POLICY_FIFO ? SCHED_FIFO
+                   : attr->policy == FOSSIL_THREADS_POLICY_RR ? SCHED_RR : SCHED_OTHER;
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = fossil__sched_priority(policy, attr->priority);
+        rc = pthread_attr_setinheritsched(pa, PTHREAD_EXPLICIT_SCHED);
+        if (rc == 0) rc = pthread_attr_setschedpolicy(pa, policy);
+        if (rc == 0) rc = pthread_attr_setschedparam(pa, &param);
+    }
+    if (rc != 0) {
+        pthread_attr_destroy(pa);
+        return rc == ENOTSUP ? FOSSIL_THREADS_EUNSUPPORTED : FOSSIL_THREADS_EINVAL;
     }
+    return FOSSIL_THREADS_OK;
+}
+#endif
+
+/* ============================================================================
+** Windows Implementation
+** --------------------------------------------------------------------------*/
+#if defined(_WIN32)
+static unsigned __stdcall fossil__thread_start(void *param) {
+    fossil_threads_thread_t *self = (fossil_threads_thread_t*)param;
+    fossil_threads_thread_func func = self->start_func;
+    void *arg = self->start_arg;
+    fossil__atomic_store_u32(&self->launched, 1u);
+
+    const int traced = fossil__trace_on();
+    long long t0 = traced ? fossil__monotonic_ns() : 0;
+    void *ret = func ? func(arg) : NULL;
+    if (traced)
+        fossil__trace_complete("thread", "thread.run", NULL, t0, fossil__monotonic_ns(),
+                               (unsigned long long)(uintptr_t)func);
+    fossil__tls_thread_exit();
+    fossil__epoch_thread_exit();
+    fossil__trace_thread_exit();
+
+    self->retval = ret;
+    self->end_time_ns = (unsigned long long)fossil__monotonic_ns();
+    self->exec_time_ns = (unsigned long)(self->end_time_ns - self->start_time_ns);
+    self->exit_code = (unsigned)(uintptr_t)ret;
+    self->finished = 1;
+    /* Last touch of the object: dispose() of a detached thread may reuse
+     * it as soon as the exit is published. */
+    fossil__thread_publish_exit(self);
 
-    if (ctx) free(ctx);
     unsigned code = (unsigned)(uintptr_t)ret;
     _endthreadex(code);
     return code;
 }
 
-int fossil_threads_thread_create(
+int fossil_threads_thread_create_ex(
     fossil_threads_thread_t *thread,
+    const fossil_threads_thread_attr_t *attr,
     fossil_threads_thread_func func,
     void *arg
 ) {
     if (!thread || !func) return FOSSIL_THREADS_EINVAL;
     if (thread->started) return FOSSIL_THREADS_EBUSY;
+    if (attr) {
+        int rc = fossil__thread_attr_check(attr);
+        if (rc != FOSSIL_THREADS_OK) return rc;
+        /* _beginthreadex always allocates the stack, and Windows has no
+         * POSIX real-time policies. */
+        if (attr->stack || attr->policy != FOSSIL_THREADS_POLICY_DEFAULT)
+            return FOSSIL_THREADS_EUNSUPPORTED;
+        if (attr->stack_size > 0xffffffffu) return FOSSIL_THREADS_EINVAL;
+    }
     fossil__thread_zero(thread);
-    fossil__thread_start_ctx *ctx = (fossil__thread_start_ctx*)malloc(sizeof(*ctx));
-    if (!ctx) return FOSSIL_THREADS_ENOMEM;
-    ctx->func = func;
-    ctx->arg = arg;
-    ctx->owner = thread;
+    thread->start_func = func;
+    thread->start_arg = arg;
+    /* Stamped before launch so the new thread never races these stores;
+     * a failed launch zeroes them again. */
+    thread->start_time_ns = (unsigned long long)fossil__monotonic_ns();
+    thread->started = 1;
+
+    unsigned stack_size = attr ? (unsigned)attr->stack_size : 0u;
+    unsigned flags = 0;
+    if (stack_size) flags |= STACK_SIZE_PARAM_IS_A_RESERVATION;
+    if (attr && attr->priority) flags |= CREATE_SUSPENDED;
 
     unsigned thread_id = 0;
-    uintptr_t handle = _beginthreadex(NULL, 0, fossil__thread_start, ctx, 0, &thread_id);
+    uintptr_t handle = _beginthreadex(NULL, stack_size, fossil__thread_start, thread, flags, &thread_id);
     if (!handle) {
-        free(ctx);
+        fossil__thread_zero(thread);
         return FOSSIL_THREADS_EINTERNAL;
     }
+    if (flags & CREATE_SUSPENDED) {
+        SetThreadPriority((HANDLE)handle, fossil__win_priority(attr->priority));
+        ResumeThread((HANDLE)handle);
+    }
 
     thread->handle = (void*)handle;
     thread->id = (unsigned long)thread_id;
-    thread->joinable = 1;
-    thread->started = 1;
-    thread->start_time_ns = GetTickCount64() * 1000000ULL;
+    thread->joinable = attr && attr->detached ? 0 : 1;
+    thread->priority = attr ? attr->priority : 0;
+    thread->policy = FOSSIL_THREADS_POLICY_DEFAULT;
 
     return FOSSIL_THREADS_OK;
 }
@@ -208,8 +365,9 @@ int fossil_threads_thread_join(fossil_threads_thread_t *thread, void **retval) {
     thread->handle = NULL;
     thread->joinable = 0;
     thread->finished = 1;
-    thread->end_time_ns = GetTickCount64() * 1000000ULL;
-    thread->exec_time_ns = (unsigned long)(thread->end_time_ns - thread->start_time_ns);
+    /* The thread is gone; mark it exited here too, for a structure the
+     * exit was published into before being copied elsewhere. */
+    fossil__atomic_store_u32(&thread->exit_state, FOSSIL__EXIT_DONE);
     return FOSSIL_THREADS_OK;
 }
 
@@ -245,69 +403,82 @@ unsigned long fossil_threads_thread_id(void) {
 #else /* POSIX */
 
 static void* fossil__thread_start(void *param) {
-    fossil__thread_start_ctx *ctx = (fossil__thread_start_ctx*)param;
-    fossil_threads_thread_t *self = ctx ? ctx->owner : NULL;
-    if (self) {
-        self->started = 1;
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        self->start_time_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
-    }
-
-    void *ret = ctx && ctx->func ? ctx->func(ctx->arg) : NULL;
+    fossil_threads_thread_t *self = (fossil_threads_thread_t*)param;
+    fossil_threads_thread_func func = self->start_func;
+    void *arg = self->start_arg;
+    fossil__atomic_store_u32(&self->launched, 1u);
+
+    const int traced = fossil__trace_on();
+    long long t0 = traced ? fossil__monotonic_ns() : 0;
+    void *ret = func ? func(arg) : NULL;
+    if (traced)
+        fossil__trace_complete("thread", "thread.run", NULL, t0, fossil__monotonic_ns(),
+                               (unsigned long long)(uintptr_t)func);
+    fossil__tls_thread_exit();
+    fossil__epoch_thread_exit();
+    fossil__trace_thread_exit();
+
+    self->retval = ret;
+    self->end_time_ns = (unsigned long long)fossil__monotonic_ns();
+    self->exec_time_ns = (unsigned long)(self->end_time_ns - self->start_time_ns);
+    self->exit_code = 0;
+    self->finished = 1;
+    /* Last touch of the object: dispose() of a detached thread may reuse
+     * it as soon as the exit is published. */
+    fossil__thread_publish_exit(self);
 
-    if (self) {
-        self->retval = ret;
-        self->finished = 1;
-        struct timespec ts;
-        clock_gettime(CLOCK_REALTIME, &ts);
-        self->end_time_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
-        self->exec_time_ns = (unsigned long)(self->end_time_ns - self->start_time_ns);
-        self->exit_code = 0;
-    }
-
-    if (ctx) free(ctx);
     return ret;
 }
 
-int fossil_threads_thread_create(
+int fossil_threads_thread_create_ex(
     fossil_threads_thread_t *thread,
+    const fossil_threads_thread_attr_t *attr,
     fossil_threads_thread_func func,
     void *arg
 ) {
     if (!thread || !func) return FOSSIL_THREADS_EINVAL;
     if (thread->started) return FOSSIL_THREADS_EBUSY;
+    if (attr) {
+        int rc = fossil__thread_attr_check(attr);
+        if (rc != FOSSIL_THREADS_OK) return rc;
+    }
     fossil__thread_zero(thread);
 
-    fossil__thread_start_ctx *ctx = malloc(sizeof(*ctx));
-    if (!ctx) return FOSSIL_THREADS_ENOMEM;
-    ctx->func = func;
-    ctx->arg = arg;
-    ctx->owner = thread;
+    pthread_attr_t pattr;
+    if (attr) {
+        int rc = fossil__thread_attr_apply(&pattr, attr);
+        if (rc != FOSSIL_THREADS_OK) return rc;
+    }
 
-    pthread_t *pth = malloc(sizeof(pthread_t));
-    if (!pth) { free(ctx); return FOSSIL_THREADS_ENOMEM; }
+    thread->start_func = func;
+    thread->start_arg = arg;
+    /* Stamped before launch so the new thread never races these stores;
+     * a failed launch zeroes them again. */
+    thread->start_time_ns = (unsigned long long)fossil__monotonic_ns();
+    thread->started = 1;
 
-    int rc = pthread_create(pth, NULL, fossil__thread_start, ctx);
+    pthread_t *pth = fossil__pthread(thread);
+    int rc = pthread_create(pth, attr ? &pattr : NULL, fossil__thread_start, thread);
+    if (attr) pthread_attr_destroy(&pattr);
     if (rc != 0) {
-        free(ctx);
-        free(pth);
+        fossil__thread_zero(thread);
+        if (rc == EPERM) return FOSSIL_THREADS_EPERM;
+        if (rc == EINVAL) return FOSSIL_THREADS_EINVAL;
         return FOSSIL_THREADS_EINTERNAL;
     }
 
-    thread->handle = (void*)pth;
-    thread->joinable = 1;
-    thread->started = 1;
-    if (pth) {
-        memcpy(&thread->id, pth, sizeof(thread->id) < sizeof(*pth) ? sizeof(thread->id) : sizeof(*pth));
+    memcpy(&thread->id, pth, sizeof(thread->id) < sizeof(*pth) ? sizeof(thread->id) : sizeof(*pth));
+    thread->priority = attr ? attr->priority : 0;
+    thread->policy = attr ? attr->policy : FOSSIL_THREADS_POLICY_DEFAULT;
+    if (attr && attr->detached) {
+        /* Same state detach() leaves behind: no handle to join. */
+        thread->handle = NULL;
+        thread->joinable = 0;
     } else {
-        thread->id = 0;
+        thread->handle = (void*)pth;
+        thread->joinable = 1;
     }
 
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    thread->start_time_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
-
     return FOSSIL_THREADS_OK;
 }
 
@@ -316,23 +487,19 @@ int fossil_threads_thread_join(fossil_threads_thread_t *thread, void **retval) {
     if (!thread->started) return FOSSIL_THREADS_ENOTSTARTED;
     if (!thread->joinable) return FOSSIL_THREADS_EDETACHED;
 
-    pthread_t *pth = (pthread_t*)thread->handle;
-    if (!pth) return FOSSIL_THREADS_EINTERNAL;
+    if (!thread->handle) return FOSSIL_THREADS_EINTERNAL;
 
     void *ret = NULL;
-    int rc = pthread_join(*pth, &ret);
+    int rc = pthread_join(*fossil__pthread(thread), &ret);
     if (rc != 0) return FOSSIL_THREADS_EINTERNAL;
 
     if (retval) *retval = ret ? ret : thread->retval;
-    free(pth);
     thread->handle = NULL;
     thread->joinable = 0;
     thread->finished = 1;
-
-    struct timespec ts;
-    clock_gettime(CLOCK_REALTIME, &ts);
-    thread->end_time_ns = ts.tv_sec * 1000000000ULL + ts.tv_nsec;
-    thread->exec_time_ns = (unsigned long)(thread->end_time_ns - thread->start_time_ns);
+    /* The thread is gone; mark it exited here too, for a structure the
+     * exit was published into before being copied elsewhere. */
+    fossil__atomic_store_u32(&thread->exit_state, FOSSIL__EXIT_DONE);
 
     return FOSSIL_THREADS_OK;
 }
@@ -341,11 +508,9 @@ int fossil_threads_thread_detach(fossil_threads_thread_t *thread) {
     if (!thread || !thread->started) return FOSSIL_THREADS_EINVAL;
     if (!thread->joinable) return FOSSIL_THREADS_EDETACHED;
 
-    pthread_t *pth = (pthread_t*)thread->handle;
-    if (!pth) return FOSSIL_THREADS_EINTERNAL;
+    if (!thread->handle) return FOSSIL_THREADS_EINTERNAL;
 
-    pthread_detach(*pth);
-    free(pth);
+    pthread_detach(*fossil__pthread(thread));
     thread->handle = NULL;
     thread->joinable = 0;
     return FOSSIL_THREADS_OK;
@@ -377,6 +542,25 @@ unsigned long fossil_threads_thread_id(void) {
 }
 #endif /* platform switch */
 
+int fossil_threads_thread_create(
+    fossil_threads_thread_t *thread,
+    fossil_threads_thread_func func,
+    void *arg
+) {
+    return fossil_threads_thread_create_ex(thread, NULL, func, arg);
+}
+
+int fossil_threads_thread_timedjoin(fossil_threads_thread_t *thread, void **retval, unsigned int timeout_ms) {
+    if (!thread) return FOSSIL_THREADS_EINVAL;
+    if (!thread->started) return FOSSIL_THREADS_ENOTSTARTED;
+    if (!thread->joinable) return FOSSIL_THREADS_EDETACHED;
+
+    int rc = fossil__thread_wait_exit(thread, (long long)timeout_ms * 1000000LL);
+    if (rc != FOSSIL_THREADS_OK) return rc;
+    /* The function has returned; the OS join only waits out thread teardown. */
+    return fossil_threads_thread_join(thread, retval);
+}
+
 int fossil_threads_thread_equal(
     const fossil_threads_thread_t *t1,
     const fossil_threads_thread_t *t2
@@ -392,12 +576,8 @@ int fossil_threads_thread_equal(
     return 0;
 #else
     // Compare by pthread_t if handles exist, else by id
-    if (t1->handle && t2->handle) {
-        const pthread_t *p1 = (const pthread_t*)t1->handle;
-        const pthread_t *p2 = (const pthread_t*)t2->handle;
-        if (p1 && p2)
-            return pthread_equal(*p1, *p2) != 0;
-    }
+    if (t1->handle && t2->handle)
+        return pthread_equal(*fossil__pthread(t1), *fossil__pthread(t2)) != 0;
     // Fallback: compare stored thread id
     size_t cmp_size = sizeof(t1->id) < sizeof(t2->id) ? sizeof(t1->id) : sizeof(t2->id);
     return memcmp(&t1->id, &t2->id, cmp_size) == 0;
@@ -415,33 +595,16 @@ int fossil_threads_thread_set_priority(fossil_threads_thread_t *thread, int prio
     thread->priority = priority;
 #if defined(_WIN32)
     if (thread->handle) {
-        int win_prio;
-        switch (priority) {
-            case 2: win_prio = THREAD_PRIORITY_HIGHEST; break;
-            case 1: win_prio = THREAD_PRIORITY_ABOVE_NORMAL; break;
-            case 0: win_prio = THREAD_PRIORITY_NORMAL; break;
-            case -1: win_prio = THREAD_PRIORITY_BELOW_NORMAL; break;
-            case -2: win_prio = THREAD_PRIORITY_LOWEST; break;
-            default: win_prio = THREAD_PRIORITY_NORMAL; break;
-        }
-        if (!SetThreadPriority((HANDLE)thread->handle, win_prio))
+        if (!SetThreadPriority((HANDLE)thread->handle, fossil__win_priority(priority)))
             return FOSSIL_THREADS_EINTERNAL;
     }
 #elif defined(__unix__) || defined(__APPLE__)
     if (thread->handle) {
-        pthread_t *pt = (pthread_t*)thread->handle;
+        pthread_t *pt = fossil__pthread(thread);
         struct sched_param param;
         int policy;
         if (pthread_getschedparam(*pt, &policy, &param) == 0) {
-            int min = sched_get_priority_min(policy);
-            int max = sched_get_priority_max(policy);
-            int mid = (min + max) / 2;
-            if (priority > 0)
-                param.sched_priority = max;
-            else if (priority < 0)
-                param.sched_priority = min;
-            else
-                param.sched_priority = mid;
+            param.sched_priority = fossil__sched_priority(policy, priority);
             if (pthread_setschedparam(*pt, policy, &param) != 0)
                 return FOSSIL_THREADS_EINTERNAL;
         }
@@ -466,7 +629,7 @@ int fossil_threads_thread_get_priority(const fossil_threads_thread_t *thread) {
     }
 #elif defined(__unix__) || defined(__APPLE__)
     if (thread->handle) {
-        pthread_t *pt = (pthread_t*)thread->handle;
+        pthread_t *pt = fossil__pthread(thread);
         struct sched_param param;
         int policy;
         if (pthread_getschedparam(*pt, &policy, &param) == 0) {
@@ -489,13 +652,276 @@ int fossil_threads_thread_get_priority(const fossil_threads_thread_t *thread) {
     return thread->priority;
 }
 
+/* ============================================================================
+** CPU Topology and Affinity
+** --------------------------------------------------------------------------
+** The topology is probed once, on first use: the CPUs this process may run
+** on (its affinity mask on Linux, every active processor on Windows),
+** ordered node by node, plus a dense NUMA node index for each of them.
+** Linux reads the node layout from sysfs, so no libnuma is required;
+** platforms without NUMA information report a single node.
+** --------------------------------------------------------------------------*/
+#define FOSSIL__TOPO_MAX_CPUS  1024
+#define FOSSIL__TOPO_MAX_NODES 64
+#define FOSSIL__TOPO_NO_NODE   0xffffu
+
+static struct {
+    volatile unsigned int state;                   /* 0 unprobed, 1 probing, 2 ready */
+    size_t cpu_count;
+    size_t node_count;
+    unsigned short cpus[FOSSIL__TOPO_MAX_CPUS];    /* usable CPU ids, grouped by node */
+    unsigned short node_of[FOSSIL__TOPO_MAX_CPUS]; /* dense node per CPU id */
+    size_t node_first[FOSSIL__TOPO_MAX_NODES + 1]; /* node n owns cpus[node_first[n] .. node_first[n + 1]) */
+} fossil__topo;
+
+#define FOSSIL__BIT_SET(bits, i)  ((bits)[(i) >> 3] |= (unsigned char)(1u << ((i) & 7u)))
+#define FOSSIL__BIT_TEST(bits, i) (((bits)[(i) >> 3] >> ((i) & 7u)) & 1u)
+
+#if defined(__linux__)
+/* Parse a sysfs list such as "0-3,8-11" into a bitmap. */
+static int fossil__topo_read_list(const char *path, unsigned char *bits, size_t nbits) {
+    char buf[4096];
+    FILE *f = fopen(path, "r");
+    if (!f) return 0;
+    size_t len = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[len] = '\0';
+
+    size_t i = 0;
+    while (buf[i] >= '0' && buf[i] <= '9') {
+        size_t lo = 0, hi;
+        while (buf[i] >= '0' && buf[i] <= '9') lo = lo * 10 + (size_t)(buf[i++] - '0');
+        hi = lo;
+        if (buf[i] == '-') {
+            hi = 0;
+            ++i;
+            while (buf[i] >= '0' && buf[i] <= '9') hi = hi * 10 + (size_t)(buf[i++] - '0');
+        }
+        for (size_t b = lo; b <= hi && b < nbits; ++b) FOSSIL__BIT_SET(bits, b);
+        if (buf[i] == ',') ++i;
+    }
+    return 1;
+}
+#endif
+
+static void fossil__topo_probe(void) {
+    unsigned char usable[FOSSIL__TOPO_MAX_CPUS / 8];
+    size_t nodes = 0, count = 0;
+
+    memset(usable, 0, sizeof(usable));
+    for (size_t cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu)
+        fossil__topo.node_of[cpu] = FOSSIL__TOPO_NO_NODE;
+
+#if defined(_WIN32)
+    /* CPU ids flatten the processor groups: group g starts after all
+     * processors of groups 0 .. g-1. */
+    USHORT os_nodes[FOSSIL__TOPO_MAX_NODES];
+    WORD groups = GetActiveProcessorGroupCount();
+    size_t base = 0;
+    for (WORD g = 0; g < groups; ++g) {
+        DWORD n = GetActiveProcessorCount(g);
+        for (DWORD i = 0; i < n && base + i < FOSSIL__TOPO_MAX_CPUS; ++i) {
+            PROCESSOR_NUMBER pn;
+            USHORT node = 0;
+            size_t k;
+            pn.Group = g;
+            pn.Number = (BYTE)i;
+            pn.Reserved = 0;
+            FOSSIL__BIT_SET(usable, base + i);
+            if (!GetNumaProcessorNodeEx(&pn, &node)) continue;
+            for (k = 0; k < nodes && os_nodes[k] != node; ++k) {}
+            if (k == nodes) {
+                if (nodes == FOSSIL__TOPO_MAX_NODES) continue;
+                os_nodes[nodes++] = node;
+            }
+            fossil__topo.node_of[base + i] = (unsigned short)k;
+        }
+        base += n;
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (size_t cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS && cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &set)) FOSSIL__BIT_SET(usable, cpu);
+    } else {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        for (long cpu = 0; cpu < n && cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu)
+            FOSSIL__BIT_SET(usable, (size_t)cpu);
+    }
+
+    unsigned char online[FOSSIL__TOPO_MAX_NODES / 8];
+    memset(online, 0, sizeof(online));
+    if (fossil__topo_read_list("/sys/devices/system/node/online", online, FOSSIL__TOPO_MAX_NODES)) {
+        for (size_t node = 0; node < FOSSIL__TOPO_MAX_NODES; ++node) {
+            unsigned char members[FOSSIL__TOPO_MAX_CPUS / 8];
+            char path[64];
+            int used = 0;
+            if (!FOSSIL__BIT_TEST(online, node)) continue;
+            snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", (unsigned)node);
+            memset(members, 0, sizeof(members));
+            if (!fossil__topo_read_list(path, members, FOSSIL__TOPO_MAX_CPUS)) continue;
+            for (size_t cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu) {
+                if (FOSSIL__BIT_TEST(usable, cpu) && FOSSIL__BIT_TEST(members, cpu) &&
+                    fossil__topo.node_of[cpu] == FOSSIL__TOPO_NO_NODE) {
+                    fossil__topo.node_of[cpu] = (unsigned short)nodes;
+                    used = 1;
+                }
+            }
+            if (used) nodes++;
+        }
+    }
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    for (long cpu = 0; cpu < n && cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu)
+        FOSSIL__BIT_SET(usable, (size_t)cpu);
+#endif
+
+    /* Keep at least one CPU if every probe failed; CPUs the OS gave no
+     * node for join node 0. */
+    {
+        size_t cpu;
+        for (cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS && !FOSSIL__BIT_TEST(usable, cpu); ++cpu) {}
+        if (cpu == FOSSIL__TOPO_MAX_CPUS) FOSSIL__BIT_SET(usable, 0u);
+    }
+    if (nodes == 0) nodes = 1;
+    for (size_t cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu) {
+        if (FOSSIL__BIT_TEST(usable, cpu) && fossil__topo.node_of[cpu] == FOSSIL__TOPO_NO_NODE)
+            fossil__topo.node_of[cpu] = 0;
+    }
+
+    for (size_t node = 0; node < nodes; ++node) {
+        fossil__topo.node_first[node] = count;
+        for (size_t cpu = 0; cpu < FOSSIL__TOPO_MAX_CPUS; ++cpu) {
+            if (fossil__topo.node_of[cpu] == node)
+                fossil__topo.cpus[count++] = (unsigned short)cpu;
+        }
+    }
+    fossil__topo.node_first[nodes] = count;
+    fossil__topo.cpu_count = count;
+    fossil__topo.node_count = nodes;
+}
+
+static void fossil__topo_init(void) {
+    unsigned int state = fossil__atomic_load_u32(&fossil__topo.state);
+    if (state == 2u) return;
+    state = 0u;
+    if (fossil__atomic_cas_u32(&fossil__topo.state, &state, 1u)) {
+        fossil__topo_probe();
+        fossil__atomic_store_u32(&fossil__topo.state, 2u);
+        return;
+    }
+    while (fossil__atomic_load_u32(&fossil__topo.state) != 2u)
+        fossil_threads_thread_yield();
+}
+
+size_t fossil_threads_cpu_count(void) {
+    fossil__topo_init();
+    return fossil__topo.cpu_count;
+}
+
+int fossil_threads_cpu_current(void) {
+#if defined(_WIN32)
+    PROCESSOR_NUMBER pn;
+    size_t base = 0;
+    GetCurrentProcessorNumberEx(&pn);
+    for (WORD g = 0; g < pn.Group; ++g) base += GetActiveProcessorCount(g);
+    return (int)(base + pn.Number);
+#elif defined(__linux__)
+    int cpu = sched_getcpu();
+    return cpu < 0 ? -1 : cpu;
+#else
+    return -1;
+#endif
+}
+
+size_t fossil_threads_numa_node_count(void) {
+    fossil__topo_init();
+    return fossil__topo.node_count;
+}
+
+int fossil_threads_numa_node_of_cpu(unsigned int cpu) {
+    fossil__topo_init();
+    if (cpu >= FOSSIL__TOPO_MAX_CPUS || fossil__topo.node_of[cpu] == FOSSIL__TOPO_NO_NODE)
+        return -1;
+    return (int)fossil__topo.node_of[cpu];
+}
+
+size_t fossil_threads_numa_node_cpus(size_t node, unsigned int *cpus, size_t max) {
+    fossil__topo_init();
+    if (node >= fossil__topo.node_count) return 0;
+    size_t first = fossil__topo.node_first[node];
+    size_t n = fossil__topo.node_first[node + 1] - first;
+    if (cpus) {
+        for (size_t i = 0; i < n && i < max; ++i)
+            cpus[i] = fossil__topo.cpus[first + i];
+    }
+    return n;
+}
+
+int fossil_threads_thread_set_affinity(fossil_threads_thread_t *thread,
+                                       const unsigned int *cpus, size_t count) {
+    if (!cpus || count == 0) return FOSSIL_THREADS_EINVAL;
+    if (thread) {
+        if (!thread->started) return FOSSIL_THREADS_ENOTSTARTED;
+        if (fossil__thread_exited(thread)) return FOSSIL_THREADS_EFINISHED;
+        /* Detaching gives the handle up; the thread pins itself via NULL. */
+        if (!thread->handle) return FOSSIL_THREADS_EDETACHED;
+    }
+#if defined(_WIN32)
+    GROUP_AFFINITY ga;
+    WORD groups = GetActiveProcessorGroupCount();
+    memset(&ga, 0, sizeof(ga));
+    for (size_t i = 0; i < count; ++i) {
+        size_t base = 0;
+        WORD g;
+        for (g = 0; g < groups; ++g) {
+            DWORD n = GetActiveProcessorCount(g);
+            if (cpus[i] < base + n) break;
+            base += n;
+        }
+        /* One GROUP_AFFINITY cannot span processor groups. */
+        if (g == groups || (i > 0 && ga.Group != g)) return FOSSIL_THREADS_EINVAL;
+        ga.Group = g;
+        ga.Mask |= (KAFFINITY)1 << (cpus[i] - base);
+    }
+    if (!SetThreadGroupAffinity(thread ? (HANDLE)thread->handle : GetCurrentThread(), &ga, NULL))
+        return FOSSIL_THREADS_EOSFAIL;
+    return FOSSIL_THREADS_OK;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (size_t i = 0; i < count; ++i) {
+        if (cpus[i] >= CPU_SETSIZE) return FOSSIL_THREADS_EINVAL;
+        CPU_SET(cpus[i], &set);
+    }
+    pthread_t pt = thread ? *fossil__pthread(thread) : pthread_self();
+    if (pthread_setaffinity_np(pt, sizeof(set), &set) != 0)
+        return FOSSIL_THREADS_EOSFAIL;
+    return FOSSIL_THREADS_OK;
+#elif defined(__APPLE__)
+    /* Mach has no hard pinning: threads sharing a tag are kept on the same
+     * cache domain, distinct tags are spread apart. Tag 0 means "none". */
+    thread_affinity_policy_data_t policy;
+    pthread_t pt = thread ? *fossil__pthread(thread) : pthread_self();
+    policy.affinity_tag = (integer_t)(cpus[0] + 1);
+    kern_return_t kr = thread_policy_set(pthread_mach_thread_np(pt), THREAD_AFFINITY_POLICY,
+                                         (thread_policy_t)&policy, THREAD_AFFINITY_POLICY_COUNT);
+    if (kr == KERN_NOT_SUPPORTED) return FOSSIL_THREADS_EUNSUPPORTED;
+    return kr == KERN_SUCCESS ? FOSSIL_THREADS_OK : FOSSIL_THREADS_EOSFAIL;
+#else
+    (void)thread;
+    return FOSSIL_THREADS_EUNSUPPORTED;
+#endif
+}
+
 /* ============================================================================
 ** Cooperative Cancellation
 ** --------------------------------------------------------------------------*/
 int fossil_threads_thread_cancel(fossil_threads_thread_t *thread) {
     if (!thread) return FOSSIL_THREADS_EINVAL;
     if (!thread->started) return FOSSIL_THREADS_ENOTSTARTED;
-    if (thread->finished) return FOSSIL_THREADS_EFINISHED;
+    if (fossil__thread_exited(thread)) return FOSSIL_THREADS_EFINISHED;
 
     thread->cancel_requested = 1;
 
@@ -510,7 +936,7 @@ int fossil_threads_thread_cancel(fossil_threads_thread_t *thread) {
     if (!thread->handle)
         return FOSSIL_THREADS_EINTERNAL;
     {
-        pthread_t *pt = (pthread_t*)thread->handle;
+        pthread_t *pt = fossil__pthread(thread);
         if (!pt)
             return FOSSIL_THREADS_EINTERNAL;
 #if defined(PTHREAD_CANCEL_ENABLE)
@@ -529,203 +955,1977 @@ int fossil_threads_thread_cancel(fossil_threads_thread_t *thread) {
 
 int fossil_threads_thread_is_running(const fossil_threads_thread_t *thread) {
     if (!thread) return 0;
-#if defined(_WIN32)
-    if (!thread->started || thread->finished) return 0;
-    if (thread->handle) {
-        DWORD code = 0;
-        if (GetExitCodeThread((HANDLE)thread->handle, &code)) {
-            return code == STILL_ACTIVE;
-        }
-    }
-    return thread->started && !thread->finished;
-#else
-    if (!thread->started || thread->finished) return 0;
-    if (thread->handle) {
-        pthread_t *pt = (pthread_t*)thread->handle;
-        if (pt) {
-            int kill_rc = pthread_kill(*pt, 0);
-            if (kill_rc == 0)
-                return 1; // thread is running
-            // ESRCH means no such thread (finished)
-        }
-    }
-    return thread->started && !thread->finished;
-#endif
+    return thread->started && !fossil__thread_exited(thread);
 }
 
 void* fossil_threads_thread_get_retval(const fossil_threads_thread_t *thread) {
     if (!thread) return NULL;
-    if (!thread->finished) return NULL;
+    if (!fossil__thread_exited(thread)) return NULL;
     return thread->retval;
 }
 
-/* Thread pool API stubs (not implemented) */
+/* ============================================================================
+** Thread Groups
+**
+** One allocation holds the group header and every member's thread object.
+** Members park on the start word until the creator has launched all of
+** them, then a single wake releases the whole group. Each member counts
+** itself out of remaining once its function returns; join sleeps on that
+** word once and only then reaps the threads, which by then have finished
+** or are about to.
+** --------------------------------------------------------------------------*/
+
+/* Start word values */
+#define FOSSIL__GROUP_WAIT  0u  /* members still being created */
+#define FOSSIL__GROUP_RUN   1u  /* every member launched: run */
+#define FOSSIL__GROUP_ABORT 2u  /* a create failed: exit without running */
+
+typedef struct fossil__group_member {
+    fossil_threads_thread_t thread;
+    struct fossil_threads_group *group;
+    size_t index;
+    void *result;
+} fossil__group_member_t;
+
+struct fossil_threads_group {
+    fossil_threads_group_func func;
+    void *ctx;
+    size_t count;
+    volatile unsigned int start;      /* FOSSIL__GROUP_* */
+    volatile unsigned int remaining;  /* members whose function has not returned */
+    int joined;
+    fossil__group_member_t members[1];
+};
+
+static void *fossil__group_entry(void *arg) {
+    fossil__group_member_t *m = (fossil__group_member_t*)arg;
+    fossil_threads_group_t *g = m->group;
+    unsigned int start;
+    while ((start = fossil__atomic_load_u32(&g->start)) == FOSSIL__GROUP_WAIT)
+        fossil__futex_wait(&g->start, FOSSIL__GROUP_WAIT, FOSSIL__FUTEX_INFINITE);
+    if (start == FOSSIL__GROUP_RUN)
+        m->result = g->func(m->index, g->ctx);
+    if (fossil__atomic_add_u32(&g->remaining, (unsigned int)-1) == 1)
+        fossil__futex_wake_all(&g->remaining);
+    return m->result;
+}
+
+/* Reap every launched member once none is still running its function. */
+static void fossil__group_reap(fossil_threads_group_t *g) {
+    unsigned int left;
+    while ((left = fossil__atomic_load_u32(&g->remaining)) != 0)
+        fossil__futex_wait(&g->remaining, left, FOSSIL__FUTEX_INFINITE);
+    for (size_t i = 0; i < g->count; ++i)
+        fossil_threads_thread_join(&g->members[i].thread, NULL);
+    g->joined = 1;
+}
+
+int fossil_threads_group_create(
+    fossil_threads_group_t **group,
+    size_t count,
+    const fossil_threads_thread_attr_t *attr,
+    fossil_threads_group_func func,
+    void *ctx
+) {
+    if (!group) return FOSSIL_THREADS_EINVAL;
+    *group = NULL;
+    if (!func || count == 0 || count > 0xffffffffu) return FOSSIL_THREADS_EINVAL;
+    if (attr && attr->detached) return FOSSIL_THREADS_EINVAL;
+    if (attr && attr->stack && count > 1) return FOSSIL_THREADS_EINVAL;
+
+    /* The member count is 32-bit, the allocation may not be. */
+    if (count - 1 > (SIZE_MAX - sizeof(fossil_threads_group_t)) / sizeof(fossil__group_member_t))
+        return FOSSIL_THREADS_ENOMEM;
+    size_t bytes = sizeof(fossil_threads_group_t) + (count - 1) * sizeof(fossil__group_member_t);
+    fossil_threads_group_t *g = (fossil_threads_group_t*)calloc(1, bytes);
+    if (!g) return FOSSIL_THREADS_ENOMEM;
+    g->func = func;
+    g->ctx = ctx;
+    g->start = FOSSIL__GROUP_WAIT;
+
+    int rc = FOSSIL_THREADS_OK;
+    for (size_t i = 0; i < count; ++i) {
+        fossil__group_member_t *m = &g->members[i];
+        fossil_threads_thread_init(&m->thread);
+        m->group = g;
+        m->index = i;
+        /* Count the member in before it can possibly count itself out. */
+        fossil__atomic_add_u32(&g->remaining, 1);
+        rc = fossil_threads_thread_create_ex(&m->thread, attr, fossil__group_entry, m);
+        if (rc != FOSSIL_THREADS_OK) {
+            fossil__atomic_add_u32(&g->remaining, (unsigned int)-1);
+            break;
+        }
+        g->count = i + 1;
+    }
+
+    fossil__atomic_store_u32(&g->start, rc == FOSSIL_THREADS_OK ? FOSSIL__GROUP_RUN
+                                                                : FOSSIL__GROUP_ABORT);
+    fossil__futex_wake_all(&g->start);
+    if (rc != FOSSIL_THREADS_OK) {
+        fossil__group_reap(g);
+        free(g);
+        return rc;
+    }
+    *group = g;
+    return FOSSIL_THREADS_OK;
+}
+
+int fossil_threads_group_join(fossil_threads_group_t *group, void **results) {
+    if (!group) return FOSSIL_THREADS_EINVAL;
+    if (!group->joined) fossil__group_reap(group);
+    if (results) {
+        for (size_t i = 0; i < group->count; ++i)
+            results[i] = group->members[i].result;
+    }
+    return FOSSIL_THREADS_OK;
+}
+
+size_t fossil_threads_group_size(const fossil_threads_group_t *group) {
+    return group ? group->count : 0;
+}
+
+fossil_threads_thread_t *fossil_threads_group_thread(fossil_threads_group_t *group, size_t index) {
+    if (!group || index >= group->count) return NULL;
+    return &group->members[index].thread;
+}
+
+void fossil_threads_group_destroy(fossil_threads_group_t *group) {
+    if (!group) return;
+    if (!group->joined) fossil__group_reap(group);
+    free(group);
+}
 
 /* ================================================================
  * Fossil Threads — Thread Pool
  * Cross-platform pool with cooperative task dispatch.
+ *
+ * Two schedulers are available, selected at creation time:
+ *   - SHARED:        one FIFO list guarded by tasks_mutex (default).
+ *   - WORK_STEALING: one Chase-Lev deque per worker. Tasks submitted
+ *                    from inside a worker go to that worker's deque
+ *                    (LIFO for the owner), idle workers steal from the
+ *                    top of other deques (FIFO). Submissions from
+ *                    outside the pool, and deque overflow, go through
+ *                    the shared list which doubles as injection queue.
+ *   - BOUNDED:       one fixed-size lock-free MPMC ring (Vyukov) shared
+ *                    by all producers and workers. A full ring applies
+ *                    the pool's full policy (block, fail, run on caller),
+ *                    giving producers backpressure.
  * ================================================================ */
 
-/* Task node */
-typedef struct fossil_threads_pool_task {
-    fossil_threads_thread_func func;
+#define FOSSIL__POOL_DEFAULT_DEQUE_CAPACITY 1024
+#define FOSSIL__POOL_DEFAULT_TASK_SLAB      1024
+#define FOSSIL__POOL_DEFAULT_QUEUE_CAPACITY 1024
+#define FOSSIL__POOL_DEFAULT_FUTURE_SLAB    256
+#define FOSSIL__POOL_LOCAL_CACHE_MAX        64
+#define FOSSIL__POOL_PAGE_SIZE              4096
+#define FOSSIL__POOL_DEFAULT_KEEP_ALIVE_MS  30000
+#define FOSSIL__POOL_DEFAULT_GROW_LATENCY_US 1000
+#define FOSSIL__POOL_DEFAULT_AGING_LIMIT    8
+#define FOSSIL__POOL_DEFAULT_ARENA_SIZE    (64u * 1024u)
+#define FOSSIL__POOL_SPIN_RELAX            32u  /* pauses between polls while spinning */
+
+/* Shared queue levels: the deadline queue, then one list per priority class */
+#define FOSSIL__POOL_LEVEL_DEADLINE 0
+#define FOSSIL__POOL_LEVELS         (1 + FOSSIL_THREADS_POOL_PRIORITY_COUNT)
+
+/* Task node ownership (fossil_threads_pool_task_t::flags) */
+#define FOSSIL__TASK_HEAP       0x1u  /* malloc'd fallback node, freed after run */
+#define FOSSIL__TASK_SLAB       0x2u  /* node from the pool slab, recycled after run */
+#define FOSSIL__TASK_INTRUSIVE  0x4u  /* caller-owned node, never touched after run */
+#define FOSSIL__TASK_DRAIN      0x8u  /* internal intrusive task that still runs on discard */
+
+/* Worker slot states (fossil__pool_worker_t::state, under tasks_mutex) */
+#define FOSSIL__WORKER_OFF     0u  /* no thread: never started, or joined */
+#define FOSSIL__WORKER_LIVE    1u  /* thread running the worker loop */
+#define FOSSIL__WORKER_RETIRED 2u  /* thread left the loop, not yet joined */
+#define FOSSIL__WORKER_JOINING 3u  /* retired thread being joined outside the lock */
+
+/* Per-worker bounded Chase-Lev deque. top and bottom live on separate
+ * cache lines so thieves and the owner do not false-share. */
+typedef struct fossil__pool_deque {
+    volatile long long top;
+    char pad0[FOSSIL__CACHE_LINE - sizeof(long long)];
+    volatile long long bottom;
+    char pad1[FOSSIL__CACHE_LINE - sizeof(long long)];
+    void *volatile *slots;
+    long long mask;
+} fossil__pool_deque_t;
+
+/* Bounded MPMC ring cell. Each cell owns a cache line so producers and
+ * consumers working on neighbouring slots do not false-share. */
+typedef struct fossil__pool_cell {
+    volatile size_t seq;
+    void *volatile task;
+    char pad[FOSSIL__CACHE_LINE - sizeof(size_t) - sizeof(void*)];
+} fossil__pool_cell_t;
+
+typedef struct fossil__pool_ring {
+    volatile size_t enqueue_pos;
+    char pad0[FOSSIL__CACHE_LINE - sizeof(size_t)];
+    volatile size_t dequeue_pos;
+    char pad1[FOSSIL__CACHE_LINE - sizeof(size_t)];
+    fossil__pool_cell_t *cells;
+    size_t mask;
+} fossil__pool_ring_t;
+
+/* Future states */
+#define FOSSIL__FUTURE_PENDING   0u
+#define FOSSIL__FUTURE_DONE      1u
+#define FOSSIL__FUTURE_CANCELLED 2u
+
+/* Closed continuation list: the future has completed. */
+#define FOSSIL__FUTURE_CLOSED ((void*)&fossil__future_closed_marker)
+static char fossil__future_closed_marker;
+
+/* Future state. The embedded node lets the future be queued without a
+ * separate task allocation. One reference belongs to the caller's handle
+ * and one to the pending execution; the last one recycles the future. */
+struct fossil_threads_pool_future {
+    fossil_threads_pool_task_t task;          /* intrusive queue node */
+    fossil_threads_pool_t *pool;
+    fossil_threads_thread_func func;          /* plain task, or NULL */
     void *arg;
-    struct fossil_threads_pool_task *next;
-} fossil_threads_pool_task_t;
+    fossil_threads_pool_then_func then_func;  /* continuation, or NULL */
+    void *then_ctx;
+    struct fossil_threads_pool_future *parent;    /* future a continuation consumes */
+    struct fossil_threads_pool_future *next;      /* continuation / free-list link */
+    void *volatile continuations;             /* pushed dependents, or FOSSIL__FUTURE_CLOSED */
+    void *result;
+    volatile unsigned int state;              /* FOSSIL__FUTURE_*; futex word */
+    volatile unsigned int waiters;
+    volatile unsigned int refs;
+    unsigned int flags;                       /* FOSSIL__TASK_HEAP or FOSSIL__TASK_SLAB */
+};
+
+/* Per-worker runtime counters (opts.stats). Only the owning worker writes
+ * them, so each update is a plain load and store; fossil_threads_pool_stats()
+ * reads them from any thread. */
+typedef struct fossil__pool_stats {
+    volatile long long tasks;            /* task bodies run */
+    volatile long long steals;           /* tasks taken from another deque */
+    volatile long long wakeups;          /* returns from a park */
+    volatile long long busy_ns;          /* time inside task bodies */
+    volatile long long idle_ns;          /* time parked */
+    volatile long long spin_hits;        /* tasks found while spinning */
+    volatile long long deque_high_water; /* deepest own deque after a push */
+    unsigned int depth;                  /* task bodies on this worker's stack */
+} fossil__pool_stats_t;
+
+/* Worker task arena chunk; the usable bytes follow the header. */
+typedef struct fossil__arena_chunk {
+    struct fossil__arena_chunk *prev;    /* older chunk, NULL for the base */
+    size_t size;                         /* usable bytes */
+    size_t bytes;                        /* whole allocation, header included */
+    int pages;                           /* from fossil__arena_pages_alloc, not malloc */
+} fossil__arena_chunk_t;
+
+/* Position in a worker arena, taken at task start and rewound to at its end. */
+typedef struct fossil__arena_mark {
+    fossil__arena_chunk_t *chunk;        /* NULL: before the first allocation */
+    size_t used;
+} fossil__arena_mark_t;
+
+/* Bump allocator owned by one worker thread. Chunks form a stack on top of
+ * the base; rewinding frees the ones above the mark but keeps the largest
+ * as a spare, so a steady workload settles without calling malloc. */
+typedef struct fossil__arena {
+    fossil__arena_chunk_t *chunk;        /* current chunk, NULL until first use */
+    size_t used;                         /* bytes taken from chunk */
+    fossil__arena_chunk_t *spare;        /* last overflow chunk released */
+    fossil__arena_mark_t task;           /* start of the running task's allocations */
+} fossil__arena_t;
+
+/* Worker slot */
+typedef struct fossil__pool_worker {
+    fossil__pool_deque_t deque;
+    fossil_threads_thread_t thread;
+    struct fossil_threads_pool *pool;
+    size_t index;
+    unsigned int rng;        /* victim selection state */
+    fossil_threads_pool_task_t *cache;   /* worker-local free slab nodes */
+    size_t cache_count;
+    size_t node;             /* pool node (placement), 0 otherwise */
+    size_t pin_first;        /* pinned CPUs: fossil__topo.cpus[pin_first ..] */
+    size_t pin_count;
+    int owns_segment;        /* first touches its node's slab segment */
+    int placed;              /* deque and segment faulted in by an earlier thread */
+    unsigned int state;      /* FOSSIL__WORKER_* */
+    long long progress_ns;   /* last progress_ns this worker published */
+    void *local;             /* fossil_threads_pool_worker_local() slot */
+    fossil__arena_t arena;   /* fossil_threads_pool_task_alloc() memory */
+    /* A full line of padding on each side keeps the counters, rewritten
+     * after every task, off the lines that thieves and submitters read. */
+    char stats_pad0[FOSSIL__CACHE_LINE];
+    fossil__pool_stats_t stats;
+    char stats_pad1[FOSSIL__CACHE_LINE];
+} fossil__pool_worker_t;
+
+/* One FIFO list of the shared queue */
+typedef struct fossil__pool_list {
+    fossil_threads_pool_task_t *head;
+    fossil_threads_pool_task_t *tail;
+} fossil__pool_list_t;
+
+/* Per-node slab free list, one cache line each */
+typedef struct fossil__pool_node {
+    volatile long long slab_free;        /* tagged free list: (tag << 32) | (index + 1) */
+    char pad[FOSSIL__CACHE_LINE - sizeof(long long)];
+} fossil__pool_node_t;
 
 /* Thread pool */
 typedef struct fossil_threads_pool {
-    size_t num_threads;
-    fossil_threads_thread_t *threads;
-    fossil_threads_pool_task_t *tasks_head;
-    fossil_threads_pool_task_t *tasks_tail;
-    size_t tasks_count;
-    int stop;                /* stop flag */
+    size_t num_threads;      /* worker slots (max_threads) */
+    size_t joining;          /* slots in FOSSIL__WORKER_JOINING, under tasks_mutex */
+    int scheduler;           /* FOSSIL_THREADS_POOL_SCHED_* */
+    fossil__pool_worker_t *workers;
+    fossil__pool_list_t lists[FOSSIL_THREADS_POOL_PRIORITY_COUNT]; /* per-class FIFO lists */
+    fossil_threads_pool_task_t **deadlines;  /* binary min-heap on deadline_ns */
+    size_t deadlines_count;
+    size_t deadlines_capacity;
+    size_t level_count[FOSSIL__POOL_LEVELS];    /* tasks queued per level */
+    unsigned int level_skipped[FOSSIL__POOL_LEVELS]; /* pops that passed a level over */
+    unsigned int aging_limit;
+    void (*local_destructor)(void *local);
+    size_t arena_size;                       /* base chunk of each worker arena */
+    int arena_huge_pages;                    /* back arena chunks with huge pages */
+    volatile size_t tasks_count;     /* tasks on the shared queue, all levels */
+    volatile size_t urgent_count;    /* deadline and HIGH tasks on the shared queue */
+    volatile size_t pending;         /* submitted and not yet finished (queued + running) */
+    volatile unsigned int idle_seq;  /* bumped each time pending drops to zero */
+    volatile unsigned int idle_waiters; /* threads blocked in fossil_threads_pool_wait */
+    volatile unsigned int sleepers;  /* workers parked on park_seq */
+    volatile unsigned int park_seq;  /* event count parked workers wait on */
+    volatile unsigned int spinners;  /* idle workers polling before they park */
+    unsigned int spin_max;           /* cap on spinners */
+    long long idle_spin_ns;          /* busy-poll budget before parking */
+    long long idle_yield_ns;         /* then poll with yields this long */
+    volatile unsigned int stop;      /* stop flag */
+    fossil_threads_pool_task_t *slab;    /* preallocated task nodes, one segment per node */
+    size_t slab_size;
+    size_t slab_per_node;                /* nodes in each segment */
+    int placement;                       /* FOSSIL_THREADS_POOL_PLACE_* */
+    size_t node_count;                   /* NUMA nodes hosting workers (1 if unplaced) */
+    fossil__pool_node_t *nodes;
+    unsigned char node_of_topo[FOSSIL__TOPO_MAX_NODES]; /* topology node -> pool node */
+    fossil__pool_ring_t ring;            /* bounded scheduler queue */
+    int full_policy;                     /* FOSSIL_THREADS_POOL_FULL_* */
+    volatile unsigned int space_seq;     /* bumped when a slot frees up for blocked producers */
+    volatile unsigned int full_waiters;  /* producers blocked on a full ring */
+    fossil_threads_pool_future_t *futures;   /* preallocated future states */
+    size_t futures_size;
+    volatile long long futures_free;         /* tagged free list like slab_free */
+    volatile size_t futures_live;            /* slab futures handed out, plus one
+                                                until destroy; the last frees the
+                                                slab and the pool block */
+    int stats;                               /* collect runtime counters */
+    volatile size_t queue_high_water;        /* deepest shared list or ring seen */
+    long long created_ns;                    /* monotonic creation time */
+    /* Elastic sizing: slot states, target and min_threads change under
+     * tasks_mutex; active is also read without it. */
+    int elastic;                             /* min_threads < max_threads */
+    volatile size_t active;                  /* live workers */
+    size_t target;                           /* live workers wanted */
+    size_t min_threads;
+    long long keep_alive_ns;                 /* idle time before retiring, 0 = never */
+    long long grow_latency_ns;               /* queue wait that grows the pool, 0 = off */
+    volatile long long progress_ns;          /* last time a worker took a task */
+    volatile long long grown_ns;             /* last automatic growth */
 #if defined(_WIN32)
-    HANDLE tasks_mutex;
-    HANDLE tasks_cond;
+    CRITICAL_SECTION tasks_mutex;
 #else
     pthread_mutex_t tasks_mutex;
-    pthread_cond_t tasks_cond;
 #endif
 } fossil_threads_pool_t;
 
+/* Worker owning the calling thread, if any. */
+static FOSSIL__TLS fossil__pool_worker_t *fossil__tls_worker = NULL;
+
 /* ================================================================
- * Internal Worker Function
+ * Runtime statistics
  * ================================================================ */
-static void* fossil__pool_worker(void *arg) {
-    fossil_threads_pool_t *pool = (fossil_threads_pool_t*)arg;
-    if (!pool) return NULL;
+static void fossil__stat_add(volatile long long *counter, long long v) {
+    fossil__atomic_store_i64(counter, fossil__atomic_load_relaxed_i64(counter) + v);
+}
 
-    while (1) {
-        fossil_threads_pool_task_t *task = NULL;
+static void fossil__stat_max(volatile long long *mark, long long v) {
+    if (v > fossil__atomic_load_relaxed_i64(mark)) fossil__atomic_store_i64(mark, v);
+}
 
-#if defined(_WIN32)
-        WaitForSingleObject(pool->tasks_mutex, INFINITE);
-        while (!pool->tasks_head && !pool->stop)
-            WaitForSingleObject(pool->tasks_cond, INFINITE);
+/* Calling worker when it belongs to a stats-enabled pool, NULL otherwise. */
+static fossil__pool_worker_t *fossil__pool_stats_self(fossil_threads_pool_t *pool) {
+    fossil__pool_worker_t *self = pool->stats ? fossil__tls_worker : NULL;
+    return self && self->pool == pool ? self : NULL;
+}
 
-        if (pool->stop) {
-            ReleaseMutex(pool->tasks_mutex);
-            break;
-        }
+/* Raise the shared queue high-water mark; any thread may submit. */
+static void fossil__pool_note_depth(fossil_threads_pool_t *pool, size_t depth) {
+    size_t mark = fossil__atomic_load_relaxed_size(&pool->queue_high_water);
+    while (depth > mark && !fossil__atomic_cas_size(&pool->queue_high_water, &mark, depth)) {}
+}
 
-        task = pool->tasks_head;
-        if (task) {
-            pool->tasks_head = task->next;
-            if (!pool->tasks_head) pool->tasks_tail = NULL;
-            pool->tasks_count--;
-        }
-        ReleaseMutex(pool->tasks_mutex);
+/* ================================================================
+ * Locking helpers
+ * ================================================================ */
+static void fossil__pool_lock(fossil_threads_pool_t *pool) {
+#if defined(_WIN32)
+    EnterCriticalSection(&pool->tasks_mutex);
 #else
-        pthread_mutex_lock(&pool->tasks_mutex);
-        while (!pool->tasks_head && !pool->stop)
-            pthread_cond_wait(&pool->tasks_cond, &pool->tasks_mutex);
-
-        if (pool->stop) {
-            pthread_mutex_unlock(&pool->tasks_mutex);
-            break;
-        }
-
-        task = pool->tasks_head;
-        if (task) {
-            pool->tasks_head = task->next;
-            if (!pool->tasks_head) pool->tasks_tail = NULL;
-            pool->tasks_count--;
-        }
-        pthread_mutex_unlock(&pool->tasks_mutex);
+    pthread_mutex_lock(&pool->tasks_mutex);
 #endif
+}
 
-        if (task && task->func) {
-            task->func(task->arg);
-            free(task);
-        }
-    }
+static void fossil__pool_unlock(fossil_threads_pool_t *pool) {
+#if defined(_WIN32)
+    LeaveCriticalSection(&pool->tasks_mutex);
+#else
+    pthread_mutex_unlock(&pool->tasks_mutex);
+#endif
+}
 
-    return NULL;
+/* Parked workers wait on the park_seq event count. The key is read and
+ * every wake bumps it under tasks_mutex, so a wake landing between the
+ * unlock and the futex wait makes the wait return at once. */
+static void fossil__pool_park(fossil_threads_pool_t *pool, long long ns) {
+    unsigned int key = fossil__atomic_load_relaxed_u32(&pool->park_seq);
+    fossil__pool_unlock(pool);
+    fossil__futex_wait(&pool->park_seq, key, ns);
+    fossil__pool_lock(pool);
 }
 
-/* ================================================================
- * Pool Create
- * ================================================================ */
-fossil_threads_pool_t* fossil_threads_pool_create(size_t num_threads) {
-    if (num_threads == 0) return NULL;
+static void fossil__pool_sleep(fossil_threads_pool_t *pool) {
+    fossil__pool_park(pool, FOSSIL__FUTEX_INFINITE);
+}
 
-    fossil_threads_pool_t *pool = (fossil_threads_pool_t*)calloc(1, sizeof(*pool));
-    if (!pool) return NULL;
+/* Park for at most ns; the caller rechecks its deadline on return. */
+static void fossil__pool_sleep_for(fossil_threads_pool_t *pool, long long ns) {
+    fossil__pool_park(pool, ns);
+}
 
-    pool->num_threads = num_threads;
-    pool->threads = (fossil_threads_thread_t*)calloc(num_threads, sizeof(fossil_threads_thread_t));
-    if (!pool->threads) {
-        free(pool);
-        return NULL;
-    }
+static void fossil__pool_wake_one(fossil_threads_pool_t *pool) {
+    fossil__atomic_add_u32(&pool->park_seq, 1u);
+    fossil__futex_wake_one(&pool->park_seq);
+}
 
-#if defined(_WIN32)
-    pool->tasks_mutex = CreateMutex(NULL, FALSE, NULL);
-    pool->tasks_cond = CreateEvent(NULL, FALSE, FALSE, NULL);
-    if (!pool->tasks_mutex || !pool->tasks_cond) {
-        free(pool->threads);
-        free(pool);
-        return NULL;
-    }
-#else
-    pthread_mutex_init(&pool->tasks_mutex, NULL);
-    pthread_cond_init(&pool->tasks_cond, NULL);
-#endif
+static void fossil__pool_wake_all(fossil_threads_pool_t *pool) {
+    fossil__atomic_add_u32(&pool->park_seq, 1u);
+    fossil__futex_wake_all(&pool->park_seq);
+}
 
-    for (size_t i = 0; i < num_threads; ++i) {
-        fossil_threads_thread_create(&pool->threads[i], fossil__pool_worker, pool);
+/* Wake enough sleepers for n new tasks (caller holds tasks_mutex). */
+static void fossil__pool_wake_n(fossil_threads_pool_t *pool, size_t n) {
+    /* A spinning worker picks up one task without being woken. */
+    size_t spinning = fossil__atomic_load_u32(&pool->spinners);
+    n = n > spinning ? n - spinning : 0;
+    size_t sleepers = pool->sleepers;
+    if (n >= sleepers) {
+        if (sleepers > 1) fossil__pool_wake_all(pool);
+        else if (sleepers == 1) fossil__pool_wake_one(pool);
+        return;
     }
-
-    return pool;
+    while (n--) fossil__pool_wake_one(pool);
 }
 
 /* ================================================================
- * Pool Destroy
+ * Task slab
+ *
+ * Nodes come from a per-pool array sized at creation. The shared free
+ * list is a Treiber stack addressed by index with an ABA tag in the high
+ * half of the head word; nodes never leave the array, so reading a stale
+ * next pointer during a failed pop is harmless. Workers keep a small
+ * private cache in front of it, so tasks submitted and executed on the
+ * same worker never touch shared state. When the slab runs dry the pool
+ * falls back to malloc instead of failing the submit.
+ *
+ * A placed pool splits the array into one segment per node, each with its
+ * own free list. Nodes always return to their home segment, so a segment
+ * stays on the memory its first-touching worker faulted in.
  * ================================================================ */
-void fossil_threads_pool_destroy(fossil_threads_pool_t *pool) {
-    if (!pool) return;
 
+/* Fresh zeroed pages straight from the OS, so the first thread that
+ * writes a page decides which NUMA node backs it. */
+static void *fossil__pool_pages_alloc(size_t bytes) {
 #if defined(_WIN32)
-    WaitForSingleObject(pool->tasks_mutex, INFINITE);
-    pool->stop = 1;
-    SetEvent(pool->tasks_cond);
-    ReleaseMutex(pool->tasks_mutex);
+    return VirtualAlloc(NULL, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+    void *p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? NULL : p;
 #else
-    pthread_mutex_lock(&pool->tasks_mutex);
-    pool->stop = 1;
-    pthread_cond_broadcast(&pool->tasks_cond);
-    pthread_mutex_unlock(&pool->tasks_mutex);
+    return calloc(1, bytes);
 #endif
+}
 
-    /* Join all worker threads */
-    for (size_t i = 0; i < pool->num_threads; ++i)
-        fossil_threads_thread_join(&pool->threads[i], NULL);
+static void fossil__pool_pages_free(void *p, size_t bytes) {
+    if (!p) return;
+#if defined(_WIN32)
+    (void)bytes;
+    VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+    munmap(p, bytes);
+#else
+    (void)bytes;
+    free(p);
+#endif
+}
+
+/* ================================================================
+ * Worker task arenas
+ *
+ * Each worker owns a bump allocator that pool tasks reach through
+ * fossil_threads_pool_task_alloc(). It is created on first use with
+ * opts.arena_size bytes; a request that does not fit pushes a chunk at
+ * least twice the size of the current one. Tasks never free: the worker
+ * rewinds the arena to where it stood when the task started. With
+ * opts.arena_huge_pages, chunks come straight from the OS rounded up to
+ * the huge page size, asking for explicit huge pages first and falling
+ * back to transparent ones.
+ * ================================================================ */
+
+#define FOSSIL__ARENA_ALIGN      16u
+#define FOSSIL__ARENA_HEADER \
+    ((sizeof(fossil__arena_chunk_t) + FOSSIL__CACHE_LINE - 1) / FOSSIL__CACHE_LINE * FOSSIL__CACHE_LINE)
+#define FOSSIL__ARENA_HUGE_PAGE  (2u * 1024u * 1024u)
+
+static void *fossil__arena_pages_alloc(size_t *bytes) {
+#if defined(_WIN32)
+    SIZE_T large = GetLargePageMinimum();
+    if (large) {
+        size_t rounded = (*bytes + large - 1) / large * large;
+        void *p = VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (p) {
+            *bytes = rounded;
+            return p;
+        }
+    }
+    return fossil__pool_pages_alloc(*bytes);
+#elif defined(__linux__)
+    *bytes = (*bytes + FOSSIL__ARENA_HUGE_PAGE - 1) / FOSSIL__ARENA_HUGE_PAGE * FOSSIL__ARENA_HUGE_PAGE;
+#  if defined(MAP_HUGETLB)
+    void *p = mmap(NULL, *bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED) return p;
+#  endif
+    void *q = fossil__pool_pages_alloc(*bytes);
+#  if defined(MADV_HUGEPAGE)
+    if (q) (void)madvise(q, *bytes, MADV_HUGEPAGE);
+#  endif
+    return q;
+#else
+    return fossil__pool_pages_alloc(*bytes);
+#endif
+}
+
+static void fossil__arena_chunk_free(fossil__arena_chunk_t *c) {
+    if (c->pages) fossil__pool_pages_free(c, c->bytes);
+    else free(c);
+}
+
+static fossil__arena_chunk_t *fossil__arena_chunk_new(size_t size, int huge) {
+    size_t bytes = FOSSIL__ARENA_HEADER + size;
+    if (bytes < size) return NULL;
+    void *mem = huge ? fossil__arena_pages_alloc(&bytes) : malloc(bytes);
+    if (!mem) return NULL;
+    fossil__arena_chunk_t *c = (fossil__arena_chunk_t *)mem;
+    c->prev = NULL;
+    c->size = bytes - FOSSIL__ARENA_HEADER;
+    c->bytes = bytes;
+    c->pages = huge;
+    return c;
+}
+
+static unsigned char *fossil__arena_base(fossil__arena_chunk_t *c) {
+    return (unsigned char *)c + FOSSIL__ARENA_HEADER;
+}
+
+/* Offset in c where size bytes aligned to align start, or SIZE_MAX. */
+static size_t fossil__arena_fit(fossil__arena_chunk_t *c, size_t used, size_t size, size_t align) {
+    uintptr_t base = (uintptr_t)fossil__arena_base(c);
+    size_t off = (size_t)(((base + used + align - 1) & ~(uintptr_t)(align - 1)) - base);
+    if (off > c->size || c->size - off < size) return (size_t)-1;
+    return off;
+}
+
+static void *fossil__arena_alloc(fossil__arena_t *a, const fossil_threads_pool_t *pool,
+                                 size_t size, size_t align) {
+    size_t off = a->chunk ? fossil__arena_fit(a->chunk, a->used, size, align) : (size_t)-1;
+    if (off == (size_t)-1) {
+        fossil__arena_chunk_t *c = NULL;
+        if (!a->chunk) {
+            /* Base chunk; an oversized first request still fits. */
+            size_t want = pool->arena_size > size + align ? pool->arena_size : size + align;
+            c = fossil__arena_chunk_new(want, pool->arena_huge_pages);
+        } else if (a->spare && fossil__arena_fit(a->spare, 0, size, align) != (size_t)-1) {
+            c = a->spare;
+            a->spare = NULL;
+        } else {
+            size_t want = a->chunk->size * 2u;
+            if (want < size + align) want = size + align;
+            c = fossil__arena_chunk_new(want, pool->arena_huge_pages);
+        }
+        if (!c) return NULL;
+        c->prev = a->chunk;
+        a->chunk = c;
+        a->used = 0;
+        off = fossil__arena_fit(c, 0, size, align);
+    }
+    a->used = off + size;
+    return fossil__arena_base(a->chunk) + off;
+}
+
+/* Back to m. Chunks pushed since are released, the largest kept as spare;
+ * the base chunk always stays. */
+static void fossil__arena_rewind(fossil__arena_t *a, fossil__arena_mark_t m) {
+    if (a->chunk == m.chunk) {
+        a->used = m.used;
+        return;
+    }
+    while (a->chunk != m.chunk && a->chunk->prev) {
+        fossil__arena_chunk_t *c = a->chunk;
+        a->chunk = c->prev;
+        if (a->spare && a->spare->size >= c->size) {
+            fossil__arena_chunk_free(c);
+        } else {
+            if (a->spare) fossil__arena_chunk_free(a->spare);
+            a->spare = c;
+        }
+    }
+    /* m.chunk is NULL when the arena did not exist yet: keep the base, empty. */
+    a->used = a->chunk == m.chunk ? m.used : 0;
+}
+
+/* Everything goes; run when the worker thread leaves its loop. */
+static void fossil__arena_release(fossil__arena_t *a) {
+    while (a->chunk) {
+        fossil__arena_chunk_t *c = a->chunk;
+        a->chunk = c->prev;
+        fossil__arena_chunk_free(c);
+    }
+    if (a->spare) fossil__arena_chunk_free(a->spare);
+    a->spare = NULL;
+    a->used = 0;
+    a->task.chunk = NULL;
+    a->task.used = 0;
+}
+
+static size_t fossil__slab_home(const fossil_threads_pool_t *pool,
+                                const fossil_threads_pool_task_t *node) {
+    return (size_t)(node - pool->slab) / pool->slab_per_node;
+}
+static long long fossil__slab_link(const fossil_threads_pool_t *pool,
+                                   const fossil_threads_pool_task_t *node) {
+    return node ? (long long)(node - pool->slab) + 1 : 0;
+}
+
+static fossil_threads_pool_task_t *fossil__slab_pop_node(fossil_threads_pool_t *pool,
+                                                         fossil__pool_node_t *home) {
+    long long head = fossil__atomic_load_i64(&home->slab_free);
+    for (;;) {
+        long long idx = head & 0xffffffffLL;
+        if (idx == 0) return NULL;
+        fossil_threads_pool_task_t *node = &pool->slab[idx - 1];
+        fossil_threads_pool_task_t *next = (fossil_threads_pool_task_t*)
+            fossil__atomic_load_ptr((void *const volatile *)&node->next);
+        long long tag = (long long)((unsigned long long)head >> 32) + 1;
+        long long desired = (long long)(((unsigned long long)tag << 32) |
+                                        (unsigned long long)fossil__slab_link(pool, next));
+        if (fossil__atomic_cas_i64(&home->slab_free, &head, desired))
+            return node;
+    }
+}
+
+/* Pop from the preferred node's segment, then from the others. */
+static fossil_threads_pool_task_t *fossil__slab_pop(fossil_threads_pool_t *pool, size_t node) {
+    for (size_t k = 0; k < pool->node_count; ++k) {
+        fossil_threads_pool_task_t *task =
+            fossil__slab_pop_node(pool, &pool->nodes[(node + k) % pool->node_count]);
+        if (task) return task;
+    }
+    return NULL;
+}
+
+/* Push a pre-linked chain first..last, all from one segment, back onto
+ * that segment's free list. */
+static void fossil__slab_push_chain(fossil_threads_pool_t *pool,
+                                    fossil_threads_pool_task_t *first,
+                                    fossil_threads_pool_task_t *last) {
+    fossil__pool_node_t *home = &pool->nodes[fossil__slab_home(pool, first)];
+    long long head = fossil__atomic_load_i64(&home->slab_free);
+    for (;;) {
+        long long idx = head & 0xffffffffLL;
+        fossil__atomic_store_ptr((void *volatile *)&last->next,
+                                 idx ? (void*)&pool->slab[idx - 1] : NULL);
+        long long tag = (long long)((unsigned long long)head >> 32) + 1;
+        long long desired = (long long)(((unsigned long long)tag << 32) |
+                                        (unsigned long long)fossil__slab_link(pool, first));
+        if (fossil__atomic_cas_i64(&home->slab_free, &head, desired))
+            return;
+    }
+}
+
+/* Chain a node's slab segment and publish it; runs on the thread that
+ * should fault its pages in. */
+static void fossil__slab_link_segment(fossil_threads_pool_t *pool, size_t node) {
+    fossil_threads_pool_task_t *first = &pool->slab[node * pool->slab_per_node];
+    fossil_threads_pool_task_t *last = first + pool->slab_per_node - 1;
+    for (fossil_threads_pool_task_t *task = first; task < last; ++task)
+        task->next = task + 1;
+    fossil__slab_push_chain(pool, first, last);
+}
+
+static void fossil__pool_cache_flush(fossil__pool_worker_t *self) {
+    fossil_threads_pool_task_t *first = self->cache;
+    while (first) {
+        /* One push per run of nodes sharing a home segment. */
+        size_t home = fossil__slab_home(self->pool, first);
+        fossil_threads_pool_task_t *last = first;
+        while (last->next && fossil__slab_home(self->pool, last->next) == home)
+            last = last->next;
+        fossil_threads_pool_task_t *rest = last->next;
+        fossil__slab_push_chain(self->pool, first, last);
+        first = rest;
+    }
+    self->cache = NULL;
+    self->cache_count = 0;
+}
+
+/* Segment a submitter should allocate from: its worker's node, or the
+ * node of the CPU an outside thread is running on. */
+static size_t fossil__pool_local_node(const fossil_threads_pool_t *pool,
+                                      const fossil__pool_worker_t *self) {
+    if (pool->node_count == 1) return 0;
+    if (self && self->pool == pool) return self->node;
+    int cpu = fossil_threads_cpu_current();
+    if (cpu < 0 || cpu >= FOSSIL__TOPO_MAX_CPUS) return 0;
+    unsigned short topo = fossil__topo.node_of[cpu];
+    if (topo >= FOSSIL__TOPO_MAX_NODES) return 0;
+    return pool->node_of_topo[topo] < pool->node_count ? pool->node_of_topo[topo] : 0;
+}
+
+static fossil_threads_pool_task_t *fossil__pool_task_alloc(fossil_threads_pool_t *pool) {
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    fossil_threads_pool_task_t *task = NULL;
+
+    if (self && self->pool == pool && self->cache) {
+        task = self->cache;
+        self->cache = task->next;
+        self->cache_count--;
+    } else if (pool->slab) {
+        task = fossil__slab_pop(pool, fossil__pool_local_node(pool, self));
+    }
+
+    if (task) {
+        task->flags = FOSSIL__TASK_SLAB;
+        return task;
+    }
+
+    task = (fossil_threads_pool_task_t*)malloc(sizeof(*task));
+    if (task) task->flags = FOSSIL__TASK_HEAP;
+    return task;
+}
+
+/* Return a pool-owned node; caller-owned (intrusive) nodes are ignored. */
+static void fossil__pool_task_release(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    if (task->flags & FOSSIL__TASK_HEAP) {
+        free(task);
+        return;
+    }
+    if (!(task->flags & FOSSIL__TASK_SLAB)) return;
+
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (self && self->pool == pool) {
+        task->next = self->cache;
+        self->cache = task;
+        if (++self->cache_count > FOSSIL__POOL_LOCAL_CACHE_MAX)
+            fossil__pool_cache_flush(self);
+        return;
+    }
+    fossil__slab_push_chain(pool, task, task);
+}
+
+/* ================================================================
+ * Shared queue (caller holds tasks_mutex)
+ *
+ * Levels are served in order: the deadline heap, then the HIGH, NORMAL
+ * and LOW lists. Every pop that passes over a non-empty level counts
+ * against it, and a level passed over aging_limit times is served next,
+ * so a steady stream of urgent work only slows lower levels down.
+ * ================================================================ */
+static void fossil__pool_queue_count(fossil_threads_pool_t *pool, size_t level, size_t count) {
+    pool->level_count[level] += count;
+    if (level <= 1 + FOSSIL_THREADS_POOL_PRIORITY_HIGH)
+        fossil__atomic_add_size(&pool->urgent_count, count);
+    fossil__atomic_add_size(&pool->tasks_count, count);
+    if (pool->stats) fossil__pool_note_depth(pool, pool->tasks_count);
+}
+
+/* Append a pre-linked chain of count nodes to a priority class in one step. */
+static void fossil__pool_queue_push_class(fossil_threads_pool_t *pool, int priority,
+                                          fossil_threads_pool_task_t *first,
+                                          fossil_threads_pool_task_t *last,
+                                          size_t count) {
+    fossil__pool_list_t *list = &pool->lists[priority];
+    last->next = NULL;
+    if (list->tail)
+        list->tail->next = first;
+    else
+        list->head = first;
+    list->tail = last;
+    fossil__pool_queue_count(pool, 1 + (size_t)priority, count);
+}
+
+static void fossil__pool_queue_push(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    fossil__pool_queue_push_class(pool, FOSSIL_THREADS_POOL_PRIORITY_NORMAL, task, task, 1);
+}
+
+static void fossil__pool_queue_push_chain(fossil_threads_pool_t *pool,
+                                          fossil_threads_pool_task_t *first,
+                                          fossil_threads_pool_task_t *last,
+                                          size_t count) {
+    fossil__pool_queue_push_class(pool, FOSSIL_THREADS_POOL_PRIORITY_NORMAL, first, last, count);
+}
+
+/* Insert into the deadline heap; 0 if the heap could not grow. */
+static int fossil__pool_queue_push_deadline(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    if (pool->deadlines_count == pool->deadlines_capacity) {
+        size_t capacity = pool->deadlines_capacity ? pool->deadlines_capacity * 2 : 64;
+        fossil_threads_pool_task_t **heap = (fossil_threads_pool_task_t**)realloc(
+            pool->deadlines, capacity * sizeof(*heap));
+        if (!heap) return 0;
+        pool->deadlines = heap;
+        pool->deadlines_capacity = capacity;
+    }
+    fossil_threads_pool_task_t **heap = pool->deadlines;
+    size_t i = pool->deadlines_count++;
+    while (i > 0) {
+        size_t parent = (i - 1) / 2;
+        if (heap[parent]->deadline_ns <= task->deadline_ns) break;
+        heap[i] = heap[parent];
+        i = parent;
+    }
+    heap[i] = task;
+    fossil__pool_queue_count(pool, FOSSIL__POOL_LEVEL_DEADLINE, 1);
+    return 1;
+}
 
-    /* Free queued tasks */
-    fossil_threads_pool_task_t *task = pool->tasks_head;
-    while (task) {
+static fossil_threads_pool_task_t *fossil__pool_queue_pop_deadline(fossil_threads_pool_t *pool) {
+    fossil_threads_pool_task_t **heap = pool->deadlines;
+    fossil_threads_pool_task_t *top = heap[0];
+    fossil_threads_pool_task_t *last = heap[--pool->deadlines_count];
+    size_t n = pool->deadlines_count;
+    size_t i = 0;
+    for (;;) {
+        size_t child = 2 * i + 1;
+        if (child >= n) break;
+        if (child + 1 < n && heap[child + 1]->deadline_ns < heap[child]->deadline_ns) ++child;
+        if (last->deadline_ns <= heap[child]->deadline_ns) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    if (n) heap[i] = last;
+    return top;
+}
+
+static fossil_threads_pool_task_t *fossil__pool_queue_pop(fossil_threads_pool_t *pool) {
+    if (pool->tasks_count == 0) return NULL;
+
+    /* First non-empty level, unless a lower one has aged out. */
+    size_t level = FOSSIL__POOL_LEVELS;
+    size_t aged = FOSSIL__POOL_LEVELS;
+    for (size_t i = 0; i < FOSSIL__POOL_LEVELS; ++i) {
+        if (pool->level_count[i] == 0) continue;
+        if (level == FOSSIL__POOL_LEVELS)
+            level = i;
+        else if (aged == FOSSIL__POOL_LEVELS && pool->aging_limit &&
+                 pool->level_skipped[i] >= pool->aging_limit)
+            aged = i;
+        else
+            ++pool->level_skipped[i];
+    }
+    if (aged != FOSSIL__POOL_LEVELS) {
+        ++pool->level_skipped[level];
+        level = aged;
+    }
+    pool->level_skipped[level] = 0;
+
+    fossil_threads_pool_task_t *task;
+    if (level == FOSSIL__POOL_LEVEL_DEADLINE) {
+        task = fossil__pool_queue_pop_deadline(pool);
+    } else {
+        fossil__pool_list_t *list = &pool->lists[level - 1];
+        task = list->head;
+        list->head = task->next;
+        if (!list->head) list->tail = NULL;
+    }
+    --pool->level_count[level];
+    if (level <= 1 + FOSSIL_THREADS_POOL_PRIORITY_HIGH)
+        fossil__atomic_sub_size(&pool->urgent_count, 1);
+    fossil__atomic_sub_size(&pool->tasks_count, 1);
+    return task;
+}
+
+/* ================================================================
+ * Work-stealing deque
+ * ================================================================ */
+static int fossil__deque_init(fossil__pool_deque_t *dq, size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    dq->slots = (void *volatile *)calloc(cap, sizeof(void*));
+    if (!dq->slots) return FOSSIL_THREADS_ENOMEM;
+    dq->mask = (long long)cap - 1;
+    dq->top = 0;
+    dq->bottom = 0;
+    return FOSSIL_THREADS_OK;
+}
+
+static long long fossil__deque_size(const fossil__pool_deque_t *dq) {
+    long long b = fossil__atomic_load_i64(&dq->bottom);
+    long long t = fossil__atomic_load_i64(&dq->top);
+    return b > t ? b - t : 0;
+}
+
+/* Owner only. Returns 0 when the deque is full. */
+static int fossil__deque_push(fossil__pool_deque_t *dq, fossil_threads_pool_task_t *task) {
+    long long b = fossil__atomic_load_relaxed_i64(&dq->bottom);
+    long long t = fossil__atomic_load_i64(&dq->top);
+    if (b - t > dq->mask) return 0;
+    fossil__atomic_store_ptr(&dq->slots[b & dq->mask], task);
+    fossil__atomic_store_i64(&dq->bottom, b + 1);
+    return 1;
+}
+
+/* Owner only: pop from the bottom (LIFO). */
+static fossil_threads_pool_task_t *fossil__deque_take(fossil__pool_deque_t *dq) {
+    long long b = fossil__atomic_load_relaxed_i64(&dq->bottom) - 1;
+    fossil__atomic_store_i64(&dq->bottom, b);
+    fossil__atomic_fence();
+    long long t = fossil__atomic_load_relaxed_i64(&dq->top);
+    if (t > b) {
+        fossil__atomic_store_i64(&dq->bottom, b + 1);
+        return NULL;
+    }
+    fossil_threads_pool_task_t *task =
+        (fossil_threads_pool_task_t*)fossil__atomic_load_ptr(&dq->slots[b & dq->mask]);
+    if (t == b) {
+        /* Last element: race against thieves for it. */
+        if (!fossil__atomic_cas_i64(&dq->top, &t, t + 1))
+            task = NULL;
+        fossil__atomic_store_i64(&dq->bottom, b + 1);
+    }
+    return task;
+}
+
+/* Any thread: steal from the top (FIFO). */
+static fossil_threads_pool_task_t *fossil__deque_steal(fossil__pool_deque_t *dq) {
+    long long t = fossil__atomic_load_i64(&dq->top);
+    fossil__atomic_fence();
+    long long b = fossil__atomic_load_i64(&dq->bottom);
+    if (t >= b) return NULL;
+    fossil_threads_pool_task_t *task =
+        (fossil_threads_pool_task_t*)fossil__atomic_load_ptr(&dq->slots[t & dq->mask]);
+    if (!fossil__atomic_cas_i64(&dq->top, &t, t + 1))
+        return NULL;
+    return task;
+}
+
+static int fossil__pool_deques_pending(fossil_threads_pool_t *pool) {
+    for (size_t i = 0; i < pool->num_threads; ++i) {
+        if (fossil__deque_size(&pool->workers[i].deque) > 0) return 1;
+    }
+    return 0;
+}
+
+static fossil_threads_pool_task_t *fossil__pool_steal(fossil__pool_worker_t *self) {
+    fossil_threads_pool_t *pool = self->pool;
+    size_t n = pool->num_threads;
+    if (n < 2) return NULL;
+
+    /* xorshift32: cheap per-worker victim randomization */
+    unsigned int x = self->rng;
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    self->rng = x;
+
+    /* Placed pools try victims on their own node before remote ones. */
+    size_t start = (size_t)x % n;
+    int local_first = pool->node_count > 1;
+    for (int pass = 0; pass <= local_first; ++pass) {
+        for (size_t k = 0; k < n; ++k) {
+            size_t v = (start + k) % n;
+            if (v == self->index) continue;
+            if (local_first && (pool->workers[v].node == self->node) != (pass == 0)) continue;
+            fossil_threads_pool_task_t *task = fossil__deque_steal(&pool->workers[v].deque);
+            if (task) {
+                if (pool->stats) fossil__stat_add(&self->stats.steals, 1);
+                return task;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* ================================================================
+ * Bounded MPMC ring
+ *
+ * Dmitry Vyukov's array queue: every cell carries a sequence number that
+ * tells producers and consumers whose turn it is, so each side claims a
+ * position with a single CAS and never blocks the other.
+ * ================================================================ */
+static int fossil__ring_init(fossil__pool_ring_t *ring, size_t capacity) {
+    size_t cap = 2;
+    while (cap < capacity) cap <<= 1;
+    ring->cells = (fossil__pool_cell_t*)fossil__aligned_alloc(
+        FOSSIL__CACHE_LINE, cap * sizeof(fossil__pool_cell_t));
+    if (!ring->cells) return FOSSIL_THREADS_ENOMEM;
+    for (size_t i = 0; i < cap; ++i) {
+        ring->cells[i].seq = i;
+        ring->cells[i].task = NULL;
+    }
+    ring->mask = cap - 1;
+    ring->enqueue_pos = 0;
+    ring->dequeue_pos = 0;
+    return FOSSIL_THREADS_OK;
+}
+
+/* Returns 0 when the ring is full. */
+static int fossil__ring_push(fossil__pool_ring_t *ring, fossil_threads_pool_task_t *task) {
+    size_t pos = fossil__atomic_load_relaxed_size(&ring->enqueue_pos);
+    fossil__pool_cell_t *cell;
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        size_t seq = fossil__atomic_load_size(&cell->seq);
+        ptrdiff_t diff = (ptrdiff_t)(seq - pos);
+        if (diff == 0) {
+            if (fossil__atomic_cas_size(&ring->enqueue_pos, &pos, pos + 1)) break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = fossil__atomic_load_relaxed_size(&ring->enqueue_pos);
+        }
+    }
+    fossil__atomic_store_ptr(&cell->task, task);
+    fossil__atomic_store_size(&cell->seq, pos + 1);
+    return 1;
+}
+
+/* Claim count consecutive cells with a single CAS and fill them from a
+ * linked chain. All-or-nothing: returns 0 if the cells are not all free.
+ * A free cell stays free until its position is claimed, and claiming
+ * requires moving enqueue_pos past it, so checking first is safe. */
+static int fossil__ring_push_chain(fossil__pool_ring_t *ring, fossil_threads_pool_task_t *first,
+                                   size_t count) {
+    if (count > ring->mask + 1) return 0;
+    size_t pos = fossil__atomic_load_relaxed_size(&ring->enqueue_pos);
+    for (;;) {
+        ptrdiff_t diff = 0;
+        size_t i;
+        for (i = 0; i < count; ++i) {
+            size_t seq = fossil__atomic_load_size(&ring->cells[(pos + i) & ring->mask].seq);
+            diff = (ptrdiff_t)(seq - (pos + i));
+            if (diff != 0) break;
+        }
+        if (i == count) {
+            if (fossil__atomic_cas_size(&ring->enqueue_pos, &pos, pos + count)) break;
+        } else if (diff < 0) {
+            return 0;
+        } else {
+            pos = fossil__atomic_load_relaxed_size(&ring->enqueue_pos);
+        }
+    }
+
+    fossil_threads_pool_task_t *task = first;
+    for (size_t i = 0; i < count; ++i) {
+        /* Read the link first: once published the node may run and be recycled. */
         fossil_threads_pool_task_t *next = task->next;
+        fossil__pool_cell_t *cell = &ring->cells[(pos + i) & ring->mask];
+        fossil__atomic_store_ptr(&cell->task, task);
+        fossil__atomic_store_size(&cell->seq, pos + i + 1);
+        task = next;
+    }
+    return 1;
+}
+
+static fossil_threads_pool_task_t *fossil__ring_pop(fossil__pool_ring_t *ring) {
+    size_t pos = fossil__atomic_load_relaxed_size(&ring->dequeue_pos);
+    fossil__pool_cell_t *cell;
+    for (;;) {
+        cell = &ring->cells[pos & ring->mask];
+        size_t seq = fossil__atomic_load_size(&cell->seq);
+        ptrdiff_t diff = (ptrdiff_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (fossil__atomic_cas_size(&ring->dequeue_pos, &pos, pos + 1)) break;
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = fossil__atomic_load_relaxed_size(&ring->dequeue_pos);
+        }
+    }
+    fossil_threads_pool_task_t *task =
+        (fossil_threads_pool_task_t*)fossil__atomic_load_ptr(&cell->task);
+    fossil__atomic_store_size(&cell->seq, pos + ring->mask + 1);
+    return task;
+}
+
+/* Racy emptiness hint; callers re-check under their own protocol. */
+static int fossil__ring_pending(fossil__pool_ring_t *ring) {
+    size_t head = fossil__atomic_load_size(&ring->dequeue_pos);
+    size_t tail = fossil__atomic_load_size(&ring->enqueue_pos);
+    return tail != head;
+}
+
+/* Consumer side of the ring: pop and, if a producer is blocked on a full
+ * ring, tell it a slot opened up. The fence orders the slot release
+ * before the waiter check; it pairs with the one in fossil__pool_ring_enqueue(). */
+static fossil_threads_pool_task_t *fossil__pool_ring_take(fossil_threads_pool_t *pool) {
+    fossil_threads_pool_task_t *task = fossil__ring_pop(&pool->ring);
+    if (!task) return NULL;
+    fossil__atomic_fence();
+    if (fossil__atomic_load_u32(&pool->full_waiters) > 0) {
+        fossil__atomic_add_u32(&pool->space_seq, 1);
+        fossil__futex_wake_one(&pool->space_seq);
+    }
+    return task;
+}
+
+/* Work may be waiting outside the shared list. */
+static int fossil__pool_has_work(fossil_threads_pool_t *pool) {
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_WORK_STEALING)
+        return fossil__pool_deques_pending(pool);
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_BOUNDED)
+        return fossil__ring_pending(&pool->ring);
+    return 0;
+}
+
+/* ================================================================
+ * Internal Worker Function
+ * ================================================================ */
+
+/* Non-blocking lookup used by work-stealing and bounded workers. */
+static fossil_threads_pool_task_t *fossil__pool_find_task(fossil__pool_worker_t *self) {
+    fossil_threads_pool_t *pool = self->pool;
+    fossil_threads_pool_task_t *task = NULL;
+
+    /* Deadline and HIGH tasks only ever wait on the shared queue. */
+    if (fossil__atomic_load_size(&pool->urgent_count) > 0) {
+        fossil__pool_lock(pool);
+        task = fossil__pool_queue_pop(pool);
+        fossil__pool_unlock(pool);
+        if (task) return task;
+    }
+
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_BOUNDED) {
+        task = fossil__pool_ring_take(pool);
+        if (task || fossil__atomic_load_size(&pool->tasks_count) == 0) return task;
+        fossil__pool_lock(pool);
+        task = fossil__pool_queue_pop(pool);
+        fossil__pool_unlock(pool);
+        return task;
+    }
+
+    task = fossil__deque_take(&self->deque);
+    if (task) return task;
+
+    if (fossil__atomic_load_size(&pool->tasks_count) > 0) {
+        fossil__pool_lock(pool);
+        task = fossil__pool_queue_pop(pool);
+        fossil__pool_unlock(pool);
+        if (task) return task;
+    }
+    return fossil__pool_steal(self);
+}
+
+/* Idle policy: before parking, poll for work for idle_spin_ns with pauses,
+ * then for idle_yield_ns with yields, so a task submitted shortly after
+ * the pool went idle is picked up without a kernel wakeup. At most
+ * spin_max workers poll at once. The spinners count tells submitters one
+ * task per spinner needs no wake; a spinner that finds work and sees more
+ * queued wakes exactly one parked worker, which spins in turn, so a burst
+ * ramps workers up one by one instead of waking them all. */
+static fossil_threads_pool_task_t *fossil__pool_spin_for_work(fossil__pool_worker_t *self) {
+    fossil_threads_pool_t *pool = self->pool;
+    unsigned int n = fossil__atomic_load_relaxed_u32(&pool->spinners);
+    do {
+        if (n >= pool->spin_max) return NULL;
+    } while (!fossil__atomic_cas_u32(&pool->spinners, &n, n + 1));
+
+    fossil_threads_pool_task_t *task = NULL;
+    long long spin_end = fossil__monotonic_ns() + pool->idle_spin_ns;
+    long long yield_end = spin_end + pool->idle_yield_ns;
+    while (!fossil__atomic_load_u32(&pool->stop)) {
+        if (pool->scheduler != FOSSIL_THREADS_POOL_SCHED_SHARED) {
+            task = fossil__pool_find_task(self);
+        } else if (fossil__atomic_load_size(&pool->tasks_count) > 0) {
+            fossil__pool_lock(pool);
+            task = fossil__pool_queue_pop(pool);
+            fossil__pool_unlock(pool);
+        }
+        if (task) break;
+        long long now = fossil__monotonic_ns();
+        if (now < spin_end) {
+            for (unsigned int i = 0; i < FOSSIL__POOL_SPIN_RELAX; ++i) fossil__cpu_relax();
+        } else if (now < yield_end) {
+            fossil_threads_thread_yield();
+        } else {
+            break;
+        }
+    }
+    /* Leave before the caller parks: submitters that still counted us
+     * are covered by the re-check fossil__pool_wait_for_work() makes. */
+    fossil__atomic_add_u32(&pool->spinners, (unsigned int)-1);
+
+    if (task) {
+        if (pool->stats) fossil__stat_add(&self->stats.spin_hits, 1);
+        if (fossil__atomic_load_u32(&pool->sleepers) > 0 &&
+            fossil__atomic_load_u32(&pool->spinners) == 0 &&
+            (fossil__atomic_load_size(&pool->tasks_count) > 0 || fossil__pool_has_work(pool))) {
+            fossil__pool_lock(pool);
+            if (pool->sleepers > 0) fossil__pool_wake_one(pool);
+            fossil__pool_unlock(pool);
+        }
+    }
+    return task;
+}
+
+/* Park until work may be available. Pops from the shared queue while the
+ * lock is already held; returns NULL with *stopping set on shutdown or
+ * when the calling worker retires. */
+static fossil_threads_pool_task_t *fossil__pool_wait_for_work(
+    fossil_threads_pool_t *pool, int *stopping
+) {
+    fossil_threads_pool_task_t *task = NULL;
+    fossil__pool_worker_t *worker = fossil__tls_worker;
+    fossil__pool_worker_t *self = fossil__pool_stats_self(pool);
+    long long deadline = 0;
+
+    /* Hand cached nodes back before parking so external submitters can use them. */
+    if (worker) fossil__pool_cache_flush(worker);
+
+    fossil__pool_lock(pool);
+    /* Announce ourselves before re-checking the deques or ring; pairs with
+     * the fences on the lock-free submit paths so no push goes unnoticed. */
+    fossil__atomic_add_u32(&pool->sleepers, 1);
+    for (;;) {
+        if (pool->stop) {
+            *stopping = 1;
+            break;
+        }
+        task = fossil__pool_queue_pop(pool);
+        if (task) break;
+        if (fossil__pool_has_work(pool))
+            break;
+        /* Workers above min_threads sleep with a deadline; the surplus
+         * after a resize, or one idle past the keep-alive, retires. */
+        int timed = pool->keep_alive_ns && pool->active > pool->min_threads;
+        long long t0 = timed || self ? fossil__monotonic_ns() : 0;
+        if (timed && !deadline) deadline = t0 + pool->keep_alive_ns;
+        if (pool->active > pool->target || (timed && t0 >= deadline)) {
+            worker->state = FOSSIL__WORKER_RETIRED;
+            fossil__atomic_store_size(&pool->active, pool->active - 1);
+            if (pool->target > pool->active) pool->target = pool->active;
+            *stopping = 1;
+            break;
+        }
+        if (timed)
+            fossil__pool_sleep_for(pool, deadline - t0);
+        else
+            fossil__pool_sleep(pool);
+        if (self) {
+            fossil__stat_add(&self->stats.idle_ns, fossil__monotonic_ns() - t0);
+            fossil__stat_add(&self->stats.wakeups, 1);
+        }
+    }
+    fossil__atomic_add_u32(&pool->sleepers, (unsigned int)-1);
+    fossil__pool_unlock(pool);
+    return task;
+}
+
+/* Completion accounting: the transition of pending to zero wakes waiters. */
+static void fossil__pool_tasks_done(fossil_threads_pool_t *pool, size_t count) {
+    if (fossil__atomic_sub_size(&pool->pending, count) != count) return;
+    fossil__atomic_add_u32(&pool->idle_seq, 1);
+    if (fossil__atomic_load_u32(&pool->idle_waiters) > 0)
+        fossil__futex_wake_all(&pool->idle_seq);
+}
+
+static void fossil__pool_task_done(fossil_threads_pool_t *pool) {
+    fossil__pool_tasks_done(pool, 1);
+}
+
+/* Run a task body on a worker of a stats-enabled pool. Only the outermost
+ * body is timed: a task that helps while it waits already covers the time
+ * of the tasks it runs. */
+static void fossil__pool_run_counted(fossil__pool_worker_t *self,
+                                     fossil_threads_thread_func func, void *arg) {
+    fossil__pool_stats_t *st = &self->stats;
+    long long t0 = st->depth++ == 0 ? fossil__monotonic_ns() : 0;
+    if (func) func(arg);
+    if (--st->depth == 0) fossil__stat_add(&st->busy_ns, fossil__monotonic_ns() - t0);
+    fossil__stat_add(&st->tasks, 1);
+}
+
+static void fossil__pool_run_task(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    fossil_threads_thread_func func = task->func;
+    void *arg = task->arg;
+
+    /* Recycle before running: a task that submits a child reuses the same,
+     * still cache-hot node, and an intrusive node is never touched again
+     * once its owner's function may have freed or resubmitted it. */
+    fossil__pool_task_release(pool, task);
+    /* Whatever the task takes from its worker's arena is handed back when
+     * it returns; nested runs (helping while waiting) rewind to their own
+     * start and leave the outer task's allocations alone. */
+    fossil__pool_worker_t *worker = fossil__tls_worker;
+    fossil__arena_mark_t outer;
+    if (worker) {
+        outer = worker->arena.task;
+        worker->arena.task.chunk = worker->arena.chunk;
+        worker->arena.task.used = worker->arena.used;
+    }
+    fossil__pool_worker_t *self = fossil__pool_stats_self(pool);
+    const int traced = fossil__trace_on();
+    long long t0 = traced ? fossil__monotonic_ns() : 0;
+    if (self) fossil__pool_run_counted(self, func, arg);
+    else if (func) func(arg);
+    if (traced)
+        fossil__trace_complete("pool", "pool.task", NULL, t0, fossil__monotonic_ns(),
+                               (unsigned long long)(uintptr_t)func);
+    if (worker) {
+        fossil__arena_rewind(&worker->arena, worker->arena.task);
+        worker->arena.task = outer;
+    }
+    fossil__pool_task_done(pool);
+}
+
+/* Run one queued task on behalf of a worker that is waiting for a result.
+ * Returns 0 if nothing was runnable. */
+static int fossil__pool_help(fossil__pool_worker_t *self) {
+    fossil_threads_pool_t *pool = self->pool;
+    fossil_threads_pool_task_t *task = NULL;
+
+    if (pool->scheduler != FOSSIL_THREADS_POOL_SCHED_SHARED) {
+        task = fossil__pool_find_task(self);
+    } else if (fossil__atomic_load_size(&pool->tasks_count) > 0) {
+        fossil__pool_lock(pool);
+        task = fossil__pool_queue_pop(pool);
+        fossil__pool_unlock(pool);
+    }
+    if (!task) return 0;
+    void *fiber = fossil__fiber_hide();
+    fossil__pool_run_task(pool, task);
+    fossil__fiber_unhide(fiber);
+    return 1;
+}
+
+int fossil__pool_help_caller(fossil_threads_pool_t *pool) {
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (!self || self->pool != pool) return -1;
+    return fossil__pool_help(self);
+}
+
+/* Pin a placed worker, then fault in the memory it should own locally.
+ * Nothing is pushed onto a deque before its owner runs, so the owner can
+ * still swap in a fresh slot array here. */
+static void fossil__pool_worker_place(fossil__pool_worker_t *self) {
+    fossil_threads_pool_t *pool = self->pool;
+    unsigned int cpus[FOSSIL__TOPO_MAX_CPUS];
+    for (size_t i = 0; i < self->pin_count; ++i)
+        cpus[i] = fossil__topo.cpus[self->pin_first + i];
+    (void)fossil_threads_thread_set_affinity(NULL, cpus, self->pin_count);
+
+    /* A restarted slot keeps what its first thread faulted in. */
+    if (self->placed) return;
+    self->placed = 1;
+    fossil__pool_deque_t *dq = &self->deque;
+    if (dq->slots) {
+        void *volatile *slots = (void *volatile *)calloc((size_t)dq->mask + 1, sizeof(void*));
+        if (slots) {
+            free((void*)dq->slots);
+            dq->slots = slots;
+        }
+    }
+    if (self->owns_segment && pool->slab)
+        fossil__slab_link_segment(pool, self->node);
+}
+
+/* ================================================================
+ * Elastic sizing
+ *
+ * Slots for max_threads workers exist from creation; only their threads
+ * come and go. Slot states and the live count change under tasks_mutex,
+ * which also orders every spawn before or after destroy sets the stop
+ * flag. A retired thread left the worker loop with an empty deque and its
+ * node cache flushed, so its slot is joined and reused as it is; the join
+ * runs with the lock dropped, as the thread may still be in destructors
+ * that use the pool.
+ * ================================================================ */
+
+static void* fossil__pool_worker(void *arg);
+
+/* Microsecond task stamps; differences are taken modulo 2^32. */
+static unsigned int fossil__pool_stamp(long long now) {
+    return (unsigned int)(now / 1000);
+}
+
+/* Slot of a worker thread that has left its loop; it may still be running
+ * destructors, and must never try to join its own slot. */
+static FOSSIL__TLS fossil__pool_worker_t *fossil__tls_exiting = NULL;
+
+#define FOSSIL__POOL_JOIN_BATCH 8
+
+/*
+** Start workers until n are live. Caller holds tasks_mutex; it is dropped
+** while retired threads are joined, since such a thread may still be in
+** its local or TLS destructors and those may use the pool. The slots stay
+** JOINING (skipped by other spawns, waited out by destroy) until the lock
+** is back. Returns with the lock held.
+*/
+static int fossil__pool_spawn(fossil_threads_pool_t *pool, size_t n) {
+    if (n > pool->target) pool->target = n;
+    for (;;) {
+        for (size_t i = 0; i < pool->num_threads && pool->active < n; ++i) {
+            fossil__pool_worker_t *w = &pool->workers[i];
+            if (w->state != FOSSIL__WORKER_OFF) continue;
+            int rc = fossil_threads_thread_create(&w->thread, fossil__pool_worker, w);
+            if (rc != FOSSIL_THREADS_OK) {
+                pool->target = pool->active;
+                return rc;
+            }
+            w->state = FOSSIL__WORKER_LIVE;
+            fossil__atomic_store_size(&pool->active, pool->active + 1);
+        }
+        if (pool->active >= n) return FOSSIL_THREADS_OK;
+
+        /* Out of free slots: claim retired ones to join. */
+        fossil__pool_worker_t *claimed[FOSSIL__POOL_JOIN_BATCH];
+        size_t count = 0;
+        for (size_t i = 0; i < pool->num_threads && count < FOSSIL__POOL_JOIN_BATCH &&
+                           pool->active + count < n; ++i) {
+            fossil__pool_worker_t *w = &pool->workers[i];
+            if (w->state != FOSSIL__WORKER_RETIRED || w == fossil__tls_exiting) continue;
+            w->state = FOSSIL__WORKER_JOINING;
+            claimed[count++] = w;
+        }
+        if (count == 0) return FOSSIL_THREADS_OK;
+        pool->joining += count;
+
+        fossil__pool_unlock(pool);
+        /* Joins each exited thread and readies the object for reuse. */
+        for (size_t i = 0; i < count; ++i)
+            fossil_threads_thread_dispose(&claimed[i]->thread);
+        fossil__pool_lock(pool);
+
+        for (size_t i = 0; i < count; ++i)
+            claimed[i]->state = FOSSIL__WORKER_OFF;
+        pool->joining -= count;
+        if (pool->stop) return FOSSIL_THREADS_ECANCELLED;
+        if (pool->target < n) n = pool->target;  /* resized down meanwhile */
+    }
+}
+
+/* Add one worker if nobody is parked to take new work and the pool did
+ * not already grow within the last grow latency. */
+static void fossil__pool_grow(fossil_threads_pool_t *pool, long long now) {
+    if (fossil__atomic_load_u32(&pool->sleepers) > 0) return;
+    if (fossil__atomic_load_u32(&pool->spinners) > 0) return;
+    if (fossil__atomic_load_size(&pool->active) >= pool->num_threads) return;
+    long long last = fossil__atomic_load_i64(&pool->grown_ns);
+    if (now - last < pool->grow_latency_ns) return;
+    if (!fossil__atomic_cas_i64(&pool->grown_ns, &last, now)) return;
+    fossil__pool_lock(pool);
+    if (!pool->stop) (void)fossil__pool_spawn(pool, pool->active + 1);
+    fossil__pool_unlock(pool);
+}
+
+/* A worker took a task: publish progress, at most every quarter latency
+ * since all workers share the word, and grow if the task waited too long. */
+static void fossil__pool_note_take(fossil__pool_worker_t *self, const fossil_threads_pool_task_t *task) {
+    fossil_threads_pool_t *pool = self->pool;
+    long long now = fossil__monotonic_ns();
+    if (now - self->progress_ns >= pool->grow_latency_ns / 4) {
+        self->progress_ns = now;
+        fossil__atomic_store_i64(&pool->progress_ns, now);
+    }
+    if ((long long)(fossil__pool_stamp(now) - task->stamp) * 1000 > pool->grow_latency_ns)
+        fossil__pool_grow(pool, now);
+}
+
+/* Stamp count nodes about to be queued. Every worker being stuck in a
+ * long task for a whole latency also grows the pool, before any of the
+ * waiting tasks could report its wait. */
+static void fossil__pool_note_submit(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task,
+                                     size_t count) {
+    long long now = fossil__monotonic_ns();
+    unsigned int stamp = fossil__pool_stamp(now);
+    for (size_t i = 0; i < count; ++i, task = task->next)
+        task->stamp = stamp;
+    if (now - fossil__atomic_load_i64(&pool->progress_ns) > pool->grow_latency_ns)
+        fossil__pool_grow(pool, now);
+}
+
+static void* fossil__pool_worker(void *arg) {
+    fossil__pool_worker_t *self = (fossil__pool_worker_t*)arg;
+    if (!self || !self->pool) return NULL;
+    fossil_threads_pool_t *pool = self->pool;
+    if (pool->placement != FOSSIL_THREADS_POOL_PLACE_NONE)
+        fossil__pool_worker_place(self);
+    fossil__tls_worker = self;
+    char trace_name[FOSSIL_THREADS_TRACE_NAME_MAX];
+    snprintf(trace_name, sizeof(trace_name), "pool worker %u",
+             (unsigned int)(self - pool->workers));
+    fossil_threads_trace_set_thread_name(trace_name);
+
+    for (;;) {
+        fossil_threads_pool_task_t *task = NULL;
+
+        if (pool->scheduler != FOSSIL_THREADS_POOL_SCHED_SHARED &&
+            !fossil__atomic_load_u32(&pool->stop))
+            task = fossil__pool_find_task(self);
+
+        if (!task && (pool->idle_spin_ns || pool->idle_yield_ns))
+            task = fossil__pool_spin_for_work(self);
+
+        if (!task) {
+            int stopping = 0;
+            task = fossil__pool_wait_for_work(pool, &stopping);
+            if (stopping) break;
+        }
+
+        if (task) {
+            if (pool->grow_latency_ns) fossil__pool_note_take(self, task);
+            fossil__pool_run_task(pool, task);
+        }
+    }
+
+    fossil__pool_cache_flush(self);
+    /* No longer a worker: a destructor's submits go through the queues. */
+    fossil__tls_worker = NULL;
+    fossil__tls_exiting = self;
+    if (self->local && pool->local_destructor) pool->local_destructor(self->local);
+    self->local = NULL;
+    fossil__arena_release(&self->arena);
+    return NULL;
+}
+
+/* ================================================================
+ * Pool Create
+ * ================================================================ */
+
+/* Give every worker its CPUs and pool node. Pool nodes are the topology
+ * nodes that host at least one worker, numbered in topology order; the
+ * first worker placed on each node owns that node's slab segment. */
+static void fossil__pool_place_workers(fossil_threads_pool_t *pool) {
+    fossil__topo_init();
+    memset(pool->node_of_topo, 0xff, sizeof(pool->node_of_topo));
+    pool->node_count = 0;
+    for (size_t i = 0; i < pool->num_threads; ++i) {
+        fossil__pool_worker_t *w = &pool->workers[i];
+        size_t topo;
+        if (pool->placement == FOSSIL_THREADS_POOL_PLACE_CORE) {
+            w->pin_first = i % fossil__topo.cpu_count;
+            w->pin_count = 1;
+            topo = fossil__topo.node_of[fossil__topo.cpus[w->pin_first]];
+        } else {
+            topo = i % fossil__topo.node_count;
+            w->pin_first = fossil__topo.node_first[topo];
+            w->pin_count = fossil__topo.node_first[topo + 1] - w->pin_first;
+        }
+        if (pool->node_of_topo[topo] == 0xff) {
+            pool->node_of_topo[topo] = (unsigned char)pool->node_count++;
+            w->owns_segment = 1;
+        }
+        w->node = pool->node_of_topo[topo];
+    }
+}
+void fossil_threads_pool_options_init(fossil_threads_pool_options_t *opts) {
+    if (!opts) return;
+    memset(opts, 0, sizeof(*opts));
+    opts->num_threads = 1;
+    opts->scheduler = FOSSIL_THREADS_POOL_SCHED_SHARED;
+    opts->deque_capacity = FOSSIL__POOL_DEFAULT_DEQUE_CAPACITY;
+    opts->task_slab_size = FOSSIL__POOL_DEFAULT_TASK_SLAB;
+    opts->queue_capacity = FOSSIL__POOL_DEFAULT_QUEUE_CAPACITY;
+    opts->full_policy = FOSSIL_THREADS_POOL_FULL_BLOCK;
+    opts->future_slab_size = FOSSIL__POOL_DEFAULT_FUTURE_SLAB;
+    opts->placement = FOSSIL_THREADS_POOL_PLACE_NONE;
+    opts->stats = 0;
+    opts->min_threads = 0;
+    opts->max_threads = 0;
+    opts->keep_alive_ms = FOSSIL__POOL_DEFAULT_KEEP_ALIVE_MS;
+    opts->grow_latency_us = FOSSIL__POOL_DEFAULT_GROW_LATENCY_US;
+    opts->aging_limit = FOSSIL__POOL_DEFAULT_AGING_LIMIT;
+    opts->local_destructor = NULL;
+    opts->arena_size = FOSSIL__POOL_DEFAULT_ARENA_SIZE;
+    opts->arena_huge_pages = 0;
+    opts->idle_spin_us = 0;
+    opts->idle_yield_us = 0;
+    opts->idle_spinners = 0;
+}
+
+static void *fossil__future_run(void *arg);
+static void fossil__future_cancel(fossil_threads_pool_future_t *f);
+static void fossil__future_slab_unref(fossil_threads_pool_t *pool);
+
+/* Drop a task left queued at shutdown. Drain tasks only release
+ * internal bookkeeping, so they are run rather than leaked; a future's
+ * task completes it as cancelled so waiters and continuations see it. */
+static void fossil__pool_discard_task(fossil_threads_pool_task_t *task) {
+    if (task->flags & FOSSIL__TASK_HEAP)
         free(task);
+    else if (task->flags & FOSSIL__TASK_DRAIN)
+        task->func(task->arg);
+    else if (task->func == fossil__future_run)
+        fossil__future_cancel((fossil_threads_pool_future_t*)task->arg);
+}
+
+static void fossil__pool_free(fossil_threads_pool_t *pool) {
+    fossil_threads_pool_task_t *task;
+    for (size_t i = 0; i < FOSSIL_THREADS_POOL_PRIORITY_COUNT; ++i) {
+        task = pool->lists[i].head;
+        while (task) {
+            fossil_threads_pool_task_t *next = task->next;
+            fossil__pool_discard_task(task);
+            task = next;
+        }
+    }
+    for (size_t i = 0; i < pool->deadlines_count; ++i)
+        fossil__pool_discard_task(pool->deadlines[i]);
+    free(pool->deadlines);
+
+    if (pool->workers) {
+        for (size_t i = 0; i < pool->num_threads; ++i) {
+            fossil__pool_deque_t *dq = &pool->workers[i].deque;
+            if (!dq->slots) continue;
+            for (long long j = dq->top; j < dq->bottom; ++j) {
+                task = (fossil_threads_pool_task_t*)dq->slots[j & dq->mask];
+                fossil__pool_discard_task(task);
+            }
+            free((void*)dq->slots);
+        }
+        fossil__aligned_free(pool->workers);
+    }
+
+    if (pool->ring.cells) {
+        while ((task = fossil__ring_pop(&pool->ring)) != NULL)
+            fossil__pool_discard_task(task);
+        fossil__aligned_free(pool->ring.cells);
+    }
+
+#if defined(_WIN32)
+    DeleteCriticalSection(&pool->tasks_mutex);
+#else
+    pthread_mutex_destroy(&pool->tasks_mutex);
+#endif
+    fossil__pool_pages_free(pool->slab, pool->slab_size * sizeof(*pool->slab));
+    fossil__aligned_free(pool->nodes);
+    /* Future handles still out keep the slab and this block alive. */
+    fossil__future_slab_unref(pool);
+}
+
+fossil_threads_pool_t* fossil_threads_pool_create_ex(const fossil_threads_pool_options_t *opts) {
+    if (!opts || opts->num_threads == 0) return NULL;
+    if (opts->scheduler != FOSSIL_THREADS_POOL_SCHED_SHARED &&
+        opts->scheduler != FOSSIL_THREADS_POOL_SCHED_WORK_STEALING &&
+        opts->scheduler != FOSSIL_THREADS_POOL_SCHED_BOUNDED)
+        return NULL;
+    if (opts->full_policy != FOSSIL_THREADS_POOL_FULL_BLOCK &&
+        opts->full_policy != FOSSIL_THREADS_POOL_FULL_FAIL &&
+        opts->full_policy != FOSSIL_THREADS_POOL_FULL_RUN_CALLER)
+        return NULL;
+    if (opts->placement != FOSSIL_THREADS_POOL_PLACE_NONE &&
+        opts->placement != FOSSIL_THREADS_POOL_PLACE_CORE &&
+        opts->placement != FOSSIL_THREADS_POOL_PLACE_NODE)
+        return NULL;
+    if (opts->task_slab_size > 0xffffffffu) return NULL;
+    if (opts->future_slab_size > 0xffffffffu) return NULL;
+
+    size_t min_threads = opts->min_threads ? opts->min_threads : opts->num_threads;
+    size_t num_threads = opts->max_threads ? opts->max_threads : opts->num_threads;
+    if (min_threads > opts->num_threads || opts->num_threads > num_threads) return NULL;
+    fossil_threads_pool_t *pool = (fossil_threads_pool_t*)calloc(1, sizeof(*pool));
+    if (!pool) return NULL;
+    pool->futures_live = 1;
+
+#if defined(_WIN32)
+    InitializeCriticalSection(&pool->tasks_mutex);
+#else
+    if (pthread_mutex_init(&pool->tasks_mutex, NULL) != 0) {
+        free(pool);
+        return NULL;
+    }
+#endif
+
+    pool->num_threads = num_threads;
+    pool->scheduler = opts->scheduler;
+    pool->full_policy = opts->full_policy;
+    pool->workers = (fossil__pool_worker_t*)fossil__aligned_alloc(
+        FOSSIL__CACHE_LINE, num_threads * sizeof(fossil__pool_worker_t));
+    if (!pool->workers) {
+        pool->num_threads = 0;
+        fossil__pool_free(pool);
+        return NULL;
+    }
+    memset(pool->workers, 0, num_threads * sizeof(fossil__pool_worker_t));
+
+    pool->placement = opts->placement;
+    pool->stats = opts->stats ? 1 : 0;
+    pool->created_ns = fossil__monotonic_ns();
+    pool->aging_limit = opts->aging_limit;
+    pool->local_destructor = opts->local_destructor;
+    pool->arena_size = opts->arena_size ? opts->arena_size : FOSSIL__POOL_DEFAULT_ARENA_SIZE;
+    pool->arena_huge_pages = opts->arena_huge_pages;
+    pool->idle_spin_ns = (long long)opts->idle_spin_us * 1000LL;
+    pool->idle_yield_ns = (long long)opts->idle_yield_us * 1000LL;
+    pool->spin_max = opts->idle_spinners ? opts->idle_spinners
+                                         : (unsigned int)((num_threads + 1) / 2);
+    pool->min_threads = min_threads;
+    pool->elastic = min_threads < num_threads;
+    if (pool->elastic) {
+        pool->keep_alive_ns = (long long)opts->keep_alive_ms * 1000000LL;
+        pool->grow_latency_ns = (long long)opts->grow_latency_us * 1000LL;
+        pool->progress_ns = pool->created_ns;
+    }
+    pool->node_count = 1;
+    if (pool->placement != FOSSIL_THREADS_POOL_PLACE_NONE)
+        fossil__pool_place_workers(pool);
+    pool->nodes = (fossil__pool_node_t*)fossil__aligned_alloc(
+        FOSSIL__CACHE_LINE, pool->node_count * sizeof(fossil__pool_node_t));
+    if (!pool->nodes) {
+        fossil__pool_free(pool);
+        return NULL;
+    }
+    memset(pool->nodes, 0, pool->node_count * sizeof(fossil__pool_node_t));
+
+    if (opts->task_slab_size) {
+        /* Round segments to whole pages so no page is shared by two nodes. */
+        size_t per_node = (opts->task_slab_size + pool->node_count - 1) / pool->node_count;
+        if (pool->node_count > 1 && FOSSIL__POOL_PAGE_SIZE % sizeof(*pool->slab) == 0) {
+            size_t per_page = FOSSIL__POOL_PAGE_SIZE / sizeof(*pool->slab);
+            per_node = (per_node + per_page - 1) / per_page * per_page;
+        }
+        if (per_node * pool->node_count > 0xffffffffu) {
+            fossil__pool_free(pool);
+            return NULL;
+        }
+        pool->slab = (fossil_threads_pool_task_t*)fossil__pool_pages_alloc(
+            per_node * pool->node_count * sizeof(*pool->slab));
+        if (!pool->slab) {
+            fossil__pool_free(pool);
+            return NULL;
+        }
+        pool->slab_size = per_node * pool->node_count;
+        pool->slab_per_node = per_node;
+        /* Placed workers link their own node's segment once pinned. */
+        if (pool->placement == FOSSIL_THREADS_POOL_PLACE_NONE)
+            fossil__slab_link_segment(pool, 0);
+    }
+
+    if (opts->future_slab_size) {
+        pool->futures = (fossil_threads_pool_future_t*)calloc(opts->future_slab_size,
+                                                              sizeof(*pool->futures));
+        if (!pool->futures) {
+            fossil__pool_free(pool);
+            return NULL;
+        }
+        pool->futures_size = opts->future_slab_size;
+        for (size_t i = 0; i + 1 < pool->futures_size; ++i)
+            pool->futures[i].next = &pool->futures[i + 1];
+        pool->futures_free = 1;
+    }
+
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_BOUNDED &&
+        fossil__ring_init(&pool->ring, opts->queue_capacity ? opts->queue_capacity
+                                       : FOSSIL__POOL_DEFAULT_QUEUE_CAPACITY) != FOSSIL_THREADS_OK) {
+        fossil__pool_free(pool);
+        return NULL;
+    }
+
+    size_t capacity = opts->deque_capacity ? opts->deque_capacity
+                                           : FOSSIL__POOL_DEFAULT_DEQUE_CAPACITY;
+    for (size_t i = 0; i < num_threads; ++i) {
+        fossil__pool_worker_t *w = &pool->workers[i];
+        w->pool = pool;
+        w->index = i;
+        w->rng = (unsigned int)(i * 2654435761u) | 1u;
+        fossil_threads_thread_init(&w->thread);
+        if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_WORK_STEALING &&
+            fossil__deque_init(&w->deque, capacity) != FOSSIL_THREADS_OK) {
+            fossil__pool_free(pool);
+            return NULL;
+        }
+    }
+
+    fossil__pool_lock(pool);
+    int rc = fossil__pool_spawn(pool, opts->num_threads);
+    fossil__pool_unlock(pool);
+    if (rc != FOSSIL_THREADS_OK) {
+        fossil_threads_pool_destroy(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+fossil_threads_pool_t* fossil_threads_pool_create(size_t num_threads) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = num_threads;
+    return fossil_threads_pool_create_ex(&opts);
+}
+
+/* ================================================================
+ * Pool Destroy
+ * ================================================================ */
+void fossil_threads_pool_destroy(fossil_threads_pool_t *pool) {
+    if (!pool) return;
+
+    fossil__pool_lock(pool);
+    fossil__atomic_store_u32(&pool->stop, 1);
+    fossil__pool_wake_all(pool);
+    /* A spawn (a worker growing the pool) joining retired slots outside
+     * the lock owns them until it takes the lock back. */
+    while (pool->joining) {
+        fossil__pool_unlock(pool);
+        fossil_threads_thread_yield();
+        fossil__pool_lock(pool);
+    }
+    fossil__pool_unlock(pool);
+
+    /* Release producers blocked on a full bounded ring. */
+    fossil__atomic_add_u32(&pool->space_seq, 1);
+    fossil__futex_wake_all(&pool->space_seq);
+
+    /* Join live and retired workers (empty slots are skipped by join) */
+    for (size_t i = 0; i < pool->num_threads; ++i)
+        fossil_threads_thread_join(&pool->workers[i].thread, NULL);
+
+    /* Free queued tasks and pool storage */
+    fossil__pool_free(pool);
+}
+
+/* ================================================================
+ * Submit a task to the pool
+ * ================================================================ */
+
+/* Wake one parked worker per new task, but only if a worker announced it
+ * is going to sleep and no spinner is left to take the task; pairs with
+ * the spinners decrement and sleepers increment in the idle paths so no
+ * lock-free push goes unnoticed. */
+static void fossil__pool_notify(fossil_threads_pool_t *pool, size_t count) {
+    fossil__atomic_fence();
+    if (fossil__atomic_load_u32(&pool->sleepers) > 0 &&
+        fossil__atomic_load_u32(&pool->spinners) < count) {
+        fossil__pool_lock(pool);
+        fossil__pool_wake_n(pool, count);
+        fossil__pool_unlock(pool);
+    }
+}
+
+/* Push onto the calling worker's own deque; 0 if it is full. */
+static int fossil__pool_submit_local(fossil__pool_worker_t *self, fossil_threads_pool_task_t *task) {
+    fossil_threads_pool_t *pool = self->pool;
+    if (!fossil__deque_push(&self->deque, task)) return 0;
+    if (pool->stats) fossil__stat_max(&self->stats.deque_high_water, fossil__deque_size(&self->deque));
+    fossil__pool_notify(pool, 1);
+    return 1;
+}
+
+/* Record the ring occupancy after a push. dequeue_pos is read first and
+ * both only grow, so the difference never underflows. */
+static void fossil__pool_note_ring(fossil_threads_pool_t *pool) {
+    size_t head = fossil__atomic_load_relaxed_size(&pool->ring.dequeue_pos);
+    size_t tail = fossil__atomic_load_relaxed_size(&pool->ring.enqueue_pos);
+    fossil__pool_note_depth(pool, tail - head);
+}
+
+/* Release nodes that were counted as pending but never queued. */
+static void fossil__pool_discard_chain(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task,
+                                       size_t count) {
+    for (size_t i = 0; i < count && task; ++i) {
+        fossil_threads_pool_task_t *next = task->next;
+        fossil__pool_task_release(pool, task);
         task = next;
     }
+    fossil__pool_tasks_done(pool, count);
+}
+
+/* Bounded scheduler: place one pending node in the ring, applying the
+ * full policy. Does not wake workers; the caller notifies. */
+static int fossil__pool_ring_insert(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    if (fossil__ring_push(&pool->ring, task)) return FOSSIL_THREADS_OK;
+
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    int policy = pool->full_policy;
+    /* A worker blocking on its own pool could stall every worker. */
+    if (policy == FOSSIL_THREADS_POOL_FULL_BLOCK && self && self->pool == pool)
+        policy = FOSSIL_THREADS_POOL_FULL_RUN_CALLER;
+
+    if (policy == FOSSIL_THREADS_POOL_FULL_FAIL) {
+        fossil__pool_discard_chain(pool, task, 1);
+        return FOSSIL_THREADS_EBUSY;
+    }
+    if (policy == FOSSIL_THREADS_POOL_FULL_RUN_CALLER) {
+        fossil__pool_run_task(pool, task);
+        return FOSSIL_THREADS_OK;
+    }
+
+    /* Block: announce, then retry; pairs with fossil__pool_ring_take(). */
+    int pushed = 0;
+    fossil__atomic_add_u32(&pool->full_waiters, 1);
+    fossil__atomic_fence();
+    for (;;) {
+        unsigned int seq = fossil__atomic_load_u32(&pool->space_seq);
+        if (fossil__atomic_load_u32(&pool->stop)) break;
+        if (fossil__ring_push(&pool->ring, task)) {
+            pushed = 1;
+            break;
+        }
+        fossil__futex_wait(&pool->space_seq, seq, FOSSIL__FUTEX_INFINITE);
+    }
+    fossil__atomic_add_u32(&pool->full_waiters, (unsigned int)-1);
+    if (!pushed) {
+        fossil__pool_discard_chain(pool, task, 1);
+        return FOSSIL_THREADS_ECANCELLED;
+    }
+    return FOSSIL_THREADS_OK;
+}
+
+/* Queue an initialized node; on failure the node is released. The task
+ * is counted as pending before it becomes visible to workers so that
+ * fossil_threads_pool_wait() can never observe it finished but uncounted. */
+static int fossil__pool_enqueue(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task) {
+    if (pool->grow_latency_ns) fossil__pool_note_submit(pool, task, 1);
+    fossil__atomic_add_size(&pool->pending, 1);
+
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_BOUNDED) {
+        if (fossil__atomic_load_u32(&pool->stop)) {
+            fossil__pool_discard_chain(pool, task, 1);
+            return FOSSIL_THREADS_ECANCELLED;
+        }
+        int rc = fossil__pool_ring_insert(pool, task);
+        if (rc == FOSSIL_THREADS_OK) {
+            if (pool->stats) fossil__pool_note_ring(pool);
+            fossil__pool_notify(pool, 1);
+        }
+        return rc;
+    }
 
-#if defined(_WIN32)
-    CloseHandle(pool->tasks_mutex);
-    CloseHandle(pool->tasks_cond);
-#else
-    pthread_mutex_destroy(&pool->tasks_mutex);
-    pthread_cond_destroy(&pool->tasks_cond);
-#endif
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_WORK_STEALING &&
+        self && self->pool == pool && !fossil__atomic_load_u32(&pool->stop) &&
+        fossil__pool_submit_local(self, task))
+        return FOSSIL_THREADS_OK;
 
-    free(pool->threads);
-    free(pool);
+    fossil__pool_lock(pool);
+    if (pool->stop) {
+        fossil__pool_unlock(pool);
+        fossil__pool_discard_chain(pool, task, 1);
+        return FOSSIL_THREADS_ECANCELLED;
+    }
+    fossil__pool_queue_push(pool, task);
+    fossil__pool_wake_n(pool, 1);
+    fossil__pool_unlock(pool);
+
+    return FOSSIL_THREADS_OK;
 }
 
-/* ================================================================
- * Submit a task to the pool
- * ================================================================ */
 int fossil_threads_pool_submit(
     fossil_threads_pool_t *pool,
     fossil_threads_thread_func func,
@@ -734,84 +2934,857 @@ int fossil_threads_pool_submit(
     if (!pool || !func)
         return FOSSIL_THREADS_EINVAL;
 
-    fossil_threads_pool_task_t *task = (fossil_threads_pool_task_t*)malloc(sizeof(*task));
+    fossil_threads_pool_task_t *task = fossil__pool_task_alloc(pool);
     if (!task)
         return FOSSIL_THREADS_ENOMEM;
 
     task->func = func;
     task->arg = arg;
     task->next = NULL;
+    return fossil__pool_enqueue(pool, task);
+}
 
-#if defined(_WIN32)
-    WaitForSingleObject(pool->tasks_mutex, INFINITE);
+int fossil_threads_pool_submit_task(
+    fossil_threads_pool_t *pool,
+    fossil_threads_pool_task_t *task,
+    fossil_threads_thread_func func,
+    void *arg
+) {
+    if (!pool || !task || !func)
+        return FOSSIL_THREADS_EINVAL;
+
+    task->func = func;
+    task->arg = arg;
+    task->next = NULL;
+    task->flags = FOSSIL__TASK_INTRUSIVE;
+    return fossil__pool_enqueue(pool, task);
+}
+
+/* Queue an initialized node on a shared queue level other than plain
+ * NORMAL; on failure the node is released. */
+static int fossil__pool_enqueue_level(fossil_threads_pool_t *pool, fossil_threads_pool_task_t *task,
+                                      size_t level) {
+    if (pool->grow_latency_ns) fossil__pool_note_submit(pool, task, 1);
+    fossil__atomic_add_size(&pool->pending, 1);
+
+    int rc = FOSSIL_THREADS_OK;
+    fossil__pool_lock(pool);
     if (pool->stop) {
-        ReleaseMutex(pool->tasks_mutex);
-        free(task);
-        return FOSSIL_THREADS_ECANCELLED;
+        rc = FOSSIL_THREADS_ECANCELLED;
+    } else if (level == FOSSIL__POOL_LEVEL_DEADLINE) {
+        if (!fossil__pool_queue_push_deadline(pool, task)) rc = FOSSIL_THREADS_ENOMEM;
+    } else {
+        task->next = NULL;
+        fossil__pool_queue_push_class(pool, (int)level - 1, task, task, 1);
     }
-    if (pool->tasks_tail)
-        pool->tasks_tail->next = task;
-    else
-        pool->tasks_head = task;
-    pool->tasks_tail = task;
-    pool->tasks_count++;
-    SetEvent(pool->tasks_cond);
-    ReleaseMutex(pool->tasks_mutex);
-#else
-    pthread_mutex_lock(&pool->tasks_mutex);
+    if (rc == FOSSIL_THREADS_OK)
+        fossil__pool_wake_n(pool, 1);
+    fossil__pool_unlock(pool);
+
+    if (rc != FOSSIL_THREADS_OK) fossil__pool_discard_chain(pool, task, 1);
+    return rc;
+}
+
+int fossil_threads_pool_submit_priority(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    int priority
+) {
+    if (!pool || !func || priority < 0 || priority >= FOSSIL_THREADS_POOL_PRIORITY_COUNT)
+        return FOSSIL_THREADS_EINVAL;
+
+    fossil_threads_pool_task_t *task = fossil__pool_task_alloc(pool);
+    if (!task)
+        return FOSSIL_THREADS_ENOMEM;
+
+    task->func = func;
+    task->arg = arg;
+    task->next = NULL;
+    if (priority == FOSSIL_THREADS_POOL_PRIORITY_NORMAL)
+        return fossil__pool_enqueue(pool, task);
+    return fossil__pool_enqueue_level(pool, task, 1 + (size_t)priority);
+}
+
+int fossil_threads_pool_submit_deadline(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    long long deadline_ns
+) {
+    if (!pool || !func)
+        return FOSSIL_THREADS_EINVAL;
+
+    fossil_threads_pool_task_t *task = fossil__pool_task_alloc(pool);
+    if (!task)
+        return FOSSIL_THREADS_ENOMEM;
+
+    task->func = func;
+    task->arg = arg;
+    task->next = NULL;
+    task->deadline_ns = deadline_ns;
+    return fossil__pool_enqueue_level(pool, task, FOSSIL__POOL_LEVEL_DEADLINE);
+}
+
+/*
+** Queue a linked chain of count initialized nodes as one unit. On failure
+** part of the chain may already be queued (or, under RUN_CALLER, run) and
+** will still execute; *placed, if given, receives how many nodes that is,
+** so that callers whose nodes share a reference count release only the
+** rest. The leftover nodes are released.
+*/
+static int fossil__pool_enqueue_chain(fossil_threads_pool_t *pool,
+                                      fossil_threads_pool_task_t *first,
+                                      fossil_threads_pool_task_t *last,
+                                      size_t count,
+                                      size_t *placed) {
+    size_t unused = 0;
+    if (!placed) placed = &unused;
+    *placed = 0;
+    if (pool->grow_latency_ns) fossil__pool_note_submit(pool, first, count);
+    fossil__atomic_add_size(&pool->pending, count);
+
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_BOUNDED) {
+        if (fossil__atomic_load_u32(&pool->stop)) {
+            fossil__pool_discard_chain(pool, first, count);
+            return FOSSIL_THREADS_ECANCELLED;
+        }
+        if (fossil__ring_push_chain(&pool->ring, first, count)) {
+            *placed = count;
+            if (pool->stats) fossil__pool_note_ring(pool);
+            fossil__pool_notify(pool, count);
+            return FOSSIL_THREADS_OK;
+        }
+        /* Not enough room for the whole batch. FAIL keeps the batch
+         * all-or-nothing; other policies apply per task. */
+        if (pool->full_policy == FOSSIL_THREADS_POOL_FULL_FAIL) {
+            fossil__pool_discard_chain(pool, first, count);
+            return FOSSIL_THREADS_EBUSY;
+        }
+        size_t queued = 0;
+        fossil_threads_pool_task_t *task = first;
+        for (size_t i = 0; i < count; ++i) {
+            fossil_threads_pool_task_t *next = task->next;
+            if (fossil__ring_push(&pool->ring, task)) {
+                ++queued;
+                ++*placed;
+                task = next;
+                continue;
+            }
+            /* Ring full: workers must see what is queued before we block. */
+            if (queued) fossil__pool_notify(pool, queued);
+            queued = 0;
+            int rc = fossil__pool_ring_insert(pool, task);
+            if (rc != FOSSIL_THREADS_OK) {
+                /* Only shutdown gets here: drop what is left. */
+                fossil__pool_discard_chain(pool, next, count - i - 1);
+                return rc;
+            }
+            ++queued;
+            ++*placed;
+            task = next;
+        }
+        if (pool->stats) fossil__pool_note_ring(pool);
+        fossil__pool_notify(pool, queued);
+        return FOSSIL_THREADS_OK;
+    }
+
+    size_t remaining = count;
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (pool->scheduler == FOSSIL_THREADS_POOL_SCHED_WORK_STEALING &&
+        self && self->pool == pool && !fossil__atomic_load_u32(&pool->stop)) {
+        while (remaining > 0) {
+            fossil_threads_pool_task_t *next = first->next;
+            if (!fossil__deque_push(&self->deque, first)) break;
+            first = next;
+            --remaining;
+            ++*placed;
+        }
+        if (pool->stats && remaining < count)
+            fossil__stat_max(&self->stats.deque_high_water, fossil__deque_size(&self->deque));
+        if (remaining == 0) {
+            fossil__pool_notify(pool, count);
+            return FOSSIL_THREADS_OK;
+        }
+        /* Deque overflow: the remainder goes to the shared list below. */
+    }
+
+    fossil__pool_lock(pool);
     if (pool->stop) {
-        pthread_mutex_unlock(&pool->tasks_mutex);
-        free(task);
+        fossil__pool_unlock(pool);
+        /* Nodes already on the deque stay there, counted in *placed,
+         * and are discarded (drain nodes: run) with it. */
+        fossil__pool_discard_chain(pool, first, remaining);
         return FOSSIL_THREADS_ECANCELLED;
     }
-    if (pool->tasks_tail)
-        pool->tasks_tail->next = task;
-    else
-        pool->tasks_head = task;
-    pool->tasks_tail = task;
-    pool->tasks_count++;
-    pthread_cond_signal(&pool->tasks_cond);
-    pthread_mutex_unlock(&pool->tasks_mutex);
-#endif
+    fossil__pool_queue_push_chain(pool, first, last, remaining);
+    *placed = count;
+    fossil__pool_wake_n(pool, count);
+    fossil__pool_unlock(pool);
+    return FOSSIL_THREADS_OK;
+}
+
+int fossil_threads_pool_submit_batch(
+    fossil_threads_pool_t *pool,
+    const fossil_threads_thread_func *funcs,
+    void *const *args,
+    size_t count
+) {
+    if (!pool || (!funcs && count))
+        return FOSSIL_THREADS_EINVAL;
+    if (count == 0)
+        return FOSSIL_THREADS_OK;
+    for (size_t i = 0; i < count; ++i) {
+        if (!funcs[i]) return FOSSIL_THREADS_EINVAL;
+    }
+
+    /* Allocate every node up front so the batch is never half submitted
+     * for lack of memory. */
+    fossil_threads_pool_task_t *first = NULL;
+    fossil_threads_pool_task_t *last = NULL;
+    for (size_t i = 0; i < count; ++i) {
+        fossil_threads_pool_task_t *task = fossil__pool_task_alloc(pool);
+        if (!task) {
+            while (first) {
+                fossil_threads_pool_task_t *next = first->next;
+                fossil__pool_task_release(pool, first);
+                first = next;
+            }
+            return FOSSIL_THREADS_ENOMEM;
+        }
+        task->func = funcs[i];
+        task->arg = args ? args[i] : NULL;
+        task->next = NULL;
+        if (last)
+            last->next = task;
+        else
+            first = task;
+        last = task;
+    }
+    return fossil__pool_enqueue_chain(pool, first, last, count, NULL);
+}
+
+/* ================================================================
+ * Futures
+ *
+ * Future states come from a per-pool array managed exactly like the task
+ * slab (tagged index free list, heap fallback when exhausted), so a
+ * steady stream of futures never touches the allocator. Completion is a
+ * single state word that waiters park on; continuations registered with
+ * fossil_threads_pool_future_then() hang off a lock-free list that the
+ * completing task closes and drains.
+ * ================================================================ */
+static long long fossil__future_link(const fossil_threads_pool_t *pool,
+                                     const fossil_threads_pool_future_t *f) {
+    return f ? (long long)(f - pool->futures) + 1 : 0;
+}
+
+static fossil_threads_pool_future_t *fossil__future_alloc(fossil_threads_pool_t *pool) {
+    fossil_threads_pool_future_t *f = NULL;
+    long long head = fossil__atomic_load_i64(&pool->futures_free);
+    for (;;) {
+        long long idx = head & 0xffffffffLL;
+        if (idx == 0) break;
+        fossil_threads_pool_future_t *node = &pool->futures[idx - 1];
+        fossil_threads_pool_future_t *next = (fossil_threads_pool_future_t*)
+            fossil__atomic_load_ptr((void *const volatile *)&node->next);
+        long long tag = (long long)((unsigned long long)head >> 32) + 1;
+        long long desired = (long long)(((unsigned long long)tag << 32) |
+                                        (unsigned long long)fossil__future_link(pool, next));
+        if (fossil__atomic_cas_i64(&pool->futures_free, &head, desired)) {
+            f = node;
+            break;
+        }
+    }
+
+    unsigned int flags = FOSSIL__TASK_SLAB;
+    if (f) {
+        fossil__atomic_add_size(&pool->futures_live, 1);
+    } else {
+        f = (fossil_threads_pool_future_t*)malloc(sizeof(*f));
+        if (!f) return NULL;
+        flags = FOSSIL__TASK_HEAP;
+    }
+    memset(f, 0, sizeof(*f));
+    f->pool = pool;
+    f->flags = flags;
+    f->refs = 2; /* caller handle + pending execution */
+    return f;
+}
+
+static void fossil__future_put(fossil_threads_pool_future_t *f) {
+    if (fossil__atomic_add_u32(&f->refs, (unsigned int)-1) != 1) return;
+    if (f->flags & FOSSIL__TASK_HEAP) {
+        free(f);
+        return;
+    }
+    fossil_threads_pool_t *pool = f->pool;
+    long long head = fossil__atomic_load_i64(&pool->futures_free);
+    for (;;) {
+        long long idx = head & 0xffffffffLL;
+        fossil__atomic_store_ptr((void *volatile *)&f->next,
+                                 idx ? (void*)&pool->futures[idx - 1] : NULL);
+        long long tag = (long long)((unsigned long long)head >> 32) + 1;
+        long long desired = (long long)(((unsigned long long)tag << 32) |
+                                        (unsigned long long)fossil__future_link(pool, f));
+        if (fossil__atomic_cas_i64(&pool->futures_free, &head, desired))
+            break;
+    }
+    fossil__future_slab_unref(pool);
+}
+
+/* Drop one slab reference; the last one, after destroy, frees the rest. */
+static void fossil__future_slab_unref(fossil_threads_pool_t *pool) {
+    if (fossil__atomic_add_size(&pool->futures_live, (size_t)-1) != 1) return;
+    free(pool->futures);
+    free(pool);
+}
+
+static void fossil__future_dispatch(fossil_threads_pool_future_t *f);
+
+/* Publish the outcome, wake waiters, then release dependents. */
+static void fossil__future_complete(fossil_threads_pool_future_t *f, unsigned int state, void *result) {
+    f->result = result;
+    fossil__atomic_store_u32(&f->state, state);
+    fossil__atomic_fence();
+    if (fossil__atomic_load_u32(&f->waiters) > 0)
+        fossil__futex_wake_all(&f->state);
+
+    fossil_threads_pool_future_t *child = (fossil_threads_pool_future_t*)
+        fossil__atomic_exchange_ptr(&f->continuations, FOSSIL__FUTURE_CLOSED);
+    while (child) {
+        fossil_threads_pool_future_t *next = child->next;
+        fossil__future_dispatch(child);
+        child = next;
+    }
+    fossil__future_put(f); /* execution reference */
+}
+
+static void *fossil__future_run(void *arg) {
+    fossil_threads_pool_future_t *f = (fossil_threads_pool_future_t*)arg;
+    void *result;
+    if (f->then_func) {
+        fossil_threads_pool_future_t *parent = f->parent;
+        result = f->then_func(f->then_ctx, parent->result);
+        f->parent = NULL;
+        fossil__future_put(parent);
+    } else {
+        result = f->func(f->arg);
+    }
+    fossil__future_complete(f, FOSSIL__FUTURE_DONE, result);
+    return NULL;
+}
+
+/* Queue a continuation whose parent has completed. A cancelled parent
+ * cancels the chain; a full bounded queue runs it inline. */
+static void fossil__future_dispatch(fossil_threads_pool_future_t *f) {
+    fossil_threads_pool_future_t *parent = f->parent;
+    int rc = FOSSIL_THREADS_ECANCELLED;
+
+    if (fossil__atomic_load_u32(&parent->state) == FOSSIL__FUTURE_DONE) {
+        f->task.func = fossil__future_run;
+        f->task.arg = f;
+        f->task.next = NULL;
+        f->task.flags = FOSSIL__TASK_INTRUSIVE;
+        rc = fossil__pool_enqueue(f->pool, &f->task);
+        if (rc == FOSSIL_THREADS_OK) return;
+        if (rc == FOSSIL_THREADS_EBUSY) {
+            fossil__future_run(f);
+            return;
+        }
+    }
+    f->parent = NULL;
+    fossil__future_put(parent);
+    fossil__future_complete(f, FOSSIL__FUTURE_CANCELLED, NULL);
+}
+
+/* A future's task discarded at shutdown: cancel it and, through the
+ * stopped pool refusing them, every continuation hanging off it. */
+static void fossil__future_cancel(fossil_threads_pool_future_t *f) {
+    if (f->parent) {
+        fossil__future_put(f->parent);
+        f->parent = NULL;
+    }
+    fossil__future_complete(f, FOSSIL__FUTURE_CANCELLED, NULL);
+}
+
+int fossil_threads_pool_submit_future(
+    fossil_threads_pool_t *pool,
+    fossil_threads_thread_func func,
+    void *arg,
+    fossil_threads_pool_future_t **out
+) {
+    if (!pool || !func || !out)
+        return FOSSIL_THREADS_EINVAL;
+    *out = NULL;
+
+    fossil_threads_pool_future_t *f = fossil__future_alloc(pool);
+    if (!f)
+        return FOSSIL_THREADS_ENOMEM;
+    f->func = func;
+    f->arg = arg;
+
+    int rc = fossil_threads_pool_submit_task(pool, &f->task, fossil__future_run, f);
+    if (rc != FOSSIL_THREADS_OK) {
+        f->refs = 1;
+        fossil__future_put(f);
+        return rc;
+    }
+    *out = f;
+    return FOSSIL_THREADS_OK;
+}
+
+int fossil_threads_pool_future_then(
+    fossil_threads_pool_future_t *future,
+    fossil_threads_pool_then_func func,
+    void *ctx,
+    fossil_threads_pool_future_t **out
+) {
+    if (!future || !func || !out)
+        return FOSSIL_THREADS_EINVAL;
+    *out = NULL;
+
+    fossil_threads_pool_future_t *f = fossil__future_alloc(future->pool);
+    if (!f)
+        return FOSSIL_THREADS_ENOMEM;
+    f->then_func = func;
+    f->then_ctx = ctx;
+    f->parent = future;
+    fossil__atomic_add_u32(&future->refs, 1); /* dropped once f has consumed it */
+
+    /* Hand the returned reference out first: dispatch may complete f. */
+    *out = f;
+    void *head = fossil__atomic_load_ptr(&future->continuations);
+    for (;;) {
+        if (head == FOSSIL__FUTURE_CLOSED) {
+            fossil__future_dispatch(f);
+            break;
+        }
+        f->next = (fossil_threads_pool_future_t*)head;
+        if (fossil__atomic_cas_ptr(&future->continuations, &head, f))
+            break;
+    }
+    return FOSSIL_THREADS_OK;
+}
 
+static int fossil__future_outcome(const fossil_threads_pool_future_t *f, unsigned int state, void **result) {
+    if (state == FOSSIL__FUTURE_CANCELLED) {
+        if (result) *result = NULL;
+        return FOSSIL_THREADS_ECANCELLED;
+    }
+    if (result) *result = f->result;
     return FOSSIL_THREADS_OK;
 }
 
+int fossil_threads_pool_future_wait(fossil_threads_pool_future_t *future, void **result) {
+    if (!future)
+        return FOSSIL_THREADS_EINVAL;
+
+    unsigned int state = fossil__atomic_load_u32(&future->state);
+    if (state != FOSSIL__FUTURE_PENDING)
+        return fossil__future_outcome(future, state, result);
+
+    /* A fiber gives its worker back rather than holding it while it waits. */
+    if (fossil__fiber_active())
+        return fossil_threads_fiber_await(future, result);
+
+    /* A worker of the same pool keeps executing queued tasks while it
+     * waits, so a dependency queued behind it cannot deadlock the pool. */
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    int helping = self && self->pool == future->pool;
+
+    /* Register before re-checking; pairs with the fence in fossil__future_complete(). */
+    fossil__atomic_add_u32(&future->waiters, 1);
+    for (;;) {
+        state = fossil__atomic_load_u32(&future->state);
+        if (state != FOSSIL__FUTURE_PENDING) break;
+        if (helping) {
+            if (fossil__pool_help(self)) continue;
+            fossil__futex_wait(&future->state, FOSSIL__FUTURE_PENDING, 1000000LL);
+        } else {
+            fossil__futex_wait(&future->state, FOSSIL__FUTURE_PENDING, FOSSIL__FUTEX_INFINITE);
+        }
+    }
+    fossil__atomic_add_u32(&future->waiters, (unsigned int)-1);
+    return fossil__future_outcome(future, state, result);
+}
+
+int fossil_threads_pool_future_try_get(const fossil_threads_pool_future_t *future, void **result) {
+    if (!future)
+        return FOSSIL_THREADS_EINVAL;
+    unsigned int state = fossil__atomic_load_u32(&future->state);
+    if (state == FOSSIL__FUTURE_PENDING)
+        return FOSSIL_THREADS_EBUSY;
+    return fossil__future_outcome(future, state, result);
+}
+
+void fossil_threads_pool_future_release(fossil_threads_pool_future_t *future) {
+    if (future) fossil__future_put(future);
+}
+
 /* ================================================================
- * Wait for all queued tasks to complete
+ * Wait for all submitted tasks to complete
  * ================================================================ */
 int fossil_threads_pool_wait(fossil_threads_pool_t *pool) {
     if (!pool)
         return FOSSIL_THREADS_EINVAL;
 
-    for (;;) {
-        int done = 0;
-#if defined(_WIN32)
-        WaitForSingleObject(pool->tasks_mutex, INFINITE);
-        done = (pool->tasks_count == 0);
-        ReleaseMutex(pool->tasks_mutex);
-#else
-        pthread_mutex_lock(&pool->tasks_mutex);
-        done = (pool->tasks_count == 0);
-        pthread_mutex_unlock(&pool->tasks_mutex);
-#endif
-        if (done) break;
+    /* A task waiting for its own pool would count itself as pending. */
+    if (fossil__tls_worker && fossil__tls_worker->pool == pool)
+        return FOSSIL_THREADS_EDEADLK;
 
-#if defined(_WIN32)
-        Sleep(1);
-#else
-        struct timespec ts = {0, 1000000L};
-        nanosleep(&ts, NULL);
-#endif
+    if (fossil__atomic_load_size(&pool->pending) == 0)
+        return FOSSIL_THREADS_OK;
+
+    /* Register before sampling: pairs with the pending decrement and
+     * idle_seq bump in fossil__pool_task_done(), so either the completer
+     * sees a waiter to wake or we see pending already at zero. */
+    fossil__atomic_add_u32(&pool->idle_waiters, 1);
+    for (;;) {
+        unsigned int seq = fossil__atomic_load_u32(&pool->idle_seq);
+        if (fossil__atomic_load_size(&pool->pending) == 0) break;
+        fossil__futex_wait(&pool->idle_seq, seq, FOSSIL__FUTEX_INFINITE);
     }
+    fossil__atomic_add_u32(&pool->idle_waiters, (unsigned int)-1);
 
     return FOSSIL_THREADS_OK;
 }
 
+size_t fossil_threads_pool_pending(const fossil_threads_pool_t *pool) {
+    if (!pool) return 0;
+    return fossil__atomic_load_size(&pool->pending);
+}
+
 /* ================================================================
  * Get pool size
  * ================================================================ */
 size_t fossil_threads_pool_size(const fossil_threads_pool_t *pool) {
     if (!pool) return 0;
-    return pool->num_threads;
+    return fossil__atomic_load_size(&pool->active);
+}
+
+int fossil_threads_pool_resize(fossil_threads_pool_t *pool, size_t num_threads) {
+    if (!pool || num_threads == 0 || num_threads > pool->num_threads)
+        return FOSSIL_THREADS_EINVAL;
+
+    int rc = FOSSIL_THREADS_OK;
+    fossil__pool_lock(pool);
+    if (pool->stop) {
+        rc = FOSSIL_THREADS_ECANCELLED;
+    } else {
+        if (num_threads < pool->min_threads) pool->min_threads = num_threads;
+        pool->target = num_threads;
+        if (pool->active < num_threads)
+            rc = fossil__pool_spawn(pool, num_threads);
+        else if (pool->active > num_threads)
+            fossil__pool_wake_all(pool);  /* parked surplus retires now */
+    }
+    fossil__pool_unlock(pool);
+    return rc;
+}
+
+int fossil_threads_pool_scheduler(const fossil_threads_pool_t *pool) {
+    if (!pool) return FOSSIL_THREADS_EINVAL;
+    return pool->scheduler;
+}
+
+/* ================================================================
+ * Statistics snapshot
+ * ================================================================ */
+int fossil_threads_pool_stats(
+    const fossil_threads_pool_t *pool,
+    fossil_threads_pool_stats_t *stats,
+    fossil_threads_pool_worker_stats_t *workers,
+    size_t max_workers
+) {
+    if (!pool || !stats || (!workers && max_workers))
+        return FOSSIL_THREADS_EINVAL;
+
+    memset(stats, 0, sizeof(*stats));
+    stats->enabled = pool->stats;
+    stats->num_workers = pool->num_threads;
+    stats->active_workers = fossil__atomic_load_size(&pool->active);
+    stats->pending = fossil__atomic_load_size(&pool->pending);
+    stats->queue_high_water = fossil__atomic_load_relaxed_size(&pool->queue_high_water);
+    stats->uptime_ns = (unsigned long long)(fossil__monotonic_ns() - pool->created_ns);
+
+    fossil_threads_pool_worker_stats_t *total = &stats->total;
+    for (size_t i = 0; i < pool->num_threads; ++i) {
+        const fossil__pool_stats_t *st = &pool->workers[i].stats;
+        fossil_threads_pool_worker_stats_t w;
+        w.tasks_executed = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->tasks);
+        w.steals = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->steals);
+        w.wakeups = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->wakeups);
+        w.spin_hits = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->spin_hits);
+        w.busy_ns = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->busy_ns);
+        w.idle_ns = (unsigned long long)fossil__atomic_load_relaxed_i64(&st->idle_ns);
+        w.deque_high_water = (size_t)fossil__atomic_load_relaxed_i64(&st->deque_high_water);
+        if (i < max_workers) workers[i] = w;
+
+        total->tasks_executed += w.tasks_executed;
+        total->steals += w.steals;
+        total->wakeups += w.wakeups;
+        total->spin_hits += w.spin_hits;
+        total->busy_ns += w.busy_ns;
+        total->idle_ns += w.idle_ns;
+        if (w.deque_high_water > total->deque_high_water)
+            total->deque_high_water = w.deque_high_water;
+    }
+    return FOSSIL_THREADS_OK;
+}
+
+/* ================================================================
+ * Worker-local storage
+ * ================================================================ */
+void **fossil_threads_pool_worker_local(void) {
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    return self ? &self->local : NULL;
+}
+
+void *fossil_threads_pool_task_alloc_aligned(size_t size, size_t alignment) {
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (!self || alignment == 0 || (alignment & (alignment - 1)) != 0) return NULL;
+    if (size == 0) size = 1;
+    if (size > (size_t)-1 / 2 - alignment) return NULL;
+    return fossil__arena_alloc(&self->arena, self->pool, size, alignment);
+}
+
+void *fossil_threads_pool_task_alloc(size_t size) {
+    return fossil_threads_pool_task_alloc_aligned(size, FOSSIL__ARENA_ALIGN);
+}
+
+void fossil_threads_pool_task_reset(void) {
+    fossil__pool_worker_t *self = fossil__tls_worker;
+    if (self) fossil__arena_rewind(&self->arena, self->arena.task);
+}
+
+/* ================================================================
+ * Parallel loops
+ *
+ * One call shares a claim counter between the calling thread and up to
+ * num_threads helper tasks submitted as a single batch. Chunks are
+ * guided: each claim takes max(grain, remaining / (2 * participants))
+ * indices, so early chunks are large and the tail splits finely for load
+ * balance. The caller always participates, so the loop makes progress
+ * even when every worker is busy; it returns once every claimed chunk has
+ * finished, without waiting for helpers that never started. The shared
+ * state is reference counted for those late helpers, which are drain
+ * tasks so that a pool destroyed before they run still frees it.
+ * ================================================================ */
+
+struct fossil__parallel;
+
+/* Helper task slot: queued through its embedded node. */
+typedef struct fossil__parallel_slot {
+    fossil_threads_pool_task_t task;
+    struct fossil__parallel *call;
+    size_t index;                         /* partial buffer index */
+} fossil__parallel_slot_t;
+
+typedef struct fossil__parallel {
+    volatile size_t next;                 /* next unclaimed index */
+    char pad0[FOSSIL__CACHE_LINE - sizeof(size_t)];
+    volatile size_t remaining;            /* indices not yet processed */
+    char pad1[FOSSIL__CACHE_LINE - sizeof(size_t)];
+    volatile unsigned int done;           /* futex word: set when remaining hits 0 */
+    volatile unsigned int waiting;        /* caller is parked on done */
+    volatile unsigned int refs;           /* caller + outstanding helpers */
+    size_t end;
+    size_t grain;
+    size_t participants;
+    fossil_threads_range_func body;       /* parallel_for */
+    fossil_threads_reduce_func reduce;    /* parallel_reduce */
+    void *ctx;
+    const void *identity;
+    size_t size;                          /* bytes per partial result */
+    size_t stride;                        /* partial buffer stride (cache-line rounded) */
+    unsigned char *partials;              /* participants * stride bytes */
+    unsigned char *used;                  /* partial buffer touched */
+    fossil__parallel_slot_t *slots;       /* participants - 1 helpers */
+} fossil__parallel_t;
+
+static void fossil__parallel_put(fossil__parallel_t *call) {
+    if (fossil__atomic_add_u32(&call->refs, (unsigned int)-1) == 1)
+        fossil__aligned_free(call);
+}
+
+/* Claim and run chunks until the range is exhausted. */
+static void fossil__parallel_run(fossil__parallel_t *call, size_t index) {
+    void *partial = call->partials ? call->partials + index * call->stride : NULL;
+    size_t pos = fossil__atomic_load_relaxed_size(&call->next);
+
+    for (;;) {
+        if (pos >= call->end) break;
+        size_t left = call->end - pos;
+        size_t chunk = left / (2 * call->participants);
+        if (chunk < call->grain) chunk = call->grain;
+        if (chunk > left) chunk = left;
+        if (!fossil__atomic_cas_size(&call->next, &pos, pos + chunk)) continue;
+
+        if (call->reduce) {
+            if (!call->used[index]) {
+                memcpy(partial, call->identity, call->size);
+                call->used[index] = 1;
+            }
+            call->reduce(pos, pos + chunk, partial, call->ctx);
+        } else {
+            call->body(pos, pos + chunk, call->ctx);
+        }
+
+        if (fossil__atomic_sub_size(&call->remaining, chunk) == chunk) {
+            fossil__atomic_store_u32(&call->done, 1);
+            fossil__atomic_fence();
+            if (fossil__atomic_load_u32(&call->waiting))
+                fossil__futex_wake_all(&call->done);
+            break;
+        }
+        pos += chunk;
+    }
+}
+
+static void *fossil__parallel_helper(void *arg) {
+    fossil__parallel_slot_t *slot = (fossil__parallel_slot_t*)arg;
+    fossil__parallel_t *call = slot->call;
+    fossil__parallel_run(call, slot->index);
+    fossil__parallel_put(call);
+    return NULL;
+}
+
+static int fossil__parallel_invoke(fossil_threads_pool_t *pool, size_t begin, size_t end, size_t grain,
+                                   fossil_threads_range_func body, fossil_threads_reduce_func reduce,
+                                   fossil_threads_combine_func combine, void *result,
+                                   const void *identity, size_t size, void *ctx) {
+    if (grain == 0) grain = 1;
+    size_t count = end - begin;
+    size_t chunks = count / grain + (count % grain != 0);
+    size_t participants = fossil__atomic_load_size(&pool->active) + 1;
+    if (participants > chunks) participants = chunks;
+
+    /* A single chunk is not worth a round trip through the pool. */
+    if (participants <= 1) {
+        if (!reduce) {
+            body(begin, end, ctx);
+            return FOSSIL_THREADS_OK;
+        }
+        memcpy(result, identity, size);
+        reduce(begin, end, result, ctx);
+        return FOSSIL_THREADS_OK;
+    }
+
+    size_t helpers = participants - 1;
+    size_t stride = reduce ? (size + FOSSIL__CACHE_LINE - 1) / FOSSIL__CACHE_LINE * FOSSIL__CACHE_LINE : 0;
+    size_t head = (sizeof(fossil__parallel_t) + FOSSIL__CACHE_LINE - 1) / FOSSIL__CACHE_LINE * FOSSIL__CACHE_LINE;
+    size_t slots_bytes = helpers * sizeof(fossil__parallel_slot_t);
+    size_t total = head + participants * stride + slots_bytes + (reduce ? participants : 0);
+
+    /* One allocation per call holds the shared state, the helper nodes
+     * and the cache-line separated partial results. */
+    fossil__parallel_t *call = (fossil__parallel_t*)fossil__aligned_alloc(FOSSIL__CACHE_LINE, total);
+    if (!call) return FOSSIL_THREADS_ENOMEM;
+    memset(call, 0, sizeof(*call));
+    unsigned char *base = (unsigned char*)call;
+    call->next = begin;
+    call->remaining = count;
+    call->refs = (unsigned int)participants;
+    call->end = end;
+    call->grain = grain;
+    call->participants = participants;
+    call->body = body;
+    call->reduce = reduce;
+    call->ctx = ctx;
+    call->identity = identity;
+    call->size = size;
+    call->stride = stride;
+    call->partials = reduce ? base + head : NULL;
+    call->slots = (fossil__parallel_slot_t*)(base + head + participants * stride);
+    call->used = reduce ? (unsigned char*)(call->slots + helpers) : NULL;
+    if (call->used) memset(call->used, 0, participants);
+
+    fossil_threads_pool_task_t *first = NULL;
+    fossil_threads_pool_task_t *last = NULL;
+    for (size_t i = 0; i < helpers; ++i) {
+        fossil__parallel_slot_t *slot = &call->slots[i];
+        slot->call = call;
+        slot->index = i + 1;
+        slot->task.func = fossil__parallel_helper;
+        slot->task.arg = slot;
+        slot->task.next = NULL;
+        slot->task.flags = FOSSIL__TASK_INTRUSIVE | FOSSIL__TASK_DRAIN;
+        if (last)
+            last->next = &slot->task;
+        else
+            first = &slot->task;
+        last = &slot->task;
+    }
+    size_t placed = 0;
+    if (fossil__pool_enqueue_chain(pool, first, last, helpers, &placed) != FOSSIL_THREADS_OK) {
+        /* Too few helpers (full bounded queue, shutdown): the caller does
+         * the rest. Queued helpers still run, even when the pool is freed
+         * first (drain nodes), and drop their own references. */
+        fossil__atomic_add_u32(&call->refs, (unsigned int)(0u - (unsigned int)(helpers - placed)));
+    }
+
+    fossil__parallel_run(call, 0);
+
+    if (!fossil__atomic_load_u32(&call->done)) {
+        fossil__pool_worker_t *self = fossil__tls_worker;
+        int helping = self && self->pool == pool;
+        fossil__atomic_store_u32(&call->waiting, 1);
+        fossil__atomic_fence();
+        while (!fossil__atomic_load_u32(&call->done)) {
+            if (helping) {
+                if (fossil__pool_help(self)) continue;
+                fossil__futex_wait(&call->done, 0, 1000000LL);
+            } else {
+                fossil__futex_wait(&call->done, 0, FOSSIL__FUTEX_INFINITE);
+            }
+        }
+    }
+
+    if (reduce) {
+        memcpy(result, identity, size);
+        for (size_t i = 0; i < participants; ++i) {
+            if (call->used[i])
+                combine(result, call->partials + i * stride, ctx);
+        }
+    }
+    fossil__parallel_put(call);
+    return FOSSIL_THREADS_OK;
+}
+
+int fossil_threads_parallel_for(
+    fossil_threads_pool_t *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    fossil_threads_range_func body,
+    void *ctx
+) {
+    if (!pool || !body)
+        return FOSSIL_THREADS_EINVAL;
+    if (begin >= end)
+        return FOSSIL_THREADS_OK;
+    return fossil__parallel_invoke(pool, begin, end, grain, body, NULL, NULL, NULL, NULL, 0, ctx);
+}
+
+int fossil_threads_parallel_reduce(
+    fossil_threads_pool_t *pool,
+    size_t begin,
+    size_t end,
+    size_t grain,
+    void *result,
+    const void *identity,
+    size_t size,
+    fossil_threads_reduce_func reduce,
+    fossil_threads_combine_func combine,
+    void *ctx
+) {
+    if (!pool || !result || !identity || size == 0 || !reduce || !combine)
+        return FOSSIL_THREADS_EINVAL;
+    if (begin >= end) {
+        memcpy(result, identity, size);
+        return FOSSIL_THREADS_OK;
+    }
+    return fossil__parallel_invoke(pool, begin, end, grain, NULL, reduce, combine,
+                                   result, identity, size, ctx);
 }
@@ -0,0 +1,154 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/tls.h"
+#include "fossil/threads/mutex.h"
+
+#include "internal.h"
+
+// *****************************************************************************
+// Internal structures
+// *****************************************************************************
+
+/*
+** A key is generation * FOSSIL_THREADS_TLS_KEYS_MAX + index, with the
+** generation starting at 1 so that no key is zero. Each thread keeps one
+** slot per index holding the full key it last stored under: a lookup whose
+** key differs from the slot's (an older or newer generation) reads NULL.
+*/
+typedef struct fossil__tls_slot {
+    fossil_threads_tls_key_t key;
+    void *value;
+} fossil__tls_slot;
+
+typedef struct fossil__tls_entry {
+    volatile unsigned int key;                  /* Live key on this index, 0 when free */
+    unsigned int generation;                    /* Last generation issued */
+    fossil_threads_tls_destructor destructor;
+} fossil__tls_entry;
+
+#define FOSSIL__TLS_GENERATION_MAX (0xffffffffu / FOSSIL_THREADS_TLS_KEYS_MAX - 1u)
+
+/* Registry; generation and destructor change only under the lock */
+static fossil_threads_mutex_t fossil__tls_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+static fossil__tls_entry fossil__tls_keys[FOSSIL_THREADS_TLS_KEYS_MAX];
+
+static FOSSIL__TLS fossil__tls_slot fossil__tls_values[FOSSIL_THREADS_TLS_KEYS_MAX];
+static FOSSIL__TLS unsigned int fossil__tls_used = 0u;   /* a non-NULL value was set */
+
+// *****************************************************************************
+// Keys
+// *****************************************************************************
+
+int fossil_threads_tls_key_create(fossil_threads_tls_key_t *key, fossil_threads_tls_destructor destructor) {
+    if (!key) return FOSSIL_THREADS_TLS_EINVAL;
+
+    fossil_threads_mutex_lock(&fossil__tls_lock);
+    for (unsigned int i = 0; i < FOSSIL_THREADS_TLS_KEYS_MAX; ++i) {
+        fossil__tls_entry *e = &fossil__tls_keys[i];
+        if (e->key != 0u) continue;
+        unsigned int gen = e->generation >= FOSSIL__TLS_GENERATION_MAX ? 1u : e->generation + 1u;
+        e->generation = gen;
+        e->destructor = destructor;
+        *key = gen * FOSSIL_THREADS_TLS_KEYS_MAX + i;
+        fossil__atomic_store_u32(&e->key, *key);
+        fossil_threads_mutex_unlock(&fossil__tls_lock);
+        return FOSSIL_THREADS_TLS_OK;
+    }
+    fossil_threads_mutex_unlock(&fossil__tls_lock);
+    return FOSSIL_THREADS_TLS_EAGAIN;
+}
+
+int fossil_threads_tls_key_delete(fossil_threads_tls_key_t key) {
+    if (key == 0u) return FOSSIL_THREADS_TLS_EINVAL;
+    fossil__tls_entry *e = &fossil__tls_keys[key % FOSSIL_THREADS_TLS_KEYS_MAX];
+
+    int rc = FOSSIL_THREADS_TLS_EINVAL;
+    fossil_threads_mutex_lock(&fossil__tls_lock);
+    if (e->key == key) {
+        fossil__atomic_store_u32(&e->key, 0u);
+        e->destructor = NULL;
+        rc = FOSSIL_THREADS_TLS_OK;
+    }
+    fossil_threads_mutex_unlock(&fossil__tls_lock);
+    return rc;
+}
+
+// *****************************************************************************
+// Values
+// *****************************************************************************
+
+void *fossil_threads_tls_get(fossil_threads_tls_key_t key) {
+    const fossil__tls_slot *s = &fossil__tls_values[key % FOSSIL_THREADS_TLS_KEYS_MAX];
+    return s->key == key ? s->value : NULL;
+}
+
+int fossil_threads_tls_set(fossil_threads_tls_key_t key, const void *value) {
+    if (key == 0u ||
+        fossil__atomic_load_u32(&fossil__tls_keys[key % FOSSIL_THREADS_TLS_KEYS_MAX].key) != key)
+        return FOSSIL_THREADS_TLS_EINVAL;
+    fossil__tls_slot *s = &fossil__tls_values[key % FOSSIL_THREADS_TLS_KEYS_MAX];
+    s->key = key;
+    s->value = (void *)value;
+    if (value) fossil__tls_used = 1u;
+    return FOSSIL_THREADS_TLS_OK;
+}
+
+void fossil_threads_tls_thread_exit(void) {
+    for (unsigned int pass = 0; fossil__tls_used && pass < FOSSIL_THREADS_TLS_DESTRUCTOR_ITERATIONS; ++pass) {
+        fossil_threads_tls_key_t keys[FOSSIL_THREADS_TLS_KEYS_MAX];
+        fossil_threads_tls_destructor dtors[FOSSIL_THREADS_TLS_KEYS_MAX];
+
+        fossil_threads_mutex_lock(&fossil__tls_lock);
+        for (unsigned int i = 0; i < FOSSIL_THREADS_TLS_KEYS_MAX; ++i) {
+            keys[i] = fossil__tls_keys[i].key;
+            dtors[i] = fossil__tls_keys[i].destructor;
+        }
+        fossil_threads_mutex_unlock(&fossil__tls_lock);
+
+        /* Destructors that set values again raise the flag for another pass. */
+        fossil__tls_used = 0u;
+        for (unsigned int i = 0; i < FOSSIL_THREADS_TLS_KEYS_MAX; ++i) {
+            fossil__tls_slot *s = &fossil__tls_values[i];
+            void *value = s->value;
+            if (!value) continue;
+            fossil_threads_tls_key_t key = s->key;
+            s->key = 0u;
+            s->value = NULL;
+            if (key == keys[i] && dtors[i]) dtors[i](value);
+        }
+    }
+
+    if (fossil__tls_used) {
+        for (unsigned int i = 0; i < FOSSIL_THREADS_TLS_KEYS_MAX; ++i) {
+            fossil__tls_values[i].key = 0u;
+            fossil__tls_values[i].value = NULL;
+        }
+        fossil__tls_used = 0u;
+    }
+}
+
+void fossil__tls_thread_exit(void) {
+    fossil_threads_tls_thread_exit();
+}
@@ -0,0 +1,556 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include "fossil/threads/trace.h"
+#include "fossil/threads/mutex.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internal.h"
+
+#if !defined(FOSSIL_THREADS_NO_TRACE)
+
+// *****************************************************************************
+// Internal structures
+// *****************************************************************************
+
+/*
+** Every field is written with a release store and read with atomic loads:
+** the exporter copies slots while their owner may be overwriting them and
+** throws away any whose index the owner's head has passed again since, so
+** a torn copy is never emitted (see fossil__trace_export_ring).
+*/
+typedef struct fossil__trace_event {
+    volatile long long ts;          /* Start, fossil__monotonic_ns */
+    volatile long long dur;         /* Length in ns for complete events */
+    volatile long long arg;         /* Object address or other detail */
+    void *volatile cat;             /* const char *, caller-owned */
+    void *volatile name;            /* const char *, caller-owned */
+    void *volatile label;           /* const char *, caller-owned, may be NULL */
+    volatile unsigned int phase;    /* Chrome phase letter */
+} fossil__trace_event;
+
+enum {
+    FOSSIL__TRACE_RING_OWNED   = 1, /* Recording for a live thread */
+    FOSSIL__TRACE_RING_RETIRED = 2, /* Owner exited; events not yet exported */
+    FOSSIL__TRACE_RING_FREE    = 3  /* Exported; the next new thread adopts it */
+};
+
+/*
+** One ring per recording thread. Only the owner writes events and head;
+** everything else changes under fossil__trace_lock. Rings stay on the
+** registry for the life of the process and are recycled; a free ring of
+** the wrong capacity is replaced when adopted, unless an export has it
+** pinned, in which case it is left alone.
+*/
+typedef struct fossil__trace_ring {
+    struct fossil__trace_ring *next;
+    volatile unsigned int state;
+    unsigned int tid;                           /* Thread id in exported traces */
+    char thread_name[FOSSIL_THREADS_TRACE_NAME_MAX];
+    size_t mask;                                /* Capacity - 1 */
+    volatile long long head;                    /* Events ever written */
+    long long base;                             /* First event not cleared */
+    unsigned int pins;                          /* Exports reading it unlocked */
+    fossil__trace_event events[];
+} fossil__trace_ring;
+
+#define FOSSIL__TRACE_EVENTS_MIN  64u
+#define FOSSIL__TRACE_EVENTS_MAX  ((size_t)1 << 24)
+#define FOSSIL__TRACE_CHUNK       128           /* Events copied per validation */
+#define FOSSIL__TRACE_PID         1
+
+volatile unsigned int fossil__trace_active = 0u;
+
+/* Registry, capacity, tid counter and time base change only under the lock */
+static fossil_threads_mutex_t fossil__trace_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+static fossil__trace_ring *fossil__trace_rings = NULL;
+static size_t fossil__trace_capacity = FOSSIL_THREADS_TRACE_EVENTS_DEFAULT;
+static unsigned int fossil__trace_next_tid = 0u;
+static long long fossil__trace_epoch = 0;
+static int fossil__trace_epoch_set = 0;
+
+static FOSSIL__TLS fossil__trace_ring *fossil__trace_self = NULL;
+static FOSSIL__TLS char fossil__trace_name[FOSSIL_THREADS_TRACE_NAME_MAX];
+/* Set while the thread holds the registry lock (its own lock hook must not
+ * try to attach) and for good once it exits or fails to get a ring. */
+static FOSSIL__TLS unsigned int fossil__trace_busy = 0u;
+static FOSSIL__TLS unsigned int fossil__trace_detached = 0u;
+
+// *****************************************************************************
+// Recording
+// *****************************************************************************
+
+static fossil__trace_ring *fossil__trace_ring_alloc(size_t cap) {
+    fossil__trace_ring *r = (fossil__trace_ring *)fossil__aligned_alloc(
+        FOSSIL__CACHE_LINE, sizeof(*r) + cap * sizeof(fossil__trace_event));
+    if (r) {
+        memset(r, 0, sizeof(*r) + cap * sizeof(fossil__trace_event));
+        r->mask = cap - 1;
+    }
+    return r;
+}
+
+/* Give the calling thread a ring: a free one left by an exited thread,
+ * resized to the current capacity if need be, or a new one. */
+static fossil__trace_ring *fossil__trace_attach(void) {
+    if (fossil__trace_busy || fossil__trace_detached) return NULL;
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+
+    size_t cap = fossil__trace_capacity;
+    fossil__trace_ring **link = &fossil__trace_rings;
+    while (*link && (fossil__atomic_load_u32(&(*link)->state) != FOSSIL__TRACE_RING_FREE || (*link)->pins))
+        link = &(*link)->next;
+    fossil__trace_ring *r = *link;
+    if (r && r->mask + 1 != cap) {
+        /* Keep the old ring if the new size cannot be had */
+        fossil__trace_ring *fresh = fossil__trace_ring_alloc(cap);
+        if (fresh) {
+            fresh->next = r->next;
+            *link = fresh;
+            fossil__aligned_free(r);
+            r = fresh;
+        }
+    }
+    if (r) {
+        r->base = fossil__atomic_load_relaxed_i64(&r->head);
+    } else if ((r = fossil__trace_ring_alloc(cap)) != NULL) {
+        r->next = fossil__trace_rings;
+        fossil__trace_rings = r;
+    }
+    if (r) {
+        r->tid = ++fossil__trace_next_tid;
+        memcpy(r->thread_name, fossil__trace_name, sizeof(r->thread_name));
+        fossil__atomic_store_u32(&r->state, FOSSIL__TRACE_RING_OWNED);
+    } else {
+        fossil__trace_detached = 1u;
+    }
+
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+    fossil__trace_self = r;
+    return r;
+}
+
+static void fossil__trace_record(unsigned int phase, const char *cat, const char *name,
+                                 const char *label, long long ts, long long dur,
+                                 unsigned long long arg) {
+    fossil__trace_ring *r = fossil__trace_self;
+    if (!r && !(r = fossil__trace_attach())) return;
+
+    long long h = fossil__atomic_load_relaxed_i64(&r->head);
+    fossil__trace_event *e = &r->events[(size_t)h & r->mask];
+    fossil__atomic_store_i64(&e->ts, ts);
+    fossil__atomic_store_i64(&e->dur, dur);
+    fossil__atomic_store_i64(&e->arg, (long long)arg);
+    fossil__atomic_store_ptr(&e->cat, (void *)(uintptr_t)cat);
+    fossil__atomic_store_ptr(&e->name, (void *)(uintptr_t)name);
+    fossil__atomic_store_ptr(&e->label, (void *)(uintptr_t)label);
+    fossil__atomic_store_u32(&e->phase, phase);
+    fossil__atomic_store_i64(&r->head, h + 1);
+}
+
+void fossil__trace_complete(const char *cat, const char *name, const char *label,
+                            long long start_ns, long long end_ns, unsigned long long arg) {
+    fossil__trace_record('X', cat, name, label, start_ns, end_ns - start_ns, arg);
+}
+
+void fossil__trace_thread_exit(void) {
+    fossil__trace_ring *r = fossil__trace_self;
+    fossil__trace_self = NULL;
+    fossil__trace_detached = 1u;
+    if (r) fossil__atomic_store_u32(&r->state, FOSSIL__TRACE_RING_RETIRED);
+}
+
+// *****************************************************************************
+// Control
+// *****************************************************************************
+
+int fossil_threads_trace_start(size_t events_per_thread) {
+    if (events_per_thread == 0) events_per_thread = FOSSIL_THREADS_TRACE_EVENTS_DEFAULT;
+    if (events_per_thread > FOSSIL__TRACE_EVENTS_MAX) events_per_thread = FOSSIL__TRACE_EVENTS_MAX;
+    size_t cap = FOSSIL__TRACE_EVENTS_MIN;
+    while (cap < events_per_thread) cap <<= 1;
+
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+    int rc = FOSSIL_THREADS_TRACE_OK;
+    if (fossil__atomic_load_u32(&fossil__trace_active)) {
+        rc = FOSSIL_THREADS_TRACE_EBUSY;
+    } else {
+        fossil__trace_capacity = cap;
+        if (!fossil__trace_epoch_set) {
+            fossil__trace_epoch = fossil__monotonic_ns();
+            fossil__trace_epoch_set = 1;
+        }
+        fossil__atomic_store_u32(&fossil__trace_active, 1u);
+    }
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+    return rc;
+}
+
+void fossil_threads_trace_stop(void) {
+    fossil__atomic_store_u32(&fossil__trace_active, 0u);
+}
+
+bool fossil_threads_trace_enabled(void) {
+    return fossil__trace_on() ? true : false;
+}
+
+void fossil_threads_trace_begin(const char *name) {
+    if (!fossil__trace_on()) return;
+    fossil__trace_record('B', "user", name ? name : "span", NULL, fossil__monotonic_ns(), 0, 0);
+}
+
+void fossil_threads_trace_end(void) {
+    if (!fossil__trace_on()) return;
+    fossil__trace_record('E', "user", NULL, NULL, fossil__monotonic_ns(), 0, 0);
+}
+
+void fossil_threads_trace_instant(const char *name) {
+    if (!fossil__trace_on()) return;
+    fossil__trace_record('i', "user", name ? name : "mark", NULL, fossil__monotonic_ns(), 0, 0);
+}
+
+void fossil_threads_trace_set_thread_name(const char *name) {
+    size_t n = name ? strlen(name) : 0;
+    if (n >= sizeof(fossil__trace_name)) n = sizeof(fossil__trace_name) - 1;
+    if (n) memcpy(fossil__trace_name, name, n);
+    fossil__trace_name[n] = '\0';
+
+    fossil__trace_ring *r = fossil__trace_self;
+    if (!r) return;
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+    memcpy(r->thread_name, fossil__trace_name, sizeof(r->thread_name));
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+}
+
+void fossil_threads_trace_clear(void) {
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+    for (fossil__trace_ring *r = fossil__trace_rings; r; r = r->next) {
+        r->base = fossil__atomic_load_i64(&r->head);
+        unsigned int expected = FOSSIL__TRACE_RING_RETIRED;
+        fossil__atomic_cas_u32(&r->state, &expected, FOSSIL__TRACE_RING_FREE);
+    }
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+}
+
+// *****************************************************************************
+// Export
+// *****************************************************************************
+
+/* Output is staged in a fixed buffer and handed to the writer when full. */
+typedef struct fossil__trace_out {
+    fossil_threads_trace_write_func write;
+    void *ctx;
+    int failed;
+    size_t used;
+    char buf[4096];
+} fossil__trace_out;
+
+static void fossil__trace_flush(fossil__trace_out *out) {
+    if (out->used && !out->failed && out->write(out->ctx, out->buf, out->used) != 0)
+        out->failed = 1;
+    out->used = 0;
+}
+
+static void fossil__trace_put(fossil__trace_out *out, const char *s, size_t n) {
+    while (n) {
+        if (out->used == sizeof(out->buf)) fossil__trace_flush(out);
+        size_t k = sizeof(out->buf) - out->used;
+        if (k > n) k = n;
+        memcpy(out->buf + out->used, s, k);
+        out->used += k;
+        s += k;
+        n -= k;
+    }
+}
+
+static void fossil__trace_puts(fossil__trace_out *out, const char *s) {
+    fossil__trace_put(out, s, strlen(s));
+}
+
+/* Formatted pieces are short: numbers and fixed keys only; fmt uses at
+ * most the two arguments and ignores the rest. */
+static void fossil__trace_printf(fossil__trace_out *out, const char *fmt, long long a, long long b) {
+    char tmp[64];
+    int n = snprintf(tmp, sizeof(tmp), fmt, a, b);
+    if (n > 0) fossil__trace_put(out, tmp, (size_t)n < sizeof(tmp) ? (size_t)n : sizeof(tmp) - 1);
+}
+
+/* A JSON string literal, quotes included. */
+static void fossil__trace_put_string(fossil__trace_out *out, const char *s) {
+    fossil__trace_put(out, "\"", 1);
+    for (; s && *s; ++s) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            char esc[2] = { '\\', (char)c };
+            fossil__trace_put(out, esc, 2);
+        } else if (c < 0x20) {
+            char esc[8];
+            int n = snprintf(esc, sizeof(esc), "\\u%04x", (unsigned int)c);
+            fossil__trace_put(out, esc, (size_t)n);
+        } else {
+            fossil__trace_put(out, (const char *)&c, 1);
+        }
+    }
+    fossil__trace_put(out, "\"", 1);
+}
+
+/* Nanoseconds as the microsecond decimal Chrome expects. */
+static void fossil__trace_put_us(fossil__trace_out *out, const char *key, long long ns) {
+    fossil__trace_puts(out, key);
+    if (ns < 0) {
+        fossil__trace_puts(out, "-");
+        ns = -ns;
+    }
+    fossil__trace_printf(out, "%lld.%03lld", ns / 1000, ns % 1000);
+}
+
+static void fossil__trace_put_meta(fossil__trace_out *out, int *first, unsigned int tid,
+                                   const char *what, const char *name) {
+    fossil__trace_puts(out, *first ? "\n" : ",\n");
+    *first = 0;
+    fossil__trace_puts(out, "{\"name\":");
+    fossil__trace_put_string(out, what);
+    fossil__trace_printf(out, ",\"ph\":\"M\",\"pid\":%lld,\"tid\":%lld,\"args\":{\"name\":",
+                         FOSSIL__TRACE_PID, (long long)tid);
+    fossil__trace_put_string(out, name);
+    fossil__trace_puts(out, "}}");
+}
+
+static void fossil__trace_put_event(fossil__trace_out *out, int *first, unsigned int tid,
+                                    long long epoch, const fossil__trace_event *e) {
+    fossil__trace_puts(out, *first ? "\n{" : ",\n{");
+    *first = 0;
+    if (e->name) {
+        fossil__trace_puts(out, "\"name\":");
+        fossil__trace_put_string(out, (const char *)e->name);
+        fossil__trace_puts(out, ",");
+    }
+    if (e->cat) {
+        fossil__trace_puts(out, "\"cat\":");
+        fossil__trace_put_string(out, (const char *)e->cat);
+        fossil__trace_puts(out, ",");
+    }
+    char ph[10] = "\"ph\":\"?\"";
+    ph[6] = (char)e->phase;
+    fossil__trace_puts(out, ph);
+    fossil__trace_printf(out, ",\"pid\":%lld,\"tid\":%lld", FOSSIL__TRACE_PID, (long long)tid);
+    fossil__trace_put_us(out, ",\"ts\":", e->ts - epoch);
+    if (e->phase == 'X') {
+        fossil__trace_put_us(out, ",\"dur\":", e->dur);
+        fossil__trace_printf(out, ",\"args\":{\"object\":\"0x%llx\"", e->arg, 0);
+        if (e->label) {
+            fossil__trace_puts(out, ",\"label\":");
+            fossil__trace_put_string(out, (const char *)e->label);
+        }
+        fossil__trace_puts(out, "}");
+    } else if (e->phase == 'i') {
+        fossil__trace_puts(out, ",\"s\":\"t\"");
+    }
+    fossil__trace_puts(out, "}");
+}
+
+/* What an export needs of a ring, copied under the lock; the ring itself
+ * is pinned so it is neither adopted nor replaced until the export ends. */
+typedef struct fossil__trace_snap {
+    fossil__trace_ring *ring;
+    unsigned int state;
+    unsigned int tid;
+    long long base;
+    char thread_name[FOSSIL_THREADS_TRACE_NAME_MAX];
+} fossil__trace_snap;
+
+/*
+** Copies a chunk of slots, then re-reads head: a slot whose index is at
+** least a full lap behind the new head may have been rewritten during the
+** copy and is dropped. The release stores on the owner's side make any
+** value it wrote into a slot imply the head store that preceded it.
+*/
+static void fossil__trace_export_ring(fossil__trace_out *out, int *first, long long epoch,
+                                      const fossil__trace_snap *snap) {
+    fossil__trace_ring *r = snap->ring;
+    const long long cap = (long long)r->mask + 1;
+    long long head = fossil__atomic_load_i64(&r->head);
+    long long lo = snap->base;
+    if (head - lo > cap) lo = head - cap;
+
+    fossil__trace_event chunk[FOSSIL__TRACE_CHUNK];
+    while (lo < head && !out->failed) {
+        long long n = head - lo;
+        if (n > FOSSIL__TRACE_CHUNK) n = FOSSIL__TRACE_CHUNK;
+        for (long long i = 0; i < n; ++i) {
+            fossil__trace_event *src = &r->events[(size_t)(lo + i) & r->mask];
+            fossil__trace_event *dst = &chunk[i];
+            dst->ts = fossil__atomic_load_relaxed_i64(&src->ts);
+            dst->dur = fossil__atomic_load_relaxed_i64(&src->dur);
+            dst->arg = fossil__atomic_load_relaxed_i64(&src->arg);
+            dst->cat = fossil__atomic_load_ptr(&src->cat);
+            dst->name = fossil__atomic_load_ptr(&src->name);
+            dst->label = fossil__atomic_load_ptr(&src->label);
+            dst->phase = fossil__atomic_load_relaxed_u32(&src->phase);
+        }
+        fossil__atomic_fence();
+        long long intact = fossil__atomic_load_i64(&r->head) - cap + 1;
+        for (long long i = 0; i < n; ++i) {
+            if (lo + i < intact || chunk[i].phase == 0u) continue;
+            fossil__trace_put_event(out, first, snap->tid, epoch, &chunk[i]);
+        }
+        lo += n;
+        if (lo < intact) lo = intact;
+    }
+}
+
+/*
+** The registry lock is held only to snapshot and pin the rings and, at
+** the end, to unpin them and free the retired ones that were written
+** out. Formatting and the writer run unlocked, so a writer may itself
+** take locks, trace, or start threads without stalling recording.
+*/
+int fossil_threads_trace_export(fossil_threads_trace_write_func write, void *ctx) {
+    if (!write) return FOSSIL_THREADS_TRACE_EINVAL;
+
+    fossil__trace_out *out = (fossil__trace_out *)malloc(sizeof(*out));
+    if (!out) return FOSSIL_THREADS_TRACE_EIO;
+    out->write = write;
+    out->ctx = ctx;
+    out->failed = 0;
+    out->used = 0;
+
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+    size_t count = 0;
+    for (fossil__trace_ring *r = fossil__trace_rings; r; r = r->next)
+        if (fossil__atomic_load_u32(&r->state) != FOSSIL__TRACE_RING_FREE) ++count;
+    fossil__trace_snap *snaps = (fossil__trace_snap *)malloc((count ? count : 1) * sizeof(*snaps));
+    size_t n = 0;
+    if (snaps) {
+        for (fossil__trace_ring *r = fossil__trace_rings; r; r = r->next) {
+            unsigned int state = fossil__atomic_load_u32(&r->state);
+            if (state == FOSSIL__TRACE_RING_FREE) continue;
+            fossil__trace_snap *sn = &snaps[n++];
+            sn->ring = r;
+            sn->state = state;
+            sn->tid = r->tid;
+            sn->base = r->base;
+            memcpy(sn->thread_name, r->thread_name, sizeof(sn->thread_name));
+            r->pins++;
+        }
+    }
+    long long epoch = fossil__trace_epoch;
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+    if (!snaps) {
+        free(out);
+        return FOSSIL_THREADS_TRACE_EIO;
+    }
+
+    int first = 1;
+    fossil__trace_puts(out, "{\"traceEvents\":[");
+    fossil__trace_put_meta(out, &first, 0, "process_name", "fossil-threads");
+    for (size_t i = 0; i < n; ++i) {
+        fossil__trace_snap *sn = &snaps[i];
+        if (!sn->thread_name[0])
+            snprintf(sn->thread_name, sizeof(sn->thread_name), "thread %u", sn->tid);
+        fossil__trace_put_meta(out, &first, sn->tid, "thread_name", sn->thread_name);
+        fossil__trace_export_ring(out, &first, epoch, sn);
+    }
+    fossil__trace_puts(out, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    fossil__trace_flush(out);
+    int rc = out->failed ? FOSSIL_THREADS_TRACE_EIO : FOSSIL_THREADS_TRACE_OK;
+
+    /* A ring pinned since the snapshot cannot have been re-adopted, so
+     * one still retired holds exactly the events written out above. */
+    fossil__trace_busy = 1u;
+    fossil_threads_mutex_lock(&fossil__trace_lock);
+    for (size_t i = 0; i < n; ++i) {
+        fossil__trace_ring *r = snaps[i].ring;
+        r->pins--;
+        if (snaps[i].state == FOSSIL__TRACE_RING_RETIRED && rc == FOSSIL_THREADS_TRACE_OK) {
+            unsigned int expected = FOSSIL__TRACE_RING_RETIRED;
+            fossil__atomic_cas_u32(&r->state, &expected, FOSSIL__TRACE_RING_FREE);
+        }
+    }
+    fossil_threads_mutex_unlock(&fossil__trace_lock);
+    fossil__trace_busy = 0u;
+
+    free(snaps);
+    free(out);
+    return rc;
+}
+
+#else /* FOSSIL_THREADS_NO_TRACE */
+
+int fossil_threads_trace_start(size_t events_per_thread) {
+    (void)events_per_thread;
+    return FOSSIL_THREADS_TRACE_ENOSYS;
+}
+
+void fossil_threads_trace_stop(void) {}
+
+bool fossil_threads_trace_enabled(void) { return false; }
+
+void fossil_threads_trace_begin(const char *name) { (void)name; }
+
+void fossil_threads_trace_end(void) {}
+
+void fossil_threads_trace_instant(const char *name) { (void)name; }
+
+void fossil_threads_trace_set_thread_name(const char *name) { (void)name; }
+
+void fossil_threads_trace_clear(void) {}
+
+int fossil_threads_trace_export(fossil_threads_trace_write_func write, void *ctx) {
+    (void)ctx;
+    return write ? FOSSIL_THREADS_TRACE_ENOSYS : FOSSIL_THREADS_TRACE_EINVAL;
+}
+
+#endif /* FOSSIL_THREADS_NO_TRACE */
+
+static int fossil__trace_write_file(void *ctx, const char *data, size_t len) {
+    return fwrite(data, 1, len, (FILE *)ctx) == len ? 0 : 1;
+}
+
+int fossil_threads_trace_export_file(const char *path) {
+    if (!path) return FOSSIL_THREADS_TRACE_EINVAL;
+#if defined(FOSSIL_THREADS_NO_TRACE)
+    (void)fossil__trace_write_file;
+    return FOSSIL_THREADS_TRACE_ENOSYS;
+#else
+    FILE *f = fopen(path, "wb");
+    if (!f) return FOSSIL_THREADS_TRACE_EIO;
+    int rc = fossil_threads_trace_export(fossil__trace_write_file, f);
+    if (fclose(f) != 0 && rc == FOSSIL_THREADS_TRACE_OK) rc = FOSSIL_THREADS_TRACE_EIO;
+    return rc;
+#endif
+}
@@ -0,0 +1,203 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_barrier_fixture);
+
+FOSSIL_SETUP(c_barrier_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_barrier_fixture) {
+    // Teardown the test fixture
+}
+
+#define BARRIER_THREADS 4
+#define BARRIER_PHASES  200
+
+typedef struct {
+    fossil_threads_barrier_t barrier;
+    int slots[BARRIER_THREADS];
+    int serial[BARRIER_THREADS];  /* per-thread count of SERIAL returns */
+    int mismatch[BARRIER_THREADS];
+} barrier_shared_t;
+
+typedef struct {
+    barrier_shared_t *shared;
+    int index;
+} barrier_member_t;
+
+/* Writes its slot, waits, checks every slot, waits again so nobody writes
+ * the next phase while another thread is still checking. */
+static void *barrier_member(void *arg) {
+    barrier_member_t *m = (barrier_member_t *)arg;
+    barrier_shared_t *s = m->shared;
+    for (int phase = 1; phase <= BARRIER_PHASES; ++phase) {
+        s->slots[m->index] = phase;
+        if (fossil_threads_barrier_wait(&s->barrier) == FOSSIL_THREADS_BARRIER_SERIAL)
+            s->serial[m->index]++;
+        for (int i = 0; i < BARRIER_THREADS; ++i)
+            if (s->slots[i] != phase) s->mismatch[m->index] = 1;
+        if (fossil_threads_barrier_wait(&s->barrier) == FOSSIL_THREADS_BARRIER_SERIAL)
+            s->serial[m->index]++;
+    }
+    return NULL;
+}
+
+typedef struct {
+    fossil_threads_latch_t latch;
+    int ready[BARRIER_THREADS];
+} latch_shared_t;
+
+typedef struct {
+    latch_shared_t *shared;
+    int index;
+} latch_member_t;
+
+static void *latch_member(void *arg) {
+    latch_member_t *m = (latch_member_t *)arg;
+    m->shared->ready[m->index] = 1;
+    fossil_threads_latch_count_down(&m->shared->latch, 1);
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_barrier_invalid_args) {
+    fossil_threads_barrier_t b;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_init(NULL, 2, 0), FOSSIL_THREADS_BARRIER_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_init(&b, 0, 0), FOSSIL_THREADS_BARRIER_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_wait(NULL), FOSSIL_THREADS_BARRIER_EINVAL);
+
+    /* A one-thread barrier completes every phase on its own. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_init(&b, 1, 0), FOSSIL_THREADS_BARRIER_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_wait(&b), FOSSIL_THREADS_BARRIER_SERIAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_wait(&b), FOSSIL_THREADS_BARRIER_SERIAL);
+    fossil_threads_barrier_dispose(&b);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_wait(&b), FOSSIL_THREADS_BARRIER_EINVAL);
+}
+
+FOSSIL_TEST(c_barrier_phases_stay_in_step) {
+    /* Once parking straight away, once with the spin phase. */
+    const unsigned int spins[2] = { 0u, FOSSIL_THREADS_BARRIER_SPIN_DEFAULT };
+    for (int run = 0; run < 2; ++run) {
+        barrier_shared_t s;
+        memset(&s, 0, sizeof(s));
+        ASSUME_ITS_EQUAL_I32(fossil_threads_barrier_init(&s.barrier, BARRIER_THREADS, spins[run]),
+                             FOSSIL_THREADS_BARRIER_OK);
+
+        fossil_threads_thread_t threads[BARRIER_THREADS];
+        barrier_member_t members[BARRIER_THREADS];
+        for (int i = 0; i < BARRIER_THREADS; ++i) {
+            members[i].shared = &s;
+            members[i].index = i;
+            fossil_threads_thread_init(&threads[i]);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&threads[i], barrier_member, &members[i]),
+                                 FOSSIL_THREADS_OK);
+        }
+        int serial = 0, mismatch = 0;
+        for (int i = 0; i < BARRIER_THREADS; ++i) {
+            fossil_threads_thread_join(&threads[i], NULL);
+            fossil_threads_thread_dispose(&threads[i]);
+            serial += s.serial[i];
+            mismatch |= s.mismatch[i];
+        }
+        ASSUME_ITS_FALSE(mismatch);
+        ASSUME_ITS_EQUAL_I32(serial, 2 * BARRIER_PHASES);
+        fossil_threads_barrier_dispose(&s.barrier);
+    }
+}
+
+FOSSIL_TEST(c_latch_count_down_and_try_wait) {
+    fossil_threads_latch_t l = FOSSIL_THREADS_LATCH_INITIALIZER(3);
+    ASSUME_ITS_FALSE(fossil_threads_latch_try_wait(&l));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_count_down(&l, 2), FOSSIL_THREADS_BARRIER_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_count_down(&l, 2), FOSSIL_THREADS_BARRIER_EINVAL);
+    ASSUME_ITS_FALSE(fossil_threads_latch_try_wait(&l));
+
+    long long deadline = fossil_threads_clock_monotonic_ns() + 10 * 1000000LL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_wait_until(&l, deadline), FOSSIL_THREADS_BARRIER_ETIMEDOUT);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_arrive_and_wait(&l, 1), FOSSIL_THREADS_BARRIER_OK);
+    ASSUME_ITS_TRUE(fossil_threads_latch_try_wait(&l));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_wait_until(&l, 0), FOSSIL_THREADS_BARRIER_OK);
+
+    fossil_threads_latch_t open;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_init(&open, 0, 0), FOSSIL_THREADS_BARRIER_OK);
+    ASSUME_ITS_TRUE(fossil_threads_latch_try_wait(&open));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_init(NULL, 1, 0), FOSSIL_THREADS_BARRIER_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_count_down(NULL, 1), FOSSIL_THREADS_BARRIER_EINVAL);
+}
+
+FOSSIL_TEST(c_latch_releases_waiter) {
+    latch_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_latch_init(&s.latch, BARRIER_THREADS, 0);
+
+    fossil_threads_thread_t threads[BARRIER_THREADS];
+    latch_member_t members[BARRIER_THREADS];
+    for (int i = 0; i < BARRIER_THREADS; ++i) {
+        members[i].shared = &s;
+        members[i].index = i;
+        fossil_threads_thread_init(&threads[i]);
+        fossil_threads_thread_create(&threads[i], latch_member, &members[i]);
+    }
+    fossil_threads_latch_wait(&s.latch);
+    ASSUME_ITS_TRUE(fossil_threads_latch_try_wait(&s.latch));
+    for (int i = 0; i < BARRIER_THREADS; ++i)
+        ASSUME_ITS_EQUAL_I32(s.ready[i], 1);
+
+    for (int i = 0; i < BARRIER_THREADS; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_barrier_tests) {
+    FOSSIL_ADD_TEST(c_barrier_fixture, c_barrier_invalid_args);
+    FOSSIL_ADD_TEST(c_barrier_fixture, c_barrier_phases_stay_in_step);
+    FOSSIL_ADD_TEST(c_barrier_fixture, c_latch_count_down_and_try_wait);
+    FOSSIL_ADD_TEST(c_barrier_fixture, c_latch_releases_waiter);
+
+    FOSSIL_ADD_SUITE(c_barrier_fixture);
+} // end of tests
@@ -0,0 +1,110 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_barrier_fixture);
+
+FOSSIL_SETUP(cpp_barrier_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_barrier_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Barrier;
+using fossil::threads::Latch;
+
+FOSSIL_TEST(cpp_barrier_arrive_and_wait) {
+    const int threads = 3, phases = 100;
+    Barrier barrier(threads);
+    std::atomic<int> counter{0};
+    std::atomic<int> serial{0};
+    std::atomic<bool> behind{false};
+
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&] {
+            for (int p = 1; p <= phases; ++p) {
+                counter.fetch_add(1);
+                if (barrier.arrive_and_wait()) serial.fetch_add(1);
+                if (counter.load() != p * threads) behind.store(true);
+                barrier.arrive_and_wait();
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    ASSUME_ITS_FALSE(behind.load());
+    ASSUME_ITS_EQUAL_I32(serial.load(), phases);
+    ASSUME_ITS_EQUAL_I32(counter.load(), threads * phases);
+}
+
+FOSSIL_TEST(cpp_latch_count_down_and_wait) {
+    Latch latch(2);
+    ASSUME_ITS_FALSE(latch.try_wait());
+    bool threw = false;
+    try {
+        latch.count_down(3);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+
+    std::thread worker([&] { latch.count_down(); });
+    latch.arrive_and_wait();
+    worker.join();
+    ASSUME_ITS_TRUE(latch.try_wait());
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_barrier_tests) {
+    FOSSIL_ADD_TEST(cpp_barrier_fixture, cpp_barrier_arrive_and_wait);
+    FOSSIL_ADD_TEST(cpp_barrier_fixture, cpp_latch_count_down_and_wait);
+
+    FOSSIL_ADD_SUITE(cpp_barrier_fixture);
+} // end of tests
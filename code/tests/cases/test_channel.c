@@ -0,0 +1,396 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_channel_fixture);
+
+FOSSIL_SETUP(c_channel_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_channel_fixture) {
+    // Teardown the test fixture
+}
+
+#define CHANNEL_STREAM  20000
+#define CHANNEL_WORKERS 3
+
+typedef struct {
+    fossil_threads_channel_t *ch;
+    int batched;
+    int out_of_order;  /* consumer only */
+    long long sum;     /* consumer only */
+    size_t received;   /* consumer only */
+} channel_stream_t;
+
+/* Sends 1..CHANNEL_STREAM, one at a time or in small batches. */
+static void *channel_stream_producer(void *arg) {
+    channel_stream_t *s = (channel_stream_t *)arg;
+    if (!s->batched) {
+        for (int i = 1; i <= CHANNEL_STREAM; ++i) fossil_threads_channel_send(s->ch, &i);
+    } else {
+        int buf[7];
+        int next = 1;
+        while (next <= CHANNEL_STREAM) {
+            size_t n = 0;
+            while (n < 7 && next + (int)n <= CHANNEL_STREAM) { buf[n] = next + (int)n; ++n; }
+            size_t sent = fossil_threads_channel_send_batch(s->ch, buf, n);
+            if (sent == 0) fossil_threads_channel_send(s->ch, &buf[sent++]);
+            next += (int)sent;
+        }
+    }
+    fossil_threads_channel_close(s->ch);
+    return NULL;
+}
+
+static void *channel_stream_consumer(void *arg) {
+    channel_stream_t *s = (channel_stream_t *)arg;
+    int expect = 1;
+    for (;;) {
+        int buf[5];
+        size_t n = s->batched ? fossil_threads_channel_recv_batch(s->ch, buf, 5) : 0;
+        if (n == 0) {
+            if (fossil_threads_channel_recv(s->ch, &buf[0]) != FOSSIL_THREADS_CHANNEL_OK) break;
+            n = 1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            if (buf[i] != expect++) s->out_of_order = 1;
+            s->sum += buf[i];
+            s->received++;
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    fossil_threads_channel_t *ch;
+    fossil_threads_mutex_t lock;
+    long long sum;
+    size_t received;
+} channel_mpmc_t;
+
+static void *channel_mpmc_producer(void *arg) {
+    channel_mpmc_t *m = (channel_mpmc_t *)arg;
+    for (int i = 1; i <= CHANNEL_STREAM / CHANNEL_WORKERS; ++i) fossil_threads_channel_send(m->ch, &i);
+    return NULL;
+}
+
+static void *channel_mpmc_consumer(void *arg) {
+    channel_mpmc_t *m = (channel_mpmc_t *)arg;
+    long long sum = 0;
+    size_t received = 0;
+    int v;
+    while (fossil_threads_channel_recv(m->ch, &v) == FOSSIL_THREADS_CHANNEL_OK) {
+        sum += v;
+        received++;
+    }
+    fossil_threads_mutex_lock(&m->lock);
+    m->sum += sum;
+    m->received += received;
+    fossil_threads_mutex_unlock(&m->lock);
+    return NULL;
+}
+
+typedef struct {
+    fossil_threads_latch_t done;
+    long long sum;     /* stage only; at most one drain task runs at a time */
+    int out_of_order;
+    int expect;
+} channel_stage_t;
+
+static void channel_stage_func(void *elem, void *ctx) {
+    channel_stage_t *st = (channel_stage_t *)ctx;
+    int v = *(int *)elem;
+    if (v != st->expect++) st->out_of_order = 1;
+    st->sum += v;
+    fossil_threads_latch_count_down(&st->done, 1);
+}
+
+typedef struct {
+    fossil_threads_mpsc_node_t node;
+    int producer;
+    int value;
+} channel_item_t;
+
+typedef struct {
+    fossil_threads_mpsc_t q;
+    channel_item_t items[CHANNEL_WORKERS][1000];
+} channel_mpsc_shared_t;
+
+typedef struct {
+    channel_mpsc_shared_t *shared;
+    int producer;
+} channel_mpsc_arg_t;
+
+/* Pushes its items one by one for even producers and in batches of 10 for odd. */
+static void *channel_mpsc_producer(void *arg) {
+    channel_mpsc_arg_t *a = (channel_mpsc_arg_t *)arg;
+    channel_item_t *items = a->shared->items[a->producer];
+    for (int i = 0; i < 1000; ++i) {
+        items[i].producer = a->producer;
+        items[i].value = i;
+    }
+    if (a->producer % 2 == 0) {
+        for (int i = 0; i < 1000; ++i) fossil_threads_mpsc_push(&a->shared->q, &items[i].node);
+    } else {
+        for (int i = 0; i < 1000; i += 10) {
+            fossil_threads_mpsc_node_t *batch[10];
+            for (int j = 0; j < 10; ++j) batch[j] = &items[i + j].node;
+            fossil_threads_mpsc_push_batch(&a->shared->q, batch, 10);
+        }
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_channel_create_invalid_args) {
+    fossil_threads_channel_t *ch = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(NULL, FOSSIL_THREADS_CHANNEL_SPSC, 4, 4),
+                         FOSSIL_THREADS_CHANNEL_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&ch, 7, 4, 4), FOSSIL_THREADS_CHANNEL_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&ch, FOSSIL_THREADS_CHANNEL_SPSC, 0, 4),
+                         FOSSIL_THREADS_CHANNEL_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&ch, FOSSIL_THREADS_CHANNEL_MPMC, 4, 0),
+                         FOSSIL_THREADS_CHANNEL_EINVAL);
+    ASSUME_ITS_TRUE(ch == NULL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&ch, FOSSIL_THREADS_CHANNEL_MPMC, 1, 4),
+                         FOSSIL_THREADS_CHANNEL_OK);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_capacity(ch), 2);
+    fossil_threads_channel_destroy(ch);
+    fossil_threads_channel_destroy(NULL);
+}
+
+FOSSIL_TEST(c_channel_fifo_full_empty_and_close) {
+    const int kinds[2] = { FOSSIL_THREADS_CHANNEL_SPSC, FOSSIL_THREADS_CHANNEL_MPMC };
+    for (int k = 0; k < 2; ++k) {
+        fossil_threads_channel_t *ch = NULL;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&ch, kinds[k], 5, sizeof(int)),
+                             FOSSIL_THREADS_CHANNEL_OK);
+        ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_capacity(ch), 8);
+
+        int v = 0;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_try_recv(ch, &v), FOSSIL_THREADS_CHANNEL_EAGAIN);
+        for (int i = 0; i < 8; ++i)
+            ASSUME_ITS_EQUAL_I32(fossil_threads_channel_try_send(ch, &i), FOSSIL_THREADS_CHANNEL_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_try_send(ch, &v), FOSSIL_THREADS_CHANNEL_EAGAIN);
+        ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_size(ch), 8);
+
+        /* Wrap around: drain five, refill with a batch that only partly fits. */
+        int out[8];
+        ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_recv_batch(ch, out, 5), 5);
+        for (int i = 0; i < 5; ++i) ASSUME_ITS_EQUAL_I32(out[i], i);
+        int more[6] = { 8, 9, 10, 11, 12, 13 };
+        ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_send_batch(ch, more, 6), 5);
+
+        fossil_threads_channel_close(ch);
+        ASSUME_ITS_TRUE(fossil_threads_channel_is_closed(ch));
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_try_send(ch, &v), FOSSIL_THREADS_CHANNEL_ECLOSED);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_send(ch, &v), FOSSIL_THREADS_CHANNEL_ECLOSED);
+        for (int i = 5; i < 13; ++i) {
+            ASSUME_ITS_EQUAL_I32(fossil_threads_channel_recv(ch, &v), FOSSIL_THREADS_CHANNEL_OK);
+            ASSUME_ITS_EQUAL_I32(v, i);
+        }
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_recv(ch, &v), FOSSIL_THREADS_CHANNEL_ECLOSED);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_try_recv(ch, &v), FOSSIL_THREADS_CHANNEL_ECLOSED);
+        fossil_threads_channel_destroy(ch);
+    }
+}
+
+FOSSIL_TEST(c_channel_recv_until_times_out) {
+    fossil_threads_channel_t *ch = NULL;
+    fossil_threads_channel_create(&ch, FOSSIL_THREADS_CHANNEL_SPSC, 4, sizeof(int));
+    int v = 0;
+    long long deadline = fossil_threads_clock_monotonic_ns() + 10 * 1000000LL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_recv_until(ch, &v, deadline), FOSSIL_THREADS_CHANNEL_ETIMEDOUT);
+    ASSUME_ITS_TRUE(fossil_threads_clock_monotonic_ns() >= deadline);
+    fossil_threads_channel_destroy(ch);
+}
+
+FOSSIL_TEST(c_channel_spsc_stream_in_order) {
+    for (int batched = 0; batched < 2; ++batched) {
+        channel_stream_t s;
+        memset(&s, 0, sizeof(s));
+        s.batched = batched;
+        /* Small ring so both sides block over and over. */
+        ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&s.ch, FOSSIL_THREADS_CHANNEL_SPSC, 16, sizeof(int)),
+                             FOSSIL_THREADS_CHANNEL_OK);
+        fossil_threads_thread_t prod, cons;
+        fossil_threads_thread_init(&prod);
+        fossil_threads_thread_init(&cons);
+        fossil_threads_thread_create(&cons, channel_stream_consumer, &s);
+        fossil_threads_thread_create(&prod, channel_stream_producer, &s);
+        fossil_threads_thread_join(&prod, NULL);
+        fossil_threads_thread_join(&cons, NULL);
+        fossil_threads_thread_dispose(&prod);
+        fossil_threads_thread_dispose(&cons);
+
+        ASSUME_ITS_FALSE(s.out_of_order);
+        ASSUME_ITS_EQUAL_I32((int)s.received, CHANNEL_STREAM);
+        ASSUME_ITS_TRUE(s.sum == (long long)CHANNEL_STREAM * (CHANNEL_STREAM + 1) / 2);
+        fossil_threads_channel_destroy(s.ch);
+    }
+}
+
+FOSSIL_TEST(c_channel_mpmc_delivers_every_element_once) {
+    channel_mpmc_t m;
+    memset(&m, 0, sizeof(m));
+    fossil_threads_mutex_init(&m.lock);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_create(&m.ch, FOSSIL_THREADS_CHANNEL_MPMC, 32, sizeof(int)),
+                         FOSSIL_THREADS_CHANNEL_OK);
+
+    fossil_threads_thread_t prod[CHANNEL_WORKERS], cons[CHANNEL_WORKERS];
+    for (int i = 0; i < CHANNEL_WORKERS; ++i) {
+        fossil_threads_thread_init(&prod[i]);
+        fossil_threads_thread_init(&cons[i]);
+        fossil_threads_thread_create(&cons[i], channel_mpmc_consumer, &m);
+        fossil_threads_thread_create(&prod[i], channel_mpmc_producer, &m);
+    }
+    for (int i = 0; i < CHANNEL_WORKERS; ++i) {
+        fossil_threads_thread_join(&prod[i], NULL);
+        fossil_threads_thread_dispose(&prod[i]);
+    }
+    fossil_threads_channel_close(m.ch);
+    for (int i = 0; i < CHANNEL_WORKERS; ++i) {
+        fossil_threads_thread_join(&cons[i], NULL);
+        fossil_threads_thread_dispose(&cons[i]);
+    }
+
+    const long long per = CHANNEL_STREAM / CHANNEL_WORKERS;
+    ASSUME_ITS_EQUAL_I32((int)m.received, (int)(per * CHANNEL_WORKERS));
+    ASSUME_ITS_TRUE(m.sum == CHANNEL_WORKERS * per * (per + 1) / 2);
+    fossil_threads_channel_destroy(m.ch);
+    fossil_threads_mutex_dispose(&m.lock);
+}
+
+FOSSIL_TEST(c_channel_stage_runs_on_pool) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    ASSUME_ITS_TRUE(pool != NULL);
+    fossil_threads_channel_t *ch = NULL;
+    fossil_threads_channel_create(&ch, FOSSIL_THREADS_CHANNEL_SPSC, 64, sizeof(int));
+
+    channel_stage_t st;
+    memset(&st, 0, sizeof(st));
+    st.expect = 1;
+    fossil_threads_latch_init(&st.done, 5000, 0);
+
+    /* Sent before attaching: drained as soon as the stage exists. */
+    int first = 1;
+    fossil_threads_channel_send(ch, &first);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_attach(NULL, pool, channel_stage_func, &st, 0),
+                         FOSSIL_THREADS_CHANNEL_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_attach(ch, pool, channel_stage_func, &st, 16),
+                         FOSSIL_THREADS_CHANNEL_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_channel_attach(ch, pool, channel_stage_func, &st, 16),
+                         FOSSIL_THREADS_CHANNEL_EBUSY);
+    for (int i = 2; i <= 5000; ++i) fossil_threads_channel_send(ch, &i);
+
+    long long deadline = fossil_threads_clock_monotonic_ns() + 10LL * 1000000000LL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_latch_wait_until(&st.done, deadline), FOSSIL_THREADS_BARRIER_OK);
+    fossil_threads_channel_detach(ch);
+    ASSUME_ITS_FALSE(st.out_of_order);
+    ASSUME_ITS_TRUE(st.sum == 5000LL * 5001 / 2);
+
+    /* Detached: elements stay queued. */
+    int later = 7;
+    fossil_threads_channel_send(ch, &later);
+    fossil_threads_pool_wait(pool);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_channel_size(ch), 1);
+
+    fossil_threads_channel_destroy(ch);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_channel_mpsc_queue) {
+    static channel_mpsc_shared_t shared;
+    fossil_threads_mpsc_init(&shared.q);
+    ASSUME_ITS_TRUE(fossil_threads_mpsc_empty(&shared.q));
+    ASSUME_ITS_TRUE(fossil_threads_mpsc_pop(&shared.q) == NULL);
+    long long deadline = fossil_threads_clock_monotonic_ns() + 5 * 1000000LL;
+    ASSUME_ITS_TRUE(fossil_threads_mpsc_pop_wait(&shared.q, deadline) == NULL);
+
+    fossil_threads_thread_t threads[CHANNEL_WORKERS];
+    channel_mpsc_arg_t args[CHANNEL_WORKERS];
+    for (int i = 0; i < CHANNEL_WORKERS; ++i) {
+        args[i].shared = &shared;
+        args[i].producer = i;
+        fossil_threads_thread_init(&threads[i]);
+        fossil_threads_thread_create(&threads[i], channel_mpsc_producer, &args[i]);
+    }
+
+    /* Per-producer order must survive; interleaving between producers is free. */
+    int next[CHANNEL_WORKERS] = { 0 };
+    int out_of_order = 0;
+    for (int got = 0; got < CHANNEL_WORKERS * 1000;) {
+        fossil_threads_mpsc_node_t *batch[8];
+        size_t n = fossil_threads_mpsc_pop_batch(&shared.q, batch, 8);
+        if (n == 0) {
+            batch[0] = fossil_threads_mpsc_pop_wait(&shared.q, -1);
+            n = 1;
+        }
+        for (size_t i = 0; i < n; ++i) {
+            channel_item_t *item = (channel_item_t *)(void *)batch[i];
+            if (item->value != next[item->producer]++) out_of_order = 1;
+        }
+        got += (int)n;
+    }
+    for (int i = 0; i < CHANNEL_WORKERS; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+    ASSUME_ITS_FALSE(out_of_order);
+    ASSUME_ITS_TRUE(fossil_threads_mpsc_empty(&shared.q));
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_channel_tests) {
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_create_invalid_args);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_fifo_full_empty_and_close);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_recv_until_times_out);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_spsc_stream_in_order);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_mpmc_delivers_every_element_once);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_stage_runs_on_pool);
+    FOSSIL_ADD_TEST(c_channel_fixture, c_channel_mpsc_queue);
+
+    FOSSIL_ADD_SUITE(c_channel_fixture);
+} // end of tests
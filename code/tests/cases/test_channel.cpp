@@ -0,0 +1,120 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <thread>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_channel_fixture);
+
+FOSSIL_SETUP(cpp_channel_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_channel_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Channel;
+
+namespace {
+    struct Sample {
+        int id;
+        double weight;
+    };
+}
+
+FOSSIL_TEST(cpp_channel_try_send_recv) {
+    Channel<Sample> ch(3);
+    ASSUME_ITS_EQUAL_I32((int)ch.capacity(), 4);
+    ASSUME_ITS_FALSE(ch.try_recv().has_value());
+    for (int i = 0; i < 4; ++i)
+        ASSUME_ITS_EQUAL_I32(ch.try_send(Sample{i, i * 0.5}), FOSSIL_THREADS_CHANNEL_OK);
+    ASSUME_ITS_EQUAL_I32(ch.try_send(Sample{9, 0.0}), FOSSIL_THREADS_CHANNEL_EAGAIN);
+
+    auto first = ch.try_recv();
+    ASSUME_ITS_TRUE(first.has_value());
+    ASSUME_ITS_EQUAL_I32(first->id, 0);
+
+    ch.close();
+    ASSUME_ITS_TRUE(ch.is_closed());
+    ASSUME_ITS_FALSE(ch.send(Sample{10, 0.0}));
+    Sample rest[4];
+    ASSUME_ITS_EQUAL_I32((int)ch.recv_batch(rest, 4), 3);
+    ASSUME_ITS_EQUAL_I32(rest[2].id, 3);
+    ASSUME_ITS_FALSE(ch.recv().has_value());
+}
+
+FOSSIL_TEST(cpp_channel_pipeline_two_stages) {
+    const int count = 5000;
+    Channel<int> raw(16, FOSSIL_THREADS_CHANNEL_SPSC);
+    Channel<long long> squared(16);
+
+    std::thread source([&] {
+        for (int i = 1; i <= count; ++i) raw.send(i);
+        raw.close();
+    });
+    std::thread mapper([&] {
+        while (auto v = raw.recv()) squared.send((long long)*v * *v);
+        squared.close();
+    });
+
+    long long total = 0;
+    int received = 0;
+    while (auto v = squared.recv()) {
+        total += *v;
+        ++received;
+    }
+    source.join();
+    mapper.join();
+
+    ASSUME_ITS_EQUAL_I32(received, count);
+    ASSUME_ITS_TRUE(total == (long long)count * (count + 1) * (2LL * count + 1) / 6);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_channel_tests) {
+    FOSSIL_ADD_TEST(cpp_channel_fixture, cpp_channel_try_send_recv);
+    FOSSIL_ADD_TEST(cpp_channel_fixture, cpp_channel_pipeline_two_stages);
+
+    FOSSIL_ADD_SUITE(cpp_channel_fixture);
+} // end of tests
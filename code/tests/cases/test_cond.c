@@ -35,6 +35,70 @@
 
 FOSSIL_SUITE(c_cond_fixture);
 
+typedef struct {
+    fossil_threads_mutex_t mutex;
+    fossil_threads_cond_t cond;
+    int ready;
+} cond_flag_t;
+
+static void *cond_flag_setter(void *arg) {
+    cond_flag_t *f = (cond_flag_t *)arg;
+    fossil_threads_mutex_lock(&f->mutex);
+    f->ready = 1;
+    fossil_threads_cond_signal(&f->cond);
+    fossil_threads_mutex_unlock(&f->mutex);
+    return NULL;
+}
+
+#define COND_BROADCAST_WAITERS 4
+
+typedef struct {
+    fossil_threads_mutex_t mutex;
+    fossil_threads_cond_t cond;
+    int go;
+    int woken;
+} cond_gate_t;
+
+static void *cond_gate_waiter(void *arg) {
+    cond_gate_t *g = (cond_gate_t *)arg;
+    fossil_threads_mutex_lock(&g->mutex);
+    while (!g->go) fossil_threads_cond_wait(&g->cond, &g->mutex);
+    g->woken++;
+    fossil_threads_mutex_unlock(&g->mutex);
+    return NULL;
+}
+
+/* Parks COND_BROADCAST_WAITERS threads, releases them with one broadcast. */
+static int cond_run_broadcast(int kind) {
+    cond_gate_t g;
+    fossil_threads_thread_t threads[COND_BROADCAST_WAITERS];
+    memset(&g, 0, sizeof(g));
+    fossil_threads_mutex_init_ex(&g.mutex, kind);
+    fossil_threads_cond_init(&g.cond);
+
+    for (int i = 0; i < COND_BROADCAST_WAITERS; ++i) {
+        fossil_threads_thread_init(&threads[i]);
+        fossil_threads_thread_create(&threads[i], cond_gate_waiter, &g);
+    }
+    while (fossil_threads_cond_waiter_count(&g.cond) < COND_BROADCAST_WAITERS)
+        fossil_threads_thread_yield();
+
+    fossil_threads_mutex_lock(&g.mutex);
+    g.go = 1;
+    fossil_threads_cond_broadcast(&g.cond);
+    fossil_threads_mutex_unlock(&g.mutex);
+
+    for (int i = 0; i < COND_BROADCAST_WAITERS; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+    int woken = g.woken == COND_BROADCAST_WAITERS &&
+                fossil_threads_cond_waiter_count(&g.cond) == 0;
+    fossil_threads_cond_dispose(&g.cond);
+    fossil_threads_mutex_dispose(&g.mutex);
+    return woken;
+}
+
 FOSSIL_SETUP(c_cond_fixture) {
     // Setup the test fixture
 }
@@ -155,6 +219,110 @@ FOSSIL_TEST(c_cond_waiter_count_increments_and_decrements) {
     fossil_threads_mutex_dispose(&mutex);
 }
 
+FOSSIL_TEST(c_cond_adaptive_mutex_wait_and_timeout) {
+    cond_flag_t f;
+    fossil_threads_thread_t thread;
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&f.mutex, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_init(&f.cond), FOSSIL_THREADS_COND_OK);
+    f.ready = 0;
+
+    fossil_threads_mutex_lock(&f.mutex);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_timedwait(&f.cond, &f.mutex, 10), FOSSIL_THREADS_COND_ETIMEDOUT);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_locked(&f.mutex));
+
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&thread, cond_flag_setter, &f), FOSSIL_THREADS_OK);
+    while (!f.ready) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_cond_wait(&f.cond, &f.mutex), FOSSIL_THREADS_COND_OK);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_waiter_count(&f.cond), 0);
+    fossil_threads_mutex_unlock(&f.mutex);
+
+    fossil_threads_thread_join(&thread, NULL);
+    fossil_threads_thread_dispose(&thread);
+    fossil_threads_cond_dispose(&f.cond);
+    fossil_threads_mutex_dispose(&f.mutex);
+}
+
+FOSSIL_TEST(c_cond_inline_storage_timedwait) {
+    fossil_threads_cond_t cond;
+    fossil_threads_mutex_t mutex;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init(&mutex), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_init(&cond), FOSSIL_THREADS_COND_OK);
+    ASSUME_ITS_TRUE(cond.handle == NULL);
+
+    fossil_threads_mutex_lock(&mutex);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_timedwait(&cond, &mutex, 5), FOSSIL_THREADS_COND_ETIMEDOUT);
+    fossil_threads_mutex_unlock(&mutex);
+
+    fossil_threads_cond_dispose(&cond);
+    fossil_threads_mutex_dispose(&mutex);
+}
+
+FOSSIL_TEST(c_cond_static_initializer) {
+    static fossil_threads_mutex_t mutex = FOSSIL_THREADS_MUTEX_INITIALIZER;
+    static fossil_threads_cond_t cond = FOSSIL_THREADS_COND_INITIALIZER;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_is_valid(&cond), 1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_waiter_count(&cond), 0);
+
+    fossil_threads_mutex_lock(&mutex);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_timedwait(&cond, &mutex, 5), FOSSIL_THREADS_COND_ETIMEDOUT);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_waiter_count(&cond), 0);
+    fossil_threads_mutex_unlock(&mutex);
+}
+
+FOSSIL_TEST(c_cond_signal_without_waiters) {
+    fossil_threads_cond_t cond;
+    fossil_threads_cond_init(&cond);
+    for (int i = 0; i < 1000; ++i) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_cond_signal(&cond), FOSSIL_THREADS_COND_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_cond_broadcast(&cond), FOSSIL_THREADS_COND_OK);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_waiter_count(&cond), 0);
+    fossil_threads_cond_dispose(&cond);
+}
+
+FOSSIL_TEST(c_cond_broadcast_wakes_all_normal) {
+    ASSUME_ITS_TRUE(cond_run_broadcast(FOSSIL_THREADS_MUTEX_KIND_NORMAL));
+}
+
+FOSSIL_TEST(c_cond_broadcast_requeues_adaptive) {
+    for (int round = 0; round < 20; ++round)
+        ASSUME_ITS_TRUE(cond_run_broadcast(FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE));
+}
+
+FOSSIL_TEST(c_cond_wait_until_monotonic_deadline) {
+    cond_flag_t f;
+    fossil_threads_thread_t thread;
+    fossil_threads_mutex_init(&f.mutex);
+    fossil_threads_cond_init(&f.cond);
+    f.ready = 0;
+
+    fossil_threads_mutex_lock(&f.mutex);
+    long long start = fossil_threads_clock_monotonic_ns();
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_wait_until(&f.cond, &f.mutex, -1), FOSSIL_THREADS_COND_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_wait_until(&f.cond, &f.mutex, start), FOSSIL_THREADS_COND_ETIMEDOUT);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_cond_wait_until(&f.cond, &f.mutex, start + 5000000LL), FOSSIL_THREADS_COND_ETIMEDOUT);
+    ASSUME_ITS_TRUE(fossil_threads_clock_monotonic_ns() - start >= 4000000LL);
+
+    /* Re-waiting against one deadline in a predicate loop */
+    long long deadline = fossil_threads_clock_monotonic_ns() + 5000000000LL;
+    int rc = FOSSIL_THREADS_COND_OK;
+    fossil_threads_thread_init(&thread);
+    fossil_threads_thread_create(&thread, cond_flag_setter, &f);
+    while (!f.ready && rc == FOSSIL_THREADS_COND_OK)
+        rc = fossil_threads_cond_wait_until(&f.cond, &f.mutex, deadline);
+    ASSUME_ITS_EQUAL_I32(rc, FOSSIL_THREADS_COND_OK);
+    ASSUME_ITS_TRUE(f.ready);
+    fossil_threads_mutex_unlock(&f.mutex);
+
+    fossil_threads_thread_join(&thread, NULL);
+    fossil_threads_thread_dispose(&thread);
+    fossil_threads_cond_dispose(&f.cond);
+    fossil_threads_mutex_dispose(&f.mutex);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -167,6 +335,13 @@ FOSSIL_TEST_GROUP(c_cond_tests) {
     FOSSIL_ADD_TEST(c_cond_fixture, c_cond_is_valid_and_waiter_count);
     FOSSIL_ADD_TEST(c_cond_fixture, c_cond_reset);
     FOSSIL_ADD_TEST(c_cond_fixture, c_cond_waiter_count_increments_and_decrements);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_adaptive_mutex_wait_and_timeout);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_inline_storage_timedwait);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_static_initializer);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_signal_without_waiters);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_broadcast_wakes_all_normal);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_broadcast_requeues_adaptive);
+    FOSSIL_ADD_TEST(c_cond_fixture, c_cond_wait_until_monotonic_deadline);
 
     FOSSIL_ADD_SUITE(c_cond_fixture);
 } // end of tests
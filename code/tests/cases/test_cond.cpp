@@ -24,6 +24,8 @@
  */
 #include <fossil/maip/framework.h>
 #include "fossil/threads/framework.h"
+#include <thread>
+#include <vector>
 
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -134,6 +136,36 @@ FOSSIL_TEST(cpp_cond_waiter_count_increments_and_decrements) {
     fossil_threads_mutex_dispose(&mutex);
 }
 
+FOSSIL_TEST(cpp_cond_broadcast_with_std_threads) {
+    using fossil::threads::Cond;
+    Cond cond;
+    fossil_threads_mutex_t mutex;
+    fossil_threads_mutex_init_ex(&mutex, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE);
+    bool go = false;
+    int woken = 0;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.emplace_back([&] {
+            fossil_threads_mutex_lock(&mutex);
+            while (!go) cond.wait(&mutex);
+            ++woken;
+            fossil_threads_mutex_unlock(&mutex);
+        });
+    }
+    while (cond.waiter_count() < 3) std::this_thread::yield();
+
+    fossil_threads_mutex_lock(&mutex);
+    go = true;
+    ASSUME_ITS_EQUAL_I32(cond.broadcast(), FOSSIL_THREADS_COND_OK);
+    fossil_threads_mutex_unlock(&mutex);
+    for (auto& t : threads) t.join();
+
+    ASSUME_ITS_EQUAL_I32(woken, 3);
+    ASSUME_ITS_EQUAL_I32(cond.waiter_count(), 0);
+    fossil_threads_mutex_dispose(&mutex);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -145,6 +177,7 @@ FOSSIL_TEST_GROUP(cpp_cond_tests) {
     FOSSIL_ADD_TEST(cpp_cond_fixture, cpp_cond_is_valid_and_waiter_count);
     FOSSIL_ADD_TEST(cpp_cond_fixture, cpp_cond_reset);
     FOSSIL_ADD_TEST(cpp_cond_fixture, cpp_cond_waiter_count_increments_and_decrements);
+    FOSSIL_ADD_TEST(cpp_cond_fixture, cpp_cond_broadcast_with_std_threads);
 
     FOSSIL_ADD_SUITE(cpp_cond_fixture);
 } // end of tests
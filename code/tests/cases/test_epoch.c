@@ -0,0 +1,280 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <stdlib.h>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_epoch_fixture);
+
+FOSSIL_SETUP(c_epoch_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_epoch_fixture) {
+    // Teardown the test fixture
+}
+
+#define EPOCH_READERS 3
+#define EPOCH_SWAPS   2000
+
+/* Objects are owned by the test; "freeing" one only marks it dead */
+typedef struct {
+    int dead;
+    int *freed;
+} epoch_obj_t;
+
+static void epoch_obj_free(void *p) {
+    epoch_obj_t *o = (epoch_obj_t *)p;
+    o->dead = 1;
+    (*o->freed)++;
+}
+
+typedef struct {
+    fossil_threads_mutex_t lock;
+    epoch_obj_t *current;
+    int entered;
+    int release;
+    int done;
+    int use_after_retire;
+    epoch_obj_t *orphan;
+} epoch_shared_t;
+
+static int epoch_flag(epoch_shared_t *s, int *flag) {
+    fossil_threads_mutex_lock(&s->lock);
+    int v = *flag;
+    fossil_threads_mutex_unlock(&s->lock);
+    return v;
+}
+
+static void epoch_set(epoch_shared_t *s, int *flag) {
+    fossil_threads_mutex_lock(&s->lock);
+    *flag = 1;
+    fossil_threads_mutex_unlock(&s->lock);
+}
+
+static void *epoch_holding_reader(void *arg) {
+    epoch_shared_t *s = (epoch_shared_t *)arg;
+    fossil_threads_epoch_enter();
+    epoch_set(s, &s->entered);
+    while (!epoch_flag(s, &s->release)) fossil_threads_thread_yield();
+    fossil_threads_epoch_exit();
+    return NULL;
+}
+
+static void *epoch_retire_and_exit(void *arg) {
+    epoch_shared_t *s = (epoch_shared_t *)arg;
+    fossil_threads_epoch_retire(s->orphan, epoch_obj_free);
+    return (void *)fossil_threads_epoch_pending();
+}
+
+static void *epoch_swap_reader(void *arg) {
+    epoch_shared_t *s = (epoch_shared_t *)arg;
+    while (!epoch_flag(s, &s->done)) {
+        fossil_threads_epoch_enter();
+        fossil_threads_mutex_lock(&s->lock);
+        epoch_obj_t *o = s->current;
+        fossil_threads_mutex_unlock(&s->lock);
+        for (int i = 0; i < 8; ++i) {
+            if (o->dead) {
+                fossil_threads_mutex_lock(&s->lock);
+                s->use_after_retire = 1;
+                fossil_threads_mutex_unlock(&s->lock);
+            }
+        }
+        fossil_threads_epoch_exit();
+    }
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_epoch_enter_exit_nesting) {
+    ASSUME_ITS_FALSE(fossil_threads_epoch_in_section());
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_exit(), FOSSIL_THREADS_EPOCH_EPERM);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_enter(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_enter(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_TRUE(fossil_threads_epoch_in_section());
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_synchronize(), FOSSIL_THREADS_EPOCH_EDEADLK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_exit(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_TRUE(fossil_threads_epoch_in_section());
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_exit(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_FALSE(fossil_threads_epoch_in_section());
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_synchronize(), FOSSIL_THREADS_EPOCH_OK);
+}
+
+FOSSIL_TEST(c_epoch_retire_and_synchronize) {
+    int freed = 0;
+    epoch_obj_t objs[3] = { { 0, &freed }, { 0, &freed }, { 0, &freed } };
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_synchronize(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_retire(NULL, NULL), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_epoch_pending(), 0);
+
+    fossil_threads_epoch_enter();
+    for (int i = 0; i < 3; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_retire(&objs[i], epoch_obj_free), FOSSIL_THREADS_EPOCH_OK);
+    fossil_threads_epoch_exit();
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_epoch_pending(), 3);
+    ASSUME_ITS_EQUAL_I32(freed, 0);
+
+    /* A NULL destructor means free() */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_retire(malloc(32), NULL), FOSSIL_THREADS_EPOCH_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_epoch_synchronize(), FOSSIL_THREADS_EPOCH_OK);
+    ASSUME_ITS_EQUAL_I32(freed, 3);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_epoch_pending(), 0);
+}
+
+FOSSIL_TEST(c_epoch_amortized_reclaim) {
+    int freed = 0;
+    epoch_obj_t objs[128];
+    for (int i = 0; i < 128; ++i) {
+        objs[i].dead = 0;
+        objs[i].freed = &freed;
+        fossil_threads_epoch_retire(&objs[i], epoch_obj_free);
+    }
+    /* With no readers every periodic scan advances the epoch */
+    ASSUME_ITS_TRUE(freed > 0);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_epoch_pending(), 128 - freed);
+    fossil_threads_epoch_synchronize();
+    ASSUME_ITS_EQUAL_I32(freed, 128);
+}
+
+FOSSIL_TEST(c_epoch_active_reader_defers_reclaim) {
+    epoch_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_mutex_init(&s.lock);
+    int freed = 0;
+    epoch_obj_t target = { 0, &freed };
+    epoch_obj_t filler[96];
+
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, epoch_holding_reader, &s);
+    while (!epoch_flag(&s, &s.entered)) fossil_threads_thread_yield();
+
+    fossil_threads_epoch_retire(&target, epoch_obj_free);
+    for (int i = 0; i < 96; ++i) {
+        filler[i].dead = 0;
+        filler[i].freed = &freed;
+        fossil_threads_epoch_retire(&filler[i], epoch_obj_free);
+    }
+    ASSUME_ITS_FALSE(target.dead);
+
+    epoch_set(&s, &s.release);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+    fossil_threads_epoch_synchronize();
+    ASSUME_ITS_TRUE(target.dead);
+    ASSUME_ITS_EQUAL_I32(freed, 97);
+    fossil_threads_mutex_dispose(&s.lock);
+}
+
+FOSSIL_TEST(c_epoch_thread_exit_hands_off_pending) {
+    epoch_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_mutex_init(&s.lock);
+    int freed = 0;
+    epoch_obj_t obj = { 0, &freed };
+    s.orphan = &obj;
+
+    void *pending = NULL;
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, epoch_retire_and_exit, &s);
+    fossil_threads_thread_join(&t, &pending);
+    fossil_threads_thread_dispose(&t);
+    ASSUME_ITS_EQUAL_I32((int)(size_t)pending, 1);
+
+    /* The exited thread's slot was released and its leftovers adopted */
+    fossil_threads_epoch_synchronize();
+    ASSUME_ITS_EQUAL_I32(freed, 1);
+    fossil_threads_mutex_dispose(&s.lock);
+}
+
+FOSSIL_TEST(c_epoch_pointer_swap_under_readers) {
+    epoch_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_mutex_init(&s.lock);
+    int freed = 0;
+    epoch_obj_t *objs = (epoch_obj_t *)calloc(EPOCH_SWAPS + 1, sizeof(*objs));
+    ASSUME_ITS_TRUE(objs != NULL);
+    for (int i = 0; i <= EPOCH_SWAPS; ++i) objs[i].freed = &freed;
+    s.current = &objs[0];
+
+    fossil_threads_thread_t readers[EPOCH_READERS];
+    for (int i = 0; i < EPOCH_READERS; ++i) {
+        fossil_threads_thread_init(&readers[i]);
+        fossil_threads_thread_create(&readers[i], epoch_swap_reader, &s);
+    }
+    for (int i = 1; i <= EPOCH_SWAPS; ++i) {
+        fossil_threads_mutex_lock(&s.lock);
+        epoch_obj_t *old = s.current;
+        s.current = &objs[i];
+        fossil_threads_mutex_unlock(&s.lock);
+        fossil_threads_epoch_retire(old, epoch_obj_free);
+    }
+    epoch_set(&s, &s.done);
+    for (int i = 0; i < EPOCH_READERS; ++i) {
+        fossil_threads_thread_join(&readers[i], NULL);
+        fossil_threads_thread_dispose(&readers[i]);
+    }
+    fossil_threads_epoch_synchronize();
+
+    ASSUME_ITS_FALSE(s.use_after_retire);
+    ASSUME_ITS_EQUAL_I32(freed, EPOCH_SWAPS);
+    ASSUME_ITS_FALSE(objs[EPOCH_SWAPS].dead);
+    free(objs);
+    fossil_threads_mutex_dispose(&s.lock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_epoch_tests) {
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_enter_exit_nesting);
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_retire_and_synchronize);
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_amortized_reclaim);
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_active_reader_defers_reclaim);
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_thread_exit_hands_off_pending);
+    FOSSIL_ADD_TEST(c_epoch_fixture, c_epoch_pointer_swap_under_readers);
+
+    FOSSIL_ADD_SUITE(c_epoch_fixture);
+} // end of tests
@@ -0,0 +1,142 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_epoch_fixture);
+
+FOSSIL_SETUP(cpp_epoch_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_epoch_fixture) {
+    // Teardown the test fixture
+}
+
+namespace {
+
+    std::atomic<int> cpp_epoch_destroyed{0};
+
+    struct cpp_epoch_config {
+        int version;
+        explicit cpp_epoch_config(int v) : version(v) {}
+        ~cpp_epoch_config() { cpp_epoch_destroyed++; }
+    };
+
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Epoch;
+using fossil::threads::EpochGuard;
+
+FOSSIL_TEST(cpp_epoch_guard_and_retire) {
+    cpp_epoch_destroyed = 0;
+    {
+        EpochGuard g;
+        ASSUME_ITS_TRUE(fossil_threads_epoch_in_section());
+        Epoch::retire(new cpp_epoch_config(1));
+        bool threw = false;
+        try {
+            Epoch::synchronize();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ASSUME_ITS_TRUE(threw);
+    }
+    ASSUME_ITS_FALSE(fossil_threads_epoch_in_section());
+    ASSUME_ITS_EQUAL_I32((int)Epoch::pending(), 1);
+    Epoch::synchronize();
+    ASSUME_ITS_EQUAL_I32(cpp_epoch_destroyed.load(), 1);
+}
+
+FOSSIL_TEST(cpp_epoch_std_threads_publish_configs) {
+    cpp_epoch_destroyed = 0;
+    std::mutex m;
+    cpp_epoch_config *current = new cpp_epoch_config(0);
+    std::atomic<bool> done{false};
+    std::atomic<bool> bad{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                EpochGuard g;
+                cpp_epoch_config *c;
+                {
+                    std::lock_guard<std::mutex> lk(m);
+                    c = current;
+                }
+                if (c->version < 0) bad = true;
+            }
+            // Not a library thread, so release the slot by hand
+            Epoch::thread_exit();
+        });
+    }
+    for (int v = 1; v <= 500; ++v) {
+        cpp_epoch_config *old;
+        {
+            std::lock_guard<std::mutex> lk(m);
+            old = current;
+            current = new cpp_epoch_config(v);
+        }
+        Epoch::retire(old);
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    Epoch::synchronize();
+
+    ASSUME_ITS_FALSE(bad.load());
+    ASSUME_ITS_EQUAL_I32(cpp_epoch_destroyed.load(), 500);
+    delete current;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_epoch_tests) {
+    FOSSIL_ADD_TEST(cpp_epoch_fixture, cpp_epoch_guard_and_retire);
+    FOSSIL_ADD_TEST(cpp_epoch_fixture, cpp_epoch_std_threads_publish_configs);
+
+    FOSSIL_ADD_SUITE(cpp_epoch_fixture);
+} // end of tests
@@ -0,0 +1,337 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <string.h>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_fiber_fixture);
+
+FOSSIL_SETUP(c_fiber_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_fiber_fixture) {
+    // Teardown the test fixture
+}
+
+static void *fiber_echo(void *arg) {
+    return arg;
+}
+
+/* Spawns a throwaway fiber; false where the platform has no fibers. */
+static int fiber_supported(fossil_threads_pool_t *pool) {
+    fossil_threads_fiber_t *f = NULL;
+    if (fossil_threads_fiber_spawn(pool, fiber_echo, NULL, 0, &f) != FOSSIL_THREADS_OK)
+        return 0;
+    fossil_threads_fiber_join(f, NULL);
+    return 1;
+}
+
+/* Keeps a one-worker pool busy until the test has queued what it needs. */
+static void *fiber_hold_worker(void *arg) {
+    fossil_threads_latch_wait((fossil_threads_latch_t *)arg);
+    return NULL;
+}
+
+typedef struct {
+    char log[16];
+    size_t len;
+} fiber_log_t;
+
+typedef struct {
+    fiber_log_t *log;
+    char tag;
+} fiber_turn_t;
+
+/* Three turns, yielding in between; one worker runs both fibers. */
+static void *fiber_take_turns(void *arg) {
+    fiber_turn_t *t = (fiber_turn_t *)arg;
+    for (int i = 0; i < 3; ++i) {
+        t->log->log[t->log->len++] = t->tag;
+        fossil_threads_fiber_yield();
+    }
+    return NULL;
+}
+
+typedef struct {
+    fossil_threads_pool_future_t **gate;  /* set before the worker is released */
+    volatile unsigned int *waiting;
+    int use_future_wait;
+    size_t index;
+} fiber_gate_arg_t;
+
+static fossil_threads_mutex_t fiber_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+
+static void *fiber_wait_gate(void *arg) {
+    fiber_gate_arg_t *a = (fiber_gate_arg_t *)arg;
+    fossil_threads_mutex_lock(&fiber_lock);
+    (*a->waiting)++;
+    fossil_threads_mutex_unlock(&fiber_lock);
+
+    void *value = NULL;
+    int rc = a->use_future_wait ? fossil_threads_pool_future_wait(*a->gate, &value)
+                                : fossil_threads_fiber_await(*a->gate, &value);
+    if (rc != FOSSIL_THREADS_OK || !fossil_threads_fiber_inside()) return NULL;
+    return (void *)((size_t)value + a->index);
+}
+
+/* Runs only after every fiber has parked on it: none holds the worker. */
+static void *fiber_open_gate(void *arg) {
+    volatile unsigned int *waiting = (volatile unsigned int *)arg;
+    fossil_threads_mutex_lock(&fiber_lock);
+    size_t seen = *waiting;
+    fossil_threads_mutex_unlock(&fiber_lock);
+    return (void *)(seen * 1000);
+}
+
+typedef struct {
+    fossil_threads_pool_t *pool;
+    size_t child_result;
+} fiber_parent_arg_t;
+
+static void *fiber_spawn_and_join(void *arg) {
+    fiber_parent_arg_t *a = (fiber_parent_arg_t *)arg;
+    fossil_threads_fiber_t *child = NULL;
+    void *result = NULL;
+    if (fossil_threads_fiber_spawn(a->pool, fiber_echo, (void *)(size_t)41, 0, &child) != FOSSIL_THREADS_OK)
+        return NULL;
+    if (fossil_threads_fiber_join(child, &result) != FOSSIL_THREADS_OK)
+        return NULL;
+    a->child_result = (size_t)result + 1;
+    return a;
+}
+
+static volatile unsigned int fiber_rounds;
+
+static void *fiber_yield_rounds(void *arg) {
+    (void)arg;
+    for (int i = 0; i < 10; ++i) {
+        fossil_threads_mutex_lock(&fiber_lock);
+        fiber_rounds++;
+        fossil_threads_mutex_unlock(&fiber_lock);
+        fossil_threads_fiber_yield();
+    }
+    return NULL;
+}
+
+/* Touches most of a 64 KiB frame to prove the requested stack is there. */
+static void *fiber_deep_stack(void *arg) {
+    volatile unsigned char buf[64 * 1024];
+    for (size_t i = 0; i < sizeof(buf); i += 512) buf[i] = (unsigned char)i;
+    fossil_threads_fiber_yield();
+    size_t sum = 0;
+    for (size_t i = 0; i < sizeof(buf); i += 512) sum += buf[i];
+    return (void *)(sum + (size_t)arg);
+}
+
+/* Holds its worker until destroy stops the pool, then keeps yielding:
+ * every yield is refused and the fiber runs on where it is. */
+static volatile unsigned int fiber_holding;
+
+static void *fiber_yield_through_shutdown(void *arg) {
+    fossil_threads_pool_t *pool = (fossil_threads_pool_t *)arg;
+    fossil_threads_mutex_lock(&fiber_lock);
+    fiber_holding = 1;
+    fossil_threads_mutex_unlock(&fiber_lock);
+    while (fossil_threads_pool_resize(pool, 1) != FOSSIL_THREADS_ECANCELLED)
+        fossil_threads_thread_sleep_ms(1);
+    size_t yields = 0;
+    for (int i = 0; i < 100000; ++i)
+        if (fossil_threads_fiber_yield() == FOSSIL_THREADS_OK) ++yields;
+    return (void *)yields;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_fiber_invalid_args) {
+    fossil_threads_fiber_t *f = (fossil_threads_fiber_t *)&f;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(NULL, fiber_echo, NULL, 0, &f), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_TRUE(f == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(NULL, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_await(NULL, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_yield(), FOSSIL_THREADS_EPERM);
+    ASSUME_ITS_FALSE(fossil_threads_fiber_inside());
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, NULL, NULL, 0, &f), FOSSIL_THREADS_EINVAL);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_fiber_spawn_join_and_detach) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    ASSUME_ITS_TRUE(pool != NULL);
+    if (!fiber_supported(pool)) {
+        fossil_threads_pool_destroy(pool);
+        return;
+    }
+    fossil_threads_fiber_t *f = NULL;
+    void *result = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_echo, (void *)(size_t)7, 0, &f), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE((size_t)result == 7);
+
+    /* Detached fibers are covered by pool_wait like any task. */
+    fiber_rounds = 0;
+    for (int i = 0; i < 50; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_yield_rounds, NULL, 1, NULL), FOSSIL_THREADS_OK);
+    fossil_threads_pool_wait(pool);
+    ASSUME_ITS_EQUAL_I32((int)fiber_rounds, 500);
+
+    /* A small stack request is raised to the minimum; a large one is honoured. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_deep_stack, (void *)(size_t)3, 256 * 1024, &f),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(f, &result), FOSSIL_THREADS_OK);
+    size_t expect = 3;
+    for (size_t i = 0; i < 64 * 1024; i += 512) expect += (unsigned char)i;
+    ASSUME_ITS_TRUE((size_t)result == expect);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_fiber_yield_interleaves) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    if (!fiber_supported(pool)) {
+        fossil_threads_pool_destroy(pool);
+        return;
+    }
+    fiber_log_t log = {{0}, 0};
+    fiber_turn_t a = {&log, 'a'}, b = {&log, 'b'};
+    fossil_threads_fiber_t *fa = NULL, *fb = NULL;
+    fossil_threads_latch_t hold;
+    fossil_threads_latch_init(&hold, 1, 0);
+    fossil_threads_pool_submit(pool, fiber_hold_worker, &hold);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_take_turns, &a, 0, &fa), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_take_turns, &b, 0, &fb), FOSSIL_THREADS_OK);
+    fossil_threads_latch_count_down(&hold, 1);
+    fossil_threads_fiber_join(fa, NULL);
+    fossil_threads_fiber_join(fb, NULL);
+    ASSUME_ITS_TRUE(strcmp(log.log, "ababab") == 0);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_fiber_await_releases_the_worker) {
+    enum { N = 32 };
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    if (!fiber_supported(pool)) {
+        fossil_threads_pool_destroy(pool);
+        return;
+    }
+    volatile unsigned int waiting = 0;
+    fossil_threads_pool_future_t *gate = NULL;
+    fiber_gate_arg_t args[N];
+    fossil_threads_fiber_t *fibers[N];
+    fossil_threads_latch_t hold;
+    fossil_threads_latch_init(&hold, 1, 0);
+
+    /* Keep the only worker busy until the fibers and then the gate are
+     * queued: the gate can run only once every fiber has parked on it. */
+    fossil_threads_pool_submit(pool, fiber_hold_worker, &hold);
+    for (size_t i = 0; i < N; ++i) {
+        args[i].gate = &gate;
+        args[i].waiting = &waiting;
+        args[i].use_future_wait = (int)(i & 1);
+        args[i].index = i;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_wait_gate, &args[i], 0, &fibers[i]),
+                             FOSSIL_THREADS_OK);
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_future(pool, fiber_open_gate, (void *)&waiting, &gate),
+                         FOSSIL_THREADS_OK);
+    fossil_threads_latch_count_down(&hold, 1);
+
+    for (size_t i = 0; i < N; ++i) {
+        void *result = NULL;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(fibers[i], &result), FOSSIL_THREADS_OK);
+        ASSUME_ITS_TRUE((size_t)result == N * 1000 + i);
+    }
+    fossil_threads_pool_future_release(gate);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_fiber_join_from_fiber) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    if (!fiber_supported(pool)) {
+        fossil_threads_pool_destroy(pool);
+        return;
+    }
+    fiber_parent_arg_t arg = {pool, 0};
+    fossil_threads_fiber_t *parent = NULL;
+    void *result = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_spawn_and_join, &arg, 0, &parent), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(parent, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(result == &arg);
+    ASSUME_ITS_TRUE(arg.child_result == 42);
+    fossil_threads_pool_destroy(pool);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST(c_fiber_yields_during_destroy) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    if (!fiber_supported(pool)) {
+        fossil_threads_pool_destroy(pool);
+        return;
+    }
+    fossil_threads_fiber_t *f = NULL;
+    void *result = NULL;
+    fiber_holding = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_spawn(pool, fiber_yield_through_shutdown, pool, 0, &f),
+                         FOSSIL_THREADS_OK);
+    for (;;) {
+        fossil_threads_mutex_lock(&fiber_lock);
+        unsigned int holding = fiber_holding;
+        fossil_threads_mutex_unlock(&fiber_lock);
+        if (holding) break;
+        fossil_threads_thread_sleep_ms(1);
+    }
+    /* Far more refused yields than the worker stack could nest. */
+    fossil_threads_pool_destroy(pool);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_fiber_join(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE((size_t)result == 100000);
+}
+
+FOSSIL_TEST_GROUP(c_fiber_tests) {
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_invalid_args);
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_spawn_join_and_detach);
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_yield_interleaves);
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_await_releases_the_worker);
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_join_from_fiber);
+    FOSSIL_ADD_TEST(c_fiber_fixture, c_fiber_yields_during_destroy);
+
+    FOSSIL_ADD_SUITE(c_fiber_fixture);
+} // end of tests
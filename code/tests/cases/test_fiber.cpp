@@ -0,0 +1,178 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_fiber_fixture);
+
+FOSSIL_SETUP(cpp_fiber_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_fiber_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Fiber;
+using fossil::threads::Future;
+using fossil::threads::Pool;
+
+namespace {
+    void* fiber_double(void* arg) {
+        return reinterpret_cast<void*>(reinterpret_cast<size_t>(arg) * 2);
+    }
+
+    struct AwaitArgs {
+        Pool* pool;
+        size_t sum;
+    };
+
+    void* fiber_await_futures(void* arg) {
+        auto* a = static_cast<AwaitArgs*>(arg);
+        std::vector<Future> futures;
+        for (size_t i = 1; i <= 4; ++i)
+            futures.push_back(a->pool->submit_future(fiber_double, reinterpret_cast<void*>(i)));
+        for (Future& f : futures) {
+            a->sum += reinterpret_cast<size_t>(Fiber::await(f));
+            Fiber::yield();
+        }
+        return Fiber::inside() ? a : nullptr;
+    }
+
+    bool fibers_supported(Pool& pool) {
+        try {
+            Fiber probe(pool, fiber_double);
+            return true;
+        } catch (const std::runtime_error&) {
+            return false;
+        }
+    }
+}
+
+FOSSIL_TEST(cpp_fiber_wrapper) {
+    Pool pool(2);
+    ASSUME_ITS_FALSE(Fiber::inside());
+    ASSUME_ITS_EQUAL_I32(Fiber::yield(), FOSSIL_THREADS_EPERM);
+    if (!fibers_supported(pool)) return;
+
+    Fiber plain(pool, fiber_double, reinterpret_cast<void*>(21));
+    ASSUME_ITS_TRUE(plain.joinable());
+    ASSUME_ITS_TRUE(reinterpret_cast<size_t>(plain.join()) == 42);
+    ASSUME_ITS_FALSE(plain.joinable());
+
+    AwaitArgs args{&pool, 0};
+    Fiber waiter(pool, fiber_await_futures, &args);
+    Fiber moved(std::move(waiter));
+    ASSUME_ITS_TRUE(moved.join() == &args);
+    ASSUME_ITS_TRUE(args.sum == 2 + 4 + 6 + 8);
+}
+
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+using fossil::threads::Task;
+
+namespace {
+    Task<size_t> coro_on_worker(Pool& pool, size_t value) {
+        co_await pool.schedule();
+        if (!Pool::worker_local()) throw std::runtime_error("not on a worker");
+        Future doubled = pool.submit_future(fiber_double, reinterpret_cast<void*>(value));
+        void* result = co_await doubled;
+        co_return reinterpret_cast<size_t>(result);
+    }
+
+    Task<size_t> coro_fails(Pool& pool) {
+        co_await pool.schedule();
+        throw std::runtime_error("task failed");
+    }
+
+    Task<void> coro_sum(Pool& pool, std::atomic<size_t>& total) {
+        std::vector<Task<size_t>> parts;
+        for (size_t i = 1; i <= 8; ++i) parts.push_back(coro_on_worker(pool, i));
+        for (Task<size_t>& part : parts) total += co_await part;
+        try {
+            co_await coro_fails(pool);
+        } catch (const std::runtime_error&) {
+            total += 1000;
+        }
+    }
+}
+
+FOSSIL_TEST(cpp_coroutine_pool_schedule_and_future) {
+    Pool pool(2);
+    ASSUME_ITS_TRUE(coro_on_worker(pool, 5).get() == 10);
+
+    Task<size_t> failing = coro_fails(pool);
+    bool threw = false;
+    try {
+        (void)failing.get();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+    ASSUME_ITS_TRUE(failing.done());
+}
+
+FOSSIL_TEST(cpp_coroutine_task_chain) {
+    Pool pool(4);
+    std::atomic<size_t> total{0};
+    Task<void> all = coro_sum(pool, total);
+    ASSUME_ITS_TRUE(all.valid());
+    ASSUME_ITS_FALSE(all.done());
+    all.get();
+    ASSUME_ITS_TRUE(total.load() == 2 * (1 + 2 + 3 + 4 + 5 + 6 + 7 + 8) + 1000);
+    pool.wait();
+}
+#endif
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_fiber_tests) {
+    FOSSIL_ADD_TEST(cpp_fiber_fixture, cpp_fiber_wrapper);
+#if defined(FOSSIL_THREADS_HAS_COROUTINES)
+    FOSSIL_ADD_TEST(cpp_fiber_fixture, cpp_coroutine_pool_schedule_and_future);
+    FOSSIL_ADD_TEST(cpp_fiber_fixture, cpp_coroutine_task_chain);
+#endif
+
+    FOSSIL_ADD_SUITE(cpp_fiber_fixture);
+} // end of tests
@@ -24,6 +24,7 @@
  */
 #include <fossil/maip/framework.h>
 #include "fossil/threads/framework.h"
+#include <string.h>
 
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -35,6 +36,126 @@
 
 FOSSIL_SUITE(c_mutex_fixture);
 
+#define MUTEX_CONTEND_THREADS 4
+#define MUTEX_CONTEND_ITERS   20000
+
+typedef struct {
+    fossil_threads_mutex_t *m;
+    long counter;
+} mutex_contend_t;
+
+static void *mutex_contend_worker(void *arg) {
+    mutex_contend_t *c = (mutex_contend_t *)arg;
+    for (int i = 0; i < MUTEX_CONTEND_ITERS; ++i) {
+        fossil_threads_mutex_lock(c->m);
+        c->counter++;
+        fossil_threads_mutex_unlock(c->m);
+    }
+    return NULL;
+}
+
+static void *mutex_hold_briefly(void *arg) {
+    fossil_threads_mutex_t *m = (fossil_threads_mutex_t *)arg;
+    fossil_threads_mutex_lock(m);
+    fossil_threads_thread_sleep_ms(40);
+    fossil_threads_mutex_unlock(m);
+    return NULL;
+}
+
+/* Checks lock_until against a lock another thread holds for a while. */
+static int mutex_run_lock_until(int kind) {
+    fossil_threads_mutex_t m;
+    fossil_threads_thread_t holder;
+    int ok = 1;
+    fossil_threads_mutex_init_ex(&m, kind);
+    fossil_threads_thread_init(&holder);
+    fossil_threads_thread_create(&holder, mutex_hold_briefly, &m);
+    while (!fossil_threads_mutex_is_locked(&m)) fossil_threads_thread_yield();
+
+    long long start = fossil_threads_clock_monotonic_ns();
+    ok &= fossil_threads_mutex_lock_until(&m, start + 5000000LL) == FOSSIL_THREADS_MUTEX_ETIMEDOUT;
+    ok &= fossil_threads_clock_monotonic_ns() - start >= 4000000LL;
+    ok &= fossil_threads_mutex_lock_until(&m, start - 1) == FOSSIL_THREADS_MUTEX_ETIMEDOUT;
+    ok &= fossil_threads_mutex_lock_until(&m, fossil_threads_clock_monotonic_ns() + 5000000000LL) == FOSSIL_THREADS_MUTEX_OK;
+    ok &= fossil_threads_mutex_unlock(&m) == FOSSIL_THREADS_MUTEX_OK;
+
+    fossil_threads_thread_join(&holder, NULL);
+    fossil_threads_thread_dispose(&holder);
+    fossil_threads_mutex_dispose(&m);
+    return ok;
+}
+
+/* Copies the profile record tagged name, if it is among the hottest locks. */
+static int mutex_find_profile(const char *name, fossil_threads_mutex_profile_t *out) {
+    static fossil_threads_mutex_profile_t top[256];
+    size_t n = fossil_threads_mutex_profile_top(top, 256);
+    for (size_t i = 0; i < n; ++i) {
+        if (top[i].name == name) {
+            *out = top[i];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* Ten quiet acquisitions and one that waits for a holder; checks the record. */
+static int mutex_run_profile(int kind, const char *tag) {
+    fossil_threads_mutex_t m;
+    fossil_threads_thread_t holder;
+    fossil_threads_mutex_profile_t p;
+    int ok = 1;
+    fossil_threads_mutex_init_ex(&m, kind);
+    fossil_threads_mutex_set_name(&m, tag);
+    for (int i = 0; i < 10; ++i) {
+        fossil_threads_mutex_lock(&m);
+        fossil_threads_mutex_unlock(&m);
+    }
+    fossil_threads_thread_init(&holder);
+    fossil_threads_thread_create(&holder, mutex_hold_briefly, &m);
+    while (!fossil_threads_mutex_is_locked(&m)) fossil_threads_thread_yield();
+    fossil_threads_mutex_lock(&m);
+    fossil_threads_mutex_unlock(&m);
+    fossil_threads_thread_join(&holder, NULL);
+    fossil_threads_thread_dispose(&holder);
+
+    ok &= mutex_find_profile(tag, &p);
+    ok &= p.mutex == (const void *)&m;
+    ok &= p.acquisitions == 12;
+    ok &= p.contended == 1;
+    ok &= p.wait_ns_max >= 1000000ULL && p.wait_ns_total == p.wait_ns_max;
+    ok &= p.hold_ns_max >= 1000000ULL;
+    unsigned long long waits = 0;
+    for (int i = 0; i < FOSSIL_THREADS_MUTEX_PROFILE_BUCKETS; ++i) waits += p.wait_histogram[i];
+    ok &= waits == 1;
+
+    /* Disposed records stay listed until the next reset */
+    fossil_threads_mutex_dispose(&m);
+    ok &= mutex_find_profile(tag, &p) && p.mutex == NULL;
+    fossil_threads_mutex_profile_reset();
+    ok &= !mutex_find_profile(tag, &p);
+    return ok;
+}
+
+/* Dump sink collecting text; refuses every line once stop_after are in. */
+typedef struct {
+    char text[8192];
+    size_t len;
+    int lines;
+    int stop_after;
+} mutex_dump_sink_t;
+
+static int mutex_dump_write(void *ctx, const char *data, size_t len) {
+    mutex_dump_sink_t *sink = (mutex_dump_sink_t *)ctx;
+    if (sink->stop_after >= 0 && sink->lines >= sink->stop_after) return 1;
+    if (sink->len + len < sizeof(sink->text)) {
+        memcpy(sink->text + sink->len, data, len);
+        sink->len += len;
+        sink->text[sink->len] = '\0';
+    }
+    sink->lines++;
+    return 0;
+}
+
 FOSSIL_SETUP(c_mutex_fixture) {
     // Setup the test fixture
 }
@@ -179,6 +300,166 @@ FOSSIL_TEST(c_thread_mutex_is_locked_null) {
     ASSUME_ITS_FALSE(fossil_threads_mutex_is_locked(NULL));
 }
 
+FOSSIL_TEST(c_thread_mutex_init_ex_kinds) {
+    fossil_threads_mutex_t m;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&m, FOSSIL_THREADS_MUTEX_KIND_NORMAL), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_initialized(&m));
+    fossil_threads_mutex_dispose(&m);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&m, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_initialized(&m));
+    fossil_threads_mutex_dispose(&m);
+    ASSUME_ITS_FALSE(fossil_threads_mutex_is_initialized(&m));
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&m, 42), FOSSIL_THREADS_MUTEX_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(NULL, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE), FOSSIL_THREADS_MUTEX_EINVAL);
+}
+
+FOSSIL_TEST(c_thread_mutex_adaptive_lock_trylock) {
+    fossil_threads_mutex_t m;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&m, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE), FOSSIL_THREADS_MUTEX_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_locked(&m));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_trylock(&m), FOSSIL_THREADS_MUTEX_EBUSY);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_FALSE(fossil_threads_mutex_is_locked(&m));
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_trylock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&m), FOSSIL_THREADS_MUTEX_EUNLOCK);
+
+    fossil_threads_mutex_dispose(&m);
+}
+
+FOSSIL_TEST(c_thread_mutex_adaptive_contended) {
+    fossil_threads_mutex_t m;
+    fossil_threads_thread_t threads[MUTEX_CONTEND_THREADS];
+    mutex_contend_t c;
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init_ex(&m, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE), FOSSIL_THREADS_MUTEX_OK);
+    c.m = &m;
+    c.counter = 0;
+
+    for (int i = 0; i < MUTEX_CONTEND_THREADS; ++i) {
+        fossil_threads_thread_init(&threads[i]);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&threads[i], mutex_contend_worker, &c), FOSSIL_THREADS_OK);
+    }
+    for (int i = 0; i < MUTEX_CONTEND_THREADS; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+
+    ASSUME_ITS_EQUAL_I32((int)c.counter, MUTEX_CONTEND_THREADS * MUTEX_CONTEND_ITERS);
+    ASSUME_ITS_FALSE(fossil_threads_mutex_is_locked(&m));
+    fossil_threads_mutex_dispose(&m);
+}
+
+FOSSIL_TEST(c_thread_mutex_static_initializer) {
+    static fossil_threads_mutex_t m = FOSSIL_THREADS_MUTEX_INITIALIZER;
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_initialized(&m));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_locked(&m));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_trylock(&m), FOSSIL_THREADS_MUTEX_EBUSY);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_FALSE(fossil_threads_mutex_is_locked(&m));
+}
+
+FOSSIL_TEST(c_thread_mutex_embedded_array) {
+    fossil_threads_mutex_t locks[64];
+    for (int i = 0; i < 64; ++i) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_init(&locks[i]), FOSSIL_THREADS_MUTEX_OK);
+        ASSUME_ITS_TRUE(locks[i].handle == NULL);
+    }
+    for (int i = 0; i < 64; ++i) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock(&locks[i]), FOSSIL_THREADS_MUTEX_OK);
+    }
+    for (int i = 63; i >= 0; --i) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&locks[i]), FOSSIL_THREADS_MUTEX_OK);
+        fossil_threads_mutex_dispose(&locks[i]);
+    }
+}
+
+FOSSIL_TEST(c_thread_mutex_lock_until) {
+    fossil_threads_mutex_t m;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock_until(NULL, 0), FOSSIL_THREADS_MUTEX_EINVAL);
+    fossil_threads_mutex_init(&m);
+    /* An uncontended lock succeeds even with a deadline in the past */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock_until(&m, 0), FOSSIL_THREADS_MUTEX_OK);
+    fossil_threads_mutex_unlock(&m);
+    fossil_threads_mutex_dispose(&m);
+
+    ASSUME_ITS_TRUE(mutex_run_lock_until(FOSSIL_THREADS_MUTEX_KIND_NORMAL));
+    ASSUME_ITS_TRUE(mutex_run_lock_until(FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE));
+}
+
+FOSSIL_TEST(c_thread_mutex_names) {
+    fossil_threads_mutex_t m;
+    ASSUME_ITS_TRUE(fossil_threads_mutex_name(NULL) == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_set_name(NULL, "x"), FOSSIL_THREADS_MUTEX_EINVAL);
+    fossil_threads_mutex_init(&m);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_name(&m) == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_set_name(&m, "test.mutex.named"), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_name(&m) != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_name(&m)[0] == 't');
+    fossil_threads_mutex_dispose(&m);
+    ASSUME_ITS_TRUE(fossil_threads_mutex_name(&m) == NULL);
+}
+
+FOSSIL_TEST(c_thread_mutex_profile_records_contention) {
+    static const char normal_tag[] = "test.mutex.profile.normal";
+    static const char adaptive_tag[] = "test.mutex.profile.adaptive";
+    fossil_threads_mutex_profile_t p;
+
+    /* Start from a registry without the records of earlier tests */
+    fossil_threads_mutex_profile_reset();
+    if (fossil_threads_mutex_profile_enabled()) {
+        ASSUME_ITS_TRUE(mutex_run_profile(FOSSIL_THREADS_MUTEX_KIND_NORMAL, normal_tag));
+        ASSUME_ITS_TRUE(mutex_run_profile(FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE, adaptive_tag));
+    } else {
+        fossil_threads_mutex_t m;
+        fossil_threads_mutex_init(&m);
+        fossil_threads_mutex_lock(&m);
+        fossil_threads_mutex_unlock(&m);
+        ASSUME_ITS_TRUE(m.profile == NULL);
+        ASSUME_ITS_TRUE(fossil_threads_mutex_profile_top(&p, 1) == 0);
+        fossil_threads_mutex_dispose(&m);
+    }
+    ASSUME_ITS_TRUE(fossil_threads_mutex_profile_top(NULL, 4) == 0);
+}
+
+FOSSIL_TEST(c_thread_mutex_profile_dump_to_writer) {
+    static const char tag[] = "test.mutex.profile.dump";
+    static mutex_dump_sink_t sink;
+    fossil_threads_mutex_t m;
+
+    fossil_threads_mutex_profile_reset();
+    fossil_threads_mutex_init(&m);
+    fossil_threads_mutex_set_name(&m, tag);
+    fossil_threads_mutex_lock(&m);
+    fossil_threads_mutex_unlock(&m);
+
+    memset(&sink, 0, sizeof(sink));
+    sink.stop_after = -1;
+    size_t n = fossil_threads_mutex_profile_dump(mutex_dump_write, &sink, 256);
+    if (fossil_threads_mutex_profile_enabled()) {
+        ASSUME_ITS_TRUE(n >= 1);
+        ASSUME_ITS_TRUE(sink.lines == (int)n + 1);
+        ASSUME_ITS_TRUE(strstr(sink.text, tag) != NULL);
+
+        /* A writer refusing the header stops the dump before any record */
+        memset(&sink, 0, sizeof(sink));
+        ASSUME_ITS_TRUE(fossil_threads_mutex_profile_dump(mutex_dump_write, &sink, 256) == 0);
+        ASSUME_ITS_TRUE(sink.len == 0);
+    } else {
+        ASSUME_ITS_TRUE(n == 0);
+        ASSUME_ITS_TRUE(sink.lines == 0);
+    }
+    ASSUME_ITS_TRUE(fossil_threads_mutex_profile_dump(NULL, &sink, 4) == 0);
+    fossil_threads_mutex_dispose(&m);
+    fossil_threads_mutex_profile_reset();
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -195,6 +476,15 @@ FOSSIL_TEST_GROUP(c_mutex_tests) {
     FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_is_locked_unlocked);
     FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_is_initialized_null);
     FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_is_locked_null);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_init_ex_kinds);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_adaptive_lock_trylock);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_adaptive_contended);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_static_initializer);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_embedded_array);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_lock_until);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_names);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_profile_records_contention);
+    FOSSIL_ADD_TEST(c_mutex_fixture, c_thread_mutex_profile_dump_to_writer);
 
     FOSSIL_ADD_SUITE(c_mutex_fixture);
 } // end of tests
@@ -207,6 +207,87 @@ FOSSIL_TEST(cpp_thread_mutex_raii_exceptions) {
     }
 }
 
+FOSSIL_TEST(cpp_thread_mutex_adaptive_kind) {
+    fossil::threads::Mutex m(FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE);
+    long counter = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 10000; ++i) {
+                fossil::threads::Mutex::LockGuard guard(m);
+                ++counter;
+            }
+        });
+    }
+    for (auto &th : threads) th.join();
+    ASSUME_ITS_EQUAL_I32((int)counter, 40000);
+    ASSUME_ITS_TRUE(m.try_lock_for(std::chrono::milliseconds(1)));
+    m.unlock();
+
+    // Moving an adaptive mutex keeps its kind
+    fossil::threads::Mutex moved(std::move(m));
+    ASSUME_ITS_TRUE(moved.try_lock());
+    ASSUME_ITS_FALSE(moved.try_lock());
+    moved.unlock();
+
+    try {
+        fossil::threads::Mutex bad(42);
+        ASSUME_ITS_TRUE(false);
+    } catch (const std::runtime_error&) {
+        ASSUME_ITS_TRUE(true);
+    }
+}
+
+FOSSIL_TEST(cpp_thread_mutex_static_initializer) {
+    static fossil_threads_mutex_t m = FOSSIL_THREADS_MUTEX_INITIALIZER;
+    ASSUME_ITS_TRUE(fossil_threads_mutex_is_initialized(&m));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_lock(&m), FOSSIL_THREADS_MUTEX_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_mutex_unlock(&m), FOSSIL_THREADS_MUTEX_OK);
+}
+
+FOSSIL_TEST(cpp_thread_mutex_timed_lock_blocks_until_release) {
+    using fossil::threads::Mutex;
+    for (int kind : { FOSSIL_THREADS_MUTEX_KIND_NORMAL, FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE }) {
+        Mutex m(kind);
+        std::atomic<bool> held{false};
+        std::thread holder([&] {
+            m.lock();
+            held = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            m.unlock();
+        });
+        while (!held.load()) std::this_thread::yield();
+
+        auto start = std::chrono::steady_clock::now();
+        ASSUME_ITS_FALSE(m.try_lock_for(std::chrono::milliseconds(5)));
+        ASSUME_ITS_TRUE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(4));
+
+        // Blocks past the holder's release rather than polling it
+        ASSUME_ITS_TRUE(m.try_lock_until(std::chrono::steady_clock::now() + std::chrono::seconds(5)));
+        m.unlock();
+        holder.join();
+    }
+}
+
+FOSSIL_TEST(cpp_thread_mutex_name_and_profile) {
+    using fossil::threads::Mutex;
+    static const char tag[] = "test.cpp.mutex.profiled";
+    Mutex m(FOSSIL_THREADS_MUTEX_KIND_ADAPTIVE);
+    ASSUME_ITS_TRUE(m.name() == nullptr);
+    m.set_name(tag);
+    ASSUME_ITS_TRUE(m.name() == tag);
+    {
+        Mutex::LockGuard guard(m);
+    }
+
+    auto top = Mutex::profile_top(256);
+    bool found = false;
+    for (const auto& p : top) {
+        if (p.name == tag) found = p.acquisitions >= 1;
+    }
+    ASSUME_ITS_TRUE(found == fossil_threads_mutex_profile_enabled());
+}
+
 FOSSIL_TEST_GROUP(cpp_mutex_tests) {
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_trylock_success);
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_lock_blocks_other_thread_trylock);
@@ -217,7 +298,11 @@ FOSSIL_TEST_GROUP(cpp_mutex_tests) {
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_raii_move_assign);
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_raii_try_lock_for);
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_raii_try_lock_until);
+    FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_timed_lock_blocks_until_release);
     FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_raii_exceptions);
+    FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_adaptive_kind);
+    FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_static_initializer);
+    FOSSIL_ADD_TEST(cpp_mutex_fixture, cpp_thread_mutex_name_and_profile);
 
     FOSSIL_ADD_SUITE(cpp_mutex_fixture);
 } // end of tests
@@ -0,0 +1,1742 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_pool_fixture);
+
+FOSSIL_SETUP(c_pool_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_pool_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+/* ---------- Helpers ---------- */
+
+typedef struct {
+    fossil_threads_mutex_t lock;
+    int count;
+    fossil_threads_pool_t *pool;
+    int children;
+} pool_counter_t;
+
+static void pool_counter_init(pool_counter_t *c, fossil_threads_pool_t *pool, int children) {
+    fossil_threads_mutex_init(&c->lock);
+    c->count = 0;
+    c->pool = pool;
+    c->children = children;
+}
+
+static int pool_counter_get(pool_counter_t *c) {
+    fossil_threads_mutex_lock(&c->lock);
+    int v = c->count;
+    fossil_threads_mutex_unlock(&c->lock);
+    return v;
+}
+
+static void *pool_task_increment(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    fossil_threads_mutex_lock(&c->lock);
+    c->count++;
+    fossil_threads_mutex_unlock(&c->lock);
+    return NULL;
+}
+
+/* Submits `children` nested tasks from inside a worker. */
+static void *pool_task_spawn_children(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    for (int i = 0; i < c->children; ++i)
+        fossil_threads_pool_submit(c->pool, pool_task_increment, c);
+    return pool_task_increment(arg);
+}
+
+typedef struct {
+    fossil_threads_pool_task_t node; /* embedded: submit never allocates */
+    pool_counter_t *counter;
+    int value;
+} pool_job_t;
+
+static void *pool_job_run(void *arg) {
+    pool_job_t *job = (pool_job_t *)arg;
+    fossil_threads_mutex_lock(&job->counter->lock);
+    job->counter->count += job->value;
+    fossil_threads_mutex_unlock(&job->counter->lock);
+    return NULL;
+}
+
+/* ---------- Lifecycle ---------- */
+
+FOSSIL_TEST(c_pool_create_and_destroy) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_pool_size(pool), 2);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_scheduler(pool), FOSSIL_THREADS_POOL_SCHED_SHARED);
+    fossil_threads_pool_destroy(pool);
+
+    ASSUME_ITS_TRUE(fossil_threads_pool_create(0) == NULL);
+    fossil_threads_pool_destroy(NULL);
+}
+
+FOSSIL_TEST(c_pool_create_ex_invalid_options) {
+    fossil_threads_pool_options_t opts;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(NULL) == NULL);
+
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 0;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+
+    fossil_threads_pool_options_init(&opts);
+    opts.scheduler = 42;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+
+    fossil_threads_pool_options_init(&opts);
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.full_policy = 42;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+
+    fossil_threads_pool_options_init(&opts);
+    opts.placement = 42;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+}
+
+FOSSIL_TEST(c_pool_submit_invalid_args) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(NULL, pool_task_increment, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, NULL, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(NULL), FOSSIL_THREADS_EINVAL);
+    fossil_threads_pool_destroy(pool);
+}
+
+/* ---------- Scheduling ---------- */
+
+FOSSIL_TEST(c_pool_shared_runs_all_tasks) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(4);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    for (int i = 0; i < 100; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 100);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_work_stealing_runs_nested_tasks) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 4;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    opts.deque_capacity = 8; /* small on purpose: exercises overflow to the shared queue */
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_scheduler(pool), FOSSIL_THREADS_POOL_SCHED_WORK_STEALING);
+
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 16);
+
+    for (int i = 0; i < 50; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c), FOSSIL_THREADS_OK);
+
+    /* 50 parents, each with 16 children */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 50 * 17);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_work_stealing_single_worker) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 4);
+
+    for (int i = 0; i < 10; ++i)
+        fossil_threads_pool_submit(pool, pool_task_spawn_children, &c);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 10 * 5);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* ---------- Bounded queue ---------- */
+
+typedef struct {
+    fossil_threads_mutex_t lock;
+    int started;
+    int released;
+} pool_gate_t;
+
+static void pool_gate_init(pool_gate_t *g) {
+    fossil_threads_mutex_init(&g->lock);
+    g->started = 0;
+    g->released = 0;
+}
+
+static int pool_gate_read(pool_gate_t *g, const int *field) {
+    fossil_threads_mutex_lock(&g->lock);
+    int v = *field;
+    fossil_threads_mutex_unlock(&g->lock);
+    return v;
+}
+
+static void pool_gate_set(pool_gate_t *g, int *field) {
+    fossil_threads_mutex_lock(&g->lock);
+    *field = 1;
+    fossil_threads_mutex_unlock(&g->lock);
+}
+
+/* Occupies the single worker until the test releases the gate. */
+static void *pool_task_hold_gate(void *arg) {
+    pool_gate_t *g = (pool_gate_t *)arg;
+    pool_gate_set(g, &g->started);
+    while (!pool_gate_read(g, &g->released))
+        fossil_threads_thread_sleep_ms(1);
+    return NULL;
+}
+
+/* One worker parked on a gate task, ring of two slots. */
+static fossil_threads_pool_t *pool_create_blocked_bounded(pool_gate_t *g, int policy) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.queue_capacity = 2;
+    opts.full_policy = policy;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    if (!pool) return NULL;
+    pool_gate_init(g);
+    fossil_threads_pool_submit(pool, pool_task_hold_gate, g);
+    while (!pool_gate_read(g, &g->started))
+        fossil_threads_thread_sleep_ms(1);
+    return pool;
+}
+
+FOSSIL_TEST(c_pool_bounded_runs_all_tasks) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 4;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.queue_capacity = 8; /* producers will routinely block on a full ring */
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_scheduler(pool), FOSSIL_THREADS_POOL_SCHED_BOUNDED);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    for (int i = 0; i < 500; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 500);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_bounded_full_fails) {
+    pool_gate_t g;
+    fossil_threads_pool_t *pool = pool_create_blocked_bounded(&g, FOSSIL_THREADS_POOL_FULL_FAIL);
+    ASSUME_ITS_TRUE(pool != NULL);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_EBUSY);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_pool_pending(pool), 3);
+
+    pool_gate_set(&g, &g.released);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 2);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+    fossil_threads_mutex_dispose(&g.lock);
+}
+
+FOSSIL_TEST(c_pool_bounded_full_runs_on_caller) {
+    pool_gate_t g;
+    fossil_threads_pool_t *pool = pool_create_blocked_bounded(&g, FOSSIL_THREADS_POOL_FULL_RUN_CALLER);
+    ASSUME_ITS_TRUE(pool != NULL);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    fossil_threads_pool_submit(pool, pool_task_increment, &c);
+    fossil_threads_pool_submit(pool, pool_task_increment, &c);
+    /* Ring is full and the worker is held: this one runs right here. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 1);
+
+    pool_gate_set(&g, &g.released);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 3);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+    fossil_threads_mutex_dispose(&g.lock);
+}
+
+FOSSIL_TEST(c_pool_bounded_nested_submit_does_not_block) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.queue_capacity = 2;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 8);
+
+    /* Workers overflow their own ring; BLOCK degrades to running inline. */
+    for (int i = 0; i < 10; ++i)
+        fossil_threads_pool_submit(pool, pool_task_spawn_children, &c);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 10 * 9);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* ---------- Batch submission ---------- */
+
+/* Submits `children` increments as one batch from inside a worker. */
+static void *pool_task_spawn_batch(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    fossil_threads_thread_func funcs[16];
+    void *args[16];
+    for (int i = 0; i < c->children; ++i) {
+        funcs[i] = pool_task_increment;
+        args[i] = c;
+    }
+    fossil_threads_pool_submit_batch(c->pool, funcs, args, (size_t)c->children);
+    return pool_task_increment(arg);
+}
+
+FOSSIL_TEST(c_pool_submit_batch_runs_all_tasks) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(4);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    enum { N = 64 };
+    pool_job_t jobs[N];
+    fossil_threads_thread_func funcs[N];
+    void *args[N];
+    for (int i = 0; i < N; ++i) {
+        jobs[i].counter = &c;
+        jobs[i].value = i + 1;
+        funcs[i] = pool_job_run;
+        args[i] = &jobs[i];
+    }
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, funcs, args, N), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), N * (N + 1) / 2);
+
+    /* Empty batch is a no-op; NULL args passes NULL to every task. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, funcs, args, 0), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(NULL, funcs, args, N), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, NULL, args, N), FOSSIL_THREADS_EINVAL);
+    funcs[N / 2] = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, funcs, args, N), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_pool_pending(pool), 0);
+
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_submit_batch_from_workers) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    for (int s = 0; s < 3; ++s) {
+        fossil_threads_pool_options_t opts;
+        fossil_threads_pool_options_init(&opts);
+        opts.num_threads = 3;
+        opts.scheduler = schedulers[s];
+        opts.deque_capacity = 4;  /* batches overflow the deque */
+        opts.queue_capacity = 8;  /* and do not always fit the ring */
+
+        fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+        ASSUME_ITS_TRUE(pool != NULL);
+        pool_counter_t c;
+        pool_counter_init(&c, pool, 12);
+
+        for (int i = 0; i < 20; ++i)
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_batch, &c), FOSSIL_THREADS_OK);
+
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 20 * 13);
+        fossil_threads_pool_destroy(pool);
+        fossil_threads_mutex_dispose(&c.lock);
+    }
+}
+
+FOSSIL_TEST(c_pool_submit_batch_bounded_fail_is_all_or_nothing) {
+    pool_gate_t g;
+    fossil_threads_pool_t *pool = pool_create_blocked_bounded(&g, FOSSIL_THREADS_POOL_FULL_FAIL);
+    ASSUME_ITS_TRUE(pool != NULL);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    fossil_threads_thread_func funcs[3] = { pool_task_increment, pool_task_increment, pool_task_increment };
+    void *args[3] = { &c, &c, &c };
+
+    /* Three tasks never fit a two-slot ring; two do. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, funcs, args, 3), FOSSIL_THREADS_EBUSY);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_pool_pending(pool), 1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_batch(pool, funcs, args, 2), FOSSIL_THREADS_OK);
+
+    pool_gate_set(&g, &g.released);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 2);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+    fossil_threads_mutex_dispose(&g.lock);
+}
+
+/* ---------- Futures ---------- */
+
+static void *pool_task_double(void *arg) {
+    return (void *)((uintptr_t)arg * 2);
+}
+
+static void *pool_then_add(void *ctx, void *result) {
+    return (void *)((uintptr_t)result + (uintptr_t)ctx);
+}
+
+/* Waits on a child future from inside a worker of the same pool. */
+static void *pool_task_wait_child(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    fossil_threads_pool_future_t *child = NULL;
+    void *result = NULL;
+    if (fossil_threads_pool_submit_future(c->pool, pool_task_double, (void *)(uintptr_t)21, &child) != FOSSIL_THREADS_OK)
+        return NULL;
+    fossil_threads_pool_future_wait(child, &result);
+    fossil_threads_pool_future_release(child);
+    return result;
+}
+
+FOSSIL_TEST(c_pool_future_wait_returns_result) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    fossil_threads_pool_future_t *f = NULL;
+    void *result = NULL;
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_future(pool, pool_task_double, (void *)(uintptr_t)21, &f),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(f != NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 42);
+
+    /* Results stay readable until release. */
+    result = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_try_get(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 42);
+    fossil_threads_pool_future_release(f);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_future(pool, NULL, NULL, &f), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_future(pool, pool_task_double, NULL, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(NULL, &result), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_try_get(NULL, &result), FOSSIL_THREADS_EINVAL);
+    fossil_threads_pool_future_release(NULL);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_future_try_get_pending) {
+    pool_gate_t g;
+    fossil_threads_pool_t *pool = pool_create_blocked_bounded(&g, FOSSIL_THREADS_POOL_FULL_BLOCK);
+    ASSUME_ITS_TRUE(pool != NULL);
+    fossil_threads_pool_future_t *f = NULL;
+    void *result = NULL;
+
+    fossil_threads_pool_submit_future(pool, pool_task_double, (void *)(uintptr_t)5, &f);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_try_get(f, &result), FOSSIL_THREADS_EBUSY);
+
+    pool_gate_set(&g, &g.released);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 10);
+    fossil_threads_pool_future_release(f);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&g.lock);
+}
+
+FOSSIL_TEST(c_pool_future_then_chains) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(3);
+    fossil_threads_pool_future_t *f = NULL;
+    fossil_threads_pool_future_t *g = NULL;
+    fossil_threads_pool_future_t *h = NULL;
+    void *result = NULL;
+
+    /* 21 * 2 → + 1 → + 100, releasing each handle as soon as it is chained. */
+    fossil_threads_pool_submit_future(pool, pool_task_double, (void *)(uintptr_t)21, &f);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_then(f, pool_then_add, (void *)(uintptr_t)1, &g), FOSSIL_THREADS_OK);
+    fossil_threads_pool_future_release(f);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_then(g, pool_then_add, (void *)(uintptr_t)100, &h), FOSSIL_THREADS_OK);
+    fossil_threads_pool_future_release(g);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(h, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 143);
+
+    /* Chaining onto a finished future queues the continuation right away. */
+    fossil_threads_pool_future_t *k = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_then(h, pool_then_add, (void *)(uintptr_t)7, &k), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(k, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 150);
+    fossil_threads_pool_future_release(h);
+    fossil_threads_pool_future_release(k);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_then(NULL, pool_then_add, NULL, &k), FOSSIL_THREADS_EINVAL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_future_storage_is_recycled) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.future_slab_size = 4; /* far fewer states than futures created */
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    fossil_threads_pool_future_t *fs[16];
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 16; ++i)
+            fossil_threads_pool_submit_future(pool, pool_task_double, (void *)(uintptr_t)i, &fs[i]);
+        for (int i = 0; i < 16; ++i) {
+            void *result = NULL;
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(fs[i], &result), FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, i * 2);
+            fossil_threads_pool_future_release(fs[i]);
+        }
+    }
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_future_wait_from_worker_helps) {
+    /* One worker: the child can only run if the waiting task runs it. */
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+    fossil_threads_pool_future_t *f = NULL;
+    void *result = NULL;
+
+    fossil_threads_pool_submit_future(pool, pool_task_wait_child, &c, &f);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(f, &result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)result, 42);
+    fossil_threads_pool_future_release(f);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* Holds the pool's only worker until destroy has stopped the pool. */
+static void *pool_task_hold_until_stopped(void *arg) {
+    fossil_threads_pool_t *pool = (fossil_threads_pool_t *)arg;
+    while (fossil_threads_pool_resize(pool, 1) != FOSSIL_THREADS_ECANCELLED)
+        fossil_threads_thread_sleep_ms(1);
+    return NULL;
+}
+
+static void *pool_then_count(void *ctx, void *result) {
+    (void)result;
+    return pool_task_increment(ctx);
+}
+
+typedef struct {
+    fossil_threads_pool_future_t *future;
+    int rc;
+} pool_future_waiter_t;
+
+static void *pool_thread_future_wait(void *arg) {
+    pool_future_waiter_t *w = (pool_future_waiter_t *)arg;
+    w->rc = fossil_threads_pool_future_wait(w->future, NULL);
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_destroy_cancels_queued_futures) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.future_slab_size = 4;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    /* f stays queued behind the held worker until destroy discards it. */
+    fossil_threads_pool_future_t *f = NULL;
+    fossil_threads_pool_future_t *g = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_hold_until_stopped, pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_future(pool, pool_task_double, (void *)(uintptr_t)1, &f),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_then(f, pool_then_count, &c, &g), FOSSIL_THREADS_OK);
+
+    pool_future_waiter_t w = { f, -1 };
+    fossil_threads_thread_t waiter;
+    fossil_threads_thread_init(&waiter);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&waiter, pool_thread_future_wait, &w), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&waiter, NULL), FOSSIL_THREADS_OK);
+    fossil_threads_thread_dispose(&waiter);
+
+    /* Waiter woken, continuation cancelled unrun, handles still usable. */
+    ASSUME_ITS_EQUAL_I32(w.rc, FOSSIL_THREADS_ECANCELLED);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_try_get(f, NULL), FOSSIL_THREADS_ECANCELLED);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_future_wait(g, NULL), FOSSIL_THREADS_ECANCELLED);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 0);
+    fossil_threads_pool_future_release(f);
+    fossil_threads_pool_future_release(g);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* ---------- Parallel loops ---------- */
+
+#define POOL_LOOP_N 10000
+
+static void pool_loop_mark(size_t begin, size_t end, void *ctx) {
+    int *hits = (int *)ctx;
+    for (size_t i = begin; i < end; ++i)
+        hits[i]++;
+}
+
+static void pool_loop_sum(size_t begin, size_t end, void *acc, void *ctx) {
+    (void)ctx;
+    long long *sum = (long long *)acc;
+    for (size_t i = begin; i < end; ++i)
+        *sum += (long long)i;
+}
+
+static void pool_loop_combine(void *acc, const void *other, void *ctx) {
+    (void)ctx;
+    *(long long *)acc += *(const long long *)other;
+}
+
+static int pool_loop_all_hit_once(const int *hits, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (hits[i] != 1) return 0;
+    }
+    return 1;
+}
+
+/* Runs a parallel_for from inside a pool task. */
+static void *pool_task_nested_loop(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    static int hits[POOL_LOOP_N];
+    memset(hits, 0, sizeof(hits));
+    if (fossil_threads_parallel_for(c->pool, 0, POOL_LOOP_N, 16, pool_loop_mark, hits) == FOSSIL_THREADS_OK &&
+        pool_loop_all_hit_once(hits, POOL_LOOP_N))
+        pool_task_increment(arg);
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_parallel_for_covers_range) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    static const size_t grains[] = { 0, 1, 7, 256, POOL_LOOP_N * 2 };
+    static int hits[POOL_LOOP_N];
+
+    for (int s = 0; s < 3; ++s) {
+        fossil_threads_pool_options_t opts;
+        fossil_threads_pool_options_init(&opts);
+        opts.num_threads = 4;
+        opts.scheduler = schedulers[s];
+        fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+        ASSUME_ITS_TRUE(pool != NULL);
+
+        for (int g = 0; g < 5; ++g) {
+            memset(hits, 0, sizeof(hits));
+            ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(pool, 0, POOL_LOOP_N, grains[g], pool_loop_mark, hits),
+                                 FOSSIL_THREADS_OK);
+            ASSUME_ITS_TRUE(pool_loop_all_hit_once(hits, POOL_LOOP_N));
+        }
+
+        /* Sub-range leaves everything outside it untouched. */
+        memset(hits, 0, sizeof(hits));
+        fossil_threads_parallel_for(pool, 100, 200, 3, pool_loop_mark, hits);
+        ASSUME_ITS_EQUAL_I32(hits[99], 0);
+        ASSUME_ITS_EQUAL_I32(hits[100], 1);
+        ASSUME_ITS_EQUAL_I32(hits[199], 1);
+        ASSUME_ITS_EQUAL_I32(hits[200], 0);
+
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        fossil_threads_pool_destroy(pool);
+    }
+}
+
+FOSSIL_TEST(c_pool_parallel_for_edge_cases) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    int hits[4] = { 0, 0, 0, 0 };
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(pool, 3, 3, 1, pool_loop_mark, hits), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(pool, 3, 1, 1, pool_loop_mark, hits), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(hits[1] + hits[2] + hits[3], 0);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(NULL, 0, 4, 1, pool_loop_mark, hits), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(pool, 0, 4, 1, NULL, hits), FOSSIL_THREADS_EINVAL);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_parallel_for_without_free_workers) {
+    /* The only worker and the ring are occupied: the caller does it all. */
+    pool_gate_t g;
+    fossil_threads_pool_t *pool = pool_create_blocked_bounded(&g, FOSSIL_THREADS_POOL_FULL_FAIL);
+    ASSUME_ITS_TRUE(pool != NULL);
+    fossil_threads_pool_submit(pool, pool_task_hold_gate, &g);
+    fossil_threads_pool_submit(pool, pool_task_hold_gate, &g);
+
+    static int hits[POOL_LOOP_N];
+    memset(hits, 0, sizeof(hits));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_for(pool, 0, POOL_LOOP_N, 64, pool_loop_mark, hits),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(pool_loop_all_hit_once(hits, POOL_LOOP_N));
+
+    pool_gate_set(&g, &g.released);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&g.lock);
+}
+
+FOSSIL_TEST(c_pool_parallel_for_from_worker) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    fossil_threads_pool_submit(pool, pool_task_nested_loop, &c);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 1);
+
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* Holds a worker until released; entered counts the workers it occupies. */
+typedef struct {
+    fossil_threads_latch_t entered;
+    fossil_threads_latch_t release;
+} pool_hold_t;
+
+static void *pool_task_hold_latch(void *arg) {
+    pool_hold_t *h = (pool_hold_t *)arg;
+    fossil_threads_latch_count_down(&h->entered, 1);
+    fossil_threads_latch_wait(&h->release);
+    return NULL;
+}
+
+#define POOL_TEARDOWN_N 64
+#define POOL_TEARDOWN_ROUNDS 200
+
+typedef struct {
+    fossil_threads_pool_t *pool;
+    fossil_threads_latch_t started;
+    int rounds_ok;
+} pool_teardown_t;
+
+/* Keeps issuing parallel_for calls; some of them race with destroy. */
+static void *pool_task_parallel_until_destroyed(void *arg) {
+    pool_teardown_t *t = (pool_teardown_t *)arg;
+    int hits[POOL_TEARDOWN_N];
+    for (int r = 0; r < POOL_TEARDOWN_ROUNDS; ++r) {
+        memset(hits, 0, sizeof(hits));
+        if (r == 1) fossil_threads_latch_count_down(&t->started, 1);
+        if (fossil_threads_parallel_for(t->pool, 0, POOL_TEARDOWN_N, 1, pool_loop_mark, hits) == FOSSIL_THREADS_OK &&
+            pool_loop_all_hit_once(hits, POOL_TEARDOWN_N))
+            t->rounds_ok++;
+    }
+    return NULL;
+}
+
+static void *pool_thread_parallel_once(void *arg) {
+    pool_teardown_t *t = (pool_teardown_t *)arg;
+    int hits[POOL_TEARDOWN_N];
+    memset(hits, 0, sizeof(hits));
+    if (fossil_threads_parallel_for(t->pool, 0, POOL_TEARDOWN_N, 1, pool_loop_mark, hits) == FOSSIL_THREADS_OK &&
+        pool_loop_all_hit_once(hits, POOL_TEARDOWN_N))
+        t->rounds_ok++;
+    return NULL;
+}
+
+static void *pool_thread_destroy(void *arg) {
+    fossil_threads_pool_destroy((fossil_threads_pool_t *)arg);
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_parallel_for_during_destroy) {
+    /* From a worker: a small deque sends part of each helper chain to the
+     * shared queue, where shutdown can cancel it after the rest is queued. */
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 4;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    opts.deque_capacity = 2;
+    pool_teardown_t t;
+    t.pool = fossil_threads_pool_create_ex(&opts);
+    t.rounds_ok = 0;
+    ASSUME_ITS_TRUE(t.pool != NULL);
+    fossil_threads_latch_init(&t.started, 1, 0);
+    fossil_threads_pool_submit(t.pool, pool_task_parallel_until_destroyed, &t);
+    fossil_threads_latch_wait(&t.started);
+    fossil_threads_pool_destroy(t.pool);
+    ASSUME_ITS_EQUAL_I32(t.rounds_ok, POOL_TEARDOWN_ROUNDS);
+
+    /* Deterministic partial enqueue: both workers held, one ring slot
+     * free, so the caller queues one of its two helpers and blocks on the
+     * other until destroy cancels it. The queued helper runs after the
+     * call returned and must still find its state alive. */
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.queue_capacity = 2;
+    opts.full_policy = FOSSIL_THREADS_POOL_FULL_BLOCK;
+    t.pool = fossil_threads_pool_create_ex(&opts);
+    t.rounds_ok = 0;
+    ASSUME_ITS_TRUE(t.pool != NULL);
+    pool_hold_t h;
+    fossil_threads_latch_init(&h.entered, 2, 0);
+    fossil_threads_latch_init(&h.release, 1, 0);
+    fossil_threads_pool_submit(t.pool, pool_task_hold_latch, &h);
+    fossil_threads_pool_submit(t.pool, pool_task_hold_latch, &h);
+    fossil_threads_latch_wait(&h.entered);
+    fossil_threads_pool_submit(t.pool, pool_task_hold_latch, &h);
+
+    fossil_threads_thread_t caller, destroyer;
+    fossil_threads_thread_init(&caller);
+    fossil_threads_thread_init(&destroyer);
+    fossil_threads_thread_create(&caller, pool_thread_parallel_once, &t);
+    fossil_threads_thread_sleep_ms(20);
+    fossil_threads_thread_create(&destroyer, pool_thread_destroy, t.pool);
+    fossil_threads_thread_sleep_ms(20);
+    fossil_threads_latch_count_down(&h.release, 1);
+    fossil_threads_thread_join(&caller, NULL);
+    fossil_threads_thread_join(&destroyer, NULL);
+    fossil_threads_thread_dispose(&caller);
+    fossil_threads_thread_dispose(&destroyer);
+    ASSUME_ITS_EQUAL_I32(t.rounds_ok, 1);
+}
+
+FOSSIL_TEST(c_pool_parallel_reduce_sum) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(4);
+    long long identity = 0;
+    long long sum = -1;
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_reduce(pool, 0, POOL_LOOP_N, 10, &sum, &identity, sizeof(sum),
+                                                        pool_loop_sum, pool_loop_combine, NULL),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(sum == (long long)POOL_LOOP_N * (POOL_LOOP_N - 1) / 2);
+
+    /* Empty range yields the identity; one chunk runs inline. */
+    sum = -1;
+    fossil_threads_parallel_reduce(pool, 5, 5, 1, &sum, &identity, sizeof(sum), pool_loop_sum, pool_loop_combine, NULL);
+    ASSUME_ITS_TRUE(sum == 0);
+    fossil_threads_parallel_reduce(pool, 0, 10, 100, &sum, &identity, sizeof(sum), pool_loop_sum, pool_loop_combine, NULL);
+    ASSUME_ITS_TRUE(sum == 45);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_reduce(pool, 0, 10, 1, &sum, &identity, 0,
+                                                        pool_loop_sum, pool_loop_combine, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_parallel_reduce(pool, 0, 10, 1, &sum, &identity, sizeof(sum),
+                                                        pool_loop_sum, NULL, NULL),
+                         FOSSIL_THREADS_EINVAL);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+/* ---------- Completion ---------- */
+
+static void *pool_task_sleep_then_increment(void *arg) {
+    fossil_threads_thread_sleep_ms(30);
+    return pool_task_increment(arg);
+}
+
+static void *pool_task_wait_on_own_pool(void *arg) {
+    pool_counter_t *c = (pool_counter_t *)arg;
+    if (fossil_threads_pool_wait(c->pool) == FOSSIL_THREADS_EDEADLK)
+        pool_task_increment(arg);
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_wait_covers_running_tasks) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    /* Both tasks are dequeued almost immediately; wait must still block
+     * until they have finished running. */
+    fossil_threads_pool_submit(pool, pool_task_sleep_then_increment, &c);
+    fossil_threads_pool_submit(pool, pool_task_sleep_then_increment, &c);
+    ASSUME_ITS_TRUE(fossil_threads_pool_pending(pool) <= 2);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 2);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_pool_pending(pool), 0);
+
+    /* Waiting on an idle pool returns immediately, repeatedly. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_wait_from_worker_is_rejected) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    fossil_threads_pool_submit(pool, pool_task_wait_on_own_pool, &c);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 1);
+
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* ---------- Task storage ---------- */
+
+FOSSIL_TEST(c_pool_slab_exhaustion_falls_back) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.task_slab_size = 4; /* far fewer nodes than tasks in flight */
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    for (int i = 0; i < 200; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c), FOSSIL_THREADS_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 200);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_slab_disabled) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    opts.task_slab_size = 0;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 3);
+
+    for (int i = 0; i < 20; ++i)
+        fossil_threads_pool_submit(pool, pool_task_spawn_children, &c);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 20 * 4);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+FOSSIL_TEST(c_pool_submit_intrusive_task) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(3);
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+
+    pool_job_t jobs[32];
+    for (int i = 0; i < 32; ++i) {
+        jobs[i].counter = &c;
+        jobs[i].value = i + 1;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_task(pool, &jobs[i].node, pool_job_run, &jobs[i]),
+                             FOSSIL_THREADS_OK);
+    }
+
+    /* sum of 1..32 */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 528);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_task(pool, NULL, pool_job_run, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_task(pool, &jobs[0].node, NULL, NULL), FOSSIL_THREADS_EINVAL);
+
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&c.lock);
+}
+
+/* ---------- Placement ---------- */
+
+static void *pool_task_record_cpu(void *arg) {
+    *(int *)arg = fossil_threads_cpu_current();
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_placement_core_pins_workers) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.placement = FOSSIL_THREADS_POOL_PLACE_CORE;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    /* The only worker sits on the first usable CPU. */
+    unsigned int first = 0;
+    int seen = -1;
+    fossil_threads_numa_node_cpus(0, &first, 1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_record_cpu, &seen), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    if (seen >= 0)
+        ASSUME_ITS_EQUAL_I32(seen, (int)first);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_placement_runs_all_schedulers) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    for (int p = FOSSIL_THREADS_POOL_PLACE_CORE; p <= FOSSIL_THREADS_POOL_PLACE_NODE; ++p) {
+        for (size_t s = 0; s < sizeof(schedulers) / sizeof(schedulers[0]); ++s) {
+            fossil_threads_pool_options_t opts;
+            fossil_threads_pool_options_init(&opts);
+            opts.num_threads = 4;
+            opts.scheduler = schedulers[s];
+            opts.placement = p;
+            opts.task_slab_size = 64; /* small: slab segments recycle and run dry */
+
+            fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+            ASSUME_ITS_TRUE(pool != NULL);
+
+            pool_counter_t c;
+            pool_counter_init(&c, pool, 8);
+            for (int i = 0; i < 40; ++i)
+                ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c),
+                                     FOSSIL_THREADS_OK);
+
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 40 * 9);
+            fossil_threads_pool_destroy(pool);
+            fossil_threads_mutex_dispose(&c.lock);
+        }
+    }
+}
+
+/* ---------- Statistics ---------- */
+
+FOSSIL_TEST(c_pool_stats_count_every_task) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    for (size_t s = 0; s < sizeof(schedulers) / sizeof(schedulers[0]); ++s) {
+        fossil_threads_pool_options_t opts;
+        fossil_threads_pool_options_init(&opts);
+        opts.num_threads = 3;
+        opts.scheduler = schedulers[s];
+        opts.queue_capacity = 16; /* small: nested submits run inline when full */
+        opts.stats = 1;
+
+        fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+        ASSUME_ITS_TRUE(pool != NULL);
+
+        pool_counter_t c;
+        pool_counter_init(&c, pool, 8);
+        for (int i = 0; i < 40; ++i)
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c),
+                                 FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 40 * 9);
+
+        fossil_threads_pool_stats_t st;
+        fossil_threads_pool_worker_stats_t per[3];
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, per, 3), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(st.enabled, 1);
+        ASSUME_ITS_TRUE(st.num_workers == 3);
+        ASSUME_ITS_TRUE(st.pending == 0);
+        ASSUME_ITS_TRUE(st.total.tasks_executed == 40 * 9);
+        ASSUME_ITS_TRUE(st.total.busy_ns > 0);
+        ASSUME_ITS_TRUE(st.uptime_ns > 0);
+        ASSUME_ITS_TRUE(st.queue_high_water >= 1);
+        if (schedulers[s] == FOSSIL_THREADS_POOL_SCHED_WORK_STEALING)
+            ASSUME_ITS_TRUE(st.total.deque_high_water >= 1);
+
+        unsigned long long tasks = 0, steals = 0;
+        for (int i = 0; i < 3; ++i) {
+            tasks += per[i].tasks_executed;
+            steals += per[i].steals;
+        }
+        ASSUME_ITS_TRUE(tasks == st.total.tasks_executed);
+        ASSUME_ITS_TRUE(steals == st.total.steals);
+
+        fossil_threads_pool_destroy(pool);
+        fossil_threads_mutex_dispose(&c.lock);
+    }
+}
+
+FOSSIL_TEST(c_pool_stats_disabled_reads_zero) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    int hits = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_record_cpu, &hits), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+
+    fossil_threads_pool_stats_t st;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, NULL, 0), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(st.enabled, 0);
+    ASSUME_ITS_TRUE(st.num_workers == 2);
+    ASSUME_ITS_TRUE(st.total.tasks_executed == 0);
+    ASSUME_ITS_TRUE(st.queue_high_water == 0);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(NULL, &st, NULL, 0), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, NULL, NULL, 0), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, NULL, 2), FOSSIL_THREADS_EINVAL);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_idle_spin_policy) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    for (size_t s = 0; s < sizeof(schedulers) / sizeof(schedulers[0]); ++s) {
+        fossil_threads_pool_options_t opts;
+        fossil_threads_pool_options_init(&opts);
+        ASSUME_ITS_TRUE(opts.idle_spin_us == 0 && opts.idle_yield_us == 0);
+        opts.num_threads = 2;
+        opts.scheduler = schedulers[s];
+        opts.queue_capacity = 16;
+        opts.stats = 1;
+        opts.idle_spin_us = 2000;
+        opts.idle_yield_us = 20000;
+
+        fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+        ASSUME_ITS_TRUE(pool != NULL);
+
+        /* A burst ramps workers up one wake at a time and still runs everything. */
+        pool_counter_t c;
+        pool_counter_init(&c, pool, 8);
+        for (int i = 0; i < 40; ++i)
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c),
+                                 FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 40 * 9);
+
+        /* Tasks trickling into an idle pool meet a worker that is still polling. */
+        for (int i = 0; i < 20; ++i) {
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c),
+                                 FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        }
+        ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 40 * 9 + 20);
+
+        fossil_threads_pool_stats_t st;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, NULL, 0), FOSSIL_THREADS_OK);
+        ASSUME_ITS_TRUE(st.total.tasks_executed == 40 * 9 + 20);
+        ASSUME_ITS_TRUE(st.total.spin_hits <= st.total.tasks_executed);
+
+        /* Destroy finds the workers polling and still stops them. */
+        fossil_threads_pool_destroy(pool);
+
+        /* A polling window longer than the test: the worker finds every
+         * task without ever parking. */
+        opts.num_threads = 1;
+        opts.idle_spin_us = 0;
+        opts.idle_yield_us = 60u * 1000u * 1000u;
+        pool = fossil_threads_pool_create_ex(&opts);
+        ASSUME_ITS_TRUE(pool != NULL);
+        for (int i = 0; i < 20; ++i) {
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c),
+                                 FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+        }
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, NULL, 0), FOSSIL_THREADS_OK);
+        ASSUME_ITS_TRUE(st.total.tasks_executed == 20);
+        ASSUME_ITS_TRUE(st.total.wakeups == 0 && st.total.idle_ns == 0);
+        fossil_threads_pool_destroy(pool);
+        fossil_threads_mutex_dispose(&c.lock);
+    }
+}
+
+/* ---------- Elastic sizing ---------- */
+
+/* Poll until the pool runs n workers; retirement is asynchronous. */
+static int pool_wait_for_size(fossil_threads_pool_t *pool, size_t n) {
+    for (int i = 0; i < 2000 && fossil_threads_pool_size(pool) != n; ++i)
+        fossil_threads_thread_sleep_ms(1);
+    return fossil_threads_pool_size(pool) == n;
+}
+
+FOSSIL_TEST(c_pool_resize_grows_and_shrinks) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.max_threads = 4;
+    opts.grow_latency_us = 0;
+    opts.keep_alive_ms = 0;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    opts.stats = 1;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) == 2);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 0), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 5), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(NULL, 1), FOSSIL_THREADS_EINVAL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 4), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) == 4);
+
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 4);
+    for (int i = 0; i < 20; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c),
+                             FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 20 * 5);
+
+    /* Shrink, then grow back into the retired slots. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 1), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(pool_wait_for_size(pool, 1));
+    for (int i = 0; i < 20; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_spawn_children, &c),
+                             FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 40 * 5);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 3), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) == 3);
+
+    /* Retired slots keep their counters. */
+    fossil_threads_pool_stats_t st;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_stats(pool, &st, NULL, 0), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(st.num_workers == 4);
+    ASSUME_ITS_TRUE(st.active_workers == 3);
+    ASSUME_ITS_TRUE(st.total.tasks_executed == 40 * 5);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_idle_workers_retire) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 4;
+    opts.min_threads = 1;
+    opts.keep_alive_ms = 10;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) == 4);
+    ASSUME_ITS_TRUE(pool_wait_for_size(pool, 1));
+
+    /* The survivor still serves work; destroy joins the retired threads. */
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+    for (int i = 0; i < 10; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_increment, &c),
+                             FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 10);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) >= 1);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_grows_when_tasks_wait) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.max_threads = 3;
+    opts.grow_latency_us = 1000;
+
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    /* Queued behind 30 ms tasks, each waits far past the 1 ms latency. */
+    pool_counter_t c;
+    pool_counter_init(&c, pool, 0);
+    for (int i = 0; i < 6; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool, pool_task_sleep_then_increment, &c),
+                             FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&c), 6);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) >= 2);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) <= 3);
+
+    fossil_threads_pool_destroy(pool);
+}
+
+FOSSIL_TEST(c_pool_elastic_invalid_bounds) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.min_threads = 3;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+    opts.min_threads = 0;
+    opts.max_threads = 1;
+    ASSUME_ITS_TRUE(fossil_threads_pool_create_ex(&opts) == NULL);
+
+    /* A fixed pool can shrink and grow back within its size. */
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(2);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 3), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 1), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(pool_wait_for_size(pool, 1));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool, 2), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool) == 2);
+    fossil_threads_pool_destroy(pool);
+}
+
+/* ---------- Priorities and deadlines ---------- */
+
+/* Records the order in which tagged tasks run behind a gate task that
+ * holds the only worker until every tagged task is queued. */
+typedef struct {
+    fossil_threads_mutex_t lock;
+    fossil_threads_mutex_t gate;
+    int gate_started;
+    int order[32];
+    int count;
+} pool_order_t;
+
+typedef struct {
+    pool_order_t *log;
+    int tag;
+} pool_tagged_t;
+
+static void *pool_task_gate(void *arg) {
+    pool_order_t *log = (pool_order_t *)arg;
+    fossil_threads_mutex_lock(&log->lock);
+    log->gate_started = 1;
+    fossil_threads_mutex_unlock(&log->lock);
+    fossil_threads_mutex_lock(&log->gate);
+    fossil_threads_mutex_unlock(&log->gate);
+    return NULL;
+}
+
+static void *pool_task_record(void *arg) {
+    pool_tagged_t *t = (pool_tagged_t *)arg;
+    fossil_threads_mutex_lock(&t->log->lock);
+    t->log->order[t->log->count++] = t->tag;
+    fossil_threads_mutex_unlock(&t->log->lock);
+    return NULL;
+}
+
+static fossil_threads_pool_t *pool_order_start(pool_order_t *log, int scheduler, unsigned int aging) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.scheduler = scheduler;
+    opts.aging_limit = aging;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    fossil_threads_mutex_init(&log->lock);
+    fossil_threads_mutex_init(&log->gate);
+    log->gate_started = 0;
+    log->count = 0;
+    fossil_threads_mutex_lock(&log->gate);
+    fossil_threads_pool_submit(pool, pool_task_gate, log);
+    for (int started = 0; !started; fossil_threads_thread_sleep_ms(1)) {
+        fossil_threads_mutex_lock(&log->lock);
+        started = log->gate_started;
+        fossil_threads_mutex_unlock(&log->lock);
+    }
+    return pool;
+}
+
+static void pool_order_finish(pool_order_t *log, fossil_threads_pool_t *pool) {
+    fossil_threads_mutex_unlock(&log->gate);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_destroy(pool);
+    fossil_threads_mutex_dispose(&log->gate);
+    fossil_threads_mutex_dispose(&log->lock);
+}
+
+FOSSIL_TEST(c_pool_priority_and_deadline_order) {
+    static const int schedulers[] = {
+        FOSSIL_THREADS_POOL_SCHED_SHARED,
+        FOSSIL_THREADS_POOL_SCHED_WORK_STEALING,
+        FOSSIL_THREADS_POOL_SCHED_BOUNDED
+    };
+    for (size_t s = 0; s < sizeof(schedulers) / sizeof(schedulers[0]); ++s) {
+        pool_order_t log;
+        pool_tagged_t tasks[12];
+        fossil_threads_pool_t *pool = pool_order_start(&log, schedulers[s], 0);
+        ASSUME_ITS_TRUE(pool != NULL);
+
+        /* Tags give the expected order: deadlines (submitted latest
+         * first), then HIGH, NORMAL and LOW, FIFO within a class. */
+        long long now = fossil_threads_clock_monotonic_ns();
+        for (int i = 0; i < 12; ++i) {
+            tasks[i].log = &log;
+            tasks[i].tag = i;
+        }
+        for (int i = 0; i < 3; ++i) {
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_record, &tasks[9 + i],
+                                 FOSSIL_THREADS_POOL_PRIORITY_LOW), FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_record, &tasks[6 + i],
+                                 FOSSIL_THREADS_POOL_PRIORITY_NORMAL), FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_record, &tasks[3 + i],
+                                 FOSSIL_THREADS_POOL_PRIORITY_HIGH), FOSSIL_THREADS_OK);
+            ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_deadline(pool, pool_task_record, &tasks[2 - i],
+                                 now + (2 - i) * 1000000LL), FOSSIL_THREADS_OK);
+        }
+        pool_order_finish(&log, pool);
+
+        ASSUME_ITS_EQUAL_I32(log.count, 12);
+        for (int i = 0; i < 12; ++i)
+            ASSUME_ITS_EQUAL_I32(log.order[i], i);
+    }
+}
+
+FOSSIL_TEST(c_pool_priority_aging_serves_low) {
+    pool_order_t log;
+    pool_tagged_t tasks[7];
+    fossil_threads_pool_t *pool = pool_order_start(&log, FOSSIL_THREADS_POOL_SCHED_SHARED, 2);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    /* One LOW task behind six HIGH ones runs once passed over twice. */
+    for (int i = 0; i < 7; ++i) {
+        tasks[i].log = &log;
+        tasks[i].tag = i;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_record, &tasks[i],
+                             i == 0 ? FOSSIL_THREADS_POOL_PRIORITY_LOW
+                                    : FOSSIL_THREADS_POOL_PRIORITY_HIGH), FOSSIL_THREADS_OK);
+    }
+    pool_order_finish(&log, pool);
+
+    ASSUME_ITS_EQUAL_I32(log.count, 7);
+    ASSUME_ITS_EQUAL_I32(log.order[0], 1);
+    ASSUME_ITS_EQUAL_I32(log.order[1], 2);
+    ASSUME_ITS_EQUAL_I32(log.order[2], 0);
+    ASSUME_ITS_EQUAL_I32(log.order[6], 6);
+}
+
+FOSSIL_TEST(c_pool_priority_invalid_args) {
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_increment, NULL, -1),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, pool_task_increment, NULL,
+                                                             FOSSIL_THREADS_POOL_PRIORITY_COUNT),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_priority(pool, NULL, NULL,
+                                                             FOSSIL_THREADS_POOL_PRIORITY_HIGH),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit_deadline(NULL, pool_task_increment, NULL, 0),
+                         FOSSIL_THREADS_EINVAL);
+    fossil_threads_pool_destroy(pool);
+}
+
+/* ---------- Worker-local storage ---------- */
+
+/* Folded in by the destructor of each worker's slot. */
+static pool_counter_t pool_local_totals;
+static int pool_local_destroyed;
+
+typedef struct {
+    int tasks;
+} pool_local_t;
+
+static void *pool_task_local(void *arg) {
+    (void)arg;
+    void **slot = fossil_threads_pool_worker_local();
+    if (!slot) return NULL;
+    if (!*slot) *slot = calloc(1, sizeof(pool_local_t));
+    ((pool_local_t *)*slot)->tasks++;
+    return NULL;
+}
+
+static void pool_local_destroy(void *local) {
+    fossil_threads_mutex_lock(&pool_local_totals.lock);
+    pool_local_totals.count += ((pool_local_t *)local)->tasks;
+    pool_local_destroyed++;
+    fossil_threads_mutex_unlock(&pool_local_totals.lock);
+    free(local);
+}
+
+FOSSIL_TEST(c_pool_worker_local_slot) {
+    ASSUME_ITS_TRUE(fossil_threads_pool_worker_local() == NULL);
+
+    pool_counter_init(&pool_local_totals, NULL, 0);
+    pool_local_destroyed = 0;
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    ASSUME_ITS_TRUE(opts.local_destructor == NULL);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    opts.local_destructor = pool_local_destroy;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    for (int i = 0; i < 200; ++i)
+        fossil_threads_pool_submit(pool, pool_task_local, NULL);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_destroy(pool);
+
+    /* Every task counted in exactly one worker's slot, each slot destroyed once. */
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&pool_local_totals), 200);
+    ASSUME_ITS_TRUE(pool_local_destroyed >= 1 && pool_local_destroyed <= 2);
+    fossil_threads_mutex_dispose(&pool_local_totals.lock);
+}
+
+/* A retiring worker's destructor uses the pool while the submitter grows
+ * it back into that worker's slot. */
+static fossil_threads_pool_t *pool_respawn_pool;
+static pool_counter_t pool_respawn_entered;
+static pool_counter_t pool_respawn_ran;
+static int pool_respawn_marker;
+
+static void *pool_task_mark_local(void *arg) {
+    (void)arg;
+    void **slot = fossil_threads_pool_worker_local();
+    if (slot) *slot = &pool_respawn_marker;
+    pool_task_increment(&pool_respawn_entered);
+    /* Keep both workers busy so each one marks its slot. */
+    for (int i = 0; i < 2000 && pool_counter_get(&pool_respawn_entered) < 2; ++i)
+        fossil_threads_thread_sleep_ms(1);
+    return NULL;
+}
+
+static void pool_local_submit_late(void *local) {
+    (void)local;
+    fossil_threads_thread_sleep_ms(50);  /* the resize below is joining us by now */
+    (void)fossil_threads_pool_submit(pool_respawn_pool, pool_task_increment, &pool_respawn_ran);
+}
+
+FOSSIL_TEST(c_pool_respawn_while_destructor_uses_pool) {
+    pool_counter_init(&pool_respawn_entered, NULL, 0);
+    pool_counter_init(&pool_respawn_ran, NULL, 0);
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.max_threads = 2;
+    opts.keep_alive_ms = 0;
+    opts.local_destructor = pool_local_submit_late;
+    pool_respawn_pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool_respawn_pool != NULL);
+
+    for (int i = 0; i < 2; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_pool_submit(pool_respawn_pool, pool_task_mark_local, NULL),
+                             FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool_respawn_pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&pool_respawn_entered), 2);
+
+    /* The surplus worker retires into its destructor; growing back must not
+     * join it under the lock its submit needs. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool_respawn_pool, 1), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(pool_wait_for_size(pool_respawn_pool, 1));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_resize(pool_respawn_pool, 2), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_pool_size(pool_respawn_pool) == 2);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_pool_wait(pool_respawn_pool), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&pool_respawn_ran), 1);
+
+    /* Destroy runs the remaining destructor; its submit is refused. */
+    fossil_threads_pool_destroy(pool_respawn_pool);
+    ASSUME_ITS_EQUAL_I32(pool_counter_get(&pool_respawn_ran), 1);
+    fossil_threads_mutex_dispose(&pool_respawn_entered.lock);
+    fossil_threads_mutex_dispose(&pool_respawn_ran.lock);
+}
+
+/* ---------- Task arenas ---------- */
+
+typedef struct {
+    fossil_threads_pool_t *pool;
+    unsigned char *first;   /* first allocation of the outer task */
+    unsigned char *next;    /* first allocation of the task after it */
+    int ok;
+} pool_arena_t;
+
+static void *pool_arena_inner(void *arg) {
+    (void)arg;
+    unsigned char *p = (unsigned char *)fossil_threads_pool_task_alloc(256);
+    if (p) memset(p, 0xBB, 256);
+    return p;
+}
+
+static void *pool_arena_outer(void *arg) {
+    pool_arena_t *a = (pool_arena_t *)arg;
+    unsigned char *p = (unsigned char *)fossil_threads_pool_task_alloc(100);
+    unsigned char *q = (unsigned char *)fossil_threads_pool_task_alloc_aligned(64, 64);
+    unsigned char *big = (unsigned char *)fossil_threads_pool_task_alloc(3 * 4096); /* past arena_size */
+    int ok = p && q && big && (uintptr_t)p % 16 == 0 && (uintptr_t)q % 64 == 0 && q >= p + 100;
+    ok = ok && fossil_threads_pool_task_alloc_aligned(8, 3) == NULL;
+    if (!ok) {
+        a->ok = 0;
+        return NULL;
+    }
+    memset(p, 0xAA, 100);
+    memset(big, 0xCC, 3 * 4096);
+
+    /* Waiting on a one-worker pool runs the inner task nested right here. */
+    fossil_threads_pool_future_t *f = NULL;
+    void *inner = NULL;
+    ok = fossil_threads_pool_submit_future(a->pool, pool_arena_inner, NULL, &f) == FOSSIL_THREADS_OK &&
+         fossil_threads_pool_future_wait(f, &inner) == FOSSIL_THREADS_OK && inner != NULL;
+    fossil_threads_pool_future_release(f);
+    for (int i = 0; ok && i < 100; ++i) ok = p[i] == 0xAA;
+    for (int i = 0; ok && i < 3 * 4096; ++i) ok = big[i] == 0xCC;
+
+    /* The inner task's memory was handed back and is reused... */
+    ok = ok && fossil_threads_pool_task_alloc(256) == inner;
+    /* ...and an explicit reset starts this task over. */
+    fossil_threads_pool_task_reset();
+    a->first = (unsigned char *)fossil_threads_pool_task_alloc(100);
+    a->ok = ok && a->first == p;
+    return NULL;
+}
+
+static void *pool_arena_next(void *arg) {
+    pool_arena_t *a = (pool_arena_t *)arg;
+    a->next = (unsigned char *)fossil_threads_pool_task_alloc(100);
+    return NULL;
+}
+
+static void *pool_arena_huge(void *arg) {
+    int *ok = (int *)arg;
+    unsigned char *p = (unsigned char *)fossil_threads_pool_task_alloc(1u << 20);
+    if (p) memset(p, 0x5A, 1u << 20);
+    *ok = p != NULL && p[(1u << 20) - 1] == 0x5A;
+    return NULL;
+}
+
+FOSSIL_TEST(c_pool_task_arena) {
+    ASSUME_ITS_TRUE(fossil_threads_pool_task_alloc(16) == NULL);
+    fossil_threads_pool_task_reset();
+
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.arena_size = 4096;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+
+    pool_arena_t a = { pool, NULL, NULL, 0 };
+    fossil_threads_pool_submit(pool, pool_arena_outer, &a);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_submit(pool, pool_arena_next, &a);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_destroy(pool);
+    ASSUME_ITS_TRUE(a.ok);
+    /* Rewound at the task boundary: the next task starts where the last one did. */
+    ASSUME_ITS_TRUE(a.next != NULL && a.next == a.first);
+
+    fossil_threads_pool_options_init(&opts);
+    opts.arena_huge_pages = 1;
+    pool = fossil_threads_pool_create_ex(&opts);
+    ASSUME_ITS_TRUE(pool != NULL);
+    int huge_ok = 0;
+    fossil_threads_pool_submit(pool, pool_arena_huge, &huge_ok);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_destroy(pool);
+    ASSUME_ITS_TRUE(huge_ok);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_pool_tests) {
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_create_and_destroy);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_create_ex_invalid_options);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_submit_invalid_args);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_shared_runs_all_tasks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_work_stealing_runs_nested_tasks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_work_stealing_single_worker);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_bounded_runs_all_tasks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_bounded_full_fails);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_bounded_full_runs_on_caller);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_bounded_nested_submit_does_not_block);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_submit_batch_runs_all_tasks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_submit_batch_from_workers);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_submit_batch_bounded_fail_is_all_or_nothing);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_future_wait_returns_result);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_future_try_get_pending);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_future_then_chains);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_future_storage_is_recycled);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_future_wait_from_worker_helps);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_destroy_cancels_queued_futures);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_for_covers_range);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_for_edge_cases);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_for_without_free_workers);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_for_from_worker);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_for_during_destroy);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_parallel_reduce_sum);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_wait_covers_running_tasks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_wait_from_worker_is_rejected);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_slab_exhaustion_falls_back);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_slab_disabled);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_submit_intrusive_task);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_placement_core_pins_workers);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_placement_runs_all_schedulers);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_stats_count_every_task);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_stats_disabled_reads_zero);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_idle_spin_policy);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_resize_grows_and_shrinks);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_idle_workers_retire);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_grows_when_tasks_wait);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_elastic_invalid_bounds);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_priority_and_deadline_order);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_priority_aging_serves_low);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_priority_invalid_args);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_worker_local_slot);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_respawn_while_destructor_uses_pool);
+    FOSSIL_ADD_TEST(c_pool_fixture, c_pool_task_arena);
+
+    FOSSIL_ADD_SUITE(c_pool_fixture);
+} // end of tests
@@ -0,0 +1,374 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <utility>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_pool_fixture);
+
+FOSSIL_SETUP(cpp_pool_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_pool_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using namespace fossil::threads;
+
+static void *cpp_pool_task_increment(void *arg) {
+    static_cast<std::atomic<int> *>(arg)->fetch_add(1);
+    return nullptr;
+}
+
+static void *cpp_pool_task_add_two(void *arg) {
+    static_cast<std::atomic<int> *>(arg)->fetch_add(2);
+    return nullptr;
+}
+
+/* ---------- Lifecycle ---------- */
+
+FOSSIL_TEST(cpp_pool_create_and_move) {
+    Pool pool(2);
+    ASSUME_ITS_EQUAL_I32((int)pool.size(), 2);
+    ASSUME_ITS_EQUAL_I32(pool.scheduler(), FOSSIL_THREADS_POOL_SCHED_SHARED);
+
+    Pool moved(std::move(pool));
+    ASSUME_ITS_TRUE(pool.native_handle() == nullptr);
+    ASSUME_ITS_TRUE(moved.native_handle() != nullptr);
+    ASSUME_ITS_EQUAL_I32((int)moved.size(), 2);
+}
+
+FOSSIL_TEST(cpp_pool_invalid_options_throw) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 0;
+
+    bool threw = false;
+    try {
+        Pool pool(opts);
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+}
+
+/* ---------- Submission ---------- */
+
+FOSSIL_TEST(cpp_pool_submit_and_wait) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 3;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_WORK_STEALING;
+    Pool pool(opts);
+
+    std::atomic<int> count(0);
+    for (int i = 0; i < 50; ++i)
+        ASSUME_ITS_EQUAL_I32(pool.submit(cpp_pool_task_increment, &count), FOSSIL_THREADS_OK);
+
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(count.load(), 50);
+    ASSUME_ITS_EQUAL_I32((int)pool.pending(), 0);
+}
+
+FOSSIL_TEST(cpp_pool_submit_batch_range_of_args) {
+    Pool pool(4);
+    std::vector<std::atomic<int>> slots(32);
+    std::vector<std::atomic<int> *> args;
+    for (auto &slot : slots) {
+        slot.store(0);
+        args.push_back(&slot);
+    }
+
+    ASSUME_ITS_EQUAL_I32(pool.submit_batch(cpp_pool_task_increment, args), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+    for (auto &slot : slots)
+        ASSUME_ITS_EQUAL_I32(slot.load(), 1);
+}
+
+FOSSIL_TEST(cpp_pool_submit_batch_range_of_pairs) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.scheduler = FOSSIL_THREADS_POOL_SCHED_BOUNDED;
+    opts.queue_capacity = 16;
+    Pool pool(opts);
+
+    std::atomic<int> count(0);
+    std::vector<std::pair<Pool::Func, void *>> tasks;
+    for (int i = 0; i < 10; ++i) {
+        tasks.emplace_back(cpp_pool_task_increment, &count);
+        tasks.emplace_back(cpp_pool_task_add_two, &count);
+    }
+
+    ASSUME_ITS_EQUAL_I32(pool.submit_batch(tasks), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(count.load(), 30);
+
+    std::vector<void *> empty;
+    ASSUME_ITS_EQUAL_I32(pool.submit_batch(cpp_pool_task_increment, empty), FOSSIL_THREADS_OK);
+}
+
+/* ---------- Futures ---------- */
+
+static void *cpp_pool_task_square(void *arg) {
+    uintptr_t v = reinterpret_cast<uintptr_t>(arg);
+    return reinterpret_cast<void *>(v * v);
+}
+
+static void *cpp_pool_then_negate_plus(void *ctx, void *result) {
+    return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(ctx) - reinterpret_cast<uintptr_t>(result));
+}
+
+FOSSIL_TEST(cpp_pool_future_get_and_then) {
+    Pool pool(2);
+    Future f = pool.submit_future(cpp_pool_task_square, reinterpret_cast<void *>(uintptr_t(9)));
+    ASSUME_ITS_TRUE(f.valid());
+
+    Future g = f.then(cpp_pool_then_negate_plus, reinterpret_cast<void *>(uintptr_t(100)));
+    ASSUME_ITS_EQUAL_I32(static_cast<int>(reinterpret_cast<uintptr_t>(f.get())), 81);
+    ASSUME_ITS_EQUAL_I32(static_cast<int>(reinterpret_cast<uintptr_t>(g.get())), 19);
+
+    void *result = nullptr;
+    ASSUME_ITS_EQUAL_I32(g.try_get(&result), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(result == reinterpret_cast<void *>(uintptr_t(19)));
+
+    Future moved(std::move(g));
+    ASSUME_ITS_TRUE(!g.valid());
+    ASSUME_ITS_TRUE(moved.valid());
+
+    bool threw = false;
+    try {
+        Future empty;
+        empty.get();
+    } catch (const std::runtime_error &) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+}
+
+/* ---------- Parallel loops ---------- */
+
+FOSSIL_TEST(cpp_pool_parallel_for_lambdas) {
+    Pool pool(4);
+    std::vector<int> hits(5000, 0);
+
+    ASSUME_ITS_EQUAL_I32(parallel_for(pool, 0, hits.size(), 32, [&](size_t i) { hits[i] += 1; }), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(parallel_for(pool, 0, hits.size(), 32, [&](size_t b, size_t e) {
+        for (size_t i = b; i < e; ++i) hits[i] += 2;
+    }), FOSSIL_THREADS_OK);
+
+    bool all = true;
+    for (int h : hits) all = all && (h == 3);
+    ASSUME_ITS_TRUE(all);
+}
+
+FOSSIL_TEST(cpp_pool_parallel_reduce_lambdas) {
+    Pool pool(3);
+    std::vector<double> values(4096);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = 0.5;
+
+    double sum = parallel_reduce(pool, 0, values.size(), 64, 0.0,
+        [&](size_t b, size_t e, double acc) {
+            for (size_t i = b; i < e; ++i) acc += values[i];
+            return acc;
+        },
+        [](double a, double b) { return a + b; });
+    ASSUME_ITS_TRUE(sum == 2048.0);
+
+    size_t longest = parallel_reduce(pool.native_handle(), 0, 1000, 1, size_t(0),
+        [](size_t, size_t e, size_t acc) { return e - 1 > acc ? e - 1 : acc; },
+        [](size_t a, size_t b) { return a > b ? a : b; });
+    ASSUME_ITS_EQUAL_I32(static_cast<int>(longest), 999);
+}
+
+FOSSIL_TEST(cpp_pool_parallel_body_exceptions_reach_caller) {
+    Pool pool(4);
+    std::atomic<int> calls{0};
+
+    bool caught = false;
+    try {
+        parallel_for(pool, 0, 4096, 16, [&](size_t i) {
+            calls.fetch_add(1);
+            if (i == 100) throw std::runtime_error("body");
+        });
+    } catch (const std::runtime_error &) {
+        caught = true;
+    }
+    ASSUME_ITS_TRUE(caught);
+    ASSUME_ITS_TRUE(calls.load() <= 4096);
+
+    caught = false;
+    try {
+        (void)parallel_reduce(pool, 0, 4096, 16, 0,
+            [](size_t b, size_t e, int acc) {
+                if (b <= 2000 && 2000 < e) throw std::logic_error("reduce");
+                return acc + static_cast<int>(e - b);
+            },
+            [](int a, int b) { return a + b; });
+    } catch (const std::logic_error &) {
+        caught = true;
+    }
+    ASSUME_ITS_TRUE(caught);
+
+    /* The pool is still usable after a throwing loop. */
+    std::vector<int> hits(256, 0);
+    ASSUME_ITS_EQUAL_I32(parallel_for(pool, 0, hits.size(), 8, [&](size_t i) { hits[i] = 1; }), FOSSIL_THREADS_OK);
+    bool all = true;
+    for (int h : hits) all = all && (h == 1);
+    ASSUME_ITS_TRUE(all);
+}
+
+/* ---------- Statistics ---------- */
+
+FOSSIL_TEST(cpp_pool_stats_snapshot) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 2;
+    opts.stats = 1;
+    Pool pool(opts);
+
+    std::atomic<int> count(0);
+    for (int i = 0; i < 30; ++i)
+        ASSUME_ITS_EQUAL_I32(pool.submit(cpp_pool_task_increment, &count), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+
+    std::vector<fossil_threads_pool_worker_stats_t> workers;
+    fossil_threads_pool_stats_t st = pool.stats(&workers);
+    ASSUME_ITS_EQUAL_I32(st.enabled, 1);
+    ASSUME_ITS_EQUAL_I32((int)workers.size(), 2);
+    ASSUME_ITS_TRUE(st.total.tasks_executed == 30);
+    ASSUME_ITS_TRUE(workers[0].tasks_executed + workers[1].tasks_executed == 30);
+}
+
+FOSSIL_TEST(cpp_pool_resize) {
+    fossil_threads_pool_options_t opts;
+    fossil_threads_pool_options_init(&opts);
+    opts.num_threads = 1;
+    opts.max_threads = 3;
+    opts.stats = 1;
+    Pool pool(opts);
+
+    pool.resize(3);
+    ASSUME_ITS_EQUAL_I32((int)pool.size(), 3);
+    bool threw = false;
+    try {
+        pool.resize(4);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+
+    std::vector<fossil_threads_pool_worker_stats_t> workers;
+    fossil_threads_pool_stats_t st = pool.stats(&workers);
+    ASSUME_ITS_EQUAL_I32((int)workers.size(), 3);
+    ASSUME_ITS_EQUAL_I32((int)st.active_workers, 3);
+}
+
+FOSSIL_TEST(cpp_pool_submit_priority_and_deadline) {
+    Pool pool(2);
+    std::atomic<int> count(0);
+    long long now = fossil_threads_clock_monotonic_ns();
+    for (int i = 0; i < 10; ++i) {
+        ASSUME_ITS_EQUAL_I32(pool.submit_priority(cpp_pool_task_increment, &count,
+                                                  FOSSIL_THREADS_POOL_PRIORITY_LOW), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(pool.submit_priority(cpp_pool_task_increment, &count,
+                                                  FOSSIL_THREADS_POOL_PRIORITY_HIGH), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(pool.submit_deadline(cpp_pool_task_increment, &count, now + i),
+                             FOSSIL_THREADS_OK);
+    }
+    ASSUME_ITS_EQUAL_I32(pool.submit_priority(cpp_pool_task_increment, &count, 7),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(count.load(), 30);
+}
+
+/* ---------- Worker memory ---------- */
+
+static void *cpp_pool_task_scratch(void *arg) {
+    auto *bad = static_cast<std::atomic<int> *>(arg);
+    void **slot = Pool::worker_local();
+    auto *v = static_cast<double *>(Pool::task_alloc(32 * sizeof(double), alignof(double)));
+    if (!slot || !v) {
+        bad->fetch_add(1);
+        return nullptr;
+    }
+    for (int i = 0; i < 32; ++i) v[i] = i;
+    Pool::task_reset();
+    if (Pool::task_alloc(sizeof(double), alignof(double)) != v) bad->fetch_add(1);
+    return nullptr;
+}
+
+FOSSIL_TEST(cpp_pool_worker_memory) {
+    ASSUME_ITS_TRUE(Pool::worker_local() == nullptr);
+    ASSUME_ITS_TRUE(Pool::task_alloc(8) == nullptr);
+
+    Pool pool(2);
+    std::atomic<int> bad(0);
+    for (int i = 0; i < 20; ++i)
+        ASSUME_ITS_EQUAL_I32(pool.submit(cpp_pool_task_scratch, &bad), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(pool.wait(), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(bad.load(), 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST_GROUP(cpp_pool_tests) {
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_create_and_move);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_invalid_options_throw);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_submit_and_wait);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_submit_batch_range_of_args);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_submit_batch_range_of_pairs);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_future_get_and_then);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_parallel_for_lambdas);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_parallel_reduce_lambdas);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_parallel_body_exceptions_reach_caller);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_stats_snapshot);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_resize);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_submit_priority_and_deadline);
+    FOSSIL_ADD_TEST(cpp_pool_fixture, cpp_pool_worker_memory);
+
+    FOSSIL_ADD_SUITE(cpp_pool_fixture);
+} // end of tests
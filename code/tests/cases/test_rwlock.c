@@ -0,0 +1,290 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_rwlock_fixture);
+
+FOSSIL_SETUP(c_rwlock_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_rwlock_fixture) {
+    // Teardown the test fixture
+}
+
+#define RWLOCK_THREADS 4
+#define RWLOCK_ITERS   5000
+
+static const int rwlock_policies[] = {
+    FOSSIL_THREADS_RWLOCK_POLICY_NATIVE,
+    FOSSIL_THREADS_RWLOCK_POLICY_PREFER_READER,
+    FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER
+};
+
+typedef struct {
+    fossil_threads_rwlock_t rw;
+    long a;
+    long b;           /* always equal to a outside a write section */
+    int torn;         /* set by a reader that saw a != b */
+    volatile int ret; /* result of a helper thread's lock call */
+} rwlock_shared_t;
+
+static void *rwlock_mixed_worker(void *arg) {
+    rwlock_shared_t *s = (rwlock_shared_t *)arg;
+    for (int i = 0; i < RWLOCK_ITERS; ++i) {
+        if (i % 8 == 0) {
+            fossil_threads_rwlock_wrlock(&s->rw);
+            s->a++;
+            s->b++;
+            fossil_threads_rwlock_unlock(&s->rw);
+        } else {
+            fossil_threads_rwlock_rdlock(&s->rw);
+            if (s->a != s->b) s->torn = 1;
+            fossil_threads_rwlock_unlock(&s->rw);
+        }
+    }
+    return NULL;
+}
+
+static void *rwlock_timed_write(void *arg) {
+    rwlock_shared_t *s = (rwlock_shared_t *)arg;
+    s->ret = fossil_threads_rwlock_timedwrlock(&s->rw, 20);
+    if (s->ret == FOSSIL_THREADS_RWLOCK_OK) fossil_threads_rwlock_unlock(&s->rw);
+    return NULL;
+}
+
+static void *rwlock_timed_read(void *arg) {
+    rwlock_shared_t *s = (rwlock_shared_t *)arg;
+    s->ret = fossil_threads_rwlock_timedrdlock(&s->rw, 20);
+    if (s->ret == FOSSIL_THREADS_RWLOCK_OK) fossil_threads_rwlock_unlock(&s->rw);
+    return NULL;
+}
+
+static void *rwlock_blocking_write(void *arg) {
+    rwlock_shared_t *s = (rwlock_shared_t *)arg;
+    s->ret = fossil_threads_rwlock_wrlock(&s->rw);
+    s->a++;
+    fossil_threads_rwlock_unlock(&s->rw);
+    return NULL;
+}
+
+static void rwlock_run_helper(rwlock_shared_t *s, fossil_threads_thread_func fn) {
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, fn, s);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_rwlock_init_dispose) {
+    fossil_threads_rwlock_t rw;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init(&rw), FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_TRUE(fossil_threads_rwlock_is_initialized(&rw));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_policy(&rw), FOSSIL_THREADS_RWLOCK_POLICY_NATIVE);
+    fossil_threads_rwlock_dispose(&rw);
+    ASSUME_ITS_FALSE(fossil_threads_rwlock_is_initialized(&rw));
+    fossil_threads_rwlock_dispose(&rw); /* twice is safe */
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&rw, FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER), FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_policy(&rw), FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER);
+    fossil_threads_rwlock_dispose(&rw);
+}
+
+FOSSIL_TEST(c_rwlock_invalid_arguments) {
+    fossil_threads_rwlock_t rw;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init(NULL), FOSSIL_THREADS_RWLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&rw, 7), FOSSIL_THREADS_RWLOCK_EINVAL);
+
+    memset(&rw, 0, sizeof(rw));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_rdlock(&rw), FOSSIL_THREADS_RWLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_wrlock(&rw), FOSSIL_THREADS_RWLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_tryrdlock(NULL), FOSSIL_THREADS_RWLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_policy(NULL), -1);
+    ASSUME_ITS_FALSE(fossil_threads_rwlock_is_initialized(NULL));
+}
+
+FOSSIL_TEST(c_rwlock_shared_and_exclusive) {
+    for (size_t p = 0; p < sizeof(rwlock_policies) / sizeof(rwlock_policies[0]); ++p) {
+        fossil_threads_rwlock_t rw;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&rw, rwlock_policies[p]), FOSSIL_THREADS_RWLOCK_OK);
+
+        /* Readers share */
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_rdlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_tryrdlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_trywrlock(&rw), FOSSIL_THREADS_RWLOCK_EBUSY);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+
+        /* Writers exclude */
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_trywrlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_trywrlock(&rw), FOSSIL_THREADS_RWLOCK_EBUSY);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_tryrdlock(&rw), FOSSIL_THREADS_RWLOCK_EBUSY);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_wrlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+        fossil_threads_rwlock_dispose(&rw);
+    }
+}
+
+FOSSIL_TEST(c_rwlock_timed_variants) {
+    for (size_t p = 0; p < sizeof(rwlock_policies) / sizeof(rwlock_policies[0]); ++p) {
+        rwlock_shared_t s;
+        memset(&s, 0, sizeof(s));
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&s.rw, rwlock_policies[p]), FOSSIL_THREADS_RWLOCK_OK);
+
+        /* A held read lock times out a writer but admits a timed reader */
+        fossil_threads_rwlock_rdlock(&s.rw);
+        rwlock_run_helper(&s, rwlock_timed_write);
+        ASSUME_ITS_EQUAL_I32(s.ret, FOSSIL_THREADS_RWLOCK_ETIMEDOUT);
+        rwlock_run_helper(&s, rwlock_timed_read);
+        ASSUME_ITS_EQUAL_I32(s.ret, FOSSIL_THREADS_RWLOCK_OK);
+        fossil_threads_rwlock_unlock(&s.rw);
+
+        /* A held write lock times out a reader */
+        fossil_threads_rwlock_wrlock(&s.rw);
+        rwlock_run_helper(&s, rwlock_timed_read);
+        ASSUME_ITS_EQUAL_I32(s.ret, FOSSIL_THREADS_RWLOCK_ETIMEDOUT);
+        fossil_threads_rwlock_unlock(&s.rw);
+
+        /* Uncontended timed calls succeed */
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_timedwrlock(&s.rw, 5), FOSSIL_THREADS_RWLOCK_OK);
+        fossil_threads_rwlock_unlock(&s.rw);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_timedrdlock(&s.rw, 5), FOSSIL_THREADS_RWLOCK_OK);
+        fossil_threads_rwlock_unlock(&s.rw);
+
+        fossil_threads_rwlock_dispose(&s.rw);
+    }
+}
+
+FOSSIL_TEST(c_rwlock_upgrade_downgrade) {
+    fossil_threads_rwlock_t rw;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&rw, FOSSIL_THREADS_RWLOCK_POLICY_PREFER_READER), FOSSIL_THREADS_RWLOCK_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_try_upgrade(&rw), FOSSIL_THREADS_RWLOCK_EPERM);
+    fossil_threads_rwlock_rdlock(&rw);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_try_upgrade(&rw), FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_tryrdlock(&rw), FOSSIL_THREADS_RWLOCK_EBUSY);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_downgrade(&rw), FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_tryrdlock(&rw), FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_try_upgrade(&rw), FOSSIL_THREADS_RWLOCK_EBUSY);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_downgrade(&rw), FOSSIL_THREADS_RWLOCK_EUNLOCK);
+    fossil_threads_rwlock_unlock(&rw);
+    fossil_threads_rwlock_unlock(&rw);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_unlock(&rw), FOSSIL_THREADS_RWLOCK_EUNLOCK);
+    fossil_threads_rwlock_dispose(&rw);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init(&rw), FOSSIL_THREADS_RWLOCK_OK);
+    fossil_threads_rwlock_rdlock(&rw);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_try_upgrade(&rw), FOSSIL_THREADS_RWLOCK_EUNSUPPORTED);
+    fossil_threads_rwlock_unlock(&rw);
+    fossil_threads_rwlock_dispose(&rw);
+}
+
+FOSSIL_TEST(c_rwlock_prefer_writer_blocks_new_readers) {
+    rwlock_shared_t s;
+    fossil_threads_thread_t writer;
+    memset(&s, 0, sizeof(s));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&s.rw, FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER), FOSSIL_THREADS_RWLOCK_OK);
+
+    fossil_threads_rwlock_rdlock(&s.rw);
+    fossil_threads_thread_init(&writer);
+    fossil_threads_thread_create(&writer, rwlock_blocking_write, &s);
+
+    /* Once the writer is queued, new readers are turned away */
+    int refused = 0;
+    for (int i = 0; i < 2000 && !refused; ++i) {
+        if (fossil_threads_rwlock_tryrdlock(&s.rw) == FOSSIL_THREADS_RWLOCK_OK) {
+            fossil_threads_rwlock_unlock(&s.rw);
+            fossil_threads_thread_sleep_ms(1);
+        } else {
+            refused = 1;
+        }
+    }
+    ASSUME_ITS_TRUE(refused);
+
+    fossil_threads_rwlock_unlock(&s.rw);
+    fossil_threads_thread_join(&writer, NULL);
+    fossil_threads_thread_dispose(&writer);
+    ASSUME_ITS_EQUAL_I32(s.ret, FOSSIL_THREADS_RWLOCK_OK);
+    ASSUME_ITS_EQUAL_I32((int)s.a, 1);
+    fossil_threads_rwlock_dispose(&s.rw);
+}
+
+FOSSIL_TEST(c_rwlock_contended_mixed) {
+    for (size_t p = 0; p < sizeof(rwlock_policies) / sizeof(rwlock_policies[0]); ++p) {
+        rwlock_shared_t s;
+        fossil_threads_thread_t threads[RWLOCK_THREADS];
+        memset(&s, 0, sizeof(s));
+        ASSUME_ITS_EQUAL_I32(fossil_threads_rwlock_init_ex(&s.rw, rwlock_policies[p]), FOSSIL_THREADS_RWLOCK_OK);
+
+        for (int i = 0; i < RWLOCK_THREADS; ++i) {
+            fossil_threads_thread_init(&threads[i]);
+            fossil_threads_thread_create(&threads[i], rwlock_mixed_worker, &s);
+        }
+        for (int i = 0; i < RWLOCK_THREADS; ++i) {
+            fossil_threads_thread_join(&threads[i], NULL);
+            fossil_threads_thread_dispose(&threads[i]);
+        }
+
+        ASSUME_ITS_FALSE(s.torn);
+        ASSUME_ITS_EQUAL_I32((int)s.a, RWLOCK_THREADS * (RWLOCK_ITERS / 8));
+        fossil_threads_rwlock_dispose(&s.rw);
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_rwlock_tests) {
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_init_dispose);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_invalid_arguments);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_shared_and_exclusive);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_timed_variants);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_upgrade_downgrade);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_prefer_writer_blocks_new_readers);
+    FOSSIL_ADD_TEST(c_rwlock_fixture, c_rwlock_contended_mixed);
+
+    FOSSIL_ADD_SUITE(c_rwlock_fixture);
+} // end of tests
@@ -0,0 +1,145 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_rwlock_fixture);
+
+FOSSIL_SETUP(cpp_rwlock_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_rwlock_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::RwLock;
+
+FOSSIL_TEST(cpp_rwlock_guards) {
+    RwLock rw;
+    {
+        RwLock::ReadGuard r1(rw);
+        ASSUME_ITS_TRUE(rw.try_lock_shared());
+        ASSUME_ITS_FALSE(rw.try_lock());
+        rw.unlock_shared();
+    }
+    {
+        RwLock::WriteGuard w(rw);
+        ASSUME_ITS_FALSE(rw.try_lock_shared());
+    }
+    ASSUME_ITS_TRUE(rw.try_lock());
+    rw.unlock();
+}
+
+FOSSIL_TEST(cpp_rwlock_standard_lock_adaptors) {
+    RwLock rw(FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER);
+    ASSUME_ITS_EQUAL_I32(rw.policy(), FOSSIL_THREADS_RWLOCK_POLICY_PREFER_WRITER);
+    long value = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&rw, &value, t] {
+            for (int i = 0; i < 2000; ++i) {
+                if ((i + t) % 4 == 0) {
+                    std::unique_lock<RwLock> lk(rw);
+                    ++value;
+                } else {
+                    std::shared_lock<RwLock> lk(rw);
+                    (void)value;
+                }
+            }
+        });
+    }
+    for (auto &th : threads) th.join();
+    ASSUME_ITS_EQUAL_I32((int)value, 2000);
+}
+
+FOSSIL_TEST(cpp_rwlock_timed_and_upgrade) {
+    RwLock rw(FOSSIL_THREADS_RWLOCK_POLICY_PREFER_READER);
+    rw.lock_shared();
+    bool got = true;
+    std::thread other([&] { got = rw.try_lock_for(std::chrono::milliseconds(10)); });
+    other.join();
+    ASSUME_ITS_FALSE(got);
+
+    ASSUME_ITS_TRUE(rw.try_upgrade());
+    ASSUME_ITS_FALSE(rw.try_lock_shared_for(std::chrono::microseconds(500)));
+    rw.downgrade();
+    ASSUME_ITS_TRUE(rw.try_lock_shared_for(std::chrono::milliseconds(1)));
+    rw.unlock_shared();
+    rw.unlock_shared();
+}
+
+FOSSIL_TEST(cpp_rwlock_invalid_policy_throws) {
+    bool threw = false;
+    try {
+        RwLock rw(42);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+
+    RwLock native;
+    native.lock_shared();
+    bool unsupported = false;
+    try {
+        native.try_upgrade();
+    } catch (const std::runtime_error&) {
+        unsupported = true;
+    }
+    native.unlock_shared();
+    ASSUME_ITS_TRUE(unsupported);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_rwlock_tests) {
+    FOSSIL_ADD_TEST(cpp_rwlock_fixture, cpp_rwlock_guards);
+    FOSSIL_ADD_TEST(cpp_rwlock_fixture, cpp_rwlock_standard_lock_adaptors);
+    FOSSIL_ADD_TEST(cpp_rwlock_fixture, cpp_rwlock_timed_and_upgrade);
+    FOSSIL_ADD_TEST(cpp_rwlock_fixture, cpp_rwlock_invalid_policy_throws);
+
+    FOSSIL_ADD_SUITE(cpp_rwlock_fixture);
+} // end of tests
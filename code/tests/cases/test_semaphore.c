@@ -0,0 +1,170 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_semaphore_fixture);
+
+FOSSIL_SETUP(c_semaphore_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_semaphore_fixture) {
+    // Teardown the test fixture
+}
+
+#define SEM_RING      8
+#define SEM_PRODUCERS 2
+#define SEM_CONSUMERS 2
+#define SEM_ITEMS     5000  /* per producer */
+
+/* Bounded buffer: free counts empty slots, full counts queued items. */
+typedef struct {
+    fossil_threads_sem_t free;
+    fossil_threads_sem_t full;
+    fossil_threads_mutex_t lock;
+    long ring[SEM_RING];
+    size_t head, tail;
+    long long consumed_sum;
+} sem_ring_t;
+
+static void *sem_producer(void *arg) {
+    sem_ring_t *r = (sem_ring_t *)arg;
+    for (long i = 1; i <= SEM_ITEMS; ++i) {
+        fossil_threads_sem_wait(&r->free);
+        fossil_threads_mutex_lock(&r->lock);
+        r->ring[r->tail++ % SEM_RING] = i;
+        fossil_threads_mutex_unlock(&r->lock);
+        fossil_threads_sem_post(&r->full);
+    }
+    return NULL;
+}
+
+static void *sem_consumer(void *arg) {
+    sem_ring_t *r = (sem_ring_t *)arg;
+    for (long n = 0; n < SEM_ITEMS * SEM_PRODUCERS / SEM_CONSUMERS; ++n) {
+        fossil_threads_sem_wait(&r->full);
+        fossil_threads_mutex_lock(&r->lock);
+        r->consumed_sum += r->ring[r->head++ % SEM_RING];
+        fossil_threads_mutex_unlock(&r->lock);
+        fossil_threads_sem_post(&r->free);
+    }
+    return NULL;
+}
+
+static void *sem_poster(void *arg) {
+    fossil_threads_thread_sleep_ms(10);
+    fossil_threads_sem_post_n((fossil_threads_sem_t *)arg, 3);
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_semaphore_counts_and_errors) {
+    fossil_threads_sem_t s = FOSSIL_THREADS_SEM_INITIALIZER(2);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_init(NULL, 0, 0), FOSSIL_THREADS_SEM_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_wait(NULL), FOSSIL_THREADS_SEM_EINVAL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_trywait(&s), FOSSIL_THREADS_SEM_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_wait(&s), FOSSIL_THREADS_SEM_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_trywait(&s), FOSSIL_THREADS_SEM_EAGAIN);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_timedwait(&s, 10), FOSSIL_THREADS_SEM_ETIMEDOUT);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_wait_until(&s, 0), FOSSIL_THREADS_SEM_ETIMEDOUT);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_post_n(&s, 5), FOSSIL_THREADS_SEM_OK);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_sem_value(&s), 5);
+
+    fossil_threads_sem_t big;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_init(&big, FOSSIL_THREADS_SEM_VALUE_MAX + 1u, 0),
+                         FOSSIL_THREADS_SEM_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_init(&big, FOSSIL_THREADS_SEM_VALUE_MAX, 0),
+                         FOSSIL_THREADS_SEM_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_post(&big), FOSSIL_THREADS_SEM_EOVERFLOW);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_sem_value(&big), (int)FOSSIL_THREADS_SEM_VALUE_MAX);
+    fossil_threads_sem_dispose(&big);
+}
+
+FOSSIL_TEST(c_semaphore_post_wakes_parked_waiter) {
+    fossil_threads_sem_t s;
+    fossil_threads_sem_init(&s, 0, 0);
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&t, sem_poster, &s), FOSSIL_THREADS_OK);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_sem_timedwait(&s, 10000), FOSSIL_THREADS_SEM_OK);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_sem_value(&s), 2);
+    fossil_threads_sem_dispose(&s);
+}
+
+FOSSIL_TEST(c_semaphore_bounded_buffer) {
+    sem_ring_t r;
+    memset(&r, 0, sizeof(r));
+    fossil_threads_sem_init(&r.free, SEM_RING, 256);
+    fossil_threads_sem_init(&r.full, 0, 256);
+    fossil_threads_mutex_init(&r.lock);
+
+    fossil_threads_thread_t threads[SEM_PRODUCERS + SEM_CONSUMERS];
+    for (int i = 0; i < SEM_PRODUCERS + SEM_CONSUMERS; ++i) {
+        fossil_threads_thread_init(&threads[i]);
+        fossil_threads_thread_create(&threads[i], i < SEM_PRODUCERS ? sem_producer : sem_consumer, &r);
+    }
+    for (int i = 0; i < SEM_PRODUCERS + SEM_CONSUMERS; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+    }
+
+    long long expected = (long long)SEM_PRODUCERS * SEM_ITEMS * (SEM_ITEMS + 1) / 2;
+    ASSUME_ITS_TRUE(r.consumed_sum == expected);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_sem_value(&r.free), SEM_RING);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_sem_value(&r.full), 0);
+    fossil_threads_mutex_dispose(&r.lock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_semaphore_tests) {
+    FOSSIL_ADD_TEST(c_semaphore_fixture, c_semaphore_counts_and_errors);
+    FOSSIL_ADD_TEST(c_semaphore_fixture, c_semaphore_post_wakes_parked_waiter);
+    FOSSIL_ADD_TEST(c_semaphore_fixture, c_semaphore_bounded_buffer);
+
+    FOSSIL_ADD_SUITE(c_semaphore_fixture);
+} // end of tests
@@ -0,0 +1,103 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_semaphore_fixture);
+
+FOSSIL_SETUP(cpp_semaphore_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_semaphore_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Semaphore;
+
+FOSSIL_TEST(cpp_semaphore_acquire_release) {
+    Semaphore sem(1);
+    ASSUME_ITS_TRUE(sem.try_acquire());
+    ASSUME_ITS_FALSE(sem.try_acquire());
+    ASSUME_ITS_FALSE(sem.try_acquire_for(std::chrono::milliseconds(5)));
+    sem.release(2);
+    ASSUME_ITS_EQUAL_I32((int)sem.value(), 2);
+    sem.acquire();
+    ASSUME_ITS_EQUAL_I32((int)sem.value(), 1);
+}
+
+FOSSIL_TEST(cpp_semaphore_limits_concurrency) {
+    const int limit = 2, workers = 6, rounds = 200;
+    Semaphore sem(limit, 128);
+    std::atomic<int> inside{0};
+    std::atomic<bool> exceeded{false};
+
+    std::vector<std::thread> pool;
+    for (int w = 0; w < workers; ++w) {
+        pool.emplace_back([&] {
+            for (int r = 0; r < rounds; ++r) {
+                sem.acquire();
+                if (inside.fetch_add(1) + 1 > limit) exceeded.store(true);
+                std::this_thread::yield();
+                inside.fetch_sub(1);
+                sem.release();
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    ASSUME_ITS_FALSE(exceeded.load());
+    ASSUME_ITS_EQUAL_I32((int)sem.value(), limit);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_semaphore_tests) {
+    FOSSIL_ADD_TEST(cpp_semaphore_fixture, cpp_semaphore_acquire_release);
+    FOSSIL_ADD_TEST(cpp_semaphore_fixture, cpp_semaphore_limits_concurrency);
+
+    FOSSIL_ADD_SUITE(cpp_semaphore_fixture);
+} // end of tests
@@ -0,0 +1,195 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_seqlock_fixture);
+
+FOSSIL_SETUP(c_seqlock_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_seqlock_fixture) {
+    // Teardown the test fixture
+}
+
+#define SEQLOCK_READERS 3
+#define SEQLOCK_WRITES  20000
+
+typedef struct {
+    long a;
+    long b;    /* always a * 2 in a consistent snapshot */
+    long c;    /* always a * 3 in a consistent snapshot */
+} seqlock_point_t;
+
+typedef struct {
+    fossil_threads_seqlock_t sl;
+    seqlock_point_t point;
+    fossil_threads_mutex_t done_lock;
+    int done;
+    int torn; /* only written by the reader that found a torn snapshot */
+} seqlock_shared_t;
+
+static int seqlock_is_done(seqlock_shared_t *s) {
+    fossil_threads_mutex_lock(&s->done_lock);
+    int d = s->done;
+    fossil_threads_mutex_unlock(&s->done_lock);
+    return d;
+}
+
+static void *seqlock_reader(void *arg) {
+    seqlock_shared_t *s = (seqlock_shared_t *)arg;
+    long last = 0;
+    while (!seqlock_is_done(s)) {
+        seqlock_point_t p;
+        fossil_threads_seqlock_read(&s->sl, &p, &s->point, sizeof(p));
+        if (p.b != p.a * 2 || p.c != p.a * 3 || p.a < last) s->torn = 1;
+        last = p.a;
+    }
+    return NULL;
+}
+
+static void *seqlock_blocked_writer(void *arg) {
+    seqlock_shared_t *s = (seqlock_shared_t *)arg;
+    seqlock_point_t p = { 7, 14, 21 };
+    fossil_threads_seqlock_write(&s->sl, &s->point, &p, sizeof(p));
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_seqlock_init_and_initializer) {
+    fossil_threads_seqlock_t a = FOSSIL_THREADS_SEQLOCK_INITIALIZER;
+    fossil_threads_seqlock_t b;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_seqlock_init(&b), FOSSIL_THREADS_SEQLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_seqlock_init(NULL), FOSSIL_THREADS_SEQLOCK_EINVAL);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_seqlock_read_begin(&a), 0);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_seqlock_read_begin(&b), 0);
+}
+
+FOSSIL_TEST(c_seqlock_retry_after_write) {
+    fossil_threads_seqlock_t sl = FOSSIL_THREADS_SEQLOCK_INITIALIZER;
+    unsigned int s = fossil_threads_seqlock_read_begin(&sl);
+    ASSUME_ITS_FALSE(fossil_threads_seqlock_read_retry(&sl, s));
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_seqlock_write_trylock(&sl), FOSSIL_THREADS_SEQLOCK_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_seqlock_write_trylock(&sl), FOSSIL_THREADS_SEQLOCK_EBUSY);
+    ASSUME_ITS_TRUE(fossil_threads_seqlock_read_retry(&sl, s));
+    fossil_threads_seqlock_write_unlock(&sl);
+
+    ASSUME_ITS_TRUE(fossil_threads_seqlock_read_retry(&sl, s));
+    s = fossil_threads_seqlock_read_begin(&sl);
+    ASSUME_ITS_FALSE(fossil_threads_seqlock_read_retry(&sl, s));
+}
+
+FOSSIL_TEST(c_seqlock_copy_helpers) {
+    fossil_threads_seqlock_t sl = FOSSIL_THREADS_SEQLOCK_INITIALIZER;
+    char shared[13] = { 0 };
+    char in[13] = "hello seqlck";
+    char out[13] = { 0 };
+    fossil_threads_seqlock_write(&sl, shared, in, sizeof(in));
+    fossil_threads_seqlock_read(&sl, out, shared, sizeof(out));
+    ASSUME_ITS_TRUE(memcmp(in, out, sizeof(in)) == 0);
+
+    /* Unaligned source and destination take the byte path */
+    fossil_threads_seqlock_copy(out + 1, in + 3, 7);
+    ASSUME_ITS_TRUE(memcmp(out + 1, in + 3, 7) == 0);
+}
+
+FOSSIL_TEST(c_seqlock_writer_waits_for_writer) {
+    seqlock_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_seqlock_init(&s.sl);
+
+    fossil_threads_seqlock_write_lock(&s.sl);
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, seqlock_blocked_writer, &s);
+    fossil_threads_thread_sleep_ms(20);
+    seqlock_point_t p = { 1, 2, 3 };
+    fossil_threads_seqlock_copy(&s.point, &p, sizeof(p));
+    fossil_threads_seqlock_write_unlock(&s.sl);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+
+    fossil_threads_seqlock_read(&s.sl, &p, &s.point, sizeof(p));
+    ASSUME_ITS_EQUAL_I32((int)p.a, 7);
+    ASSUME_ITS_EQUAL_I32((int)p.c, 21);
+}
+
+FOSSIL_TEST(c_seqlock_concurrent_snapshots) {
+    seqlock_shared_t s;
+    memset(&s, 0, sizeof(s));
+    fossil_threads_seqlock_init(&s.sl);
+    fossil_threads_mutex_init(&s.done_lock);
+
+    fossil_threads_thread_t readers[SEQLOCK_READERS];
+    for (int i = 0; i < SEQLOCK_READERS; ++i) {
+        fossil_threads_thread_init(&readers[i]);
+        fossil_threads_thread_create(&readers[i], seqlock_reader, &s);
+    }
+    for (long i = 1; i <= SEQLOCK_WRITES; ++i) {
+        seqlock_point_t p = { i, i * 2, i * 3 };
+        fossil_threads_seqlock_write(&s.sl, &s.point, &p, sizeof(p));
+    }
+    fossil_threads_mutex_lock(&s.done_lock);
+    s.done = 1;
+    fossil_threads_mutex_unlock(&s.done_lock);
+    for (int i = 0; i < SEQLOCK_READERS; ++i) {
+        fossil_threads_thread_join(&readers[i], NULL);
+        fossil_threads_thread_dispose(&readers[i]);
+    }
+
+    ASSUME_ITS_FALSE(s.torn);
+    ASSUME_ITS_EQUAL_I32((int)s.point.a, SEQLOCK_WRITES);
+    fossil_threads_mutex_dispose(&s.done_lock);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_seqlock_tests) {
+    FOSSIL_ADD_TEST(c_seqlock_fixture, c_seqlock_init_and_initializer);
+    FOSSIL_ADD_TEST(c_seqlock_fixture, c_seqlock_retry_after_write);
+    FOSSIL_ADD_TEST(c_seqlock_fixture, c_seqlock_copy_helpers);
+    FOSSIL_ADD_TEST(c_seqlock_fixture, c_seqlock_writer_waits_for_writer);
+    FOSSIL_ADD_TEST(c_seqlock_fixture, c_seqlock_concurrent_snapshots);
+
+    FOSSIL_ADD_SUITE(c_seqlock_fixture);
+} // end of tests
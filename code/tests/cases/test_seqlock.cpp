@@ -0,0 +1,114 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_seqlock_fixture);
+
+FOSSIL_SETUP(cpp_seqlock_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_seqlock_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Seqlocked;
+
+struct cpp_seqlock_pair {
+    long lo;
+    long hi; // always -lo in a consistent snapshot
+};
+
+FOSSIL_TEST(cpp_seqlock_load_store_update) {
+    Seqlocked<cpp_seqlock_pair> v;
+    ASSUME_ITS_EQUAL_I32((int)v.load().lo, 0);
+
+    v.store({ 5, -5 });
+    ASSUME_ITS_EQUAL_I32((int)v.load().hi, -5);
+
+    v.update([](cpp_seqlock_pair& p) { p.lo += 1; p.hi -= 1; });
+    cpp_seqlock_pair p = v.load();
+    ASSUME_ITS_EQUAL_I32((int)p.lo, 6);
+    ASSUME_ITS_EQUAL_I32((int)p.hi, -6);
+}
+
+FOSSIL_TEST(cpp_seqlock_concurrent_updates) {
+    Seqlocked<cpp_seqlock_pair> v(cpp_seqlock_pair{ 0, 0 });
+    std::atomic<bool> done{false};
+    std::atomic<bool> torn{false};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                cpp_seqlock_pair p = v.load();
+                if (p.hi != -p.lo) torn = true;
+            }
+        });
+    }
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 2; ++i) {
+        writers.emplace_back([&] {
+            for (int n = 0; n < 5000; ++n)
+                v.update([](cpp_seqlock_pair& p) { p.lo += 1; p.hi -= 1; });
+        });
+    }
+    for (auto& t : writers) t.join();
+    done = true;
+    for (auto& t : readers) t.join();
+
+    ASSUME_ITS_FALSE(torn.load());
+    ASSUME_ITS_EQUAL_I32((int)v.load().lo, 10000);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_seqlock_tests) {
+    FOSSIL_ADD_TEST(cpp_seqlock_fixture, cpp_seqlock_load_store_update);
+    FOSSIL_ADD_TEST(cpp_seqlock_fixture, cpp_seqlock_concurrent_updates);
+
+    FOSSIL_ADD_SUITE(cpp_seqlock_fixture);
+} // end of tests
@@ -213,6 +213,197 @@ FOSSIL_TEST(c_thread_priority_set_get) {
     fossil_threads_thread_dispose(&thread);
 }
 
+static void *test_thread_func_echo(void *arg) {
+    return arg;
+}
+
+FOSSIL_TEST(c_thread_reuse_after_join) {
+    /* Start state is stored inline, so one object can be recycled. */
+    fossil_threads_thread_t thread;
+    fossil_threads_thread_init(&thread);
+    for (uintptr_t i = 1; i <= 64; ++i) {
+        void *ret = NULL;
+        ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&thread, test_thread_func_echo, (void *)i),
+                             FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&thread, &ret), FOSSIL_THREADS_OK);
+        ASSUME_ITS_TRUE(ret == (void *)i);
+        ASSUME_ITS_TRUE(thread.launched);
+        ASSUME_ITS_TRUE(thread.start_time_ns > 0);
+        ASSUME_ITS_TRUE(thread.end_time_ns >= thread.start_time_ns);
+        fossil_threads_thread_dispose(&thread);
+    }
+}
+
+/* Touches a few KB of stack so an undersized stack would fault. */
+static void *test_thread_func_stack_use(void *arg) {
+    volatile unsigned char buf[8192];
+    for (size_t i = 0; i < sizeof(buf); ++i) buf[i] = (unsigned char)i;
+    return (void *)(uintptr_t)(buf[100] + (arg ? 1u : 0u));
+}
+
+FOSSIL_TEST(c_thread_create_ex_attributes) {
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_thread_t thread;
+    void *ret = NULL;
+    fossil_threads_thread_attr_init(&attr);
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32((int)attr.stack_size, 0);
+    ASSUME_ITS_EQUAL_I32(attr.detached, 0);
+    ASSUME_ITS_EQUAL_I32(attr.policy, FOSSIL_THREADS_POLICY_DEFAULT);
+
+    /* NULL attributes behave like thread_create(). */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, NULL, test_thread_func_noop, NULL),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&thread, NULL), FOSSIL_THREADS_OK);
+
+    /* A small stack is rounded up to whatever the platform requires. */
+    attr.stack_size = 1;
+    attr.guard_size = 4096;
+    attr.priority = -1;
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_stack_use, NULL),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(thread.priority, -1);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&thread, &ret), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)ret, 100);
+
+    fossil_threads_thread_attr_init(&attr);
+    attr.policy = 42;
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_noop, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    attr.policy = FOSSIL_THREADS_POLICY_DEFAULT;
+    attr.stack = &attr;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_noop, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_TRUE(!thread.started);
+
+    /* Real-time policies need privileges the test may not have. */
+    fossil_threads_thread_attr_init(&attr);
+    attr.policy = FOSSIL_THREADS_POLICY_RR;
+    int rc = fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_noop, NULL);
+    ASSUME_ITS_TRUE(rc == FOSSIL_THREADS_OK || rc == FOSSIL_THREADS_EPERM ||
+                    rc == FOSSIL_THREADS_EUNSUPPORTED);
+    if (rc == FOSSIL_THREADS_OK) {
+        ASSUME_ITS_EQUAL_I32(thread.policy, FOSSIL_THREADS_POLICY_RR);
+        fossil_threads_thread_join(&thread, NULL);
+    }
+
+    fossil_threads_thread_dispose(&thread);
+}
+
+FOSSIL_TEST(c_thread_create_ex_caller_stack) {
+    /* Room for the descriptor and TLS carved from it too (see attr.stack);
+     * 256 KiB is too little under ThreadSanitizer. */
+    enum { STACK_BYTES = 1024 * 1024, STACK_ALIGN = 16 * 1024 };
+    /* Page-aligned carve-out: some platforms reject unaligned stacks. */
+    unsigned char *raw = (unsigned char *)malloc(STACK_BYTES + STACK_ALIGN);
+    ASSUME_ITS_TRUE(raw != NULL);
+    void *stack = raw + (STACK_ALIGN - (uintptr_t)raw % STACK_ALIGN);
+
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_thread_t thread;
+    void *ret = NULL;
+    fossil_threads_thread_attr_init(&attr);
+    fossil_threads_thread_init(&thread);
+    attr.stack = stack;
+    attr.stack_size = STACK_BYTES;
+
+    int rc = fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_stack_use, &attr);
+    ASSUME_ITS_TRUE(rc == FOSSIL_THREADS_OK || rc == FOSSIL_THREADS_EUNSUPPORTED);
+    if (rc == FOSSIL_THREADS_OK) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&thread, &ret), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32((int)(uintptr_t)ret, 101);
+    }
+
+    fossil_threads_thread_dispose(&thread);
+    free(raw);
+}
+
+FOSSIL_TEST(c_thread_create_ex_detached) {
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_thread_t thread;
+    unsigned int ms = 5;
+    fossil_threads_thread_attr_init(&attr);
+    fossil_threads_thread_init(&thread);
+    attr.detached = 1;
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_sleep, &ms),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(thread.joinable, 0);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_join(&thread, NULL), FOSSIL_THREADS_EDETACHED);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_detach(&thread), FOSSIL_THREADS_EDETACHED);
+
+    /* dispose() waits for a detached thread to finish. */
+    fossil_threads_thread_dispose(&thread);
+}
+
+/* Pins itself to the first CPU of node 0 and reports the outcome. */
+static void *test_thread_func_pin(void *arg) {
+    unsigned int cpu = 0;
+    int *out = (int *)arg;
+    fossil_threads_numa_node_cpus(0, &cpu, 1);
+    out[0] = fossil_threads_thread_set_affinity(NULL, &cpu, 1);
+    out[1] = (int)cpu;
+    out[2] = fossil_threads_cpu_current();
+    return NULL;
+}
+
+/* Waits for the test to open the latch. */
+static void *test_thread_func_latch(void *arg) {
+    fossil_threads_latch_wait((fossil_threads_latch_t *)arg);
+    return NULL;
+}
+
+FOSSIL_TEST(c_thread_affinity_and_topology) {
+    size_t cpus = fossil_threads_cpu_count();
+    size_t nodes = fossil_threads_numa_node_count();
+    ASSUME_ITS_TRUE(cpus >= 1);
+    ASSUME_ITS_TRUE(nodes >= 1);
+
+    /* Every usable CPU is listed under exactly the node it maps to. */
+    size_t listed = 0;
+    for (size_t n = 0; n < nodes; ++n) {
+        unsigned int ids[64];
+        size_t count = fossil_threads_numa_node_cpus(n, ids, 64);
+        ASSUME_ITS_TRUE(count >= 1);
+        for (size_t i = 0; i < count && i < 64; ++i)
+            ASSUME_ITS_EQUAL_I32(fossil_threads_numa_node_of_cpu(ids[i]), (int)n);
+        listed += count;
+    }
+    ASSUME_ITS_EQUAL_I32((int)listed, (int)cpus);
+    ASSUME_ITS_EQUAL_I32((int)fossil_threads_numa_node_cpus(nodes, NULL, 0), 0);
+
+    fossil_threads_thread_t thread;
+    unsigned int cpu = 0;
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_set_affinity(NULL, NULL, 1), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_set_affinity(NULL, &cpu, 0), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_set_affinity(&thread, &cpu, 1), FOSSIL_THREADS_ENOTSTARTED);
+
+    int out[3] = { -1, -1, -1 };
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&thread, test_thread_func_pin, out), FOSSIL_THREADS_OK);
+    fossil_threads_thread_join(&thread, NULL);
+    ASSUME_ITS_TRUE(out[0] == FOSSIL_THREADS_OK || out[0] == FOSSIL_THREADS_EUNSUPPORTED);
+    if (out[0] == FOSSIL_THREADS_OK && out[2] >= 0)
+        ASSUME_ITS_EQUAL_I32(out[2], out[1]);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_set_affinity(&thread, &cpu, 1), FOSSIL_THREADS_EFINISHED);
+    fossil_threads_thread_dispose(&thread);
+
+    /* A detached thread has no handle to pin through. */
+    fossil_threads_latch_t hold;
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_latch_init(&hold, 1, 0);
+    fossil_threads_thread_attr_init(&attr);
+    attr.detached = 1;
+    fossil_threads_thread_init(&thread);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create_ex(&thread, &attr, test_thread_func_latch, &hold),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_set_affinity(&thread, &cpu, 1), FOSSIL_THREADS_EDETACHED);
+    fossil_threads_latch_count_down(&hold, 1);
+    fossil_threads_thread_dispose(&thread);
+}
+
 FOSSIL_TEST(c_thread_cancel_and_is_running) {
     fossil_threads_thread_t thread;
     fossil_threads_thread_init(&thread);
@@ -252,6 +443,134 @@ FOSSIL_TEST(c_thread_get_retval) {
     fossil_threads_thread_dispose(&thread);
 }
 
+/* Blocks on the caller-held mutex, so the caller decides when it returns. */
+static void *test_thread_func_gated(void *arg) {
+    fossil_threads_mutex_t *gate = (fossil_threads_mutex_t *)arg;
+    fossil_threads_mutex_lock(gate);
+    fossil_threads_mutex_unlock(gate);
+    return (void *)(uintptr_t)7;
+}
+
+FOSSIL_TEST(c_thread_timedjoin) {
+    fossil_threads_thread_t thread;
+    fossil_threads_mutex_t gate;
+    void *ret = NULL;
+    fossil_threads_thread_init(&thread);
+    fossil_threads_mutex_init(&gate);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(NULL, NULL, 0), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(&thread, NULL, 0), FOSSIL_THREADS_ENOTSTARTED);
+
+    fossil_threads_mutex_lock(&gate);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&thread, test_thread_func_gated, &gate),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(&thread, &ret, 0), FOSSIL_THREADS_ETIMEDOUT);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(&thread, &ret, 10), FOSSIL_THREADS_ETIMEDOUT);
+    ASSUME_ITS_TRUE(fossil_threads_thread_is_running(&thread));
+
+    /* Still joinable after a timeout. */
+    fossil_threads_mutex_unlock(&gate);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(&thread, &ret, 10000), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((int)(uintptr_t)ret, 7);
+    ASSUME_ITS_TRUE(!fossil_threads_thread_is_running(&thread));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_timedjoin(&thread, NULL, 0), FOSSIL_THREADS_EDETACHED);
+
+    fossil_threads_thread_dispose(&thread);
+    fossil_threads_mutex_dispose(&gate);
+}
+
+/* ---------- Thread groups ---------- */
+
+typedef struct {
+    fossil_threads_mutex_t lock;
+    size_t arrived;
+    size_t count;
+    int all_met;
+} test_group_rendezvous_t;
+
+/* Every member waits until all have arrived, so the group only finishes
+ * if its members really run side by side. */
+static void *test_group_member(size_t index, void *ctx) {
+    test_group_rendezvous_t *r = (test_group_rendezvous_t *)ctx;
+    fossil_threads_mutex_lock(&r->lock);
+    r->arrived++;
+    fossil_threads_mutex_unlock(&r->lock);
+    for (int i = 0; i < 5000; ++i) {
+        fossil_threads_mutex_lock(&r->lock);
+        int met = r->arrived == r->count;
+        fossil_threads_mutex_unlock(&r->lock);
+        if (met) return (void *)(uintptr_t)(index + 1);
+        fossil_threads_thread_sleep_ms(1);
+    }
+    return NULL;
+}
+
+FOSSIL_TEST(c_thread_group_runs_all_members) {
+    test_group_rendezvous_t r;
+    fossil_threads_mutex_init(&r.lock);
+    r.arrived = 0;
+    r.count = 6;
+
+    fossil_threads_group_t *group = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(&group, 6, NULL, test_group_member, &r),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(group != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_group_size(group) == 6);
+
+    void *results[6];
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_join(group, results), FOSSIL_THREADS_OK);
+    for (uintptr_t i = 0; i < 6; ++i)
+        ASSUME_ITS_TRUE(results[i] == (void *)(i + 1));
+
+    /* A second join hands back the same results. */
+    void *again[6];
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_join(group, again), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(again[5] == (void *)(uintptr_t)6);
+    fossil_threads_group_destroy(group);
+    fossil_threads_mutex_dispose(&r.lock);
+}
+
+static void *test_group_index(size_t index, void *ctx) {
+    (void)ctx;
+    return (void *)(uintptr_t)(index * 2);
+}
+
+FOSSIL_TEST(c_thread_group_attributes_and_members) {
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_thread_attr_init(&attr);
+    attr.stack_size = 256 * 1024;
+
+    fossil_threads_group_t *group = NULL;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(&group, 3, &attr, test_group_index, NULL),
+                         FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_group_thread(group, 0) != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_group_thread(group, 2) != NULL);
+    ASSUME_ITS_TRUE(fossil_threads_group_thread(group, 3) == NULL);
+
+    /* Destroy joins a group that was never joined explicitly. */
+    fossil_threads_group_destroy(group);
+    fossil_threads_group_destroy(NULL);
+}
+
+FOSSIL_TEST(c_thread_group_invalid_args) {
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_group_t *group = (fossil_threads_group_t *)&attr;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(NULL, 1, NULL, test_group_index, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(&group, 0, NULL, test_group_index, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_TRUE(group == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(&group, 2, NULL, NULL, NULL),
+                         FOSSIL_THREADS_EINVAL);
+
+    fossil_threads_thread_attr_init(&attr);
+    attr.detached = 1;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_create(&group, 2, &attr, test_group_index, NULL),
+                         FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_group_join(NULL, NULL), FOSSIL_THREADS_EINVAL);
+    ASSUME_ITS_TRUE(fossil_threads_group_size(NULL) == 0);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -267,8 +586,17 @@ FOSSIL_TEST_GROUP(c_thread_tests) {
     FOSSIL_ADD_TEST(c_thread_fixture, c_thread_yield_and_sleep);
     FOSSIL_ADD_TEST(c_thread_fixture, c_thread_create_invalid_args);
     FOSSIL_ADD_TEST(c_thread_fixture, c_thread_priority_set_get);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_affinity_and_topology);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_create_ex_attributes);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_create_ex_caller_stack);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_create_ex_detached);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_reuse_after_join);
     FOSSIL_ADD_TEST(c_thread_fixture, c_thread_cancel_and_is_running);
     FOSSIL_ADD_TEST(c_thread_fixture, c_thread_get_retval);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_timedjoin);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_group_runs_all_members);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_group_attributes_and_members);
+    FOSSIL_ADD_TEST(c_thread_fixture, c_thread_group_invalid_args);
 
     FOSSIL_ADD_SUITE(c_thread_fixture);
 } // end of tests
@@ -24,6 +24,7 @@
  */
 #include <fossil/maip/framework.h>
 #include "fossil/threads/framework.h"
+#include <type_traits>
 
 
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -180,6 +181,45 @@ FOSSIL_TEST(cpp_thread_priority_set_get) {
     ASSUME_ITS_EQUAL_I32(fossil_threads_thread_get_priority(NULL), FOSSIL_THREADS_EINVAL);
 }
 
+FOSSIL_TEST(cpp_thread_affinity_wrappers) {
+    ASSUME_ITS_TRUE(Thread::cpu_count() >= 1);
+    std::vector<unsigned int> cpus = Thread::node_cpus(0);
+    ASSUME_ITS_TRUE(!cpus.empty());
+    ASSUME_ITS_TRUE(Thread::node_cpus(fossil_threads_numa_node_count()).empty());
+
+    Thread idle;
+    ASSUME_ITS_EQUAL_I32(idle.set_affinity(cpus), FOSSIL_THREADS_ENOTSTARTED);
+    ASSUME_ITS_EQUAL_I32(Thread::set_current_affinity(std::vector<unsigned int>()), FOSSIL_THREADS_EINVAL);
+
+    /* Pin a running thread to the whole of node 0. */
+    unsigned int ms = 50;
+    Thread thread(test_thread_funcpp_sleep, &ms);
+    int rc = thread.set_affinity(cpus);
+    ASSUME_ITS_TRUE(rc == FOSSIL_THREADS_OK || rc == FOSSIL_THREADS_EUNSUPPORTED);
+    thread.join();
+}
+
+FOSSIL_TEST(cpp_thread_attr_constructor) {
+    fossil_threads_thread_attr_t attr;
+    fossil_threads_thread_attr_init(&attr);
+    attr.stack_size = 128 * 1024;
+
+    unsigned int ms = 7;
+    Thread thread(attr, test_thread_funcpp_sleep, &ms);
+    void *ret = nullptr;
+    ASSUME_ITS_EQUAL_I32(thread.join(&ret), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((unsigned int)(uintptr_t)ret, ms);
+
+    attr.policy = 42;
+    bool threw = false;
+    try {
+        Thread bad(attr, test_thread_funcpp_sleep, &ms);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+}
+
 FOSSIL_TEST(cpp_thread_cancel_and_is_running) {
     Thread thread;
     int rc = thread.cancel();
@@ -210,6 +250,61 @@ FOSSIL_TEST(cpp_thread_get_retval) {
     ASSUME_ITS_EQUAL_I32((unsigned int)(uintptr_t)ret, ms);
 }
 
+FOSSIL_TEST(cpp_thread_timedjoin) {
+    unsigned int ms = 50;
+    Thread thread(test_thread_funcpp_sleep, &ms);
+    void *ret = nullptr;
+    ASSUME_ITS_EQUAL_I32(thread.timedjoin(0, &ret), FOSSIL_THREADS_ETIMEDOUT);
+    ASSUME_ITS_EQUAL_I32(thread.timedjoin(10000, &ret), FOSSIL_THREADS_OK);
+    ASSUME_ITS_EQUAL_I32((unsigned int)(uintptr_t)ret, ms);
+    ASSUME_ITS_TRUE(!thread.is_running());
+}
+
+/* The running thread writes into the wrapper's inline structure. */
+static_assert(!std::is_move_constructible<Thread>::value, "Thread must stay in place");
+static_assert(!std::is_move_assignable<Thread>::value, "Thread must stay in place");
+
+FOSSIL_TEST(cpp_thread_join_then_destroy) {
+    unsigned int ms = 20;
+    void *ret = nullptr;
+    {
+        /* Exit published, joined, then disposed: nothing waits again. */
+        Thread t(test_thread_funcpp_sleep, &ms);
+        Thread::sleep_ms(100);
+        ASSUME_ITS_EQUAL_I32(t.timedjoin(200, &ret), FOSSIL_THREADS_OK);
+        ASSUME_ITS_EQUAL_I32((unsigned int)(uintptr_t)ret, ms);
+        ASSUME_ITS_FALSE(t.is_running());
+    }
+    Thread u(test_thread_funcpp_sleep, &ms);
+    ASSUME_ITS_EQUAL_I32(u.join(&ret), FOSSIL_THREADS_OK);
+    ASSUME_ITS_TRUE(u.get_retval() == ret);
+}
+
+static void* cpp_group_square(size_t index, void* ctx) {
+    (void)ctx;
+    return reinterpret_cast<void*>(static_cast<uintptr_t>(index * index));
+}
+
+FOSSIL_TEST(cpp_thread_group_join) {
+    ThreadGroup group(4, cpp_group_square);
+    ASSUME_ITS_EQUAL_I32((int)group.size(), 4);
+    std::vector<void*> results = group.join();
+    ASSUME_ITS_EQUAL_I32((int)results.size(), 4);
+    ASSUME_ITS_TRUE(results[3] == reinterpret_cast<void*>(static_cast<uintptr_t>(9)));
+
+    ThreadGroup moved(std::move(group));
+    ASSUME_ITS_EQUAL_I32((int)moved.size(), 4);
+    ASSUME_ITS_EQUAL_I32((int)group.size(), 0);
+
+    bool threw = false;
+    try {
+        ThreadGroup bad(0, cpp_group_square);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+}
+
 // * * * * * * * * * * * * * * * * * * * * * * * *
 // * Fossil Logic Test Pool
 // * * * * * * * * * * * * * * * * * * * * * * * *
@@ -225,8 +320,13 @@ FOSSIL_TEST_GROUP(cpp_thread_tests) {
     FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_yield_and_sleep);
     FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_create_invalid_args);
     FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_priority_set_get);
+    FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_affinity_wrappers);
+    FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_attr_constructor);
     FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_cancel_and_is_running);
     FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_get_retval);
+    FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_timedjoin);
+    FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_join_then_destroy);
+    FOSSIL_ADD_TEST(cpp_thread_fixture, cpp_thread_group_join);
 
     FOSSIL_ADD_SUITE(cpp_thread_fixture);
 } // end of tests
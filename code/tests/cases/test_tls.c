@@ -0,0 +1,193 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_tls_fixture);
+
+FOSSIL_SETUP(c_tls_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_tls_fixture) {
+    // Teardown the test fixture
+}
+
+/* Destructor log; written by exiting threads, read after they are joined. */
+static fossil_threads_mutex_t tls_log_lock = FOSSIL_THREADS_MUTEX_INITIALIZER;
+static int tls_destroyed_sum;
+static int tls_destroyed_calls;
+static fossil_threads_tls_key_t tls_reset_key;
+
+static void tls_record(void *value) {
+    fossil_threads_mutex_lock(&tls_log_lock);
+    tls_destroyed_sum += *(int *)value;
+    tls_destroyed_calls++;
+    fossil_threads_mutex_unlock(&tls_log_lock);
+}
+
+/* Stores a new value once, so thread exit needs a second pass. */
+static void tls_record_and_reset(void *value) {
+    static int again = 100;
+    tls_record(value);
+    if (value != &again) fossil_threads_tls_set(tls_reset_key, &again);
+}
+
+typedef struct {
+    fossil_threads_tls_key_t key;
+    int value;
+    int seen;        /* value read back inside the thread */
+    int saw_null;    /* get returned NULL before the first set */
+} tls_thread_arg_t;
+
+static void *tls_thread_body(void *arg) {
+    tls_thread_arg_t *a = (tls_thread_arg_t *)arg;
+    a->saw_null = fossil_threads_tls_get(a->key) == NULL;
+    fossil_threads_tls_set(a->key, &a->value);
+    fossil_threads_thread_yield();
+    a->seen = *(int *)fossil_threads_tls_get(a->key);
+    return NULL;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_tls_key_lifecycle) {
+    fossil_threads_tls_key_t key = 0;
+    int a = 1, b = 2;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(NULL, NULL), FOSSIL_THREADS_TLS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_set(0, &a), FOSSIL_THREADS_TLS_EINVAL);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(0) == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_delete(0), FOSSIL_THREADS_TLS_EINVAL);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&key, NULL), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_TRUE(key != 0);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(key) == NULL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_set(key, &a), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(key) == &a);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_set(key, &b), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(key) == &b);
+
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_delete(key), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_delete(key), FOSSIL_THREADS_TLS_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_set(key, &a), FOSSIL_THREADS_TLS_EINVAL);
+
+    /* A key reusing the slot must not see the value stored through the old one. */
+    fossil_threads_tls_key_t next = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&next, NULL), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_TRUE(next != key);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(next) == NULL);
+    fossil_threads_tls_key_delete(next);
+}
+
+FOSSIL_TEST(c_tls_keys_exhaust) {
+    fossil_threads_tls_key_t keys[FOSSIL_THREADS_TLS_KEYS_MAX];
+    size_t made = 0;
+    while (made < FOSSIL_THREADS_TLS_KEYS_MAX &&
+           fossil_threads_tls_key_create(&keys[made], NULL) == FOSSIL_THREADS_TLS_OK)
+        ++made;
+    fossil_threads_tls_key_t extra = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&extra, NULL), FOSSIL_THREADS_TLS_EAGAIN);
+    for (size_t i = 0; i < made; ++i)
+        ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_delete(keys[i]), FOSSIL_THREADS_TLS_OK);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&extra, NULL), FOSSIL_THREADS_TLS_OK);
+    fossil_threads_tls_key_delete(extra);
+}
+
+FOSSIL_TEST(c_tls_values_are_per_thread_and_destroyed_at_exit) {
+    fossil_threads_tls_key_t key = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&key, tls_record), FOSSIL_THREADS_TLS_OK);
+    int mine = 1000;
+    fossil_threads_tls_set(key, &mine);
+    tls_destroyed_sum = 0;
+    tls_destroyed_calls = 0;
+
+    tls_thread_arg_t args[3];
+    fossil_threads_thread_t threads[3];
+    for (int i = 0; i < 3; ++i) {
+        args[i].key = key;
+        args[i].value = i + 1;
+        args[i].seen = 0;
+        args[i].saw_null = 0;
+        fossil_threads_thread_init(&threads[i]);
+        fossil_threads_thread_create(&threads[i], tls_thread_body, &args[i]);
+    }
+    for (int i = 0; i < 3; ++i) {
+        fossil_threads_thread_join(&threads[i], NULL);
+        fossil_threads_thread_dispose(&threads[i]);
+        ASSUME_ITS_TRUE(args[i].saw_null);
+        ASSUME_ITS_EQUAL_I32(args[i].seen, i + 1);
+    }
+
+    /* One destructor per exiting thread; the main thread's value is untouched. */
+    ASSUME_ITS_EQUAL_I32(tls_destroyed_calls, 3);
+    ASSUME_ITS_EQUAL_I32(tls_destroyed_sum, 1 + 2 + 3);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(key) == &mine);
+
+    /* Explicit exit for a thread the library did not start. */
+    fossil_threads_tls_thread_exit();
+    ASSUME_ITS_EQUAL_I32(tls_destroyed_calls, 4);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(key) == NULL);
+    fossil_threads_tls_key_delete(key);
+}
+
+FOSSIL_TEST(c_tls_destructor_may_set_again) {
+    ASSUME_ITS_EQUAL_I32(fossil_threads_tls_key_create(&tls_reset_key, tls_record_and_reset),
+                         FOSSIL_THREADS_TLS_OK);
+    tls_destroyed_sum = 0;
+    tls_destroyed_calls = 0;
+    int first = 5;
+    fossil_threads_tls_set(tls_reset_key, &first);
+    fossil_threads_tls_thread_exit();
+    ASSUME_ITS_EQUAL_I32(tls_destroyed_calls, 2);
+    ASSUME_ITS_EQUAL_I32(tls_destroyed_sum, 105);
+    ASSUME_ITS_TRUE(fossil_threads_tls_get(tls_reset_key) == NULL);
+    fossil_threads_tls_key_delete(tls_reset_key);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_tls_tests) {
+    FOSSIL_ADD_TEST(c_tls_fixture, c_tls_key_lifecycle);
+    FOSSIL_ADD_TEST(c_tls_fixture, c_tls_keys_exhaust);
+    FOSSIL_ADD_TEST(c_tls_fixture, c_tls_values_are_per_thread_and_destroyed_at_exit);
+    FOSSIL_ADD_TEST(c_tls_fixture, c_tls_destructor_may_set_again);
+
+    FOSSIL_ADD_SUITE(c_tls_fixture);
+} // end of tests
@@ -0,0 +1,114 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_tls_fixture);
+
+FOSSIL_SETUP(cpp_tls_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_tls_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Thread;
+using fossil::threads::ThreadLocal;
+
+namespace {
+    std::atomic<int> tls_live{0};
+
+    struct Tracked {
+        int hits = 0;
+        Tracked() { ++tls_live; }
+        ~Tracked() { --tls_live; }
+    };
+
+    std::atomic<int> tls_total{0};
+
+    void* tls_count_hits(void* arg) {
+        auto* tl = static_cast<ThreadLocal<Tracked>*>(arg);
+        for (int r = 0; r < 10; ++r) tl->local().hits++;
+        tls_total += tl->get()->hits;
+        return nullptr;
+    }
+}
+
+FOSSIL_TEST(cpp_tls_local_and_reset) {
+    ThreadLocal<Tracked> tl;
+    ASSUME_ITS_TRUE(tl.native_handle() != 0);
+    ASSUME_ITS_TRUE(tl.get() == nullptr);
+    tl.local().hits++;
+    tl.local().hits++;
+    ASSUME_ITS_EQUAL_I32(tl.get()->hits, 2);
+    ASSUME_ITS_EQUAL_I32(tls_live.load(), 1);
+    tl.reset(new Tracked());
+    ASSUME_ITS_EQUAL_I32(tl.get()->hits, 0);
+    ASSUME_ITS_EQUAL_I32(tls_live.load(), 1);
+    tl.reset();
+    ASSUME_ITS_EQUAL_I32(tls_live.load(), 0);
+}
+
+FOSSIL_TEST(cpp_tls_deleted_when_library_threads_exit) {
+    ThreadLocal<Tracked> tl;
+    std::vector<Thread*> threads;
+    for (int i = 0; i < 3; ++i) threads.push_back(new Thread(tls_count_hits, &tl));
+    for (Thread* t : threads) {
+        t->join();
+        delete t;
+    }
+    ASSUME_ITS_EQUAL_I32(tls_total.load(), 30);
+    ASSUME_ITS_EQUAL_I32(tls_live.load(), 0);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_tls_tests) {
+    FOSSIL_ADD_TEST(cpp_tls_fixture, cpp_tls_local_and_reset);
+    FOSSIL_ADD_TEST(cpp_tls_fixture, cpp_tls_deleted_when_library_threads_exit);
+
+    FOSSIL_ADD_SUITE(cpp_tls_fixture);
+} // end of tests
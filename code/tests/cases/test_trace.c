@@ -0,0 +1,343 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <stdlib.h>
+#include <string.h>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(c_trace_fixture);
+
+FOSSIL_SETUP(c_trace_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(c_trace_fixture) {
+    // Teardown the test fixture
+}
+
+/* Growable export target; the document is NUL-terminated once export returns. */
+typedef struct {
+    char *data;
+    size_t len;
+    size_t cap;
+} trace_buffer_t;
+
+static int trace_buffer_write(void *ctx, const char *data, size_t len) {
+    trace_buffer_t *b = (trace_buffer_t *)ctx;
+    if (b->len + len + 1 > b->cap) {
+        size_t cap = b->cap ? b->cap : 4096;
+        while (b->len + len + 1 > cap) cap *= 2;
+        char *p = (char *)realloc(b->data, cap);
+        if (!p) return 1;
+        b->data = p;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, data, len);
+    b->len += len;
+    b->data[b->len] = '\0';
+    return 0;
+}
+
+static int trace_refuse_write(void *ctx, const char *data, size_t len) {
+    (void)ctx; (void)data; (void)len;
+    return 1;
+}
+
+static size_t trace_count(const char *haystack, const char *needle) {
+    size_t n = 0;
+    for (const char *p = haystack; p && (p = strstr(p, needle)) != NULL; p += strlen(needle)) ++n;
+    return n;
+}
+
+typedef struct {
+    fossil_threads_mutex_t mutex;
+    fossil_threads_latch_t held;
+} trace_holder_t;
+
+/* Holds the mutex long enough for the main thread to block on it. */
+static void *trace_hold_mutex(void *arg) {
+    trace_holder_t *h = (trace_holder_t *)arg;
+    fossil_threads_mutex_lock(&h->mutex);
+    fossil_threads_latch_count_down(&h->held, 1);
+    fossil_threads_thread_sleep_ms(20);
+    fossil_threads_mutex_unlock(&h->mutex);
+    return NULL;
+}
+
+/* Single-worker pool: the count is published by fossil_threads_pool_wait. */
+static void *trace_pool_task(void *arg) {
+    ++*(int *)arg;
+    return NULL;
+}
+
+/* False in builds configured with -Dwith_tracing=disabled. */
+static int trace_compiled_in(void) {
+    int rc = fossil_threads_trace_start(0);
+    if (rc == FOSSIL_THREADS_TRACE_OK) fossil_threads_trace_stop();
+    return rc != FOSSIL_THREADS_TRACE_ENOSYS;
+}
+
+static void *trace_many_instants(void *arg) {
+    int n = *(int *)arg;
+    for (int i = 0; i < n; ++i) fossil_threads_trace_instant("wrap");
+    return NULL;
+}
+
+/* Starts a recording thread from inside the writer; the thread needs the
+ * registry lock to get a ring, so the writer must run without it. */
+typedef struct {
+    trace_buffer_t out;
+    int spawned;
+} trace_reentrant_t;
+
+static int trace_reentrant_write(void *ctx, const char *data, size_t len) {
+    trace_reentrant_t *t = (trace_reentrant_t *)ctx;
+    if (!t->spawned) {
+        int n = 1;
+        fossil_threads_thread_t th;
+        t->spawned = 1;
+        fossil_threads_thread_init(&th);
+        fossil_threads_thread_create(&th, trace_many_instants, &n);
+        fossil_threads_thread_join(&th, NULL);
+        fossil_threads_thread_dispose(&th);
+    }
+    return trace_buffer_write(&t->out, data, len);
+}
+
+/* Records n instants on a new thread and exports them; returns how many came out. */
+static size_t trace_thread_session(size_t capacity, int n) {
+    size_t kept = 0;
+    if (fossil_threads_trace_start(capacity) != FOSSIL_THREADS_TRACE_OK) return 0;
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, trace_many_instants, &n);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+    fossil_threads_trace_stop();
+
+    trace_buffer_t out = { NULL, 0, 0 };
+    if (fossil_threads_trace_export(trace_buffer_write, &out) == FOSSIL_THREADS_TRACE_OK)
+        kept = trace_count(out.data, "\"name\":\"wrap\"");
+    free(out.data);
+    return kept;
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_TEST(c_trace_start_stop_and_errors) {
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(NULL, NULL), FOSSIL_THREADS_TRACE_EINVAL);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export_file(NULL), FOSSIL_THREADS_TRACE_EINVAL);
+
+    ASSUME_ITS_FALSE(fossil_threads_trace_enabled());
+    if (!trace_compiled_in()) {
+        ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_ENOSYS);
+        ASSUME_ITS_FALSE(fossil_threads_trace_enabled());
+        ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_refuse_write, NULL),
+                             FOSSIL_THREADS_TRACE_ENOSYS);
+        return;
+    }
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_OK);
+    ASSUME_ITS_TRUE(fossil_threads_trace_enabled());
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_EBUSY);
+    fossil_threads_trace_instant("c_trace_marker");
+    fossil_threads_trace_stop();
+    ASSUME_ITS_FALSE(fossil_threads_trace_enabled());
+
+    /* A failing writer aborts the export. */
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_refuse_write, NULL), FOSSIL_THREADS_TRACE_EIO);
+    fossil_threads_trace_clear();
+}
+
+FOSSIL_TEST(c_trace_records_library_events) {
+    if (!trace_compiled_in()) return;
+    fossil_threads_trace_clear();
+    fossil_threads_trace_set_thread_name("c \"trace\" main");
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_OK);
+
+    fossil_threads_trace_begin("c_trace_span");
+    fossil_threads_trace_instant("c_trace_instant");
+    fossil_threads_trace_end();
+
+    /* Contended mutex: a library thread holds it while this one blocks. */
+    trace_holder_t holder;
+    fossil_threads_latch_init(&holder.held, 1, 0);
+    fossil_threads_mutex_init(&holder.mutex);
+    fossil_threads_mutex_set_name(&holder.mutex, "c_trace_lock");
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    ASSUME_ITS_EQUAL_I32(fossil_threads_thread_create(&t, trace_hold_mutex, &holder), FOSSIL_THREADS_OK);
+    fossil_threads_latch_wait(&holder.held);
+    fossil_threads_mutex_lock(&holder.mutex);
+    fossil_threads_mutex_unlock(&holder.mutex);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+
+    /* Condition wait that times out. */
+    fossil_threads_cond_t cond;
+    fossil_threads_cond_init(&cond);
+    fossil_threads_mutex_lock(&holder.mutex);
+    fossil_threads_cond_timedwait(&cond, &holder.mutex, 1);
+    fossil_threads_mutex_unlock(&holder.mutex);
+    fossil_threads_cond_dispose(&cond);
+    fossil_threads_mutex_dispose(&holder.mutex);
+
+    /* Pool tasks, run by a named worker. */
+    int ran = 0;
+    fossil_threads_pool_t *pool = fossil_threads_pool_create(1);
+    ASSUME_ITS_TRUE(pool != NULL);
+    for (int i = 0; i < 4; ++i) fossil_threads_pool_submit(pool, trace_pool_task, &ran);
+    fossil_threads_pool_wait(pool);
+    fossil_threads_pool_destroy(pool);
+    ASSUME_ITS_EQUAL_I32(ran, 4);
+
+    fossil_threads_trace_stop();
+    trace_buffer_t out = { NULL, 0, 0 };
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_buffer_write, &out), FOSSIL_THREADS_TRACE_OK);
+    ASSUME_ITS_TRUE(out.data != NULL);
+    ASSUME_ITS_TRUE(strncmp(out.data, "{\"traceEvents\":[", 16) == 0);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"c_trace_span\",\"cat\":\"user\",\"ph\":\"B\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"ph\":\"E\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"c_trace_instant\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"mutex.wait\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"label\":\"c_trace_lock\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"cond.wait\"") != NULL);
+    ASSUME_ITS_EQUAL_I32((int)trace_count(out.data, "\"name\":\"pool.task\""), 4);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"thread.run\"") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"args\":{\"name\":\"pool worker 0\"}") != NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"args\":{\"name\":\"c \\\"trace\\\" main\"}") != NULL);
+    /* The marker from the previous test was cleared. */
+    ASSUME_ITS_TRUE(strstr(out.data, "c_trace_marker") == NULL);
+    free(out.data);
+
+    /* Exported rings of exited threads are recycled, not exported again. */
+    out.data = NULL;
+    out.len = out.cap = 0;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_buffer_write, &out), FOSSIL_THREADS_TRACE_OK);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"pool.task\"") == NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"c_trace_span\"") != NULL);
+    free(out.data);
+    fossil_threads_trace_set_thread_name(NULL);
+    fossil_threads_trace_clear();
+}
+
+FOSSIL_TEST(c_trace_off_records_nothing_and_ring_wraps) {
+    if (!trace_compiled_in()) return;
+    fossil_threads_trace_clear();
+    fossil_threads_trace_instant("c_trace_while_off");
+    fossil_threads_mutex_t m;
+    fossil_threads_cond_t cond;
+    fossil_threads_mutex_init(&m);
+    fossil_threads_cond_init(&cond);
+    fossil_threads_mutex_lock(&m);
+    fossil_threads_cond_timedwait(&cond, &m, 1);
+    fossil_threads_mutex_unlock(&m);
+
+    /* A thread writing more than a ring holds keeps only the newest events. */
+    int n = (int)FOSSIL_THREADS_TRACE_EVENTS_DEFAULT + 1000;
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_OK);
+    fossil_threads_thread_t t;
+    fossil_threads_thread_init(&t);
+    fossil_threads_thread_create(&t, trace_many_instants, &n);
+    fossil_threads_thread_join(&t, NULL);
+    fossil_threads_thread_dispose(&t);
+    fossil_threads_trace_stop();
+
+    trace_buffer_t out = { NULL, 0, 0 };
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_buffer_write, &out), FOSSIL_THREADS_TRACE_OK);
+    ASSUME_ITS_TRUE(strstr(out.data, "c_trace_while_off") == NULL);
+    ASSUME_ITS_TRUE(strstr(out.data, "\"name\":\"cond.wait\"") == NULL);
+    size_t wraps = trace_count(out.data, "\"name\":\"wrap\"");
+    ASSUME_ITS_TRUE(wraps > 0);
+    ASSUME_ITS_TRUE(wraps <= FOSSIL_THREADS_TRACE_EVENTS_DEFAULT);
+    free(out.data);
+
+    fossil_threads_cond_dispose(&cond);
+    fossil_threads_mutex_dispose(&m);
+    fossil_threads_trace_clear();
+}
+
+FOSSIL_TEST(c_trace_export_writer_runs_unlocked) {
+    if (!trace_compiled_in()) return;
+    fossil_threads_trace_clear();
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_start(0), FOSSIL_THREADS_TRACE_OK);
+    /* Enough events that the writer is first called mid-document */
+    for (int i = 0; i < 200; ++i) fossil_threads_trace_instant("c_trace_reentrant");
+
+    trace_reentrant_t t;
+    memset(&t, 0, sizeof(t));
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_reentrant_write, &t), FOSSIL_THREADS_TRACE_OK);
+    fossil_threads_trace_stop();
+    ASSUME_ITS_TRUE(t.spawned);
+    ASSUME_ITS_TRUE(strstr(t.out.data, "c_trace_reentrant") != NULL);
+    free(t.out.data);
+
+    /* The thread started by the writer recorded into a ring of its own */
+    trace_buffer_t again = { NULL, 0, 0 };
+    ASSUME_ITS_EQUAL_I32(fossil_threads_trace_export(trace_buffer_write, &again), FOSSIL_THREADS_TRACE_OK);
+    ASSUME_ITS_TRUE(trace_count(again.data, "\"name\":\"wrap\"") == 1);
+    free(again.data);
+    fossil_threads_trace_clear();
+}
+
+FOSSIL_TEST(c_trace_recycled_ring_takes_new_capacity) {
+    if (!trace_compiled_in()) return;
+    fossil_threads_trace_clear();
+
+    /* Each thread adopts the ring freed by the last export; it must be
+     * resized both ways, not keep the capacity it was first made with. */
+    size_t kept = trace_thread_session(64, 200);
+    ASSUME_ITS_TRUE(kept > 0 && kept <= 64);
+    ASSUME_ITS_EQUAL_I32((int)trace_thread_session(1024, 500), 500);
+    kept = trace_thread_session(64, 200);
+    ASSUME_ITS_TRUE(kept > 0 && kept <= 64);
+    fossil_threads_trace_clear();
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(c_trace_tests) {
+    FOSSIL_ADD_TEST(c_trace_fixture, c_trace_start_stop_and_errors);
+    FOSSIL_ADD_TEST(c_trace_fixture, c_trace_records_library_events);
+    FOSSIL_ADD_TEST(c_trace_fixture, c_trace_off_records_nothing_and_ring_wraps);
+    FOSSIL_ADD_TEST(c_trace_fixture, c_trace_export_writer_runs_unlocked);
+    FOSSIL_ADD_TEST(c_trace_fixture, c_trace_recycled_ring_takes_new_capacity);
+
+    FOSSIL_ADD_SUITE(c_trace_fixture);
+} // end of tests
@@ -0,0 +1,102 @@
+/**
+ * -----------------------------------------------------------------------------
+ * Project: Fossil Logic
+ *
+ * This file is part of the Fossil Logic project, which aims to develop
+ * high-performance, cross-platform applications and libraries. The code
+ * contained herein is licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License. You may obtain
+ * a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ * Author: Michael Gene Brockus (Dreamer)
+ * Date: 04/05/2013
+ *
+ * Copyright (C) 2013-Current Fossil Logic. All rights reserved.
+ * -----------------------------------------------------------------------------
+ */
+#include <fossil/maip/framework.h>
+#include "fossil/threads/framework.h"
+#include <string>
+
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Utilities
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// Setup steps for things like test fixtures and
+// mock objects are set here.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+FOSSIL_SUITE(cpp_trace_fixture);
+
+FOSSIL_SETUP(cpp_trace_fixture) {
+    // Setup the test fixture
+}
+
+FOSSIL_TEARDOWN(cpp_trace_fixture) {
+    // Teardown the test fixture
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Cases
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// The test cases below are provided as samples, inspired
+// by the Meson build system's approach of using test cases
+// as samples for library usage.
+// * * * * * * * * * * * * * * * * * * * * * * * *
+
+using fossil::threads::Trace;
+using fossil::threads::TraceScope;
+
+FOSSIL_TEST(cpp_trace_scope_and_json) {
+    if (fossil_threads_trace_start(0) == FOSSIL_THREADS_TRACE_ENOSYS) {
+        bool threw = false;
+        try {
+            Trace::start();
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        ASSUME_ITS_TRUE(threw);
+        return;
+    }
+    Trace::stop();
+    Trace::clear();
+    Trace::start();
+    ASSUME_ITS_TRUE(Trace::enabled());
+    bool threw = false;
+    try {
+        Trace::start();
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    ASSUME_ITS_TRUE(threw);
+    {
+        TraceScope scope("cpp_trace_scope");
+        Trace::instant("cpp_trace_instant");
+    }
+    Trace::stop();
+
+    std::string json = Trace::to_json();
+    ASSUME_ITS_TRUE(json.rfind("{\"traceEvents\":[", 0) == 0);
+    ASSUME_ITS_TRUE(json.find("\"name\":\"cpp_trace_scope\",\"cat\":\"user\",\"ph\":\"B\"") != std::string::npos);
+    ASSUME_ITS_TRUE(json.find("\"ph\":\"E\"") != std::string::npos);
+    ASSUME_ITS_TRUE(json.find("\"name\":\"cpp_trace_instant\"") != std::string::npos);
+    Trace::clear();
+    ASSUME_ITS_TRUE(Trace::to_json().find("cpp_trace_scope") == std::string::npos);
+}
+
+// * * * * * * * * * * * * * * * * * * * * * * * *
+// * Fossil Logic Test Pool
+// * * * * * * * * * * * * * * * * * * * * * * * *
+FOSSIL_TEST_GROUP(cpp_trace_tests) {
+    FOSSIL_ADD_TEST(cpp_trace_fixture, cpp_trace_scope_and_json);
+
+    FOSSIL_ADD_SUITE(cpp_trace_fixture);
+} // end of tests